@@ -45,6 +45,7 @@
 #include "py/mphal.h"
 #include "py/stream.h"
 #include "py/mperrno.h"
+#include "extmod/moduselect.h"
 #include "lib/netutils/netutils.h"
 #include "tcpip_adapter.h"
 
@@ -430,12 +431,52 @@ STATIC mp_uint_t socket_stream_ioctl(mp_obj_t self_in, mp_uint_t request, uintpt
         if (FD_ISSET(socket->fd, &wfds)) ret |= MP_STREAM_POLL_WR;
         if (FD_ISSET(socket->fd, &efds)) ret |= MP_STREAM_POLL_HUP;
         return ret;
+    } else if (request == MP_STREAM_GET_FILENO) {
+        return socket->fd;
     }
 
     *errcode = MP_EINVAL;
     return MP_STREAM_ERROR;
 }
 
+#if MICROPY_PY_USELECT_WAIT_FDS
+// Wait for many sockets with one lwip select, which blocks this task until
+// lwIP signals that one of them is ready
+int mp_uselect_wait_fds(mp_uselect_fd_t *fds, size_t nfds, mp_uint_t timeout_ms) {
+    fd_set rfds; FD_ZERO(&rfds);
+    fd_set wfds; FD_ZERO(&wfds);
+    fd_set efds; FD_ZERO(&efds);
+    int maxfd = -1;
+    for (size_t i = 0; i < nfds; ++i) {
+        int fd = fds[i].fd;
+        if (fds[i].events & MP_STREAM_POLL_RD) FD_SET(fd, &rfds);
+        if (fds[i].events & MP_STREAM_POLL_WR) FD_SET(fd, &wfds);
+        FD_SET(fd, &efds);
+        if (fd > maxfd) maxfd = fd;
+    }
+
+    struct timeval timeout = { .tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000 };
+    int r = select(maxfd + 1, &rfds, &wfds, &efds, &timeout);
+    if (r < 0) {
+        return -MP_EIO;
+    }
+
+    int n_ready = 0;
+    for (size_t i = 0; i < nfds; ++i) {
+        int fd = fds[i].fd;
+        uint16_t ret = 0;
+        if (r > 0) {
+            if (FD_ISSET(fd, &rfds)) ret |= MP_STREAM_POLL_RD;
+            if (FD_ISSET(fd, &wfds)) ret |= MP_STREAM_POLL_WR;
+            if (FD_ISSET(fd, &efds)) ret |= MP_STREAM_POLL_HUP;
+        }
+        fds[i].revents = ret;
+        if (ret) n_ready++;
+    }
+    return n_ready;
+}
+#endif
+
 STATIC const mp_map_elem_t socket_locals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR___del__), (mp_obj_t)&socket_close_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_close), (mp_obj_t)&socket_close_obj },
@@ -58,7 +58,7 @@ class Database:
         """Writes changes to flash"""
         if self.dirty:
             with open(self.filename, "wt") as file:
-                file.write(json.dumps(self.data))
+                json.dump(self.data, file)
                 file.flush()
             # os.sync()
             self.dirty = False
@@ -1,9 +1,17 @@
 import ugfx, badge, sys, uos as os, appglue, version, easydraw, virtualtimers, tasks.powermanagement as pm, dialogs, time, ujson, sys
+from micropython import const
 
 # Application list
 
 apps = []
 
+SYSTEM_APPS = const((
+    ("installer", {"name":"Installer", "category":"system"}),
+    ("setup", {"name":"Set nickname", "category":"system"}),
+    ("update", {"name":"Update apps", "category":"system"}),
+    ("ota_update", {"name":"Update firmware", "category":"system"}),
+))
+
 def add_app(app,information):
     global apps
     try:
@@ -26,10 +34,8 @@ def populate_apps():
         userApps = []
     for app in userApps:
         add_app(app,read_metadata(app))
-    add_app("installer",{"name":"Installer", "category":"system"})
-    add_app("setup",{"name":"Set nickname", "category":"system"})
-    add_app("update",{"name":"Update apps", "category":"system"})
-    add_app("ota_update",{"name":"Update firmware", "category":"system"})
+    for app, information in SYSTEM_APPS:
+        add_app(app,information)
   
 # List as shown on screen
 currentListTitles = []
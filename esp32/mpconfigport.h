@@ -14,14 +14,24 @@
 
 // emitters
 #define MICROPY_PERSISTENT_CODE_LOAD        (1)
+#define MICROPY_PERSISTENT_CODE_SAVE        (1)
+#define MICROPY_PERSISTENT_CODE_CACHE       (1)
 
 // compiler configuration
 #define MICROPY_COMP_MODULE_CONST           (1)
 #define MICROPY_COMP_TRIPLE_TUPLE_ASSIGN    (1)
+#define MICROPY_COMP_FOR_ENUMERATE_ZIP      (1)
+#define MICROPY_COMP_CONST_LITERAL          (1)
+#define MICROPY_COMP_STREAMING              (1)
 
 // optimisations
 #define MICROPY_OPT_COMPUTED_GOTO           (1)
 #define MICROPY_OPT_MPZ_BITWISE             (1)
+#define MICROPY_OPT_MPZ_KARATSUBA           (1)
+#define MICROPY_OPT_MPZ_MONTGOMERY          (1)
+#define MICROPY_OPT_ITER_LEN_HINT           (1)
+#define MICROPY_OPT_LIST_TIMSORT            (1)
+#define MICROPY_OPT_STR_FORMAT_CACHE        (1)
 
 // Python internal features
 #define MICROPY_READER_VFS                  (1)
@@ -38,6 +48,8 @@
 #define MICROPY_ERROR_REPORTING             (MICROPY_ERROR_REPORTING_NORMAL)
 #define MICROPY_WARNINGS                    (1)
 #define MICROPY_FLOAT_IMPL                  (MICROPY_FLOAT_IMPL_FLOAT)
+#define MICROPY_FLOAT_REPR_SHORTEST         (1)
+#define MICROPY_FLOAT_PARSE_EXACT           (1)
 #define MICROPY_PY_BUILTINS_COMPLEX         (1)
 #define MICROPY_CPYTHON_COMPAT              (1)
 #define MICROPY_STREAMS_NON_BLOCK           (1)
@@ -66,6 +78,7 @@
 #define MICROPY_PY_BUILTINS_STR_SPLITLINES  (1)
 #define MICROPY_PY_BUILTINS_BYTEARRAY       (1)
 #define MICROPY_PY_BUILTINS_MEMORYVIEW      (1)
+#define MICROPY_PY_BUILTINS_MEMORYVIEW_BYTES_METHODS (1)
 #define MICROPY_PY_BUILTINS_SET             (1)
 #define MICROPY_PY_BUILTINS_SLICE           (1)
 #define MICROPY_PY_BUILTINS_SLICE_ATTRS     (1)
@@ -88,8 +101,10 @@
 #define MICROPY_PY_BUILTINS_HELP_MODULES    (1)
 #define MICROPY_PY___FILE__                 (1)
 #define MICROPY_PY_MICROPYTHON_MEM_INFO     (1)
+#define MICROPY_PY_MICROPYTHON_STRINGBUILDER (1)
 #define MICROPY_PY_ARRAY                    (1)
 #define MICROPY_PY_ARRAY_SLICE_ASSIGN       (1)
+#define MICROPY_PY_ARRAY_BULK_OPS           (1)
 #define MICROPY_PY_ATTRTUPLE                (1)
 #define MICROPY_PY_COLLECTIONS              (1)
 #define MICROPY_PY_COLLECTIONS_ORDEREDDICT  (1)
@@ -102,6 +117,7 @@
 #define MICROPY_PY_IO_BYTESIO               (1)
 #define MICROPY_PY_IO_BUFFEREDWRITER        (1)
 #define MICROPY_PY_STRUCT                   (1)
+#define MICROPY_PY_STRUCT_STRUCT            (1)
 #define MICROPY_PY_SYS                      (1)
 #define MICROPY_PY_SYS_MAXSIZE              (1)
 #define MICROPY_PY_SYS_MODULES              (1)
@@ -110,6 +126,7 @@
 #define MICROPY_PY_SYS_STDIO_BUFFER         (0)
 #define MICROPY_PY_UERRNO                   (1)
 #define MICROPY_PY_USELECT                  (1)
+#define MICROPY_PY_USELECT_WAIT_FDS         (1)
 #define MICROPY_PY_UTIME_MP_HAL             (1)
 #define MICROPY_PY_THREAD                   (1)
 #define MICROPY_PY_THREAD_GIL               (1)
@@ -118,10 +135,18 @@
 // extended modules
 #define MICROPY_PY_UCTYPES                  (1)
 #define MICROPY_PY_UZLIB                    (1)
+#define MICROPY_PY_UZLIB_COMPRESS           (1)
+#define MICROPY_PY_UZLIB_FAST_DECODE        (1)
 #define MICROPY_PY_UJSON                    (1)
+#define MICROPY_PY_UJSON_SEPARATORS         (1)
 #define MICROPY_PY_URE                      (1)
+#define MICROPY_PY_URE_SUB                  (1)
+#define MICROPY_PY_URE_FINDITER             (1)
+#define MICROPY_PY_URE_MATCH_SPAN           (1)
+#define MICROPY_PY_URE_CACHE                (1)
 #define MICROPY_PY_UHEAPQ                   (1)
 #define MICROPY_PY_UTIMEQ                   (1)
+#define MICROPY_PY_UEVENTLOOP               (1)
 #define MICROPY_PY_UHASHLIB                 (0) // We use the ESP32 version
 #define MICROPY_PY_UHASHLIB_SHA1            (MICROPY_PY_USSL && MICROPY_SSL_AXTLS)
 #define MICROPY_PY_UBINASCII                (1)
@@ -141,6 +166,7 @@
 #define MICROPY_SSL_MBEDTLS                 (1)
 #define MICROPY_PY_WEBSOCKET                (0)
 #define MICROPY_PY_FRAMEBUF                 (1)
+#define MICROPY_PY_KVLOG                    (1)
 
 // fatfs configuration
 #define MICROPY_FATFS_ENABLE_LFN            (1)
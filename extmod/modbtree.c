@@ -52,6 +52,7 @@ typedef struct _mp_obj_btree_t {
     #define FLAG_ITER_ITEMS  0xc0
     byte flags;
     byte next_flags;
+    mp_obj_t ret_tuple;
 } mp_obj_btree_t;
 
 STATIC const mp_obj_type_t btree_type;
@@ -71,7 +72,9 @@ STATIC mp_obj_btree_t *btree_new(DB *db) {
     o->db = db;
     o->start_key = mp_const_none;
     o->end_key = mp_const_none;
+    o->flags = 0;
     o->next_flags = 0;
+    o->ret_tuple = MP_OBJ_NULL;
     return o;
 }
 
@@ -120,6 +123,45 @@ STATIC mp_obj_t btree_get(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(btree_get_obj, 2, 3, btree_get);
 
+STATIC mp_obj_t btree_load(mp_obj_t self_in, mp_obj_t items_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_iter_buf_t iter_buf;
+    mp_obj_t iterable = mp_getiter(items_in, &iter_buf);
+    mp_obj_t item;
+    while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
+        mp_obj_t *kv;
+        mp_obj_get_array_fixed_n(item, 2, &kv);
+        DBT key, val;
+        key.data = (void*)mp_obj_str_get_data(kv[0], &key.size);
+        val.data = (void*)mp_obj_str_get_data(kv[1], &val.size);
+        // Keys put in ascending order after the last key take the fast path
+        // of __bt_put, which inserts on the cached rightmost leaf without a
+        // search, and the splits then leave the pages full.
+        int res = __bt_put(self->db, &key, &val, 0);
+        CHECK_ERROR(res);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(btree_load_obj, btree_load);
+
+#if MICROPY_PY_BTREE_STATS
+STATIC mp_obj_t btree_stats(mp_obj_t self_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    BTREE *t = self->db->internal;
+    MPOOL *mp = t->bt_mp;
+    // a cached page is reused for another one only when the cache is full,
+    // and mpool counts that as a flush
+    mp_obj_t items[4] = {
+        mp_obj_new_int_from_uint(mp->cachehit),
+        mp_obj_new_int_from_uint(mp->cachemiss),
+        mp_obj_new_int_from_uint(mp->pageflush),
+        mp_obj_new_int_from_uint(mp->pagewrite),
+    };
+    return mp_obj_new_tuple(4, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(btree_stats_obj, btree_stats);
+#endif
+
 STATIC mp_obj_t btree_seq(size_t n_args, const mp_obj_t *args) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
     int flags = MP_OBJ_SMALL_INT_VALUE(args[1]);
@@ -192,27 +234,32 @@ STATIC mp_obj_t btree_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
     return self_in;
 }
 
-STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
-    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
-    DBT key, val;
+// Get the next item of the iteration set up by keys(), values() or items(),
+// returning false at the end of the range.
+STATIC bool btree_next(mp_obj_btree_t *self, DBT *key, DBT *val) {
+    if ((self->flags & FLAG_ITER_TYPE_MASK) == 0) {
+        return false;
+    }
+
     int res;
     bool desc = self->flags & FLAG_DESC;
     if (self->start_key != MP_OBJ_NULL) {
         int flags = R_FIRST;
         if (self->start_key != mp_const_none) {
-            key.data = (void*)mp_obj_str_get_data(self->start_key, &key.size);
+            key->data = (void*)mp_obj_str_get_data(self->start_key, &key->size);
             flags = R_CURSOR;
         } else if (desc) {
             flags = R_LAST;
         }
-        res = __bt_seq(self->db, &key, &val, flags);
+        res = __bt_seq(self->db, key, val, flags);
         self->start_key = MP_OBJ_NULL;
     } else {
-        res = __bt_seq(self->db, &key, &val, desc ? R_PREV : R_NEXT);
+        res = __bt_seq(self->db, key, val, desc ? R_PREV : R_NEXT);
     }
 
     if (res == RET_SPECIAL) {
-        return MP_OBJ_STOP_ITERATION;
+        self->flags &= ~FLAG_ITER_TYPE_MASK;
+        return false;
     }
     CHECK_ERROR(res);
 
@@ -220,7 +267,7 @@ STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
         DBT end_key;
         end_key.data = (void*)mp_obj_str_get_data(self->end_key, &end_key.size);
         BTREE *t = self->db->internal;
-        int cmp = t->bt_cmp(&key, &end_key);
+        int cmp = t->bt_cmp(key, &end_key);
         if (desc) {
             cmp = -cmp;
         }
@@ -228,11 +275,21 @@ STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
             cmp--;
         }
         if (cmp >= 0) {
-            self->end_key = MP_OBJ_NULL;
-            return MP_OBJ_STOP_ITERATION;
+            self->flags &= ~FLAG_ITER_TYPE_MASK;
+            return false;
         }
     }
 
+    return true;
+}
+
+STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    DBT key, val;
+    if (!btree_next(self, &key, &val)) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+
     switch (self->flags & FLAG_ITER_TYPE_MASK) {
         case FLAG_ITER_KEYS:
             return mp_obj_new_bytes(key.data, key.size);
@@ -248,6 +305,43 @@ STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
     }
 }
 
+STATIC void btree_copy_into(mp_obj_t buf_in, const DBT *dbt) {
+    if (buf_in != mp_const_none) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+        memcpy(bufinfo.buf, dbt->data, dbt->size < bufinfo.len ? dbt->size : bufinfo.len);
+    }
+}
+
+STATIC mp_obj_t btree_readinto(size_t n_args, const mp_obj_t *args) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (self->next_flags != 0) {
+        // start the iteration set up by keys(), values() or items()
+        self->flags = self->next_flags;
+        self->next_flags = 0;
+    }
+
+    DBT key, val;
+    if (!btree_next(self, &key, &val)) {
+        return mp_const_none;
+    }
+    btree_copy_into(args[1], &key);
+    if (n_args > 2) {
+        btree_copy_into(args[2], &val);
+    }
+
+    // the lengths are returned in the same tuple each time, so that
+    // scanning a range does not allocate any memory
+    if (self->ret_tuple == MP_OBJ_NULL) {
+        self->ret_tuple = mp_obj_new_tuple(2, NULL);
+    }
+    mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
+    t->items[0] = MP_OBJ_NEW_SMALL_INT(key.size);
+    t->items[1] = MP_OBJ_NEW_SMALL_INT(val.size);
+    return self->ret_tuple;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(btree_readinto_obj, 2, 3, btree_readinto);
+
 STATIC mp_obj_t btree_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
     if (value == MP_OBJ_NULL) {
@@ -306,6 +400,11 @@ STATIC const mp_rom_map_elem_t btree_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_keys), MP_ROM_PTR(&btree_keys_obj) },
     { MP_ROM_QSTR(MP_QSTR_values), MP_ROM_PTR(&btree_values_obj) },
     { MP_ROM_QSTR(MP_QSTR_items), MP_ROM_PTR(&btree_items_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&btree_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&btree_load_obj) },
+    #if MICROPY_PY_BTREE_STATS
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&btree_stats_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(btree_locals_dict, btree_locals_dict_table);
@@ -0,0 +1,660 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Paul Sokolovsky
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/runtime0.h"
+#include "py/stream.h"
+#include "py/mperrno.h"
+#include "extmod/uzlib/tinf.h"
+
+#if MICROPY_PY_KVLOG
+
+#if !MICROPY_PY_UZLIB
+#error "kvlog requires MICROPY_PY_UZLIB for its CRC32"
+#endif
+
+// A key/value store kept as a log of records in a stream, which is split
+// into fixed-size segments.  Records are only ever appended, at the end of
+// the newest ("head") segment, so a store on flash wears it evenly and never
+// rewrites data in place.  The location of the current record for each key
+// is kept in a map in RAM, built by replaying the log when it is opened.
+//
+// When the head segment is full, a free segment becomes the new head.  One
+// free segment is always kept in reserve for compaction: when taking a new
+// head would use it up, the used segment with the fewest live bytes has its
+// current records copied to the head and is then freed.
+//
+// Each segment starts with a header holding a sequence number, which gives
+// the order of the segments when replaying.  Each record has a CRC32 that
+// also covers the sequence number of its segment, so after a crash a torn
+// record, or a stale one left over from a previous use of the segment, ends
+// the replay of that segment.  A compacted segment is only freed after the
+// records copied out of it have been flushed to the stream.
+
+#define SEG_MAGIC (0x474c564b) // "KVLG"
+#define SEG_HDR_SIZE (16)
+#define REC_HDR_SIZE (8)
+#define VLEN_TOMBSTONE (0xffff)
+
+// locations in the index have this bit set for a deletion record
+#define LOC_TOMBSTONE (1)
+
+typedef struct _kvlog_seg_t {
+    uint32_t seq; // 0 if the segment is free
+    uint32_t used; // offset of the end of the last record
+    uint32_t live; // bytes of records that are current
+} kvlog_seg_t;
+
+typedef struct _mp_obj_kvlog_t {
+    mp_obj_base_t base;
+    mp_obj_t stream;
+    mp_map_t index;
+    kvlog_seg_t *segs;
+    byte *buf; // one segment's worth, to assemble and copy records in
+    uint32_t segsize;
+    uint32_t next_seq;
+    uint16_t nsegs;
+    uint16_t head;
+    size_t len;
+    mp_uint_t user_bytes;
+    mp_uint_t written_bytes;
+    mp_uint_t compactions;
+} mp_obj_kvlog_t;
+
+typedef struct _mp_obj_kvlog_it_t {
+    mp_obj_base_t base;
+    mp_fun_1_t iternext;
+    mp_obj_kvlog_t *db;
+    size_t cur;
+} mp_obj_kvlog_it_t;
+
+STATIC const mp_obj_type_t kvlog_type;
+
+#define REC_SIZE(klen, vlen) ((REC_HDR_SIZE + (klen) + ((vlen) == VLEN_TOMBSTONE ? 0 : (vlen)) + 3) & ~3)
+
+STATIC void put_le32(byte *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+STATIC uint32_t get_le32(const byte *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+STATIC uint32_t kvlog_crc(uint32_t seq, const byte *data, size_t len) {
+    byte s[4];
+    put_le32(s, seq);
+    uint32_t crc = uzlib_crc32(s, 4, 0xffffffff);
+    return uzlib_crc32(data, len, crc) ^ 0xffffffff;
+}
+
+STATIC void kvlog_seek(mp_obj_kvlog_t *self, uint32_t pos) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(self->stream, MP_STREAM_OP_IOCTL);
+    struct mp_stream_seek_t seek_s;
+    seek_s.offset = pos;
+    seek_s.whence = 0;
+    int errcode;
+    if (stream_p->ioctl(self->stream, MP_STREAM_SEEK, (mp_uint_t)(uintptr_t)&seek_s, &errcode) == MP_STREAM_ERROR) {
+        mp_raise_OSError(errcode);
+    }
+}
+
+// returns the number of bytes read, which is less than len at the end of
+// the stream
+STATIC mp_uint_t kvlog_read(mp_obj_kvlog_t *self, uint32_t pos, void *buf, mp_uint_t len) {
+    kvlog_seek(self, pos);
+    int errcode;
+    mp_uint_t n = mp_stream_read_exactly(self->stream, buf, len, &errcode);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+    return n;
+}
+
+STATIC void kvlog_write(mp_obj_kvlog_t *self, uint32_t pos, const void *buf, mp_uint_t len) {
+    kvlog_seek(self, pos);
+    int errcode;
+    mp_stream_write_exactly(self->stream, buf, len, &errcode);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+    self->written_bytes += len;
+}
+
+STATIC void kvlog_flush(mp_obj_kvlog_t *self) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(self->stream, MP_STREAM_OP_IOCTL);
+    int errcode;
+    if (stream_p->ioctl(self->stream, MP_STREAM_FLUSH, 0, &errcode) == MP_STREAM_ERROR) {
+        mp_raise_OSError(errcode);
+    }
+}
+
+// the index holds bytes objects, so a str key is converted to look it up
+STATIC mp_obj_t kvlog_key(mp_obj_t key_in, size_t *klen) {
+    const char *data = mp_obj_str_get_data(key_in, klen);
+    if (*klen >= VLEN_TOMBSTONE) {
+        mp_raise_ValueError("key too long");
+    }
+    if (MP_OBJ_IS_TYPE(key_in, &mp_type_bytes)) {
+        return key_in;
+    }
+    return mp_obj_new_bytes((const byte*)data, *klen);
+}
+
+// size of the record at the given location of the log
+STATIC uint32_t kvlog_rec_size(mp_obj_kvlog_t *self, uint32_t loc) {
+    byte hdr[REC_HDR_SIZE];
+    kvlog_read(self, loc, hdr, REC_HDR_SIZE);
+    return REC_SIZE(hdr[4] | (hdr[5] << 8), hdr[6] | (hdr[7] << 8));
+}
+
+// Make the record at loc the current one for key, and account for the
+// bytes it and the record it replaces take in their segments.
+STATIC void kvlog_index_set(mp_obj_kvlog_t *self, mp_obj_t key, uint32_t loc, uint32_t size, bool tombstone) {
+    mp_map_elem_t *elem = mp_map_lookup(&self->index, key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+    if (elem->value != MP_OBJ_NULL) {
+        mp_uint_t old = MP_OBJ_SMALL_INT_VALUE(elem->value);
+        if (!(old & LOC_TOMBSTONE)) {
+            self->len -= 1;
+        }
+        old &= ~LOC_TOMBSTONE;
+        self->segs[old / self->segsize].live -= kvlog_rec_size(self, old);
+    }
+    if (!tombstone) {
+        self->len += 1;
+    }
+    self->segs[loc / self->segsize].live += size;
+    elem->value = MP_OBJ_NEW_SMALL_INT(loc | (tombstone ? LOC_TOMBSTONE : 0));
+}
+
+// Read the record at the given offset of a segment into buf, returning its
+// size, or 0 if there is no valid record there.
+STATIC uint32_t kvlog_load_rec(mp_obj_kvlog_t *self, uint16_t seg, uint32_t pos) {
+    byte *buf = self->buf;
+    if (pos + REC_HDR_SIZE > self->segsize
+        || kvlog_read(self, seg * self->segsize + pos, buf, REC_HDR_SIZE) != REC_HDR_SIZE) {
+        return 0;
+    }
+    uint32_t klen = buf[4] | (buf[5] << 8);
+    uint32_t vlen = buf[6] | (buf[7] << 8);
+    uint32_t size = REC_SIZE(klen, vlen);
+    uint32_t data_len = size - REC_HDR_SIZE;
+    if (pos + size > self->segsize
+        || kvlog_read(self, seg * self->segsize + pos + REC_HDR_SIZE, buf + REC_HDR_SIZE, data_len) != data_len
+        || kvlog_crc(self->segs[seg].seq, buf + 4, size - 4) != get_le32(buf)) {
+        return 0;
+    }
+    return size;
+}
+
+// start using a free segment as the head of the log
+STATIC void kvlog_new_head(mp_obj_kvlog_t *self, uint16_t seg) {
+    byte hdr[SEG_HDR_SIZE];
+    put_le32(hdr, SEG_MAGIC);
+    put_le32(hdr + 4, self->next_seq);
+    put_le32(hdr + 8, self->segsize);
+    put_le32(hdr + 12, kvlog_crc(0, hdr, 12));
+    kvlog_write(self, seg * self->segsize, hdr, SEG_HDR_SIZE);
+    self->segs[seg].seq = self->next_seq++;
+    self->segs[seg].used = SEG_HDR_SIZE;
+    self->segs[seg].live = 0;
+    self->head = seg;
+}
+
+STATIC int kvlog_find_free(mp_obj_kvlog_t *self, size_t *count) {
+    int free_seg = -1;
+    *count = 0;
+    for (int i = 0; i < self->nsegs; ++i) {
+        if (self->segs[i].seq == 0) {
+            free_seg = i;
+            *count += 1;
+        }
+    }
+    return free_seg;
+}
+
+// Copy the current records of the segment with the fewest live bytes, out
+// of those with superseded records, to the head and free it.  Returns false
+// if there is no such segment.
+STATIC bool kvlog_compact(mp_obj_kvlog_t *self) {
+    int victim = -1;
+    uint32_t oldest = 0xffffffff;
+    for (int i = 0; i < self->nsegs; ++i) {
+        kvlog_seg_t *s = &self->segs[i];
+        if (s->seq == 0 || i == self->head) {
+            continue;
+        }
+        if (s->seq < oldest) {
+            oldest = s->seq;
+        }
+        if (s->used - SEG_HDR_SIZE > s->live && (victim < 0 || s->live < self->segs[victim].live)) {
+            victim = i;
+        }
+    }
+    if (victim < 0) {
+        return false;
+    }
+    // Normally the reserved free segment has room for all the records of
+    // the victim, but a crash during an earlier compaction may have left
+    // none free.
+    size_t count;
+    kvlog_find_free(self, &count);
+    kvlog_seg_t *head = &self->segs[self->head];
+    if (count == 0 && self->segs[victim].live > self->segsize - head->used) {
+        return false;
+    }
+    // a deletion only needs to be kept while an older segment may still
+    // hold a record for the key
+    bool drop_tombstones = self->segs[victim].seq == oldest;
+
+    uint32_t pos = SEG_HDR_SIZE;
+    uint32_t size;
+    while (self->segs[victim].live > 0 && (size = kvlog_load_rec(self, victim, pos)) != 0) {
+        byte *buf = self->buf;
+        uint32_t loc = victim * self->segsize + pos;
+        pos += size;
+        uint32_t klen = buf[4] | (buf[5] << 8);
+        mp_obj_t key = mp_obj_new_bytes(buf + REC_HDR_SIZE, klen);
+        mp_map_elem_t *elem = mp_map_lookup(&self->index, key, MP_MAP_LOOKUP);
+        if (elem == NULL || (MP_OBJ_SMALL_INT_VALUE(elem->value) & ~LOC_TOMBSTONE) != loc) {
+            // superseded by a later record
+            continue;
+        }
+        bool tombstone = MP_OBJ_SMALL_INT_VALUE(elem->value) & LOC_TOMBSTONE;
+        self->segs[victim].live -= size;
+        if (tombstone && drop_tombstones) {
+            mp_map_lookup(&self->index, key, MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+            continue;
+        }
+        if (head->used + size > self->segsize) {
+            kvlog_new_head(self, kvlog_find_free(self, &count));
+            head = &self->segs[self->head];
+        }
+        put_le32(buf, kvlog_crc(head->seq, buf + 4, size - 4));
+        uint32_t new_loc = self->head * self->segsize + head->used;
+        kvlog_write(self, new_loc, buf, size);
+        head->used += size;
+        head->live += size;
+        elem->value = MP_OBJ_NEW_SMALL_INT(new_loc | (tombstone ? LOC_TOMBSTONE : 0));
+    }
+
+    if (self->segs[victim].live > 0) {
+        // a current record couldn't be read back
+        mp_raise_OSError(MP_EIO);
+    }
+
+    // the copies must reach the stream before the originals are dropped
+    kvlog_flush(self);
+    memset(self->buf, 0, SEG_HDR_SIZE);
+    kvlog_write(self, victim * self->segsize, self->buf, SEG_HDR_SIZE);
+    self->segs[victim].seq = 0;
+    self->compactions += 1;
+    return true;
+}
+
+// make room for a record of the given size at the head of the log
+STATIC void kvlog_reserve(mp_obj_kvlog_t *self, uint32_t size) {
+    if (size > self->segsize - SEG_HDR_SIZE) {
+        mp_raise_ValueError("record too large");
+    }
+    while (self->segs[self->head].used + size > self->segsize) {
+        size_t count;
+        int free_seg = kvlog_find_free(self, &count);
+        if (count >= 2) {
+            kvlog_new_head(self, free_seg);
+        } else if (!kvlog_compact(self)) {
+            mp_raise_OSError(MP_ENOSPC);
+        }
+    }
+}
+
+// append a record, returning its location
+STATIC uint32_t kvlog_append(mp_obj_kvlog_t *self, const byte *key, size_t klen, const byte *val, size_t vlen) {
+    uint32_t size = REC_SIZE(klen, vlen);
+    kvlog_reserve(self, size);
+    byte *buf = self->buf;
+    buf[4] = klen;
+    buf[5] = klen >> 8;
+    buf[6] = vlen;
+    buf[7] = vlen >> 8;
+    memcpy(buf + REC_HDR_SIZE, key, klen);
+    size_t len = REC_HDR_SIZE + klen;
+    if (vlen != VLEN_TOMBSTONE) {
+        memcpy(buf + len, val, vlen);
+        len += vlen;
+    }
+    memset(buf + len, 0, size - len);
+    kvlog_seg_t *head = &self->segs[self->head];
+    put_le32(buf, kvlog_crc(head->seq, buf + 4, size - 4));
+    uint32_t loc = self->head * self->segsize + head->used;
+    kvlog_write(self, loc, buf, size);
+    head->used += size;
+    return loc;
+}
+
+// replay the log to build the index and find the head
+STATIC void kvlog_recover(mp_obj_kvlog_t *self) {
+    byte hdr[SEG_HDR_SIZE];
+    for (int i = 0; i < self->nsegs; ++i) {
+        self->segs[i].seq = 0;
+        self->segs[i].used = SEG_HDR_SIZE;
+        self->segs[i].live = 0;
+        if (kvlog_read(self, i * self->segsize, hdr, SEG_HDR_SIZE) == SEG_HDR_SIZE
+            && get_le32(hdr) == SEG_MAGIC
+            && get_le32(hdr + 12) == kvlog_crc(0, hdr, 12)) {
+            if (get_le32(hdr + 8) != self->segsize) {
+                mp_raise_ValueError("segsize mismatch");
+            }
+            self->segs[i].seq = get_le32(hdr + 4);
+        }
+    }
+
+    // segments are replayed in order of their sequence numbers
+    uint32_t last_seq = 0;
+    for (;;) {
+        int seg = -1;
+        for (int i = 0; i < self->nsegs; ++i) {
+            uint32_t seq = self->segs[i].seq;
+            if (seq > last_seq && (seg < 0 || seq < self->segs[seg].seq)) {
+                seg = i;
+            }
+        }
+        if (seg < 0) {
+            break;
+        }
+        last_seq = self->segs[seg].seq;
+
+        uint32_t pos = SEG_HDR_SIZE;
+        uint32_t size;
+        while ((size = kvlog_load_rec(self, seg, pos)) != 0) {
+            const byte *buf = self->buf;
+            uint32_t klen = buf[4] | (buf[5] << 8);
+            uint32_t vlen = buf[6] | (buf[7] << 8);
+            mp_obj_t key = mp_obj_new_bytes(buf + REC_HDR_SIZE, klen);
+            kvlog_index_set(self, key, seg * self->segsize + pos, size, vlen == VLEN_TOMBSTONE);
+            pos += size;
+        }
+        self->segs[seg].used = pos;
+        self->head = seg;
+    }
+
+    if (last_seq == 0) {
+        self->next_seq = 1;
+        kvlog_new_head(self, 0);
+    } else {
+        self->next_seq = last_seq + 1;
+    }
+}
+
+STATIC mp_obj_t kvlog_get_value(mp_obj_kvlog_t *self, mp_obj_t key_in) {
+    size_t klen;
+    mp_obj_t key = kvlog_key(key_in, &klen);
+    mp_map_elem_t *elem = mp_map_lookup(&self->index, key, MP_MAP_LOOKUP);
+    if (elem == NULL || (MP_OBJ_SMALL_INT_VALUE(elem->value) & LOC_TOMBSTONE)) {
+        return MP_OBJ_NULL;
+    }
+    uint32_t loc = MP_OBJ_SMALL_INT_VALUE(elem->value);
+    byte hdr[REC_HDR_SIZE];
+    kvlog_read(self, loc, hdr, REC_HDR_SIZE);
+    size_t vlen = hdr[6] | (hdr[7] << 8);
+    vstr_t vstr;
+    vstr_init_len(&vstr, vlen);
+    kvlog_read(self, loc + REC_HDR_SIZE + klen, vstr.buf, vlen);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+
+STATIC void kvlog_put_value(mp_obj_kvlog_t *self, mp_obj_t key_in, mp_obj_t value) {
+    size_t klen;
+    mp_obj_t key = kvlog_key(key_in, &klen);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(value, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len >= VLEN_TOMBSTONE) {
+        mp_raise_ValueError("record too large");
+    }
+    const byte *kdata = (const byte*)mp_obj_str_get_data(key, &klen);
+    uint32_t loc = kvlog_append(self, kdata, klen, bufinfo.buf, bufinfo.len);
+    kvlog_index_set(self, key, loc, REC_SIZE(klen, bufinfo.len), false);
+    self->user_bytes += klen + bufinfo.len;
+}
+
+STATIC void kvlog_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    (void)kind;
+    mp_obj_kvlog_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "<kvlog %p>", self);
+}
+
+STATIC mp_obj_t kvlog_get(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t value = kvlog_get_value(MP_OBJ_TO_PTR(args[0]), args[1]);
+    if (value == MP_OBJ_NULL) {
+        return n_args > 2 ? args[2] : mp_const_none;
+    }
+    return value;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(kvlog_get_obj, 2, 3, kvlog_get);
+
+STATIC mp_obj_t kvlog_put(mp_obj_t self_in, mp_obj_t key, mp_obj_t value) {
+    kvlog_put_value(MP_OBJ_TO_PTR(self_in), key, value);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(kvlog_put_obj, kvlog_put);
+
+STATIC mp_obj_t kvlog_update(mp_obj_t self_in, mp_obj_t items_in) {
+    mp_obj_kvlog_t *self = MP_OBJ_TO_PTR(self_in);
+    if (MP_OBJ_IS_TYPE(items_in, &mp_type_dict)) {
+        items_in = mp_call_function_0(mp_load_attr(items_in, MP_QSTR_items));
+    }
+    mp_obj_iter_buf_t iter_buf;
+    mp_obj_t iterable = mp_getiter(items_in, &iter_buf);
+    mp_obj_t item;
+    while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
+        mp_obj_t *kv;
+        mp_obj_get_array_fixed_n(item, 2, &kv);
+        kvlog_put_value(self, kv[0], kv[1]);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(kvlog_update_obj, kvlog_update);
+
+STATIC mp_obj_t kvlog_flush_(mp_obj_t self_in) {
+    kvlog_flush(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(kvlog_flush_obj, kvlog_flush_);
+
+STATIC mp_obj_t kvlog_compact_(mp_obj_t self_in) {
+    mp_obj_kvlog_t *self = MP_OBJ_TO_PTR(self_in);
+    // compact every segment that has superseded records
+    size_t n = 0;
+    while (n < self->nsegs && kvlog_compact(self)) {
+        n++;
+    }
+    return MP_OBJ_NEW_SMALL_INT(n);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(kvlog_compact_obj, kvlog_compact_);
+
+STATIC mp_obj_t kvlog_stats(mp_obj_t self_in) {
+    mp_obj_kvlog_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t items[3] = {
+        mp_obj_new_int_from_uint(self->user_bytes),
+        mp_obj_new_int_from_uint(self->written_bytes),
+        mp_obj_new_int_from_uint(self->compactions),
+    };
+    return mp_obj_new_tuple(3, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(kvlog_stats_obj, kvlog_stats);
+
+STATIC mp_obj_t kvlog_it_iternext(mp_obj_t self_in) {
+    mp_obj_kvlog_it_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_map_t *map = &self->db->index;
+    for (; self->cur < map->alloc; ++self->cur) {
+        if (MP_MAP_SLOT_IS_FILLED(map, self->cur)
+            && !(MP_OBJ_SMALL_INT_VALUE(map->table[self->cur].value) & LOC_TOMBSTONE)) {
+            return map->table[self->cur++].key;
+        }
+    }
+    return MP_OBJ_STOP_ITERATION;
+}
+
+STATIC mp_obj_t kvlog_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
+    assert(sizeof(mp_obj_kvlog_it_t) <= sizeof(mp_obj_iter_buf_t));
+    mp_obj_kvlog_it_t *o = (mp_obj_kvlog_it_t*)iter_buf;
+    o->base.type = &mp_type_polymorph_iter;
+    o->iternext = kvlog_it_iternext;
+    o->db = MP_OBJ_TO_PTR(self_in);
+    o->cur = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_obj_t kvlog_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
+    mp_obj_kvlog_t *self = MP_OBJ_TO_PTR(self_in);
+    if (value == MP_OBJ_NULL) {
+        // delete
+        size_t klen;
+        mp_obj_t key = kvlog_key(index, &klen);
+        mp_map_elem_t *elem = mp_map_lookup(&self->index, key, MP_MAP_LOOKUP);
+        if (elem == NULL || (MP_OBJ_SMALL_INT_VALUE(elem->value) & LOC_TOMBSTONE)) {
+            nlr_raise(mp_obj_new_exception_arg1(&mp_type_KeyError, index));
+        }
+        const byte *kdata = (const byte*)mp_obj_str_get_data(key, &klen);
+        uint32_t loc = kvlog_append(self, kdata, klen, NULL, VLEN_TOMBSTONE);
+        kvlog_index_set(self, key, loc, REC_SIZE(klen, VLEN_TOMBSTONE), true);
+        self->user_bytes += klen;
+        return mp_const_none;
+    } else if (value == MP_OBJ_SENTINEL) {
+        // load
+        mp_obj_t val = kvlog_get_value(self, index);
+        if (val == MP_OBJ_NULL) {
+            nlr_raise(mp_obj_new_exception_arg1(&mp_type_KeyError, index));
+        }
+        return val;
+    } else {
+        // store
+        kvlog_put_value(self, index, value);
+        return mp_const_none;
+    }
+}
+
+STATIC mp_obj_t kvlog_unary_op(mp_uint_t op, mp_obj_t self_in) {
+    mp_obj_kvlog_t *self = MP_OBJ_TO_PTR(self_in);
+    switch (op) {
+        case MP_UNARY_OP_BOOL: return mp_obj_new_bool(self->len != 0);
+        case MP_UNARY_OP_LEN: return MP_OBJ_NEW_SMALL_INT(self->len);
+        default: return MP_OBJ_NULL; // op not supported
+    }
+}
+
+STATIC mp_obj_t kvlog_binary_op(mp_uint_t op, mp_obj_t lhs_in, mp_obj_t rhs_in) {
+    mp_obj_kvlog_t *self = MP_OBJ_TO_PTR(lhs_in);
+    switch (op) {
+        case MP_BINARY_OP_IN: {
+            size_t klen;
+            mp_obj_t key = kvlog_key(rhs_in, &klen);
+            mp_map_elem_t *elem = mp_map_lookup(&self->index, key, MP_MAP_LOOKUP);
+            return mp_obj_new_bool(elem != NULL && !(MP_OBJ_SMALL_INT_VALUE(elem->value) & LOC_TOMBSTONE));
+        }
+        default:
+            // op not supported
+            return MP_OBJ_NULL;
+    }
+}
+
+STATIC const mp_rom_map_elem_t kvlog_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&kvlog_flush_obj) },
+    { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&kvlog_flush_obj) },
+    { MP_ROM_QSTR(MP_QSTR_get), MP_ROM_PTR(&kvlog_get_obj) },
+    { MP_ROM_QSTR(MP_QSTR_put), MP_ROM_PTR(&kvlog_put_obj) },
+    { MP_ROM_QSTR(MP_QSTR_update), MP_ROM_PTR(&kvlog_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_compact), MP_ROM_PTR(&kvlog_compact_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&kvlog_stats_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(kvlog_locals_dict, kvlog_locals_dict_table);
+
+STATIC const mp_obj_type_t kvlog_type = {
+    { &mp_type_type },
+    // Save on qstr's, reuse same as for module
+    .name = MP_QSTR_kvlog,
+    .print = kvlog_print,
+    .unary_op = kvlog_unary_op,
+    .binary_op = kvlog_binary_op,
+    .subscr = kvlog_subscr,
+    .getiter = kvlog_getiter,
+    .locals_dict = (void*)&kvlog_locals_dict,
+};
+
+STATIC mp_obj_t mod_kvlog_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_segsize, ARG_segments };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_segsize, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 4096} },
+        { MP_QSTR_segments, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 16} },
+    };
+
+    // Make sure we got a stream object
+    mp_get_stream_raise(pos_args[0], MP_STREAM_OP_READ | MP_STREAM_OP_WRITE | MP_STREAM_OP_IOCTL);
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+    mp_int_t segsize = args[ARG_segsize].u_int;
+    mp_int_t nsegs = args[ARG_segments].u_int;
+    if (segsize < 256 || segsize > 0x10000 || (segsize & 3) != 0 || nsegs < 2 || nsegs > 0xffff) {
+        mp_raise_ValueError(NULL);
+    }
+
+    mp_obj_kvlog_t *o = m_new_obj(mp_obj_kvlog_t);
+    o->base.type = &kvlog_type;
+    o->stream = pos_args[0];
+    mp_map_init(&o->index, 0);
+    o->segs = m_new(kvlog_seg_t, nsegs);
+    o->buf = m_new(byte, segsize);
+    o->segsize = segsize;
+    o->nsegs = nsegs;
+    o->len = 0;
+    o->user_bytes = 0;
+    o->written_bytes = 0;
+    o->compactions = 0;
+    kvlog_recover(o);
+    o->written_bytes = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_kvlog_open_obj, 1, mod_kvlog_open);
+
+STATIC const mp_rom_map_elem_t mp_module_kvlog_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_kvlog) },
+    { MP_ROM_QSTR(MP_QSTR_open), MP_ROM_PTR(&mod_kvlog_open_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_kvlog_globals, mp_module_kvlog_globals_table);
+
+const mp_obj_module_t mp_module_kvlog = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_kvlog_globals,
+};
+
+#endif // MICROPY_PY_KVLOG
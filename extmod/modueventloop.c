@@ -0,0 +1,445 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Paul Sokolovsky
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/smallint.h"
+#include "py/stream.h"
+#include "py/mphal.h"
+#include "extmod/modutimeq.h"
+
+#if MICROPY_PY_UEVENTLOOP
+
+#if !MICROPY_PY_UTIMEQ
+#error "ueventloop requires MICROPY_PY_UTIMEQ"
+#endif
+
+// Event loop core for uasyncio-style libraries.  Callbacks and coroutines
+// that are ready to run are kept in a fixed-size ring buffer, timed ones in
+// a utimeq, and ones waiting for I/O in a map keyed by the id of the stream,
+// which is registered with a uselect.poll object.  Running a coroutine for
+// one step allocates nothing, unless it yields a syscall object to wait for
+// I/O.
+
+#define TICKS_PERIOD MICROPY_PY_UTIME_TICKS_PERIOD
+
+typedef struct _runq_entry_t {
+    mp_obj_t callback;
+    // arguments tuple for a callback, or MP_OBJ_NULL if callback is a
+    // coroutine to resume
+    mp_obj_t args;
+} runq_entry_t;
+
+typedef struct _mp_obj_eventloop_t {
+    mp_obj_base_t base;
+    mp_obj_t waitq;
+    mp_obj_t ipoll[2];
+    mp_obj_t register_[2];
+    mp_obj_t unregister[2];
+    mp_map_t io_map;
+    mp_obj_t cur_task;
+    mp_obj_t main_task;
+    mp_obj_t ret_val;
+    bool stopped;
+    uint16_t runq_alloc;
+    uint16_t runq_head;
+    uint16_t runq_len;
+    runq_entry_t runq[];
+} mp_obj_eventloop_t;
+
+// Objects yielded by a coroutine to ask the loop for a service
+typedef struct _mp_obj_syscall_t {
+    mp_obj_base_t base;
+    mp_obj_t arg;
+} mp_obj_syscall_t;
+
+STATIC const mp_obj_type_t ueventloop_ioread_type;
+STATIC const mp_obj_type_t ueventloop_iowrite_type;
+STATIC const mp_obj_type_t ueventloop_ioreaddone_type;
+STATIC const mp_obj_type_t ueventloop_iowritedone_type;
+STATIC const mp_obj_type_t ueventloop_stoploop_type;
+
+STATIC mp_obj_t syscall_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args);
+
+STATIC mp_uint_t loop_ticks(void) {
+    return mp_hal_ticks_ms() & (TICKS_PERIOD - 1);
+}
+
+STATIC mp_int_t loop_ticks_diff(mp_uint_t end, mp_uint_t start) {
+    return ((end - start + TICKS_PERIOD / 2) & (TICKS_PERIOD - 1)) - TICKS_PERIOD / 2;
+}
+
+STATIC void runq_push(mp_obj_eventloop_t *self, mp_obj_t callback, mp_obj_t args) {
+    if (self->runq_len == self->runq_alloc) {
+        mp_raise_msg(&mp_type_IndexError, "runq overflow");
+    }
+    size_t i = self->runq_head + self->runq_len;
+    if (i >= self->runq_alloc) {
+        i -= self->runq_alloc;
+    }
+    self->runq[i].callback = callback;
+    self->runq[i].args = args;
+    self->runq_len++;
+}
+
+STATIC runq_entry_t runq_pop(mp_obj_eventloop_t *self) {
+    runq_entry_t *e = &self->runq[self->runq_head];
+    runq_entry_t ret = *e;
+    // so we don't retain a pointer
+    e->callback = MP_OBJ_NULL;
+    e->args = MP_OBJ_NULL;
+    if (++self->runq_head == self->runq_alloc) {
+        self->runq_head = 0;
+    }
+    self->runq_len--;
+    return ret;
+}
+
+STATIC void loop_schedule(mp_obj_eventloop_t *self, mp_int_t delay, mp_obj_t callback, mp_obj_t args) {
+    if (delay <= 0) {
+        runq_push(self, callback, args);
+    } else {
+        mp_uint_t t = (loop_ticks() + delay) & (TICKS_PERIOD - 1);
+        mp_utimeq_push(self->waitq, t, callback, args);
+    }
+}
+
+// call a method that was looked up with mp_load_method
+STATIC void loop_call_poller(const mp_obj_t *meth, size_t n_args, mp_obj_t arg1, mp_obj_t arg2) {
+    mp_obj_t args[4] = {meth[0], meth[1], arg1, arg2};
+    mp_call_method_n_kw(n_args, 0, args);
+}
+
+STATIC void loop_wait_io(mp_obj_eventloop_t *self, mp_obj_t task, mp_obj_t obj, mp_uint_t events) {
+    mp_map_lookup(&self->io_map, mp_obj_id(obj), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = task;
+    loop_call_poller(self->register_, 2, obj, MP_OBJ_NEW_SMALL_INT(events));
+}
+
+STATIC void loop_done_io(mp_obj_eventloop_t *self, mp_obj_t obj) {
+    mp_map_lookup(&self->io_map, mp_obj_id(obj), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+    loop_call_poller(self->unregister, 1, obj, MP_OBJ_NULL);
+}
+
+// resume a coroutine once and act on the value it yields
+STATIC void loop_step(mp_obj_eventloop_t *self, mp_obj_t task) {
+    mp_obj_t ret;
+    self->cur_task = task;
+    mp_vm_return_kind_t kind = mp_resume(task, mp_const_none, MP_OBJ_NULL, &ret);
+    self->cur_task = mp_const_none;
+
+    if (kind == MP_VM_RETURN_NORMAL) {
+        if (task == self->main_task) {
+            self->ret_val = ret;
+            self->stopped = true;
+        }
+        return;
+    } else if (kind == MP_VM_RETURN_EXCEPTION) {
+        nlr_raise(ret);
+    }
+
+    if (ret == mp_const_none) {
+        // just reschedule
+        runq_push(self, task, MP_OBJ_NULL);
+    } else if (MP_OBJ_IS_SMALL_INT(ret)) {
+        // sleep for the given number of milliseconds
+        loop_schedule(self, MP_OBJ_SMALL_INT_VALUE(ret), task, MP_OBJ_NULL);
+    } else if (ret == mp_const_false) {
+        // don't reschedule, something else will
+    } else if (MP_OBJ_IS_TYPE(ret, &mp_type_gen_instance)) {
+        // start a new coroutine and continue this one
+        runq_push(self, ret, MP_OBJ_NULL);
+        runq_push(self, task, MP_OBJ_NULL);
+    } else {
+        const mp_obj_type_t *type = mp_obj_get_type(ret);
+        if (type->make_new != syscall_make_new) {
+            mp_raise_TypeError("unsupported coroutine yield value");
+        }
+        mp_obj_t arg = ((mp_obj_syscall_t*)MP_OBJ_TO_PTR(ret))->arg;
+        if (type == &ueventloop_ioread_type) {
+            loop_wait_io(self, task, arg, MP_STREAM_POLL_RD);
+        } else if (type == &ueventloop_iowrite_type) {
+            loop_wait_io(self, task, arg, MP_STREAM_POLL_WR);
+        } else if (type == &ueventloop_ioreaddone_type || type == &ueventloop_iowritedone_type) {
+            loop_done_io(self, arg);
+            runq_push(self, task, MP_OBJ_NULL);
+        } else {
+            // StopLoop
+            self->ret_val = arg;
+            self->stopped = true;
+        }
+    }
+}
+
+// wait for I/O or until the given timeout, -1 meaning forever
+STATIC void loop_wait(mp_obj_eventloop_t *self, mp_int_t timeout) {
+    if (self->io_map.used == 0) {
+        if (timeout > 0) {
+            mp_hal_delay_ms(timeout);
+        }
+        return;
+    }
+
+    // use the poller in oneshot mode, so an object is only polled again
+    // once a coroutine waits on it again
+    mp_obj_t args[4] = {self->ipoll[0], self->ipoll[1], MP_OBJ_NEW_SMALL_INT(timeout), MP_OBJ_NEW_SMALL_INT(1)};
+    mp_obj_t iter = mp_call_method_n_kw(2, 0, args);
+    mp_obj_t item;
+    while ((item = mp_iternext(iter)) != MP_OBJ_STOP_ITERATION) {
+        mp_obj_t *ev;
+        mp_obj_get_array_fixed_n(item, 2, &ev);
+        mp_map_elem_t *elem = mp_map_lookup(&self->io_map, mp_obj_id(ev[0]), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+        if (elem != NULL) {
+            runq_push(self, elem->value, MP_OBJ_NULL);
+        }
+    }
+}
+
+STATIC mp_obj_t loop_run(mp_obj_eventloop_t *self) {
+    self->stopped = false;
+    self->ret_val = mp_const_none;
+    for (;;) {
+        // move expired timers to the run queue
+        mp_uint_t now = loop_ticks();
+        mp_uint_t t;
+        while (mp_utimeq_peektime(self->waitq, &t) && loop_ticks_diff(t, now) <= 0) {
+            mp_obj_t callback, args;
+            mp_utimeq_pop(self->waitq, &callback, &args);
+            runq_push(self, callback, args);
+        }
+
+        // run everything that is ready now, but not what gets scheduled
+        // while doing so
+        for (size_t n = self->runq_len; n > 0; --n) {
+            runq_entry_t e = runq_pop(self);
+            if (e.args == MP_OBJ_NULL) {
+                loop_step(self, e.callback);
+            } else {
+                size_t n_args;
+                mp_obj_t *args;
+                mp_obj_get_array(e.args, &n_args, &args);
+                mp_call_function_n_kw(e.callback, n_args, 0, args);
+            }
+            if (self->stopped) {
+                return self->ret_val;
+            }
+        }
+
+        mp_int_t timeout = 0;
+        if (self->runq_len == 0) {
+            if (mp_utimeq_peektime(self->waitq, &t)) {
+                timeout = loop_ticks_diff(t, loop_ticks());
+                if (timeout < 0) {
+                    timeout = 0;
+                }
+            } else if (self->io_map.used == 0) {
+                // nothing is left that could ever run
+                return mp_const_none;
+            } else {
+                timeout = -1;
+            }
+        }
+        loop_wait(self, timeout);
+    }
+}
+
+STATIC mp_obj_t eventloop_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 0, 2, false);
+    mp_int_t runq_len = n_args > 0 ? mp_obj_get_int(args[0]) : 16;
+    mp_int_t waitq_len = n_args > 1 ? mp_obj_get_int(args[1]) : 16;
+    if (runq_len <= 0 || runq_len > 0xffff || waitq_len <= 0) {
+        mp_raise_ValueError(NULL);
+    }
+
+    mp_obj_eventloop_t *o = m_new_obj_var(mp_obj_eventloop_t, runq_entry_t, runq_len);
+    o->base.type = type;
+    o->waitq = mp_utimeq_new(waitq_len);
+    mp_map_init(&o->io_map, 0);
+    o->cur_task = mp_const_none;
+    o->main_task = MP_OBJ_NULL;
+    o->ret_val = mp_const_none;
+    o->stopped = false;
+    o->runq_alloc = runq_len;
+    o->runq_head = 0;
+    o->runq_len = 0;
+    memset(o->runq, 0, runq_len * sizeof(runq_entry_t));
+
+    // the poller comes from whichever uselect module the port provides
+    mp_obj_t uselect = mp_import_name(MP_QSTR_uselect, mp_const_none, MP_OBJ_NEW_SMALL_INT(0));
+    mp_obj_t poller = mp_call_function_0(mp_load_attr(uselect, MP_QSTR_poll));
+    mp_load_method(poller, MP_QSTR_ipoll, o->ipoll);
+    mp_load_method(poller, MP_QSTR_register, o->register_);
+    mp_load_method(poller, MP_QSTR_unregister, o->unregister);
+
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_obj_t eventloop_time(mp_obj_t self_in) {
+    (void)self_in;
+    return MP_OBJ_NEW_SMALL_INT(loop_ticks());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(eventloop_time_obj, eventloop_time);
+
+// a coroutine given without arguments is resumed, anything else is called
+STATIC mp_obj_t loop_make_args(mp_obj_t callback, size_t n_args, const mp_obj_t *args) {
+    if (n_args == 0 && MP_OBJ_IS_TYPE(callback, &mp_type_gen_instance)) {
+        return MP_OBJ_NULL;
+    }
+    return mp_obj_new_tuple(n_args, args);
+}
+
+STATIC mp_obj_t eventloop_call_soon(size_t n_args, const mp_obj_t *args) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(args[0]);
+    runq_push(self, args[1], loop_make_args(args[1], n_args - 2, args + 2));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR(eventloop_call_soon_obj, 2, eventloop_call_soon);
+
+STATIC mp_obj_t eventloop_call_later_ms(size_t n_args, const mp_obj_t *args) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(args[0]);
+    loop_schedule(self, mp_obj_get_int(args[1]), args[2], loop_make_args(args[2], n_args - 3, args + 3));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR(eventloop_call_later_ms_obj, 3, eventloop_call_later_ms);
+
+STATIC mp_obj_t eventloop_call_at_(size_t n_args, const mp_obj_t *args) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(args[0]);
+    size_t cb_n_args = 0;
+    mp_obj_t *cb_args = NULL;
+    if (n_args > 3) {
+        mp_obj_get_array(args[3], &cb_n_args, &cb_args);
+    }
+    mp_utimeq_push(self->waitq, mp_obj_get_int(args[1]) & (TICKS_PERIOD - 1),
+        args[2], loop_make_args(args[2], cb_n_args, cb_args));
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(eventloop_call_at__obj, 3, 4, eventloop_call_at_);
+
+STATIC mp_obj_t eventloop_create_task(mp_obj_t self_in, mp_obj_t coro) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(self_in);
+    runq_push(self, coro, MP_OBJ_NULL);
+    return coro;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(eventloop_create_task_obj, eventloop_create_task);
+
+STATIC mp_obj_t eventloop_run_forever(mp_obj_t self_in) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(self_in);
+    self->main_task = MP_OBJ_NULL;
+    return loop_run(self);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(eventloop_run_forever_obj, eventloop_run_forever);
+
+STATIC mp_obj_t eventloop_run_until_complete(mp_obj_t self_in, mp_obj_t coro) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(self_in);
+    runq_push(self, coro, MP_OBJ_NULL);
+    self->main_task = coro;
+    mp_obj_t ret = loop_run(self);
+    self->main_task = MP_OBJ_NULL;
+    return ret;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(eventloop_run_until_complete_obj, eventloop_run_until_complete);
+
+STATIC mp_obj_t eventloop_stop(mp_obj_t self_in) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(self_in);
+    self->stopped = true;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(eventloop_stop_obj, eventloop_stop);
+
+STATIC mp_obj_t eventloop_cur_task(mp_obj_t self_in) {
+    mp_obj_eventloop_t *self = MP_OBJ_TO_PTR(self_in);
+    return self->cur_task;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(eventloop_cur_task_obj, eventloop_cur_task);
+
+STATIC const mp_rom_map_elem_t eventloop_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_time), MP_ROM_PTR(&eventloop_time_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call_soon), MP_ROM_PTR(&eventloop_call_soon_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call_later_ms), MP_ROM_PTR(&eventloop_call_later_ms_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call_at_), MP_ROM_PTR(&eventloop_call_at__obj) },
+    { MP_ROM_QSTR(MP_QSTR_create_task), MP_ROM_PTR(&eventloop_create_task_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run_forever), MP_ROM_PTR(&eventloop_run_forever_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run_until_complete), MP_ROM_PTR(&eventloop_run_until_complete_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&eventloop_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cur_task), MP_ROM_PTR(&eventloop_cur_task_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(eventloop_locals_dict, eventloop_locals_dict_table);
+
+STATIC const mp_obj_type_t ueventloop_eventloop_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_EventLoop,
+    .make_new = eventloop_make_new,
+    .locals_dict = (void*)&eventloop_locals_dict,
+};
+
+STATIC mp_obj_t syscall_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    // only StopLoop has a default argument
+    mp_arg_check_num(n_args, n_kw, type == &ueventloop_stoploop_type ? 0 : 1, 1, false);
+    mp_obj_syscall_t *o = m_new_obj(mp_obj_syscall_t);
+    o->base.type = type;
+    o->arg = n_args > 0 ? args[0] : mp_const_none;
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC void syscall_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (attr == MP_QSTR_arg && dest[0] == MP_OBJ_NULL) {
+        mp_obj_syscall_t *self = MP_OBJ_TO_PTR(self_in);
+        dest[0] = self->arg;
+    }
+}
+
+#define SYSCALL_TYPE(type_name, name_qstr) \
+    STATIC const mp_obj_type_t type_name = { \
+        { &mp_type_type }, \
+        .name = name_qstr, \
+        .make_new = syscall_make_new, \
+        .attr = syscall_attr, \
+    }
+
+SYSCALL_TYPE(ueventloop_ioread_type, MP_QSTR_IORead);
+SYSCALL_TYPE(ueventloop_iowrite_type, MP_QSTR_IOWrite);
+SYSCALL_TYPE(ueventloop_ioreaddone_type, MP_QSTR_IOReadDone);
+SYSCALL_TYPE(ueventloop_iowritedone_type, MP_QSTR_IOWriteDone);
+SYSCALL_TYPE(ueventloop_stoploop_type, MP_QSTR_StopLoop);
+
+STATIC const mp_rom_map_elem_t mp_module_ueventloop_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ueventloop) },
+    { MP_ROM_QSTR(MP_QSTR_EventLoop), MP_ROM_PTR(&ueventloop_eventloop_type) },
+    { MP_ROM_QSTR(MP_QSTR_IORead), MP_ROM_PTR(&ueventloop_ioread_type) },
+    { MP_ROM_QSTR(MP_QSTR_IOWrite), MP_ROM_PTR(&ueventloop_iowrite_type) },
+    { MP_ROM_QSTR(MP_QSTR_IOReadDone), MP_ROM_PTR(&ueventloop_ioreaddone_type) },
+    { MP_ROM_QSTR(MP_QSTR_IOWriteDone), MP_ROM_PTR(&ueventloop_iowritedone_type) },
+    { MP_ROM_QSTR(MP_QSTR_StopLoop), MP_ROM_PTR(&ueventloop_stoploop_type) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_ueventloop_globals, mp_module_ueventloop_globals_table);
+
+const mp_obj_module_t mp_module_ueventloop = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_ueventloop_globals,
+};
+
+#endif // MICROPY_PY_UEVENTLOOP
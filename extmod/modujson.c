@@ -25,24 +25,101 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "py/nlr.h"
 #include "py/objlist.h"
-#include "py/objstringio.h"
 #include "py/parsenum.h"
 #include "py/runtime.h"
 #include "py/stream.h"
 
 #if MICROPY_PY_UJSON
 
-STATIC mp_obj_t mod_ujson_dumps(mp_obj_t obj) {
+// dump() writes through a small buffer, so the JSON text of the object is
+// never held in memory as a whole
+#define UJSON_DUMP_BUF_SIZE (128)
+
+typedef struct _ujson_dump_stream_t {
+    mp_obj_t stream_obj;
+    size_t len;
+    char buf[UJSON_DUMP_BUF_SIZE];
+} ujson_dump_stream_t;
+
+STATIC void ujson_dump_stream_flush(ujson_dump_stream_t *ds) {
+    if (ds->len > 0) {
+        mp_stream_write_adaptor(ds->stream_obj, ds->buf, ds->len);
+        ds->len = 0;
+    }
+}
+
+STATIC void ujson_dump_stream_strn(void *data, const char *str, size_t len) {
+    ujson_dump_stream_t *ds = data;
+    if (ds->len + len > UJSON_DUMP_BUF_SIZE) {
+        ujson_dump_stream_flush(ds);
+        if (len > UJSON_DUMP_BUF_SIZE) {
+            mp_stream_write_adaptor(ds->stream_obj, str, len);
+            return;
+        }
+    }
+    memcpy(ds->buf + ds->len, str, len);
+    ds->len += len;
+}
+
+#if MICROPY_PY_UJSON_SEPARATORS
+typedef mp_print_ext_t ujson_print_t;
+#define UJSON_PRINT_BASE(p) (&(p)->base)
+#else
+typedef mp_print_t ujson_print_t;
+#define UJSON_PRINT_BASE(p) (p)
+#endif
+
+// prints the object given by the first positional arg, using the separators
+// given by the keyword args
+STATIC void ujson_dump_helper(size_t n_args, size_t n_pos, const mp_obj_t *args, mp_map_t *kw_args, ujson_print_t *print) {
+    #if MICROPY_PY_UJSON_SEPARATORS
+    enum { ARG_separators };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_separators, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
+    };
+    mp_arg_val_t vals[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - n_pos, args + n_pos, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, vals);
+    if (vals[ARG_separators].u_obj == mp_const_none) {
+        print->item_separator = ", ";
+        print->key_separator = ": ";
+    } else {
+        mp_obj_t *items;
+        mp_obj_get_array_fixed_n(vals[ARG_separators].u_obj, 2, &items);
+        print->item_separator = mp_obj_str_get_str(items[0]);
+        print->key_separator = mp_obj_str_get_str(items[1]);
+    }
+    #else
+    mp_arg_check_num(n_args, kw_args->used, n_pos, n_pos, false);
+    #endif
+    mp_obj_print_helper(UJSON_PRINT_BASE(print), args[0], PRINT_JSON);
+}
+
+STATIC mp_obj_t mod_ujson_dump(size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    mp_get_stream_raise(args[1], MP_STREAM_OP_WRITE);
+    ujson_dump_stream_t ds;
+    ds.stream_obj = args[1];
+    ds.len = 0;
+    ujson_print_t print;
+    UJSON_PRINT_BASE(&print)->data = &ds;
+    UJSON_PRINT_BASE(&print)->print_strn = ujson_dump_stream_strn;
+    ujson_dump_helper(n_args, 2, args, kw_args, &print);
+    ujson_dump_stream_flush(&ds);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_ujson_dump_obj, 2, mod_ujson_dump);
+
+STATIC mp_obj_t mod_ujson_dumps(size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
     vstr_t vstr;
-    mp_print_t print;
-    vstr_init_print(&vstr, 8, &print);
-    mp_obj_print_helper(&print, obj, PRINT_JSON);
+    ujson_print_t print;
+    vstr_init_print(&vstr, 8, UJSON_PRINT_BASE(&print));
+    ujson_dump_helper(n_args, 1, args, kw_args, &print);
     return mp_obj_new_str_from_vstr(&mp_type_str, &vstr);
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_dumps_obj, mod_ujson_dumps);
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_ujson_dumps_obj, 1, mod_ujson_dumps);
 
 // The function below implements a simple non-recursive JSON parser.
 //
@@ -57,32 +134,71 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_dumps_obj, mod_ujson_dumps);
 // strings).  It does 1 pass over the input stream.  It tries to be fast and
 // small in code size, while not using more RAM than necessary.
 
+// Input is read ahead into a buffer, so the stream's read method is called
+// once per UJSON_STREAM_BUF_SIZE bytes rather than once per byte.  For loads()
+// the "buffer" is the string itself and there is no stream to refill from.
+
+#define UJSON_STREAM_BUF_SIZE (256)
+
 typedef struct _ujson_stream_t {
     mp_obj_t stream_obj;
     mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode);
-    int errcode;
-    byte cur;
+    byte *buf; // read-ahead buffer, or NULL if reading from memory
+    const byte *cur; // next byte of input
+    const byte *end; // end of data available in the buffer
 } ujson_stream_t;
 
 #define S_EOF (0) // null is not allowed in json stream so is ok as EOF marker
-#define S_END(s) ((s).cur == S_EOF)
-#define S_CUR(s) ((s).cur)
-#define S_NEXT(s) (ujson_stream_next(&(s)))
-
-STATIC byte ujson_stream_next(ujson_stream_t *s) {
-    mp_uint_t ret = s->read(s->stream_obj, &s->cur, 1, &s->errcode);
-    if (s->errcode != 0) {
-        mp_raise_OSError(s->errcode);
+#define S_END(s) (S_CUR(s) == S_EOF)
+#define S_CUR(s) ((s).cur < (s).end ? *(s).cur : S_EOF)
+#define S_NEXT(s) (++(s).cur < (s).end ? *(s).cur : ujson_stream_fill(&(s)))
+
+// refill the buffer once all of it has been consumed, returns the next byte
+STATIC byte ujson_stream_fill(ujson_stream_t *s) {
+    if (s->buf == NULL) {
+        s->cur = s->end;
+        return S_EOF;
     }
-    if (ret == 0) {
-        s->cur = S_EOF;
+    int errcode;
+    mp_uint_t ret = s->read(s->stream_obj, s->buf, UJSON_STREAM_BUF_SIZE, &errcode);
+    if (ret == MP_STREAM_ERROR) {
+        mp_raise_OSError(errcode);
     }
-    return s->cur;
+    s->cur = s->buf;
+    s->end = s->buf + ret;
+    return S_CUR(*s);
 }
 
-STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
-    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
-    ujson_stream_t s = {stream_obj, stream_p->read, 0, 0};
+STATIC NORETURN void ujson_raise_syntax_error(void) {
+    nlr_raise(mp_obj_new_exception_msg(&mp_type_ValueError, "syntax error in JSON"));
+}
+
+// returns the end of the run of bytes at the current position that can be
+// copied as they are into a string
+static inline const byte *ujson_scan_str(const byte *p, const byte *end) {
+    while (p < end && *p != '"' && *p != '\\' && *p != S_EOF) {
+        ++p;
+    }
+    return p;
+}
+
+// returns the end of the run of bytes at the current position that can be
+// part of a number
+static inline const byte *ujson_scan_num(const byte *p, const byte *end, bool *flt) {
+    for (; p < end; ++p) {
+        byte c = *p;
+        if (c == '.' || c == 'E' || c == 'e') {
+            *flt = true;
+        } else if (!(c == '-' || unichar_isdigit(c))) {
+            break;
+        }
+    }
+    return p;
+}
+
+// parses one value from the stream, leaving it positioned just after the value
+STATIC mp_obj_t ujson_parse_value(ujson_stream_t *s_in) {
+    ujson_stream_t s = *s_in;
     vstr_t vstr;
     vstr_init(&vstr, 8);
     mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
@@ -91,7 +207,9 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
     mp_obj_t stack_top = MP_OBJ_NULL;
     mp_obj_type_t *stack_top_type = NULL;
     mp_obj_t stack_key = MP_OBJ_NULL;
-    S_NEXT(s);
+    if (s.cur == s.end) {
+        ujson_stream_fill(&s);
+    }
     for (;;) {
         cont:
         if (S_END(s)) {
@@ -135,28 +253,46 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                 break;
             case '"':
                 vstr_reset(&vstr);
-                for (; !S_END(s) && S_CUR(s) != '"';) {
-                    byte c = S_CUR(s);
-                    if (c == '\\') {
-                        c = S_NEXT(s);
-                        switch (c) {
-                            case 'b': c = 0x08; break;
-                            case 'f': c = 0x0c; break;
-                            case 'n': c = 0x0a; break;
-                            case 'r': c = 0x0d; break;
-                            case 't': c = 0x09; break;
-                            case 'u': {
-                                mp_uint_t num = 0;
-                                for (int i = 0; i < 4; i++) {
-                                    c = (S_NEXT(s) | 0x20) - '0';
-                                    if (c > 9) {
-                                        c -= ('a' - ('9' + 1));
-                                    }
-                                    num = (num << 4) | c;
+                for (;;) {
+                    // take a run of plain characters in one go
+                    const byte *run_end = ujson_scan_str(s.cur, s.end);
+                    if (run_end < s.end && *run_end == '"' && vstr.len == 0) {
+                        // whole string is in the buffer, no need to copy it
+                        next = mp_obj_new_str((const char*)s.cur, run_end - s.cur, false);
+                        s.cur = run_end;
+                        break;
+                    }
+                    vstr_add_strn(&vstr, (const char*)s.cur, run_end - s.cur);
+                    s.cur = run_end;
+                    if (s.cur == s.end) {
+                        if (ujson_stream_fill(&s) == S_EOF) {
+                            break;
+                        }
+                        continue;
+                    }
+                    byte c = *s.cur;
+                    if (c == '"' || c == S_EOF) {
+                        break;
+                    }
+                    // an escape sequence
+                    c = S_NEXT(s);
+                    switch (c) {
+                        case 'b': c = 0x08; break;
+                        case 'f': c = 0x0c; break;
+                        case 'n': c = 0x0a; break;
+                        case 'r': c = 0x0d; break;
+                        case 't': c = 0x09; break;
+                        case 'u': {
+                            mp_uint_t num = 0;
+                            for (int i = 0; i < 4; i++) {
+                                c = (S_NEXT(s) | 0x20) - '0';
+                                if (c > 9) {
+                                    c -= ('a' - ('9' + 1));
                                 }
-                                vstr_add_char(&vstr, num);
-                                goto str_cont;
+                                num = (num << 4) | c;
                             }
+                            vstr_add_char(&vstr, num);
+                            goto str_cont;
                         }
                     }
                     vstr_add_byte(&vstr, c);
@@ -167,23 +303,22 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                     goto fail;
                 }
                 S_NEXT(s);
-                next = mp_obj_new_str(vstr.buf, vstr.len, false);
+                if (next == MP_OBJ_NULL) {
+                    next = mp_obj_new_str(vstr.buf, vstr.len, false);
+                }
                 break;
             case '-':
             case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': {
                 bool flt = false;
                 vstr_reset(&vstr);
+                vstr_add_byte(&vstr, cur);
                 for (;;) {
-                    vstr_add_byte(&vstr, cur);
-                    cur = S_CUR(s);
-                    if (cur == '.' || cur == 'E' || cur == 'e') {
-                        flt = true;
-                    } else if (cur == '-' || unichar_isdigit(cur)) {
-                        // pass
-                    } else {
+                    const byte *run_end = ujson_scan_num(s.cur, s.end, &flt);
+                    vstr_add_strn(&vstr, (const char*)s.cur, run_end - s.cur);
+                    s.cur = run_end;
+                    if (s.cur < s.end || ujson_stream_fill(&s) == S_EOF) {
                         break;
                     }
-                    S_NEXT(s);
                 }
                 if (flt) {
                     next = mp_parse_num_decimal(vstr.buf, vstr.len, false, false, NULL);
@@ -253,40 +388,135 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
         }
     }
     success:
-    // eat trailing whitespace
-    while (unichar_isspace(S_CUR(s))) {
-        S_NEXT(s);
-    }
-    if (!S_END(s)) {
-        // unexpected chars
-        goto fail;
-    }
     if (stack_top == MP_OBJ_NULL || stack.len != 0) {
         // not exactly 1 object
         goto fail;
     }
     vstr_clear(&vstr);
+    *s_in = s;
     return stack_top;
 
     fail:
-    nlr_raise(mp_obj_new_exception_msg(&mp_type_ValueError, "syntax error in JSON"));
+    ujson_raise_syntax_error();
+}
+
+STATIC mp_obj_t ujson_load(ujson_stream_t *s) {
+    mp_obj_t obj = ujson_parse_value(s);
+    // eat trailing whitespace
+    while (unichar_isspace(S_CUR(*s))) {
+        S_NEXT(*s);
+    }
+    if (!S_END(*s)) {
+        // unexpected chars
+        ujson_raise_syntax_error();
+    }
+    return obj;
+}
+
+STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
+    byte buf[UJSON_STREAM_BUF_SIZE];
+    ujson_stream_t s = {stream_obj, stream_p->read, buf, buf, buf};
+    return ujson_load(&s);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_load_obj, mod_ujson_load);
 
 STATIC mp_obj_t mod_ujson_loads(mp_obj_t obj) {
     size_t len;
     const char *buf = mp_obj_str_get_data(obj, &len);
-    vstr_t vstr = {len, len, (char*)buf, true};
-    mp_obj_stringio_t sio = {{&mp_type_stringio}, &vstr, 0, MP_OBJ_NULL};
-    return mod_ujson_load(MP_OBJ_FROM_PTR(&sio));
+    ujson_stream_t s = {MP_OBJ_NULL, NULL, NULL, (const byte*)buf, (const byte*)buf + len};
+    return ujson_load(&s);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_loads_obj, mod_ujson_loads);
 
+// iterload(stream) yields the elements of a top-level array one at a time, so
+// only one element needs to be in memory at once; any other top-level value is
+// yielded as a whole
+
+enum {
+    UJSON_ITERLOAD_START,
+    UJSON_ITERLOAD_ARRAY,
+    UJSON_ITERLOAD_DONE,
+};
+
+typedef struct _mp_obj_ujson_iterload_t {
+    mp_obj_base_t base;
+    byte state;
+    ujson_stream_t s;
+    byte buf[UJSON_STREAM_BUF_SIZE];
+} mp_obj_ujson_iterload_t;
+
+// skips whitespace and, like the parser, commas and colons
+STATIC byte ujson_skip_space(ujson_stream_t *s) {
+    for (;;) {
+        byte c = S_CUR(*s);
+        if (!(unichar_isspace(c) || c == ',' || c == ':')) {
+            return c;
+        }
+        S_NEXT(*s);
+    }
+}
+
+STATIC mp_obj_t ujson_iterload_iternext(mp_obj_t self_in) {
+    mp_obj_ujson_iterload_t *self = MP_OBJ_TO_PTR(self_in);
+    ujson_stream_t *s = &self->s;
+    if (self->state == UJSON_ITERLOAD_START) {
+        ujson_stream_fill(s);
+        if (ujson_skip_space(s) == '[') {
+            S_NEXT(*s);
+            self->state = UJSON_ITERLOAD_ARRAY;
+        } else {
+            self->state = UJSON_ITERLOAD_DONE;
+            return ujson_load(s);
+        }
+    } else if (self->state == UJSON_ITERLOAD_DONE) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    byte c = ujson_skip_space(s);
+    if (c == ']') {
+        S_NEXT(*s);
+        self->state = UJSON_ITERLOAD_DONE;
+        while (unichar_isspace(S_CUR(*s))) {
+            S_NEXT(*s);
+        }
+        if (!S_END(*s)) {
+            ujson_raise_syntax_error();
+        }
+        return MP_OBJ_STOP_ITERATION;
+    } else if (c == S_EOF) {
+        ujson_raise_syntax_error();
+    }
+    return ujson_parse_value(s);
+}
+
+STATIC const mp_obj_type_t ujson_iterload_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_iterator,
+    .getiter = mp_identity_getiter,
+    .iternext = ujson_iterload_iternext,
+};
+
+STATIC mp_obj_t mod_ujson_iterload(mp_obj_t stream_obj) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
+    mp_obj_ujson_iterload_t *o = m_new_obj(mp_obj_ujson_iterload_t);
+    o->base.type = &ujson_iterload_type;
+    o->state = UJSON_ITERLOAD_START;
+    o->s.stream_obj = stream_obj;
+    o->s.read = stream_p->read;
+    o->s.buf = o->buf;
+    o->s.cur = o->buf;
+    o->s.end = o->buf;
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_iterload_obj, mod_ujson_iterload);
+
 STATIC const mp_rom_map_elem_t mp_module_ujson_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ujson) },
+    { MP_ROM_QSTR(MP_QSTR_dump), MP_ROM_PTR(&mod_ujson_dump_obj) },
     { MP_ROM_QSTR(MP_QSTR_dumps), MP_ROM_PTR(&mod_ujson_dumps_obj) },
     { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&mod_ujson_load_obj) },
     { MP_ROM_QSTR(MP_QSTR_loads), MP_ROM_PTR(&mod_ujson_loads_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iterload), MP_ROM_PTR(&mod_ujson_iterload_obj) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_ujson_globals, mp_module_ujson_globals_table);
@@ -27,11 +27,14 @@
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <limits.h>
 
 #include "py/nlr.h"
 #include "py/runtime.h"
 #include "py/binary.h"
 #include "py/objstr.h"
+#include "py/mpstate.h"
+#include "py/runtime0.h"
 
 #if MICROPY_PY_URE
 
@@ -41,6 +44,13 @@
 
 typedef struct _mp_obj_re_t {
     mp_obj_base_t base;
+    #if MICROPY_PY_URE_CACHE
+    mp_obj_t pattern;
+    #endif
+    // bytes that an anchored match can start with, see re_next_start()
+    bool any_start;
+    bool single_start;
+    unsigned char start_set[32];
     ByteProg re;
 } mp_obj_re_t;
 
@@ -75,8 +85,84 @@ STATIC mp_obj_t match_group(mp_obj_t self_in, mp_obj_t no_in) {
 }
 MP_DEFINE_CONST_FUN_OBJ_2(match_group_obj, match_group);
 
+#if MICROPY_PY_URE_MATCH_SPAN
+STATIC mp_obj_t match_groups(mp_obj_t self_in) {
+    mp_obj_match_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->num_matches <= 1) {
+        return mp_const_empty_tuple;
+    }
+    mp_obj_tuple_t *groups = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->num_matches - 1, NULL));
+    for (int i = 1; i < self->num_matches; ++i) {
+        groups->items[i - 1] = match_group(self_in, MP_OBJ_NEW_SMALL_INT(i));
+    }
+    return MP_OBJ_FROM_PTR(groups);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(match_groups_obj, match_groups);
+
+// store the start and end offsets of a group in span[0] and span[1]
+STATIC void match_span_helper(size_t n_args, const mp_obj_t *args, mp_obj_t span[2]) {
+    mp_obj_match_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    mp_int_t no = 0;
+    if (n_args == 2) {
+        no = mp_obj_get_int(args[1]);
+        if (no < 0 || no >= self->num_matches) {
+            nlr_raise(mp_obj_new_exception_arg1(&mp_type_IndexError, args[1]));
+        }
+    }
+
+    const char *start = self->caps[no * 2];
+    if (start == NULL) {
+        // no match for this group
+        span[0] = span[1] = MP_OBJ_NEW_SMALL_INT(-1);
+        return;
+    }
+
+    size_t len;
+    const char *begin = mp_obj_str_get_data(self->str, &len);
+    mp_int_t s = start - begin;
+    mp_int_t e = self->caps[no * 2 + 1] - begin;
+    #if MICROPY_PY_BUILTINS_STR_UNICODE
+    if (MP_OBJ_IS_STR(self->str)) {
+        // offsets are in characters
+        s = unichar_charlen(begin, s);
+        e = s + unichar_charlen(start, e - (start - begin));
+    }
+    #endif
+    span[0] = mp_obj_new_int(s);
+    span[1] = mp_obj_new_int(e);
+}
+
+STATIC mp_obj_t match_span(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t span[2];
+    match_span_helper(n_args, args, span);
+    return mp_obj_new_tuple(2, span);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(match_span_obj, 1, 2, match_span);
+
+STATIC mp_obj_t match_start(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t span[2];
+    match_span_helper(n_args, args, span);
+    return span[0];
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(match_start_obj, 1, 2, match_start);
+
+STATIC mp_obj_t match_end(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t span[2];
+    match_span_helper(n_args, args, span);
+    return span[1];
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(match_end_obj, 1, 2, match_end);
+#endif
+
 STATIC const mp_rom_map_elem_t match_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_group), MP_ROM_PTR(&match_group_obj) },
+    #if MICROPY_PY_URE_MATCH_SPAN
+    { MP_ROM_QSTR(MP_QSTR_groups), MP_ROM_PTR(&match_groups_obj) },
+    { MP_ROM_QSTR(MP_QSTR_span), MP_ROM_PTR(&match_span_obj) },
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&match_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_end), MP_ROM_PTR(&match_end_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(match_locals_dict, match_locals_dict_table);
@@ -88,33 +174,93 @@ STATIC const mp_obj_type_t match_type = {
     .locals_dict = (void*)&match_locals_dict,
 };
 
+STATIC mp_obj_t match_new(mp_obj_t str, const char **caps, int caps_num) {
+    mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, char*, caps_num);
+    match->base.type = &match_type;
+    match->num_matches = caps_num / 2; // caps_num counts start and end pointers
+    match->str = str;
+    // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
+    memcpy((char*)match->caps, caps, caps_num * sizeof(char*));
+    return MP_OBJ_FROM_PTR(match);
+}
+
 STATIC void re_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     (void)kind;
     mp_obj_re_t *self = MP_OBJ_TO_PTR(self_in);
     mp_printf(print, "<re %p>", self);
 }
 
+// Return the first position at or after sp where a match may start, or
+// NULL if there is none.
+STATIC const char *re_next_start(mp_obj_re_t *self, const char *sp, const char *end) {
+    if (self->single_start) {
+        return memchr(sp, self->start_set[0], end - sp);
+    }
+    for (; sp < end; ++sp) {
+        byte c = *sp;
+        if (self->start_set[c >> 3] & (1 << (c & 7))) {
+            return sp;
+        }
+    }
+    return NULL;
+}
+
+// Find the leftmost match starting at or after sp (or only at sp if it's
+// anchored) and store its captures in caps.  A match is tried with simple
+// backtracking at each position where one may start.  If that needs too
+// much stack or many more steps than the Pike VM would, then the Pike VM is
+// used for the rest of the input, which takes linear time.
+STATIC int re_exec_at(mp_obj_re_t *self, Subject *subj, const char *sp, const char **caps, int caps_num, bool is_anchored) {
+    ByteProg *prog = &self->re;
+    mp_uint_t steps = (mp_uint_t)(subj->end - sp + 1) * prog->len * 4;
+    int budget = steps > INT_MAX ? INT_MAX : steps;
+    int res;
+    for (;;) {
+        // the start of the input is always tried, for ^
+        if (!is_anchored && !self->any_start && sp != subj->begin) {
+            sp = re_next_start(self, sp, subj->end);
+            if (sp == NULL) {
+                return 0;
+            }
+        }
+        // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
+        memset((char**)caps, 0, caps_num * sizeof(char*));
+        res = re1_5_recursiveloopprog(prog, subj, sp, caps, caps_num, true, &budget);
+        if (res != 0 || is_anchored || sp == subj->end) {
+            break;
+        }
+        sp++;
+    }
+    if (res >= 0) {
+        return res;
+    }
+
+    memset((char**)caps, 0, caps_num * sizeof(char*));
+    size_t mem_size = re1_5_pikevm_memsize(prog, caps_num);
+    void *mem = m_new(byte, mem_size);
+    res = re1_5_pikevm(prog, subj, sp, caps, caps_num, is_anchored, mem);
+    m_del(byte, mem, mem_size);
+    return res;
+}
+
+STATIC void re_subject(Subject *subj, mp_obj_t str) {
+    size_t len;
+    subj->begin = mp_obj_str_get_data(str, &len);
+    subj->end = subj->begin + len;
+    subj->notempty = NULL;
+}
+
 STATIC mp_obj_t ure_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     (void)n_args;
     mp_obj_re_t *self = MP_OBJ_TO_PTR(args[0]);
     Subject subj;
-    size_t len;
-    subj.begin = mp_obj_str_get_data(args[1], &len);
-    subj.end = subj.begin + len;
+    re_subject(&subj, args[1]);
     int caps_num = (self->re.sub + 1) * 2;
-    mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, char*, caps_num);
-    // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
-    memset((char*)match->caps, 0, caps_num * sizeof(char*));
-    int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, is_anchored);
-    if (res == 0) {
-        m_del_var(mp_obj_match_t, char*, caps_num, match);
+    const char **caps = alloca(caps_num * sizeof(char*));
+    if (!re_exec_at(self, &subj, subj.begin, caps, caps_num, is_anchored)) {
         return mp_const_none;
     }
-
-    match->base.type = &match_type;
-    match->num_matches = caps_num / 2; // caps_num counts start and end pointers
-    match->str = args[1];
-    return MP_OBJ_FROM_PTR(match);
+    return match_new(args[1], caps, caps_num);
 }
 
 STATIC mp_obj_t re_match(size_t n_args, const mp_obj_t *args) {
@@ -130,10 +276,9 @@ MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(re_search_obj, 2, 4, re_search);
 STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     mp_obj_re_t *self = MP_OBJ_TO_PTR(args[0]);
     Subject subj;
-    size_t len;
     const mp_obj_type_t *str_type = mp_obj_get_type(args[1]);
-    subj.begin = mp_obj_str_get_data(args[1], &len);
-    subj.end = subj.begin + len;
+    re_subject(&subj, args[1]);
+    const char *sp = subj.begin;
     int caps_num = (self->re.sub + 1) * 2;
 
     int maxsplit = 0;
@@ -144,36 +289,202 @@ STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     mp_obj_t retval = mp_obj_new_list(0, NULL);
     const char **caps = alloca(caps_num * sizeof(char*));
     while (true) {
-        // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
-        memset((char**)caps, 0, caps_num * sizeof(char*));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, caps, caps_num, false);
+        int res = re_exec_at(self, &subj, sp, caps, caps_num, false);
 
         // if we didn't have a match, or had an empty match, it's time to stop
         if (!res || caps[0] == caps[1]) {
             break;
         }
 
-        mp_obj_t s = mp_obj_new_str_of_type(str_type, (const byte*)subj.begin, caps[0] - subj.begin);
+        mp_obj_t s = mp_obj_new_str_of_type(str_type, (const byte*)sp, caps[0] - sp);
         mp_obj_list_append(retval, s);
         if (self->re.sub > 0) {
             mp_not_implemented("Splitting with sub-captures");
         }
-        subj.begin = caps[1];
+        sp = caps[1];
         if (maxsplit > 0 && --maxsplit == 0) {
             break;
         }
     }
 
-    mp_obj_t s = mp_obj_new_str_of_type(str_type, (const byte*)subj.begin, subj.end - subj.begin);
+    mp_obj_t s = mp_obj_new_str_of_type(str_type, (const byte*)sp, subj.end - sp);
     mp_obj_list_append(retval, s);
     return retval;
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(re_split_obj, 2, 3, re_split);
 
+#if MICROPY_PY_URE_SUB
+// append the replacement for a match, expanding \N and \g<N> group references
+// and the escapes for backslash and whitespace
+STATIC void re_sub_expand(vstr_t *vstr, const char *repl, size_t repl_len, const char **caps, int caps_num) {
+    const char *top = repl + repl_len;
+    while (repl < top) {
+        const char *bs = memchr(repl, '\\', top - repl);
+        if (bs == NULL || bs + 1 == top) {
+            vstr_add_strn(vstr, repl, top - repl);
+            break;
+        }
+        vstr_add_strn(vstr, repl, bs - repl);
+        repl = bs + 1;
+
+        int no = -1;
+        if (unichar_isdigit(*repl)) {
+            no = *repl++ - '0';
+        } else if (*repl == 'g' && repl + 1 < top && repl[1] == '<') {
+            const char *close = memchr(repl, '>', top - repl);
+            if (close == NULL) {
+                mp_raise_ValueError("invalid group");
+            }
+            no = 0;
+            for (const char *d = repl + 2; d < close; ++d) {
+                if (!unichar_isdigit(*d)) {
+                    mp_raise_ValueError("invalid group");
+                }
+                no = no * 10 + *d - '0';
+            }
+            repl = close + 1;
+        } else {
+            char c;
+            switch (*repl) {
+                case '\\': c = '\\'; break;
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'v': c = '\v'; break;
+                case 'f': c = '\f'; break;
+                default:
+                    // unknown escape, so the backslash is kept
+                    vstr_add_byte(vstr, '\\');
+                    continue;
+            }
+            vstr_add_byte(vstr, c);
+            repl++;
+            continue;
+        }
+
+        if (no >= caps_num / 2) {
+            mp_raise_ValueError("invalid group");
+        }
+        if (caps[no * 2] != NULL) {
+            vstr_add_strn(vstr, caps[no * 2], caps[no * 2 + 1] - caps[no * 2]);
+        }
+    }
+}
+
+STATIC mp_obj_t re_sub_helper(mp_obj_re_t *self, size_t n_args, const mp_obj_t *args) {
+    mp_obj_t repl = args[0];
+    mp_obj_t str = args[1];
+    mp_int_t count = n_args > 2 ? mp_obj_get_int(args[2]) : 0;
+    const mp_obj_type_t *str_type = mp_obj_get_type(str);
+
+    Subject subj;
+    re_subject(&subj, str);
+    int caps_num = (self->re.sub + 1) * 2;
+    const char **caps = alloca(caps_num * sizeof(char*));
+
+    const char *repl_str = NULL;
+    size_t repl_len = 0;
+    if (!mp_obj_is_callable(repl)) {
+        repl_str = mp_obj_str_get_data(repl, &repl_len);
+    }
+
+    vstr_t vstr;
+    vstr_init(&vstr, subj.end - subj.begin);
+    const char *copied = subj.begin;
+    const char *sp = subj.begin;
+    for (mp_int_t n = 0; count <= 0 || n < count; ++n) {
+        if (!re_exec_at(self, &subj, sp, caps, caps_num, false)) {
+            break;
+        }
+
+        // the input between matches is added straight from the subject
+        vstr_add_strn(&vstr, copied, caps[0] - copied);
+        if (repl_str == NULL) {
+            mp_obj_t res = mp_call_function_1(repl, match_new(str, caps, caps_num));
+            size_t res_len;
+            const char *res_str = mp_obj_str_get_data(res, &res_len);
+            vstr_add_strn(&vstr, res_str, res_len);
+        } else {
+            re_sub_expand(&vstr, repl_str, repl_len, caps, caps_num);
+        }
+        copied = caps[1];
+
+        // the next match may be empty only if this one was not
+        sp = caps[1];
+        subj.notempty = caps[0] == caps[1] ? sp : NULL;
+    }
+    vstr_add_strn(&vstr, copied, subj.end - copied);
+
+    return mp_obj_new_str_from_vstr(str_type, &vstr);
+}
+
+STATIC mp_obj_t re_sub(size_t n_args, const mp_obj_t *args) {
+    return re_sub_helper(MP_OBJ_TO_PTR(args[0]), n_args - 1, args + 1);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(re_sub_obj, 3, 4, re_sub);
+#endif
+
+#if MICROPY_PY_URE_FINDITER
+typedef struct _mp_obj_re_iter_t {
+    mp_obj_base_t base;
+    mp_fun_1_t iternext;
+    mp_obj_re_t *re;
+    mp_obj_t str;
+    // position of the next search, or NULL when finished
+    const char *sp;
+    const char *notempty;
+} mp_obj_re_iter_t;
+
+STATIC mp_obj_t re_finditer_iternext(mp_obj_t self_in) {
+    mp_obj_re_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->sp == NULL) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+
+    Subject subj;
+    re_subject(&subj, self->str);
+    subj.notempty = self->notempty;
+    int caps_num = (self->re->re.sub + 1) * 2;
+    const char **caps = alloca(caps_num * sizeof(char*));
+    if (!re_exec_at(self->re, &subj, self->sp, caps, caps_num, false)) {
+        self->sp = NULL;
+        return MP_OBJ_STOP_ITERATION;
+    }
+
+    // the next match may be empty only if this one was not
+    self->sp = caps[1];
+    self->notempty = caps[0] == caps[1] ? caps[1] : NULL;
+    return match_new(self->str, caps, caps_num);
+}
+
+STATIC mp_obj_t re_finditer_helper(mp_obj_re_t *re, mp_obj_t str) {
+    mp_obj_re_iter_t *o = m_new_obj(mp_obj_re_iter_t);
+    o->base.type = &mp_type_polymorph_iter;
+    o->iternext = re_finditer_iternext;
+    o->re = re;
+    o->str = str;
+    size_t len;
+    o->sp = mp_obj_str_get_data(str, &len);
+    o->notempty = NULL;
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_obj_t re_finditer(mp_obj_t self_in, mp_obj_t str) {
+    return re_finditer_helper(MP_OBJ_TO_PTR(self_in), str);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(re_finditer_obj, re_finditer);
+#endif
+
 STATIC const mp_rom_map_elem_t re_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_match), MP_ROM_PTR(&re_match_obj) },
     { MP_ROM_QSTR(MP_QSTR_search), MP_ROM_PTR(&re_search_obj) },
     { MP_ROM_QSTR(MP_QSTR_split), MP_ROM_PTR(&re_split_obj) },
+    #if MICROPY_PY_URE_SUB
+    { MP_ROM_QSTR(MP_QSTR_sub), MP_ROM_PTR(&re_sub_obj) },
+    #endif
+    #if MICROPY_PY_URE_FINDITER
+    { MP_ROM_QSTR(MP_QSTR_finditer), MP_ROM_PTR(&re_finditer_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(re_locals_dict, re_locals_dict_table);
@@ -186,6 +497,27 @@ STATIC const mp_obj_type_t re_type = {
 };
 
 STATIC mp_obj_t mod_re_compile(size_t n_args, const mp_obj_t *args) {
+    int flags = 0;
+    if (n_args > 1) {
+        flags = mp_obj_get_int(args[1]);
+    }
+
+    #if MICROPY_PY_URE_CACHE
+    // the cache is direct-mapped on the hash of the pattern
+    mp_obj_t *entry = NULL;
+    if (flags == 0) {
+        mp_uint_t hash = MP_OBJ_SMALL_INT_VALUE(mp_unary_op(MP_UNARY_OP_HASH, args[0]));
+        entry = &MP_STATE_VM(ure_cache)[hash % MICROPY_PY_URE_CACHE_SIZE];
+        if (*entry != MP_OBJ_NULL) {
+            mp_obj_re_t *cached = MP_OBJ_TO_PTR(*entry);
+            if (mp_obj_get_type(cached->pattern) == mp_obj_get_type(args[0])
+                && mp_obj_equal(cached->pattern, args[0])) {
+                return *entry;
+            }
+        }
+    }
+    #endif
+
     const char *re_str = mp_obj_str_get_str(args[0]);
     int size = re1_5_sizecode(re_str);
     if (size == -1) {
@@ -193,18 +525,36 @@ STATIC mp_obj_t mod_re_compile(size_t n_args, const mp_obj_t *args) {
     }
     mp_obj_re_t *o = m_new_obj_var(mp_obj_re_t, char, size);
     o->base.type = &re_type;
-    int flags = 0;
-    if (n_args > 1) {
-        flags = mp_obj_get_int(args[1]);
-    }
     int error = re1_5_compilecode(&o->re, re_str);
     if (error != 0) {
 error:
         nlr_raise(mp_obj_new_exception_msg(&mp_type_ValueError, "Error in regex"));
     }
+    o->any_start = re1_5_firstset(&o->re, o->start_set);
+    o->single_start = false;
+    if (!o->any_start) {
+        // if a match can start with only one byte, memchr finds it
+        int n = 0, c = 0;
+        for (int i = 0; i < 256; ++i) {
+            if (o->start_set[i >> 3] & (1 << (i & 7))) {
+                n++;
+                c = i;
+            }
+        }
+        if (n == 1) {
+            o->single_start = true;
+            o->start_set[0] = c;
+        }
+    }
     if (flags & FLAG_DEBUG) {
         re1_5_dumpcode(&o->re);
     }
+    #if MICROPY_PY_URE_CACHE
+    o->pattern = args[0];
+    if (entry != NULL) {
+        *entry = MP_OBJ_FROM_PTR(o);
+    }
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_compile_obj, 1, 2, mod_re_compile);
@@ -228,11 +578,33 @@ STATIC mp_obj_t mod_re_search(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_search_obj, 2, 4, mod_re_search);
 
+#if MICROPY_PY_URE_SUB
+STATIC mp_obj_t mod_re_sub(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t self = mod_re_compile(1, args);
+    return re_sub_helper(MP_OBJ_TO_PTR(self), n_args - 1, args + 1);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_sub_obj, 3, 4, mod_re_sub);
+#endif
+
+#if MICROPY_PY_URE_FINDITER
+STATIC mp_obj_t mod_re_finditer(mp_obj_t pattern, mp_obj_t str) {
+    mp_obj_t self = mod_re_compile(1, &pattern);
+    return re_finditer_helper(MP_OBJ_TO_PTR(self), str);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(mod_re_finditer_obj, mod_re_finditer);
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_re_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ure) },
     { MP_ROM_QSTR(MP_QSTR_compile), MP_ROM_PTR(&mod_re_compile_obj) },
     { MP_ROM_QSTR(MP_QSTR_match), MP_ROM_PTR(&mod_re_match_obj) },
     { MP_ROM_QSTR(MP_QSTR_search), MP_ROM_PTR(&mod_re_search_obj) },
+    #if MICROPY_PY_URE_SUB
+    { MP_ROM_QSTR(MP_QSTR_sub), MP_ROM_PTR(&mod_re_sub_obj) },
+    #endif
+    #if MICROPY_PY_URE_FINDITER
+    { MP_ROM_QSTR(MP_QSTR_finditer), MP_ROM_PTR(&mod_re_finditer_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_DEBUG), MP_ROM_INT(FLAG_DEBUG) },
 };
 
@@ -250,6 +622,8 @@ const mp_obj_module_t mp_module_ure = {
 #include "re1.5/compilecode.c"
 #include "re1.5/dumpcode.c"
 #include "re1.5/recursiveloop.c"
+#include "re1.5/pike.c"
+#include "re1.5/firstset.c"
 #include "re1.5/charclass.c"
 
 #endif //MICROPY_PY_URE
@@ -35,10 +35,18 @@
 #include "py/stream.h"
 #include "py/mperrno.h"
 #include "py/mphal.h"
+#include "extmod/moduselect.h"
 
 // Flags for poll()
 #define FLAG_ONESHOT (1)
 
+#if MICROPY_PY_USELECT_WAIT_FDS
+// Longest time to block in mp_uselect_wait_fds before pending events are
+// handled, and how long to block while other objects need polling as well
+#define WAIT_FDS_MAX_MS (100)
+#define WAIT_FDS_SLICE_MS (10)
+#endif
+
 /// \module select - Provides select function to wait for events on a stream
 ///
 /// This module provides the select function.
@@ -48,6 +56,9 @@ typedef struct _poll_obj_t {
     mp_uint_t (*ioctl)(mp_obj_t obj, mp_uint_t request, mp_uint_t arg, int *errcode);
     mp_uint_t flags;
     mp_uint_t flags_ret;
+    #if MICROPY_PY_USELECT_WAIT_FDS
+    int fd; // from MP_STREAM_GET_FILENO, or -1 if the object doesn't have one
+    #endif
 } poll_obj_t;
 
 STATIC void poll_map_add(mp_map_t *poll_map, const mp_obj_t *obj, mp_uint_t obj_len, mp_uint_t flags, bool or_flags) {
@@ -61,6 +72,11 @@ STATIC void poll_map_add(mp_map_t *poll_map, const mp_obj_t *obj, mp_uint_t obj_
             poll_obj->ioctl = stream_p->ioctl;
             poll_obj->flags = flags;
             poll_obj->flags_ret = 0;
+            #if MICROPY_PY_USELECT_WAIT_FDS
+            int errcode;
+            mp_uint_t fd = stream_p->ioctl(obj[i], MP_STREAM_GET_FILENO, 0, &errcode);
+            poll_obj->fd = fd == MP_STREAM_ERROR ? -1 : (int)fd;
+            #endif
             elem->value = poll_obj;
         } else {
             // object exists; update its flags
@@ -73,7 +89,27 @@ STATIC void poll_map_add(mp_map_t *poll_map, const mp_obj_t *obj, mp_uint_t obj_
     }
 }
 
-// poll each object in the map
+// record the events of an object and return 1 if it is ready
+STATIC mp_uint_t poll_obj_set_ret(poll_obj_t *poll_obj, mp_uint_t ret, mp_uint_t *rwx_num) {
+    poll_obj->flags_ret = ret;
+    if (ret == 0) {
+        return 0;
+    }
+    if (rwx_num != NULL) {
+        if (ret & MP_STREAM_POLL_RD) {
+            rwx_num[0] += 1;
+        }
+        if (ret & MP_STREAM_POLL_WR) {
+            rwx_num[1] += 1;
+        }
+        if ((ret & ~(MP_STREAM_POLL_RD | MP_STREAM_POLL_WR)) != 0) {
+            rwx_num[2] += 1;
+        }
+    }
+    return 1;
+}
+
+// poll each object in the map, except those waited for by their fd
 STATIC mp_uint_t poll_map_poll(mp_map_t *poll_map, mp_uint_t *rwx_num) {
     mp_uint_t n_ready = 0;
     for (mp_uint_t i = 0; i < poll_map->alloc; ++i) {
@@ -82,31 +118,95 @@ STATIC mp_uint_t poll_map_poll(mp_map_t *poll_map, mp_uint_t *rwx_num) {
         }
 
         poll_obj_t *poll_obj = (poll_obj_t*)poll_map->table[i].value;
+        #if MICROPY_PY_USELECT_WAIT_FDS
+        if (poll_obj->fd >= 0) {
+            poll_obj->flags_ret = 0;
+            continue;
+        }
+        #endif
         int errcode;
         mp_int_t ret = poll_obj->ioctl(poll_obj->obj, MP_STREAM_POLL, poll_obj->flags, &errcode);
-        poll_obj->flags_ret = ret;
 
         if (ret == -1) {
             // error doing ioctl
             mp_raise_OSError(errcode);
         }
 
-        if (ret != 0) {
-            // object is ready
-            n_ready += 1;
-            if (rwx_num != NULL) {
-                if (ret & MP_STREAM_POLL_RD) {
-                    rwx_num[0] += 1;
-                }
-                if (ret & MP_STREAM_POLL_WR) {
-                    rwx_num[1] += 1;
-                }
-                if ((ret & ~(MP_STREAM_POLL_RD | MP_STREAM_POLL_WR)) != 0) {
-                    rwx_num[2] += 1;
+        n_ready += poll_obj_set_ret(poll_obj, ret, rwx_num);
+    }
+    return n_ready;
+}
+
+// wait until at least one object in the map is ready, or for timeout ms
+STATIC mp_uint_t poll_map_wait(mp_map_t *poll_map, mp_uint_t *rwx_num, mp_uint_t timeout) {
+    #if MICROPY_PY_USELECT_WAIT_FDS
+    // objects with an fd are all waited for with one call, which blocks
+    size_t nfds = 0;
+    for (mp_uint_t i = 0; i < poll_map->alloc; ++i) {
+        if (MP_MAP_SLOT_IS_FILLED(poll_map, i) && ((poll_obj_t*)poll_map->table[i].value)->fd >= 0) {
+            nfds += 1;
+        }
+    }
+    bool others = nfds < poll_map->used;
+    mp_uselect_fd_t *fds = NULL;
+    poll_obj_t **fd_objs = NULL;
+    if (nfds > 0) {
+        fds = m_new(mp_uselect_fd_t, nfds);
+        fd_objs = m_new(poll_obj_t*, nfds);
+        nfds = 0;
+        for (mp_uint_t i = 0; i < poll_map->alloc; ++i) {
+            if (!MP_MAP_SLOT_IS_FILLED(poll_map, i)) {
+                continue;
+            }
+            poll_obj_t *poll_obj = (poll_obj_t*)poll_map->table[i].value;
+            if (poll_obj->fd >= 0) {
+                fds[nfds].fd = poll_obj->fd;
+                fds[nfds].events = poll_obj->flags;
+                fd_objs[nfds++] = poll_obj;
+            }
+        }
+    }
+    #endif
+
+    mp_uint_t start_tick = mp_hal_ticks_ms();
+    mp_uint_t n_ready;
+    for (;;) {
+        // poll the objects
+        n_ready = poll_map_poll(poll_map, rwx_num);
+        mp_uint_t elapsed = mp_hal_ticks_ms() - start_tick;
+
+        #if MICROPY_PY_USELECT_WAIT_FDS
+        if (nfds > 0) {
+            mp_uint_t wait_ms = 0;
+            if (n_ready == 0 && (timeout == -1 || elapsed < timeout)) {
+                wait_ms = others ? WAIT_FDS_SLICE_MS : WAIT_FDS_MAX_MS;
+                if (timeout != -1 && timeout - elapsed < wait_ms) {
+                    wait_ms = timeout - elapsed;
                 }
             }
+            MP_THREAD_GIL_EXIT();
+            int ret = mp_uselect_wait_fds(fds, nfds, wait_ms);
+            MP_THREAD_GIL_ENTER();
+            if (ret < 0) {
+                mp_raise_OSError(-ret);
+            }
+            for (size_t i = 0; ret > 0 && i < nfds; ++i) {
+                n_ready += poll_obj_set_ret(fd_objs[i], fds[i].revents, rwx_num);
+            }
+            elapsed = mp_hal_ticks_ms() - start_tick;
         }
+        #endif
+
+        if (n_ready > 0 || (timeout != -1 && elapsed >= timeout)) {
+            break;
+        }
+        MICROPY_EVENT_POLL_HOOK
     }
+
+    #if MICROPY_PY_USELECT_WAIT_FDS
+    m_del(mp_uselect_fd_t, fds, nfds);
+    m_del(poll_obj_t*, fd_objs, nfds);
+    #endif
     return n_ready;
 }
 
@@ -141,39 +241,32 @@ STATIC mp_obj_t select_select(uint n_args, const mp_obj_t *args) {
     poll_map_add(&poll_map, w_array, rwx_len[1], MP_STREAM_POLL_WR, true);
     poll_map_add(&poll_map, x_array, rwx_len[2], MP_STREAM_POLL_ERR | MP_STREAM_POLL_HUP, true);
 
-    mp_uint_t start_tick = mp_hal_ticks_ms();
     rwx_len[0] = rwx_len[1] = rwx_len[2] = 0;
-    for (;;) {
-        // poll the objects
-        mp_uint_t n_ready = poll_map_poll(&poll_map, rwx_len);
-
-        if (n_ready > 0 || (timeout != -1 && mp_hal_ticks_ms() - start_tick >= timeout)) {
-            // one or more objects are ready, or we had a timeout
-            mp_obj_t list_array[3];
-            list_array[0] = mp_obj_new_list(rwx_len[0], NULL);
-            list_array[1] = mp_obj_new_list(rwx_len[1], NULL);
-            list_array[2] = mp_obj_new_list(rwx_len[2], NULL);
-            rwx_len[0] = rwx_len[1] = rwx_len[2] = 0;
-            for (mp_uint_t i = 0; i < poll_map.alloc; ++i) {
-                if (!MP_MAP_SLOT_IS_FILLED(&poll_map, i)) {
-                    continue;
-                }
-                poll_obj_t *poll_obj = (poll_obj_t*)poll_map.table[i].value;
-                if (poll_obj->flags_ret & MP_STREAM_POLL_RD) {
-                    ((mp_obj_list_t*)list_array[0])->items[rwx_len[0]++] = poll_obj->obj;
-                }
-                if (poll_obj->flags_ret & MP_STREAM_POLL_WR) {
-                    ((mp_obj_list_t*)list_array[1])->items[rwx_len[1]++] = poll_obj->obj;
-                }
-                if ((poll_obj->flags_ret & ~(MP_STREAM_POLL_RD | MP_STREAM_POLL_WR)) != 0) {
-                    ((mp_obj_list_t*)list_array[2])->items[rwx_len[2]++] = poll_obj->obj;
-                }
-            }
-            mp_map_deinit(&poll_map);
-            return mp_obj_new_tuple(3, list_array);
+    poll_map_wait(&poll_map, rwx_len, timeout);
+
+    // one or more objects are ready, or we had a timeout
+    mp_obj_t list_array[3];
+    list_array[0] = mp_obj_new_list(rwx_len[0], NULL);
+    list_array[1] = mp_obj_new_list(rwx_len[1], NULL);
+    list_array[2] = mp_obj_new_list(rwx_len[2], NULL);
+    rwx_len[0] = rwx_len[1] = rwx_len[2] = 0;
+    for (mp_uint_t i = 0; i < poll_map.alloc; ++i) {
+        if (!MP_MAP_SLOT_IS_FILLED(&poll_map, i)) {
+            continue;
+        }
+        poll_obj_t *poll_obj = (poll_obj_t*)poll_map.table[i].value;
+        if (poll_obj->flags_ret & MP_STREAM_POLL_RD) {
+            ((mp_obj_list_t*)list_array[0])->items[rwx_len[0]++] = poll_obj->obj;
+        }
+        if (poll_obj->flags_ret & MP_STREAM_POLL_WR) {
+            ((mp_obj_list_t*)list_array[1])->items[rwx_len[1]++] = poll_obj->obj;
+        }
+        if ((poll_obj->flags_ret & ~(MP_STREAM_POLL_RD | MP_STREAM_POLL_WR)) != 0) {
+            ((mp_obj_list_t*)list_array[2])->items[rwx_len[2]++] = poll_obj->obj;
         }
-        MICROPY_EVENT_POLL_HOOK
     }
+    mp_map_deinit(&poll_map);
+    return mp_obj_new_tuple(3, list_array);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_select_select_obj, 3, 4, select_select);
 
@@ -244,18 +337,7 @@ STATIC mp_uint_t poll_poll_internal(uint n_args, const mp_obj_t *args) {
 
     self->flags = flags;
 
-    mp_uint_t start_tick = mp_hal_ticks_ms();
-    mp_uint_t n_ready;
-    for (;;) {
-        // poll the objects
-        n_ready = poll_map_poll(&self->poll_map, NULL);
-        if (n_ready > 0 || (timeout != -1 && mp_hal_ticks_ms() - start_tick >= timeout)) {
-            break;
-        }
-        MICROPY_EVENT_POLL_HOOK
-    }
-
-    return n_ready;
+    return poll_map_wait(&self->poll_map, NULL, timeout);
 }
 
 STATIC mp_obj_t poll_poll(uint n_args, const mp_obj_t *args) {
@@ -0,0 +1,45 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_EXTMOD_MODUSELECT_H
+#define MICROPY_INCLUDED_EXTMOD_MODUSELECT_H
+
+#include "py/obj.h"
+
+#if MICROPY_PY_USELECT_WAIT_FDS
+
+// A file descriptor, as returned by the MP_STREAM_GET_FILENO ioctl, to wait
+// for, with the MP_STREAM_POLL_xxx events of interest and those that occurred
+typedef struct _mp_uselect_fd_t {
+    int fd;
+    uint16_t events;
+    uint16_t revents;
+} mp_uselect_fd_t;
+
+// Provided by the port: block for up to timeout_ms until any of the fds is
+// ready, set revents of each, and return the number ready or -errno
+int mp_uselect_wait_fds(mp_uselect_fd_t *fds, size_t nfds, mp_uint_t timeout_ms);
+
+#endif
+
+#endif // MICROPY_INCLUDED_EXTMOD_MODUSELECT_H
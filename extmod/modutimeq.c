@@ -32,6 +32,7 @@
 #include "py/runtime0.h"
 #include "py/runtime.h"
 #include "py/smallint.h"
+#include "extmod/modutimeq.h"
 
 #if MICROPY_PY_UTIMEQ
 
@@ -76,17 +77,21 @@ STATIC bool time_less_than(struct qentry *item, struct qentry *parent) {
     return res && res < (MODULO / 2);
 }
 
-STATIC mp_obj_t utimeq_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
-    mp_arg_check_num(n_args, n_kw, 1, 1, false);
-    mp_uint_t alloc = mp_obj_get_int(args[0]);
+mp_obj_t mp_utimeq_new(size_t alloc) {
     mp_obj_utimeq_t *o = m_new_obj_var(mp_obj_utimeq_t, struct qentry, alloc);
-    o->base.type = type;
+    o->base.type = &mp_type_utimeq;
     memset(o->items, 0, sizeof(*o->items) * alloc);
     o->alloc = alloc;
     o->len = 0;
     return MP_OBJ_FROM_PTR(o);
 }
 
+STATIC mp_obj_t utimeq_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    (void)type;
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    return mp_utimeq_new(mp_obj_get_int(args[0]));
+}
+
 STATIC void heap_siftdown(mp_obj_utimeq_t *heap, mp_uint_t start_pos, mp_uint_t pos) {
     struct qentry item = heap->items[pos];
     while (pos > start_pos) {
@@ -123,38 +128,35 @@ STATIC void heap_siftup(mp_obj_utimeq_t *heap, mp_uint_t pos) {
     heap_siftdown(heap, start_pos, pos);
 }
 
-STATIC mp_obj_t mod_utimeq_heappush(size_t n_args, const mp_obj_t *args) {
-    (void)n_args;
-    mp_obj_t heap_in = args[0];
+void mp_utimeq_push(mp_obj_t heap_in, mp_uint_t time, mp_obj_t callback, mp_obj_t args) {
     mp_obj_utimeq_t *heap = get_heap(heap_in);
     if (heap->len == heap->alloc) {
         mp_raise_msg(&mp_type_IndexError, "queue overflow");
     }
     mp_uint_t l = heap->len;
-    heap->items[l].time = MP_OBJ_SMALL_INT_VALUE(args[1]);
+    heap->items[l].time = time;
     heap->items[l].id = utimeq_id++;
-    heap->items[l].callback = args[2];
-    heap->items[l].args = args[3];
+    heap->items[l].callback = callback;
+    heap->items[l].args = args;
     heap_siftdown(heap, 0, heap->len);
     heap->len++;
-    return mp_const_none;
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_utimeq_heappush_obj, 4, 4, mod_utimeq_heappush);
 
-STATIC mp_obj_t mod_utimeq_heappop(mp_obj_t heap_in, mp_obj_t list_ref) {
+bool mp_utimeq_peektime(mp_obj_t heap_in, mp_uint_t *time) {
     mp_obj_utimeq_t *heap = get_heap(heap_in);
     if (heap->len == 0) {
-        nlr_raise(mp_obj_new_exception_msg(&mp_type_IndexError, "empty heap"));
-    }
-    mp_obj_list_t *ret = MP_OBJ_TO_PTR(list_ref);
-    if (!MP_OBJ_IS_TYPE(list_ref, &mp_type_list) || ret->len < 3) {
-        mp_raise_TypeError("");
+        return false;
     }
+    *time = heap->items[0].time;
+    return true;
+}
 
+// the caller must check that the queue is not empty
+void mp_utimeq_pop(mp_obj_t heap_in, mp_obj_t *callback, mp_obj_t *args) {
+    mp_obj_utimeq_t *heap = get_heap(heap_in);
     struct qentry *item = &heap->items[0];
-    ret->items[0] = MP_OBJ_NEW_SMALL_INT(item->time);
-    ret->items[1] = item->callback;
-    ret->items[2] = item->args;
+    *callback = item->callback;
+    *args = item->args;
     heap->len -= 1;
     heap->items[0] = heap->items[heap->len];
     heap->items[heap->len].callback = MP_OBJ_NULL; // so we don't retain a pointer
@@ -162,6 +164,27 @@ STATIC mp_obj_t mod_utimeq_heappop(mp_obj_t heap_in, mp_obj_t list_ref) {
     if (heap->len) {
         heap_siftup(heap, 0);
     }
+}
+
+STATIC mp_obj_t mod_utimeq_heappush(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    mp_utimeq_push(args[0], MP_OBJ_SMALL_INT_VALUE(args[1]), args[2], args[3]);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_utimeq_heappush_obj, 4, 4, mod_utimeq_heappush);
+
+STATIC mp_obj_t mod_utimeq_heappop(mp_obj_t heap_in, mp_obj_t list_ref) {
+    mp_obj_utimeq_t *heap = get_heap(heap_in);
+    if (heap->len == 0) {
+        nlr_raise(mp_obj_new_exception_msg(&mp_type_IndexError, "empty heap"));
+    }
+    mp_obj_list_t *ret = MP_OBJ_TO_PTR(list_ref);
+    if (!MP_OBJ_IS_TYPE(list_ref, &mp_type_list) || ret->len < 3) {
+        mp_raise_TypeError("");
+    }
+
+    ret->items[0] = MP_OBJ_NEW_SMALL_INT(heap->items[0].time);
+    mp_utimeq_pop(heap_in, &ret->items[1], &ret->items[2]);
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_utimeq_heappop_obj, mod_utimeq_heappop);
@@ -209,7 +232,7 @@ STATIC const mp_rom_map_elem_t utimeq_locals_dict_table[] = {
 
 STATIC MP_DEFINE_CONST_DICT(utimeq_locals_dict, utimeq_locals_dict_table);
 
-STATIC const mp_obj_type_t utimeq_type = {
+const mp_obj_type_t mp_type_utimeq = {
     { &mp_type_type },
     .name = MP_QSTR_utimeq,
     .make_new = utimeq_make_new,
@@ -219,7 +242,7 @@ STATIC const mp_obj_type_t utimeq_type = {
 
 STATIC const mp_rom_map_elem_t mp_module_utimeq_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_utimeq) },
-    { MP_ROM_QSTR(MP_QSTR_utimeq), MP_ROM_PTR(&utimeq_type) },
+    { MP_ROM_QSTR(MP_QSTR_utimeq), MP_ROM_PTR(&mp_type_utimeq) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_utimeq_globals, mp_module_utimeq_globals_table);
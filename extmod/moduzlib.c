@@ -34,6 +34,9 @@
 
 #if MICROPY_PY_UZLIB
 
+#if MICROPY_PY_UZLIB_FAST_DECODE
+#define TINF_FAST_BITS (9)
+#endif
 #include "uzlib/tinf.h"
 
 #if 0 // print debugging info
@@ -94,7 +97,7 @@ STATIC mp_obj_t decompio_make_new(const mp_obj_type_t *type, size_t n_args, size
 header_error:
             nlr_raise(mp_obj_new_exception_msg(&mp_type_ValueError, "compression header"));
         }
-        dict_sz = 1 << dict_opt;
+        dict_sz = 1 << (dict_opt + 8);
     } else {
         dict_sz = 1 << -dict_opt;
     }
@@ -181,11 +184,14 @@ STATIC mp_obj_t mod_uzlib_decompress(size_t n_args, const mp_obj_t *args) {
         if (st == TINF_DONE) {
             break;
         }
+        // grow the buffer geometrically so large outputs aren't copied
+        // over and over again
         size_t offset = decomp->dest - dest_buf;
-        dest_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + 256);
-        dest_buf_size += 256;
+        size_t grow = (dest_buf_size / 2 + 256) & ~255;
+        dest_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + grow);
+        dest_buf_size += grow;
         decomp->dest = dest_buf + offset;
-        decomp->destSize = 256;
+        decomp->destSize = grow;
     }
 
     mp_uint_t final_sz = decomp->dest - dest_buf;
@@ -200,10 +206,152 @@ error:
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uzlib_decompress_obj, 1, 3, mod_uzlib_decompress);
 
+#if MICROPY_PY_UZLIB_COMPRESS
+
+// Parse the optional level and wbits arguments and return the checksum type
+// that selects the framing, following the same wbits convention as DecompIO.
+STATIC int uzlib_compress_args(size_t n_args, const mp_obj_t *args, int *level, int *wbits) {
+    mp_int_t lvl = -1;
+    mp_int_t wb = 10;
+    if (n_args > 0) {
+        lvl = mp_obj_get_int(args[0]);
+    }
+    if (n_args > 1) {
+        wb = mp_obj_get_int(args[1]);
+    }
+    if (lvl == -1) {
+        lvl = 6;
+    }
+    int chksum_type;
+    if (wb >= 16 + 9 && wb <= 16 + 15) {
+        chksum_type = TINF_CHKSUM_CRC;
+        wb -= 16;
+    } else if (wb >= 9 && wb <= 15) {
+        chksum_type = TINF_CHKSUM_ADLER;
+    } else if (wb >= -15 && wb <= -9) {
+        chksum_type = TINF_CHKSUM_NONE;
+        wb = -wb;
+    } else {
+        mp_raise_ValueError("wbits");
+    }
+    if (lvl < 0 || lvl > 9) {
+        mp_raise_ValueError("level");
+    }
+    *level = lvl;
+    *wbits = wb;
+    return chksum_type;
+}
+
+typedef struct _mp_obj_compio_t {
+    mp_obj_base_t base;
+    mp_obj_t dest_stream;
+    byte *mem;
+    size_t mem_size;
+    UZLIB_COMP comp;
+} mp_obj_compio_t;
+
+STATIC void write_dest_stream(UZLIB_COMP *comp, const unsigned char *buf, unsigned int len) {
+    byte *p = (void*)comp;
+    p -= offsetof(mp_obj_compio_t, comp);
+    mp_obj_compio_t *self = (mp_obj_compio_t*)p;
+    mp_stream_write_adaptor(self->dest_stream, (const char*)buf, len);
+}
+
+STATIC mp_obj_t compio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 3, false);
+    int level, wbits;
+    int chksum_type = uzlib_compress_args(n_args - 1, args + 1, &level, &wbits);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+
+    mp_obj_compio_t *o = m_new_obj(mp_obj_compio_t);
+    o->base.type = type;
+    o->dest_stream = args[0];
+    o->mem_size = uzlib_compress_mem_size(wbits);
+    o->mem = m_new(byte, o->mem_size);
+    o->comp.writeDest = write_dest_stream;
+    uzlib_compress_init(&o->comp, o->mem, wbits, level, chksum_type);
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_uint_t compio_write(mp_obj_t o_in, const void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_compio_t *o = MP_OBJ_TO_PTR(o_in);
+    if (o->mem == NULL) {
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
+    uzlib_compress_write(&o->comp, buf, size);
+    return size;
+}
+
+// Finish the compressed stream; the underlying stream is left open
+STATIC mp_obj_t compio_close(mp_obj_t o_in) {
+    mp_obj_compio_t *o = MP_OBJ_TO_PTR(o_in);
+    if (o->mem != NULL) {
+        uzlib_compress_finish(&o->comp);
+        m_del(byte, o->mem, o->mem_size);
+        o->mem = NULL;
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(compio_close_obj, compio_close);
+
+STATIC const mp_rom_map_elem_t compio_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&compio_close_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(compio_locals_dict, compio_locals_dict_table);
+
+STATIC const mp_stream_p_t compio_stream_p = {
+    .write = compio_write,
+};
+
+STATIC const mp_obj_type_t compio_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_CompressIO,
+    .make_new = compio_make_new,
+    .protocol = &compio_stream_p,
+    .locals_dict = (void*)&compio_locals_dict,
+};
+
+typedef struct _uzlib_compress_vstr_t {
+    UZLIB_COMP comp;
+    vstr_t vstr;
+} uzlib_compress_vstr_t;
+
+STATIC void write_dest_vstr(UZLIB_COMP *comp, const unsigned char *buf, unsigned int len) {
+    vstr_add_strn(&((uzlib_compress_vstr_t*)comp)->vstr, (const char*)buf, len);
+}
+
+STATIC mp_obj_t mod_uzlib_compress(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    int level, wbits;
+    int chksum_type = uzlib_compress_args(n_args - 1, args + 1, &level, &wbits);
+
+    uzlib_compress_vstr_t c;
+    vstr_init(&c.vstr, bufinfo.len / 2 + 32);
+    size_t mem_size = uzlib_compress_mem_size(wbits);
+    byte *mem = m_new(byte, mem_size);
+    c.comp.writeDest = write_dest_vstr;
+    uzlib_compress_init(&c.comp, mem, wbits, level, chksum_type);
+    uzlib_compress_write(&c.comp, bufinfo.buf, bufinfo.len);
+    uzlib_compress_finish(&c.comp);
+    m_del(byte, mem, mem_size);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &c.vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uzlib_compress_obj, 1, 3, mod_uzlib_compress);
+
+#endif // MICROPY_PY_UZLIB_COMPRESS
+
 STATIC const mp_rom_map_elem_t mp_module_uzlib_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uzlib) },
     { MP_ROM_QSTR(MP_QSTR_decompress), MP_ROM_PTR(&mod_uzlib_decompress_obj) },
     { MP_ROM_QSTR(MP_QSTR_DecompIO), MP_ROM_PTR(&decompio_type) },
+    #if MICROPY_PY_UZLIB_COMPRESS
+    { MP_ROM_QSTR(MP_QSTR_compress), MP_ROM_PTR(&mod_uzlib_compress_obj) },
+    { MP_ROM_QSTR(MP_QSTR_CompressIO), MP_ROM_PTR(&compio_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_uzlib_globals, mp_module_uzlib_globals_table);
@@ -221,5 +369,9 @@ const mp_obj_module_t mp_module_uzlib = {
 #include "uzlib/tinfgzip.c"
 #include "uzlib/adler32.c"
 #include "uzlib/crc32.c"
+#if MICROPY_PY_UZLIB_COMPRESS
+#include "uzlib/defl_static.c"
+#include "uzlib/genlz77.c"
+#endif
 
 #endif // MICROPY_PY_UZLIB
@@ -0,0 +1,55 @@
+// Copyright 2014 Paul Sokolovsky.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Returns 1 if a match can start with anything, otherwise adds the bytes a
+// match can start with to the set.  Branches starting with ^ add nothing.
+static int
+firstset(const char *pc, unsigned char *set, int depth)
+{
+	int c;
+
+	// give up on deep or looping code
+	if(depth > 32)
+		return 1;
+
+	switch(*pc) {
+	case Char:
+		c = (unsigned char)pc[1];
+		set[c >> 3] |= 1 << (c & 7);
+		return 0;
+	case Class:
+	case ClassNot:
+	case NamedClass:
+		for(c = 0; c < 256; c++) {
+			char ch = c;
+			if(*pc == NamedClass ? _re1_5_namedclassmatch(pc + 1, &ch) : _re1_5_classmatch(pc + 1, &ch))
+				set[c >> 3] |= 1 << (c & 7);
+		}
+		return 0;
+	case Bol:
+		return 0;
+	case Save:
+		return firstset(pc + 2, set, depth + 1);
+	case Jmp:
+		return firstset(pc + 2 + (signed char)pc[1], set, depth + 1);
+	case Split:
+	case RSplit:
+		return firstset(pc + 2, set, depth + 1)
+			|| firstset(pc + 2 + (signed char)pc[1], set, depth + 1);
+	}
+	// Any, Eol, or a match of the empty string
+	return 1;
+}
+
+// Work out which bytes an anchored match can start with, so a search can
+// skip over positions where no match is possible.  The set has a bit for
+// each byte value, and the return value is 1 if no such set exists.
+int
+re1_5_firstset(ByteProg *prog, unsigned char *set)
+{
+	memset(set, 0, 32);
+	return firstset(prog->insts + NON_ANCHORED_PREFIX, set, 0);
+}
@@ -0,0 +1,171 @@
+// Copyright 2007-2009 Russ Cox.  All Rights Reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Pike VM: all the threads of the program are run in lockstep over the
+// input, so the time taken is linear in the length of the input and no
+// recursion on the input is needed.  Threads are kept in priority order and
+// at most one thread is kept for each instruction, which gives the same
+// result as backtracking.
+
+typedef struct Thread Thread;
+struct Thread
+{
+	const char *pc;
+	const char **sub;
+};
+
+typedef struct ThreadList ThreadList;
+struct ThreadList
+{
+	int n;
+	Thread *t;
+};
+
+typedef struct PikeVM PikeVM;
+struct PikeVM
+{
+	ByteProg *prog;
+	Subject *input;
+	int nsubp;
+	int gen;
+	int *mark;
+};
+
+int
+re1_5_pikevm_memsize(ByteProg *prog, int nsubp)
+{
+	// two thread lists, with room for a thread per instruction, the
+	// captures of each thread, and a mark for each byte of code
+	return 2 * prog->len * (sizeof(Thread) + nsubp * sizeof(const char*))
+		+ prog->bytelen * sizeof(int);
+}
+
+// add a thread at pc, following jumps and assertions to the instructions
+// which consume input
+static void
+addthread(PikeVM *vm, ThreadList *l, const char *pc, const char *sp, const char **sub)
+{
+	const char *old;
+	int off;
+
+	if(vm->mark[pc - vm->prog->insts] == vm->gen)
+		return;
+	vm->mark[pc - vm->prog->insts] = vm->gen;
+
+	switch(*pc) {
+	case Jmp:
+		addthread(vm, l, pc + 2 + (signed char)pc[1], sp, sub);
+		return;
+	case Split:
+		addthread(vm, l, pc + 2, sp, sub);
+		addthread(vm, l, pc + 2 + (signed char)pc[1], sp, sub);
+		return;
+	case RSplit:
+		addthread(vm, l, pc + 2 + (signed char)pc[1], sp, sub);
+		addthread(vm, l, pc + 2, sp, sub);
+		return;
+	case Save:
+		off = (unsigned char)pc[1];
+		if(off >= vm->nsubp) {
+			addthread(vm, l, pc + 2, sp, sub);
+			return;
+		}
+		old = sub[off];
+		sub[off] = sp;
+		addthread(vm, l, pc + 2, sp, sub);
+		sub[off] = old;
+		return;
+	case Bol:
+		if(sp == vm->input->begin)
+			addthread(vm, l, pc + 1, sp, sub);
+		return;
+	case Eol:
+		if(sp == vm->input->end)
+			addthread(vm, l, pc + 1, sp, sub);
+		return;
+	}
+
+	l->t[l->n].pc = pc;
+	memcpy(l->t[l->n].sub, sub, vm->nsubp * sizeof(const char*));
+	l->n++;
+}
+
+int
+re1_5_pikevm(ByteProg *prog, Subject *input, const char *sp, const char **subp, int nsubp, int is_anchored, void *mem)
+{
+	PikeVM vm;
+	ThreadList lists[2], *clist, *nlist, *tmp;
+	const char **subs;
+	const char *pc;
+	int i, matched;
+
+	lists[0].t = mem;
+	lists[1].t = lists[0].t + prog->len;
+	subs = (const char**)(lists[1].t + prog->len);
+	for(i = 0; i < prog->len; i++) {
+		lists[0].t[i].sub = subs + i * nsubp;
+		lists[1].t[i].sub = subs + (prog->len + i) * nsubp;
+	}
+	vm.prog = prog;
+	vm.input = input;
+	vm.nsubp = nsubp;
+	vm.gen = 1;
+	vm.mark = (int*)(subs + 2 * prog->len * nsubp);
+	memset(vm.mark, 0, prog->bytelen * sizeof(int));
+
+	clist = &lists[0];
+	nlist = &lists[1];
+	clist->n = 0;
+	addthread(&vm, clist, HANDLE_ANCHORED(prog->insts, is_anchored), sp, subp);
+
+	matched = 0;
+	for(; clist->n > 0; sp++) {
+		vm.gen++;
+		nlist->n = 0;
+		for(i = 0; i < clist->n; i++) {
+			pc = clist->t[i].pc;
+			if(inst_is_consumer(*pc) && sp >= input->end)
+				continue;
+			switch(*pc) {
+			case Char:
+				if(*sp != pc[1])
+					continue;
+				addthread(&vm, nlist, pc + 2, sp + 1, clist->t[i].sub);
+				continue;
+			case Any:
+				addthread(&vm, nlist, pc + 1, sp + 1, clist->t[i].sub);
+				continue;
+			case Class:
+			case ClassNot:
+				if(!_re1_5_classmatch(pc + 1, sp))
+					continue;
+				addthread(&vm, nlist, pc + 2 + *(unsigned char*)(pc + 1) * 2, sp + 1, clist->t[i].sub);
+				continue;
+			case NamedClass:
+				if(!_re1_5_namedclassmatch(pc + 1, sp))
+					continue;
+				addthread(&vm, nlist, pc + 2, sp + 1, clist->t[i].sub);
+				continue;
+			case Match:
+				if(sp == input->notempty)
+					continue;
+				memcpy(subp, clist->t[i].sub, nsubp * sizeof(const char*));
+				matched = 1;
+				// threads of lower priority are cut off
+				break;
+			default:
+				re1_5_fatal("pikevm");
+			}
+			break;
+		}
+		if(sp >= input->end)
+			break;
+		tmp = clist;
+		clist = nlist;
+		nlist = tmp;
+	}
+	return matched;
+}
@@ -129,15 +129,23 @@ void decref(Sub*);
 struct Subject {
 	const char *begin;
 	const char *end;
+	// if not nil, an empty match at this position is not accepted
+	const char *notempty;
 };
 
 
 #define NON_ANCHORED_PREFIX 5
 #define HANDLE_ANCHORED(bytecode, is_anchored) ((is_anchored) ? (bytecode) + NON_ANCHORED_PREFIX : (bytecode))
 
+// Maximum recursion depth of recursiveloop, beyond which it gives up
+#ifndef RE1_5_MAX_DEPTH
+#define RE1_5_MAX_DEPTH 100
+#endif
+
 int re1_5_backtrack(ByteProg*, Subject*, const char**, int, int);
-int re1_5_pikevm(ByteProg*, Subject*, const char**, int, int);
-int re1_5_recursiveloopprog(ByteProg*, Subject*, const char**, int, int);
+int re1_5_pikevm(ByteProg*, Subject*, const char*, const char**, int, int, void*);
+int re1_5_pikevm_memsize(ByteProg*, int);
+int re1_5_recursiveloopprog(ByteProg*, Subject*, const char*, const char**, int, int, int*);
 int re1_5_recursiveprog(ByteProg*, Subject*, const char**, int, int);
 int re1_5_thompsonvm(ByteProg*, Subject*, const char**, int, int);
 
@@ -145,6 +153,7 @@ int re1_5_sizecode(const char *re);
 int re1_5_compilecode(ByteProg *prog, const char *re);
 void re1_5_dumpcode(ByteProg *prog);
 void cleanmarks(ByteProg *prog);
+int re1_5_firstset(ByteProg *prog, unsigned char *set);
 int _re1_5_classmatch(const char *pc, const char *sp);
 int _re1_5_namedclassmatch(const char *pc, const char *sp);
 
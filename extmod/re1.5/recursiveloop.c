@@ -4,11 +4,13 @@
 
 #include "re1.5.h"
 
+// Returns 1 on match, 0 on no match, and -1 if the depth or the number of
+// steps allowed by *budget was exceeded, in which case subp is undefined.
 static int
-recursiveloop(char *pc, const char *sp, Subject *input, const char **subp, int nsubp)
+recursiveloop(char *pc, const char *sp, Subject *input, const char **subp, int nsubp, int depth, int *budget)
 {
 	const char *old;
-	int off;
+	int off, res;
 	
 	for(;;) {
 		if(inst_is_consumer(*pc)) {
@@ -37,6 +39,8 @@ recursiveloop(char *pc, const char *sp, Subject *input, const char **subp, int n
 			sp++;
 			continue;
 		case Match:
+			if(sp == input->notempty)
+				return 0;
 			return 1;
 		case Jmp:
 			off = (signed char)*pc++;
@@ -44,24 +48,30 @@ recursiveloop(char *pc, const char *sp, Subject *input, const char **subp, int n
 			continue;
 		case Split:
 			off = (signed char)*pc++;
-			if(recursiveloop(pc, sp, input, subp, nsubp))
-				return 1;
+			if(depth >= RE1_5_MAX_DEPTH || --*budget < 0)
+				return -1;
+			if((res = recursiveloop(pc, sp, input, subp, nsubp, depth + 1, budget)))
+				return res;
 			pc = pc + off;
 			continue;
 		case RSplit:
 			off = (signed char)*pc++;
-			if(recursiveloop(pc + off, sp, input, subp, nsubp))
-				return 1;
+			if(depth >= RE1_5_MAX_DEPTH || --*budget < 0)
+				return -1;
+			if((res = recursiveloop(pc + off, sp, input, subp, nsubp, depth + 1, budget)))
+				return res;
 			continue;
 		case Save:
 			off = (unsigned char)*pc++;
 			if(off >= nsubp) {
 				continue;
 			}
+			if(depth >= RE1_5_MAX_DEPTH)
+				return -1;
 			old = subp[off];
 			subp[off] = sp;
-			if(recursiveloop(pc, sp, input, subp, nsubp))
-				return 1;
+			if((res = recursiveloop(pc, sp, input, subp, nsubp, depth + 1, budget)))
+				return res;
 			subp[off] = old;
 			return 0;
 		case Bol:
@@ -78,7 +88,7 @@ recursiveloop(char *pc, const char *sp, Subject *input, const char **subp, int n
 }
 
 int
-re1_5_recursiveloopprog(ByteProg *prog, Subject *input, const char **subp, int nsubp, int is_anchored)
+re1_5_recursiveloopprog(ByteProg *prog, Subject *input, const char *sp, const char **subp, int nsubp, int is_anchored, int *budget)
 {
-	return recursiveloop(HANDLE_ANCHORED(prog->insts, is_anchored), input->begin, input, subp, nsubp);
+	return recursiveloop(HANDLE_ANCHORED(prog->insts, is_anchored), sp, input, subp, nsubp, 0, budget);
 }
@@ -0,0 +1,152 @@
+/*
+ * defl_static  -  deflate output using the fixed huffman codes
+ *
+ * Copyright (c) 2014-2016 by Paul Sokolovsky
+ *
+ * This software is provided 'as-is', without any express
+ * or implied warranty.  In no event will the authors be
+ * held liable for any damages arising from the use of
+ * this software.
+ *
+ * Permission is granted to anyone to use this software
+ * for any purpose, including commercial applications,
+ * and to alter it and redistribute it freely, subject to
+ * the following restrictions:
+ *
+ * 1. The origin of this software must not be
+ *    misrepresented; you must not claim that you
+ *    wrote the original software. If you use this
+ *    software in a product, an acknowledgment in
+ *    the product documentation would be appreciated
+ *    but is not required.
+ *
+ * 2. Altered source versions must be plainly marked
+ *    as such, and must not be misrepresented as
+ *    being the original software.
+ *
+ * 3. This notice may not be removed or altered from
+ *    any source distribution.
+ */
+
+#include "tinf.h"
+
+/* Fixed huffman codes need no tables to be sent or built, and their output
+ * can be written as soon as each symbol is known, so no memory is needed to
+ * buffer a block.  See RFC 1951, section 3.2.6. */
+
+static const unsigned short defl_length_base[29] = {
+   3, 4, 5, 6, 7, 8, 9, 10,
+   11, 13, 15, 17, 19, 23, 27, 31,
+   35, 43, 51, 59, 67, 83, 99, 115,
+   131, 163, 195, 227, 258
+};
+
+static const unsigned short defl_dist_base[30] = {
+   1, 2, 3, 4, 5, 7, 9, 13,
+   17, 25, 33, 49, 65, 97, 129, 193,
+   257, 385, 513, 769, 1025, 1537, 2049, 3073,
+   4097, 6145, 8193, 12289, 16385, 24577
+};
+
+/* number of extra bits for length code i (0..28) and distance code i */
+#define DEFL_LENGTH_BITS(i) ((i) < 8 || (i) == 28 ? 0 : ((i) - 4) >> 2)
+#define DEFL_DIST_BITS(i) ((i) < 4 ? 0 : ((i) - 2) >> 1)
+
+static void defl_flush_out(UZLIB_COMP *c)
+{
+   if (c->outlen > 0) {
+      c->writeDest(c, c->outbuf, c->outlen);
+      c->outlen = 0;
+   }
+}
+
+/* write the given number of bits, least significant first */
+static void defl_put_bits(UZLIB_COMP *c, unsigned int bits, int nbits)
+{
+   c->outbits |= bits << c->noutbits;
+   c->noutbits += nbits;
+   while (c->noutbits >= 8) {
+      c->outbuf[c->outlen++] = c->outbits;
+      if (c->outlen == sizeof(c->outbuf)) {
+         defl_flush_out(c);
+      }
+      c->outbits >>= 8;
+      c->noutbits -= 8;
+   }
+}
+
+/* huffman codes are packed starting with their most significant bit */
+static void defl_put_code(UZLIB_COMP *c, unsigned int code, int nbits)
+{
+   unsigned int rev = 0;
+   for (int i = 0; i < nbits; ++i) {
+      rev = (rev << 1) | (code & 1);
+      code >>= 1;
+   }
+   defl_put_bits(c, rev, nbits);
+}
+
+/* write a symbol of the literal/length alphabet */
+static void defl_put_lsym(UZLIB_COMP *c, unsigned int sym)
+{
+   if (sym < 144) {
+      defl_put_code(c, 0x30 + sym, 8);
+   } else if (sym < 256) {
+      defl_put_code(c, 0x190 + sym - 144, 9);
+   } else if (sym < 280) {
+      defl_put_code(c, sym - 256, 7);
+   } else {
+      defl_put_code(c, 0xc0 + sym - 280, 8);
+   }
+}
+
+void uzlib_defl_start_block(UZLIB_COMP *c, int final)
+{
+   defl_put_bits(c, final, 1);
+   defl_put_bits(c, 1, 2); /* BTYPE = 01, fixed huffman codes */
+}
+
+void uzlib_defl_finish_block(UZLIB_COMP *c)
+{
+   defl_put_lsym(c, 256);
+}
+
+/* pad to a byte boundary and pass all pending output on */
+void uzlib_defl_flush(UZLIB_COMP *c)
+{
+   if (c->noutbits > 0) {
+      defl_put_bits(c, 0, 8 - c->noutbits);
+   }
+   defl_flush_out(c);
+}
+
+void uzlib_defl_put_byte(UZLIB_COMP *c, unsigned char b)
+{
+   defl_put_bits(c, b, 8);
+}
+
+void uzlib_defl_literal(UZLIB_COMP *c, unsigned char b)
+{
+   defl_put_lsym(c, b);
+}
+
+void uzlib_defl_match(UZLIB_COMP *c, unsigned int distance, unsigned int len)
+{
+   int i;
+
+   /* length code is the last one whose base is not above len */
+   for (i = 28; defl_length_base[i] > len; --i) {
+   }
+   defl_put_lsym(c, 257 + i);
+   if (DEFL_LENGTH_BITS(i)) {
+      defl_put_bits(c, len - defl_length_base[i], DEFL_LENGTH_BITS(i));
+   }
+
+   /* likewise for the distance code, which is always 5 bits */
+   for (i = 29; defl_dist_base[i] > distance; --i) {
+   }
+   defl_put_code(c, i, 5);
+   if (DEFL_DIST_BITS(i)) {
+      defl_put_bits(c, distance - defl_dist_base[i], DEFL_DIST_BITS(i));
+   }
+}
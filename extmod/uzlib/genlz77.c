@@ -0,0 +1,262 @@
+/*
+ * genlz77  -  streaming LZ77 matcher and zlib/gzip framing for deflate
+ *
+ * Copyright (c) 2014-2016 by Paul Sokolovsky
+ *
+ * This software is provided 'as-is', without any express
+ * or implied warranty.  In no event will the authors be
+ * held liable for any damages arising from the use of
+ * this software.
+ *
+ * Permission is granted to anyone to use this software
+ * for any purpose, including commercial applications,
+ * and to alter it and redistribute it freely, subject to
+ * the following restrictions:
+ *
+ * 1. The origin of this software must not be
+ *    misrepresented; you must not claim that you
+ *    wrote the original software. If you use this
+ *    software in a product, an acknowledgment in
+ *    the product documentation would be appreciated
+ *    but is not required.
+ *
+ * 2. Altered source versions must be plainly marked
+ *    as such, and must not be misrepresented as
+ *    being the original software.
+ *
+ * 3. This notice may not be removed or altered from
+ *    any source distribution.
+ */
+
+#include <string.h>
+#include "tinf.h"
+
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+
+/* The window buffer holds two window sizes of input: the first half is
+ * history that matches may refer back to, and new input is added to the
+ * second half.  When the buffer is full it is slid down by one window size.
+ * Positions are stored in 16 bits with 0 meaning "no entry", so position 0
+ * can never be matched, which costs at most a few bytes of compression. */
+
+#define WIN_SIZE(c) (1u << (c)->win_bits)
+#define HASH_BITS(c) ((c)->win_bits - 1)
+
+/* length of the hash chains searched for each compression level */
+static const unsigned short lz77_max_chain[10] = {
+   0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096
+};
+
+static unsigned int lz77_hash(UZLIB_COMP *c, const unsigned char *p)
+{
+   uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+   return (v * 0x9e3779b1u) >> (32 - HASH_BITS(c));
+}
+
+unsigned int uzlib_compress_mem_size(unsigned int win_bits)
+{
+   unsigned int w = 1u << win_bits;
+   return w / 2 * sizeof(unsigned short) /* hash_head */
+      + w * sizeof(unsigned short)       /* hash_prev */
+      + 2 * w;                           /* window */
+}
+
+static void lz77_slide(UZLIB_COMP *c)
+{
+   unsigned int w = WIN_SIZE(c);
+   unsigned int i;
+
+   memcpy(c->window, c->window + w, w);
+   c->win_len -= w;
+   c->win_pos -= w;
+
+   for (i = 0; i < w / 2; ++i) {
+      unsigned int v = c->hash_head[i];
+      c->hash_head[i] = v >= w ? v - w : 0;
+   }
+   for (i = 0; i < w; ++i) {
+      unsigned int v = c->hash_prev[i];
+      c->hash_prev[i] = v >= w ? v - w : 0;
+   }
+}
+
+/* insert the string at pos into the hash table and return the previous
+   head of its chain */
+static unsigned int lz77_insert(UZLIB_COMP *c, unsigned int pos)
+{
+   unsigned int h = lz77_hash(c, c->window + pos);
+   unsigned int cand = c->hash_head[h];
+   c->hash_prev[pos & (WIN_SIZE(c) - 1)] = cand;
+   c->hash_head[h] = pos;
+   return cand;
+}
+
+/* emit symbols for the input up to the given position */
+static void lz77_process(UZLIB_COMP *c, unsigned int end)
+{
+   unsigned int wmask = WIN_SIZE(c) - 1;
+   unsigned char *win = c->window;
+
+   while (c->win_pos < end) {
+      unsigned int pos = c->win_pos;
+      unsigned int avail = c->win_len - pos;
+      unsigned int best_len = 0;
+      unsigned int best_dist = 0;
+
+      if (avail >= MIN_MATCH && pos > 0) {
+         unsigned int cand = lz77_insert(c, pos);
+         unsigned int max_len = avail < MAX_MATCH ? avail : MAX_MATCH;
+         unsigned int chain = c->max_chain;
+
+         /* candidates further back than the window size may have had
+            their hash_prev entry reused, so the walk stops there */
+         while (cand != 0 && chain-- > 0 && pos - cand <= wmask) {
+            const unsigned char *p = win + pos;
+            const unsigned char *q = win + cand;
+            if (q[best_len] == p[best_len] && q[0] == p[0]) {
+               unsigned int len = 1;
+               while (len < max_len && q[len] == p[len]) {
+                  ++len;
+               }
+               if (len > best_len) {
+                  best_len = len;
+                  best_dist = pos - cand;
+                  if (len == max_len) {
+                     break;
+                  }
+               }
+            }
+            unsigned int next = c->hash_prev[cand & wmask];
+            if (next >= cand) {
+               break;
+            }
+            cand = next;
+         }
+      }
+
+      if (best_len >= MIN_MATCH) {
+         uzlib_defl_match(c, best_dist, best_len);
+         /* the rest of the matched string goes into the hash table so
+            later input can refer to it */
+         unsigned int stop = pos + best_len;
+         if (stop > c->win_len - MIN_MATCH + 1) {
+            stop = c->win_len - MIN_MATCH + 1;
+         }
+         for (unsigned int i = pos + 1; i < stop; ++i) {
+            lz77_insert(c, i);
+         }
+         c->win_pos = pos + best_len;
+      } else {
+         uzlib_defl_literal(c, win[pos]);
+         c->win_pos = pos + 1;
+      }
+   }
+}
+
+static void put_uint32_be(UZLIB_COMP *c, uint32_t v)
+{
+   for (int i = 24; i >= 0; i -= 8) {
+      uzlib_defl_put_byte(c, v >> i);
+   }
+}
+
+static void put_uint32_le(UZLIB_COMP *c, uint32_t v)
+{
+   for (int i = 0; i < 32; i += 8) {
+      uzlib_defl_put_byte(c, v >> i);
+   }
+}
+
+void uzlib_compress_init(UZLIB_COMP *c, void *mem, unsigned int win_bits, int level, int checksum_type)
+{
+   unsigned int w = 1u << win_bits;
+
+   c->outlen = 0;
+   c->outbits = 0;
+   c->noutbits = 0;
+
+   c->hash_head = mem;
+   c->hash_prev = c->hash_head + w / 2;
+   c->window = (unsigned char *)(c->hash_prev + w);
+   memset(c->hash_head, 0, w / 2 * sizeof(unsigned short));
+   c->win_bits = win_bits;
+   c->win_len = 0;
+   c->win_pos = 0;
+   c->max_chain = lz77_max_chain[level];
+
+   c->checksum_type = checksum_type;
+   c->total_len = 0;
+
+   if (checksum_type == TINF_CHKSUM_ADLER) {
+      unsigned char cmf = ((win_bits - 8) << 4) | 8;
+      unsigned char flg = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+      flg += 31 - (cmf * 256 + flg) % 31;
+      uzlib_defl_put_byte(c, cmf);
+      uzlib_defl_put_byte(c, flg);
+      c->checksum = 1;
+   } else if (checksum_type == TINF_CHKSUM_CRC) {
+      /* magic, method, no flags, no mtime, no extra flags, unknown OS */
+      static const unsigned char gzip_header[10] = {
+         0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff
+      };
+      for (int i = 0; i < 10; ++i) {
+         uzlib_defl_put_byte(c, gzip_header[i]);
+      }
+      c->checksum = 0xffffffff;
+   }
+
+   uzlib_defl_start_block(c, 0);
+}
+
+void uzlib_compress_write(UZLIB_COMP *c, const void *data, unsigned int len)
+{
+   const unsigned char *src = data;
+   unsigned int w = WIN_SIZE(c);
+
+   if (c->checksum_type == TINF_CHKSUM_ADLER) {
+      c->checksum = uzlib_adler32(data, len, c->checksum);
+   } else if (c->checksum_type == TINF_CHKSUM_CRC) {
+      c->checksum = uzlib_crc32(data, len, c->checksum);
+   }
+   c->total_len += len;
+
+   while (len > 0) {
+      if (c->win_len == 2 * w) {
+         lz77_slide(c);
+      }
+      unsigned int n = 2 * w - c->win_len;
+      if (n > len) {
+         n = len;
+      }
+      memcpy(c->window + c->win_len, src, n);
+      c->win_len += n;
+      src += n;
+      len -= n;
+
+      /* keep enough lookahead that every match can reach full length */
+      if (c->win_len > MAX_MATCH) {
+         lz77_process(c, c->win_len - MAX_MATCH);
+      }
+   }
+}
+
+void uzlib_compress_finish(UZLIB_COMP *c)
+{
+   lz77_process(c, c->win_len);
+
+   /* the block is ended and followed by an empty final block, because
+      whether a block is the last one must be known when it is started */
+   uzlib_defl_finish_block(c);
+   uzlib_defl_start_block(c, 1);
+   uzlib_defl_finish_block(c);
+   uzlib_defl_flush(c);
+
+   if (c->checksum_type == TINF_CHKSUM_ADLER) {
+      put_uint32_be(c, c->checksum);
+   } else if (c->checksum_type == TINF_CHKSUM_CRC) {
+      put_uint32_le(c, ~c->checksum);
+      put_uint32_le(c, c->total_len);
+   }
+   uzlib_defl_flush(c);
+}
@@ -39,11 +39,23 @@ extern "C" {
 #define TINF_CHKSUM_ADLER 1
 #define TINF_CHKSUM_CRC   2
 
+/* Number of bits of a huffman code resolved by one lookup in the fast
+   decoding table of each tree, or 0 to decode bit by bit and save the
+   memory of the tables (2 bytes per entry, 2 trees per TINF_DATA) */
+#ifndef TINF_FAST_BITS
+#define TINF_FAST_BITS 0
+#endif
+
 /* data structures */
 
 typedef struct {
    unsigned short table[16];  /* table of code length counts */
    unsigned short trans[288]; /* code -> symbol translation table */
+#if TINF_FAST_BITS
+   /* next TINF_FAST_BITS input bits -> (symbol << 4) | code length,
+      or 0 if the code is longer */
+   unsigned short fast[1 << TINF_FAST_BITS];
+#endif
 } TINF_TREE;
 
 struct TINF_DATA;
@@ -81,6 +93,33 @@ typedef struct TINF_DATA {
    TINF_TREE dtree; /* dynamic distance tree */
 } TINF_DATA;
 
+struct UZLIB_COMP;
+typedef struct UZLIB_COMP {
+   /* Called with each chunk of compressed output */
+   void (*writeDest)(struct UZLIB_COMP *c, const unsigned char *buf, unsigned int len);
+
+   /* Output not yet passed to writeDest */
+   unsigned char outbuf[64];
+   unsigned int outlen;
+   unsigned int outbits;
+   int noutbits;
+
+   /* LZ77 state: window holds up to two window sizes of input, hash_head
+      and hash_prev chain together earlier positions with the same hash */
+   unsigned char *window;
+   unsigned short *hash_head;
+   unsigned short *hash_prev;
+   unsigned int win_bits;
+   unsigned int win_len;
+   unsigned int win_pos;
+   unsigned int max_chain;
+
+   /* Accumulating checksum of the uncompressed data */
+   uint32_t checksum;
+   char checksum_type;
+   uint32_t total_len;
+} UZLIB_COMP;
+
 #define TINF_PUT(d, c) \
     { \
         *d->dest++ = c; \
@@ -101,7 +140,19 @@ int TINFCC uzlib_gzip_parse_header(TINF_DATA *d);
 
 /* Compression API */
 
-void TINFCC uzlib_compress(void *data, const uint8_t *src, unsigned slen);
+/* checksum_type selects framing: TINF_CHKSUM_NONE for raw deflate,
+   TINF_CHKSUM_ADLER for zlib, TINF_CHKSUM_CRC for gzip */
+unsigned int TINFCC uzlib_compress_mem_size(unsigned int win_bits);
+void TINFCC uzlib_compress_init(UZLIB_COMP *c, void *mem, unsigned int win_bits, int level, int checksum_type);
+void TINFCC uzlib_compress_write(UZLIB_COMP *c, const void *data, unsigned int len);
+void TINFCC uzlib_compress_finish(UZLIB_COMP *c);
+
+void TINFCC uzlib_defl_start_block(UZLIB_COMP *c, int final);
+void TINFCC uzlib_defl_finish_block(UZLIB_COMP *c);
+void TINFCC uzlib_defl_flush(UZLIB_COMP *c);
+void TINFCC uzlib_defl_put_byte(UZLIB_COMP *c, unsigned char b);
+void TINFCC uzlib_defl_literal(UZLIB_COMP *c, unsigned char b);
+void TINFCC uzlib_defl_match(UZLIB_COMP *c, unsigned int distance, unsigned int len);
 
 /* Checksum API */
 
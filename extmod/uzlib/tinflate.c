@@ -116,6 +116,40 @@ static void tinf_build_bits_base(unsigned char *bits, unsigned short *base, int
 }
 #endif
 
+#if TINF_FAST_BITS
+/* fill the fast decoding table from the code length counts and the
+   symbols sorted by code */
+static void tinf_build_fast(TINF_TREE *t)
+{
+   unsigned int len, i, idx = 0, code = 0;
+
+   for (i = 0; i < (1 << TINF_FAST_BITS); ++i) t->fast[i] = 0;
+
+   for (len = 1; len <= TINF_FAST_BITS; ++len)
+   {
+      for (i = 0; i < t->table[len]; ++i, ++code)
+      {
+         unsigned int rev = 0, c = code, k;
+
+         /* codes are read starting with their most significant bit */
+         for (k = 0; k < len; ++k)
+         {
+            rev = (rev << 1) | (c & 1);
+            c >>= 1;
+         }
+
+         /* every input with these low bits decodes to this symbol */
+         for (k = rev; k < (1 << TINF_FAST_BITS); k += 1 << len)
+         {
+            t->fast[k] = (t->trans[idx + i] << 4) | len;
+         }
+      }
+      idx += t->table[len];
+      code <<= 1;
+   }
+}
+#endif
+
 /* build the fixed huffman trees */
 static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
 {
@@ -139,6 +173,11 @@ static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
    dt->table[5] = 32;
 
    for (i = 0; i < 32; ++i) dt->trans[i] = i;
+
+#if TINF_FAST_BITS
+   tinf_build_fast(lt);
+   tinf_build_fast(dt);
+#endif
 }
 
 /* given an array of code lengths, build a tree */
@@ -167,6 +206,10 @@ static void tinf_build_tree(TINF_TREE *t, const unsigned char *lengths, unsigned
    {
       if (lengths[i]) t->trans[offs[lengths[i]]++] = i;
    }
+
+#if TINF_FAST_BITS
+   tinf_build_fast(t);
+#endif
 }
 
 /* ---------------------- *
@@ -201,22 +244,30 @@ uint32_t tinf_get_be_uint32(TINF_DATA *d)
     return val;
 }
 
+/* The low bitcount bits of tag are input not yet used, and the bits above
+ * them are zero.  A byte is only added when the bits there are not enough,
+ * so no input beyond the end of the compressed data is ever read, and
+ * between calls fewer than 8 bits (part of the last byte) are held. */
+
+/* add the next byte of the source stream to the tag */
+static void tinf_add_byte(TINF_DATA *d)
+{
+   d->tag |= (unsigned int)uzlib_get_byte(d) << d->bitcount;
+   d->bitcount += 8;
+}
+
 /* get one bit from source stream */
 static int tinf_getbit(TINF_DATA *d)
 {
    unsigned int bit;
 
    /* check if tag is empty */
-   if (!d->bitcount--)
-   {
-      /* load next tag */
-      d->tag = uzlib_get_byte(d);
-      d->bitcount = 7;
-   }
+   if (!d->bitcount) tinf_add_byte(d);
 
    /* shift bit out of tag */
    bit = d->tag & 0x01;
    d->tag >>= 1;
+   d->bitcount--;
 
    return bit;
 }
@@ -224,17 +275,13 @@ static int tinf_getbit(TINF_DATA *d)
 /* read a num bit value from a stream and add base */
 static unsigned int tinf_read_bits(TINF_DATA *d, int num, int base)
 {
-   unsigned int val = 0;
+   unsigned int val;
 
-   /* read num bits */
-   if (num)
-   {
-      unsigned int limit = 1 << (num);
-      unsigned int mask;
+   while (d->bitcount < (unsigned int)num) tinf_add_byte(d);
 
-      for (mask = 1; mask < limit; mask *= 2)
-         if (tinf_getbit(d)) val += mask;
-   }
+   val = d->tag & ((1 << num) - 1);
+   d->tag >>= num;
+   d->bitcount -= num;
 
    return val + base;
 }
@@ -244,6 +291,26 @@ static int tinf_decode_symbol(TINF_DATA *d, TINF_TREE *t)
 {
    int sum = 0, cur = 0, len = 0;
 
+#if TINF_FAST_BITS
+   /* Missing input bits are zero in the lookup, which still gives the
+      right entry if its code is no longer than the bits there are.
+      Otherwise the code needs more input, just as bit by bit decoding
+      would, or is longer than the table covers. */
+   for (;;)
+   {
+      unsigned int e = t->fast[d->tag & ((1 << TINF_FAST_BITS) - 1)];
+      unsigned int n = e & 15;
+      if (n == 0) break;
+      if (n <= d->bitcount)
+      {
+         d->tag >>= n;
+         d->bitcount -= n;
+         return e >> 4;
+      }
+      tinf_add_byte(d);
+   }
+#endif
+
    /* get more bits while code value is above sum */
    do {
 
@@ -358,10 +425,16 @@ static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
 
         /* substring from sliding dictionary */
         sym -= 257;
+        if (sym >= 29) {
+            return TINF_DATA_ERROR;
+        }
         /* possibly get more bits from length code */
         d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
 
         dist = tinf_decode_symbol(d, dt);
+        if (dist >= 30) {
+            return TINF_DATA_ERROR;
+        }
         /* possibly get more bits from distance code */
         offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
         if (d->dict_ring) {
@@ -380,17 +453,27 @@ static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
         }
     }
 
-    /* copy next byte from dict substring */
+    /* copy as much of the dict substring as fits in the output; the caller
+       counts one byte of it */
+    unsigned int n = d->curlen < d->destSize ? d->curlen : d->destSize;
+    if (n == 0) {
+        return TINF_DATA_ERROR;
+    }
+    d->curlen -= n;
+    d->destSize -= n - 1;
     if (d->dict_ring) {
-        TINF_PUT(d, d->dict_ring[d->lzOff]);
-        if ((unsigned)++d->lzOff == d->dict_size) {
-            d->lzOff = 0;
-        }
+        do {
+            TINF_PUT(d, d->dict_ring[d->lzOff]);
+            if ((unsigned)++d->lzOff == d->dict_size) {
+                d->lzOff = 0;
+            }
+        } while (--n);
     } else {
-        d->dest[0] = d->dest[d->lzOff];
-        d->dest++;
+        do {
+            d->dest[0] = d->dest[d->lzOff];
+            d->dest++;
+        } while (--n);
     }
-    d->curlen--;
     return TINF_OK;
 }
 
@@ -412,6 +495,7 @@ static int tinf_inflate_uncompressed_block(TINF_DATA *d)
         d->curlen = length + 1;
 
         /* make sure we start next block on a byte boundary */
+        d->tag = 0;
         d->bitcount = 0;
     }
 
@@ -445,6 +529,7 @@ void uzlib_init(void)
 /* initialize decompression structure */
 void uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen)
 {
+   d->tag = 0;
    d->bitcount = 0;
    d->bfinal = 0;
    d->btype = -1;
@@ -341,6 +341,8 @@ STATIC mp_obj_t native_vfs_stat(mp_obj_t vfs_in, mp_obj_t path_in) {
 		// stat root directory
 		buf.st_size = 0;
 		buf.st_atime = 946684800; // Jan 1, 2000
+		buf.st_mtime = buf.st_atime;
+		buf.st_ctime = buf.st_atime;
 		buf.st_mode = MP_S_IFDIR;
 	} else {
 		int res = stat(path, &buf);
@@ -359,8 +361,8 @@ STATIC mp_obj_t native_vfs_stat(mp_obj_t vfs_in, mp_obj_t path_in) {
 	t->items[5] = MP_OBJ_NEW_SMALL_INT(0); // st_gid
 	t->items[6] = MP_OBJ_NEW_SMALL_INT(buf.st_size); // st_size
 	t->items[7] = MP_OBJ_NEW_SMALL_INT(buf.st_atime); // st_atime
-	t->items[8] = MP_OBJ_NEW_SMALL_INT(buf.st_atime); // st_mtime
-	t->items[9] = MP_OBJ_NEW_SMALL_INT(buf.st_atime); // st_ctime
+	t->items[8] = MP_OBJ_NEW_SMALL_INT(buf.st_mtime); // st_mtime
+	t->items[9] = MP_OBJ_NEW_SMALL_INT(buf.st_ctime); // st_ctime
 
 	return MP_OBJ_FROM_PTR(t);
 }
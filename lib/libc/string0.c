@@ -115,13 +115,31 @@ int memcmp(const void *s1, const void *s2, size_t n) {
 }
 
 void *memchr(const void *s, int c, size_t n) {
-    if (n != 0) {
-        const unsigned char *p = s;
+    const unsigned char *p = s;
+    c = (unsigned char)c;
 
-        do {
-            if (*p++ == c)
-                return ((void *)(p - 1));
-        } while (--n != 0);
+    // check bytes until the pointer is word aligned
+    for (; n != 0 && ((uintptr_t)p & 3); n--, p++) {
+        if (*p == c) {
+            return (void*)p;
+        }
+    }
+
+    // skip over whole words that don't contain c, using the standard
+    // "has zero byte" trick on the word xor'd with c in every byte
+    uint32_t mask = (uint32_t)(unsigned char)c * 0x01010101u;
+    for (; n >= 4; n -= 4, p += 4) {
+        uint32_t w = *(const uint32_t*)p ^ mask;
+        if ((w - 0x01010101) & ~w & 0x80808080) {
+            break;
+        }
+    }
+
+    // check the remaining bytes, including the word that matched
+    for (; n != 0; n--, p++) {
+        if (*p == c) {
+            return (void*)p;
+        }
     }
     return 0;
 }
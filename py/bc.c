@@ -286,7 +286,7 @@ continue2:;
     dump_args(code_state->state, n_state);
 }
 
-#if MICROPY_PERSISTENT_CODE_LOAD || MICROPY_PERSISTENT_CODE_SAVE
+#if MICROPY_PERSISTENT_CODE_LOAD || MICROPY_PERSISTENT_CODE_SAVE || MICROPY_COMP_STREAMING
 
 // The following table encodes the number of bytes that a specific opcode
 // takes up.  There are 3 special opcodes that always have an extra byte:
@@ -414,4 +414,4 @@ uint mp_opcode_format(const byte *ip, size_t *opcode_size) {
     return f;
 }
 
-#endif // MICROPY_PERSISTENT_CODE_LOAD || MICROPY_PERSISTENT_CODE_SAVE
+#endif // MICROPY_PERSISTENT_CODE_LOAD || MICROPY_PERSISTENT_CODE_SAVE || MICROPY_COMP_STREAMING
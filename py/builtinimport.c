@@ -220,6 +220,19 @@ STATIC void do_load(mp_obj_t module_obj, vstr_t *file) {
     }
     #endif
 
+    // If we cache compiled scripts then load the file from the cache, or else
+    // compile it and update the cache, and execute it.
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    if (MP_STATE_VM(persistent_code_cache)) {
+        mp_raw_code_t *raw_code = mp_raw_code_load_py_cached(file_str);
+        #if MICROPY_PY___FILE__
+        mp_store_attr(module_obj, MP_QSTR___file__, MP_OBJ_NEW_QSTR(qstr_from_str(file_str)));
+        #endif
+        do_execute_raw_code(module_obj, raw_code);
+        return;
+    }
+    #endif
+
     // If we can compile scripts then load the file and compile and execute it.
     #if MICROPY_ENABLE_COMPILER
     {
@@ -34,7 +34,11 @@
 #include "py/emit.h"
 #include "py/compile.h"
 #include "py/runtime.h"
+#include "py/smallint.h"
+#include "py/objtuple.h"
 #include "py/asmbase.h"
+#include "py/bc.h"
+#include "py/bc0.h"
 
 #if MICROPY_ENABLE_COMPILER
 
@@ -118,6 +122,10 @@ typedef struct _compiler_t {
     uint8_t is_repl;
     uint8_t pass; // holds enum type pass_kind_t
     uint8_t have_star;
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    uint8_t iter_builtin_rebound; // set if enumerate/zip may be rebound in this unit
+    uint8_t iter_builtin_lowered; // set if a loop in a function was compiled without tuples
+    #endif
 
     // try to keep compiler clean from nlr
     mp_obj_t compile_error; // set to an exception object if there's an error
@@ -236,8 +244,19 @@ STATIC void compile_load_id(compiler_t *comp, qstr qst) {
     }
 }
 
+#if MICROPY_COMP_FOR_ENUMERATE_ZIP
+STATIC void compile_note_modification(compiler_t *comp, qstr qst) {
+    if (qst == MP_QSTR_enumerate || qst == MP_QSTR_zip) {
+        comp->iter_builtin_rebound = true;
+    }
+}
+#else
+#define compile_note_modification(comp, qst) (void)(qst)
+#endif
+
 STATIC void compile_store_id(compiler_t *comp, qstr qst) {
     if (comp->pass == MP_PASS_SCOPE) {
+        compile_note_modification(comp, qst);
         mp_emit_common_get_id_for_modification(comp->scope_cur, qst);
     } else {
         #if NEED_METHOD_TABLE
@@ -250,6 +269,7 @@ STATIC void compile_store_id(compiler_t *comp, qstr qst) {
 
 STATIC void compile_delete_id(compiler_t *comp, qstr qst) {
     if (comp->pass == MP_PASS_SCOPE) {
+        compile_note_modification(comp, qst);
         mp_emit_common_get_id_for_modification(comp->scope_cur, qst);
     } else {
         #if NEED_METHOD_TABLE
@@ -260,7 +280,180 @@ STATIC void compile_delete_id(compiler_t *comp, qstr qst) {
     }
 }
 
+#if MICROPY_COMP_CONST_LITERAL
+STATIC mp_obj_t get_const_object(mp_parse_node_struct_t *pns);
+STATIC bool c_const_literal(compiler_t *comp, mp_parse_node_t pn, bool in_const, mp_obj_t *obj);
+
+// Check (if obj is NULL) or build (if obj is non-NULL) a constant tuple made of
+// the item pn (if not null) followed by the nodes in pns_list (if not NULL).
+STATIC bool c_const_literal_tuple(compiler_t *comp, mp_parse_node_t pn, mp_parse_node_struct_t *pns_list, bool in_const, mp_obj_t *obj) {
+    size_t n_list = pns_list == NULL ? 0 : MP_PARSE_NODE_STRUCT_NUM_NODES(pns_list);
+    mp_obj_tuple_t *tuple = NULL;
+    if (obj != NULL) {
+        *obj = mp_obj_new_tuple(!MP_PARSE_NODE_IS_NULL(pn) + n_list, NULL);
+        tuple = MP_OBJ_TO_PTR(*obj);
+    }
+    size_t i = 0;
+    if (!MP_PARSE_NODE_IS_NULL(pn)) {
+        if (!c_const_literal(comp, pn, in_const, tuple == NULL ? NULL : &tuple->items[i++])) {
+            return false;
+        }
+    }
+    for (size_t j = 0; j < n_list; j++) {
+        if (!c_const_literal(comp, pns_list->nodes[j], in_const, tuple == NULL ? NULL : &tuple->items[i++])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check or build a constant dict from a dict display; the dict is read-only.
+STATIC bool c_const_literal_dict(compiler_t *comp, mp_parse_node_t pn, mp_obj_t *obj) {
+    mp_parse_node_t pn_first = MP_PARSE_NODE_NULL;
+    mp_parse_node_t *nodes = NULL;
+    size_t n = 0;
+    if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_dictorsetmaker_item)) {
+        pn_first = pn;
+    } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_dictorsetmaker)) {
+        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t*)pn;
+        if (!MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_dictorsetmaker_list)) {
+            // a comprehension
+            return false;
+        }
+        pn_first = pns->nodes[0];
+        n = mp_parse_node_extract_list(&((mp_parse_node_struct_t*)pns->nodes[1])->nodes[0], PN_dictorsetmaker_list2, &nodes);
+    } else if (!MP_PARSE_NODE_IS_NULL(pn)) {
+        // a set with one element
+        return false;
+    }
+    mp_obj_t *table = NULL;
+    if (obj != NULL) {
+        table = m_new(mp_obj_t, 2 * (!MP_PARSE_NODE_IS_NULL(pn_first) + n));
+    }
+    for (size_t i = 0; i < !MP_PARSE_NODE_IS_NULL(pn_first) + n; i++) {
+        mp_parse_node_t pn_item = i == 0 ? pn_first : nodes[i - 1];
+        if (!MP_PARSE_NODE_IS_STRUCT_KIND(pn_item, PN_dictorsetmaker_item)) {
+            // a set, or a mixed dict/set display
+            return false;
+        }
+        mp_parse_node_struct_t *pns_item = (mp_parse_node_struct_t*)pn_item;
+        if (!c_const_literal(comp, pns_item->nodes[0], true, table == NULL ? NULL : &table[2 * i])
+            || !c_const_literal(comp, pns_item->nodes[1], true, table == NULL ? NULL : &table[2 * i + 1])) {
+            return false;
+        }
+    }
+    if (obj != NULL) {
+        *obj = mp_obj_new_dict_fixed(!MP_PARSE_NODE_IS_NULL(pn_first) + n, table);
+    }
+    return true;
+}
+
+// Check or build a constant literal: a number, string, bytes, None, True, False,
+// Ellipsis, or a tuple of these.  If in_const is true then this is the argument
+// of const() and dict displays (which become read-only dicts) are also allowed.
+STATIC bool c_const_literal(compiler_t *comp, mp_parse_node_t pn, bool in_const, mp_obj_t *obj) {
+    mp_obj_t o = MP_OBJ_NULL;
+    if (MP_PARSE_NODE_IS_SMALL_INT(pn)) {
+        mp_int_t arg = MP_PARSE_NODE_LEAF_SMALL_INT(pn);
+        #if MICROPY_DYNAMIC_COMPILER
+        mp_uint_t sign_mask = -(1 << (mp_dynamic_compiler.small_int_bits - 1));
+        if (!((arg & sign_mask) == 0 || (arg & sign_mask) == sign_mask)) {
+            // integer doesn't fit in target runtime's small-int
+            o = obj == NULL ? mp_const_none : mp_obj_new_int_from_ll(arg);
+        } else
+        #endif
+        {
+            o = MP_OBJ_NEW_SMALL_INT(arg);
+        }
+    } else if (MP_PARSE_NODE_IS_LEAF(pn)) {
+        uintptr_t arg = MP_PARSE_NODE_LEAF_ARG(pn);
+        switch (MP_PARSE_NODE_LEAF_KIND(pn)) {
+            case MP_PARSE_NODE_STRING:
+                o = MP_OBJ_NEW_QSTR(arg);
+                break;
+            case MP_PARSE_NODE_BYTES:
+                if (obj != NULL) {
+                    size_t len;
+                    const byte *data = qstr_data(arg, &len);
+                    o = mp_obj_new_bytes(data, len);
+                }
+                break;
+            case MP_PARSE_NODE_TOKEN:
+                if (arg == MP_TOKEN_KW_NONE) {
+                    o = mp_const_none;
+                } else if (arg == MP_TOKEN_KW_FALSE) {
+                    o = mp_const_false;
+                } else if (arg == MP_TOKEN_KW_TRUE) {
+                    o = mp_const_true;
+                } else if (arg == MP_TOKEN_ELLIPSIS) {
+                    o = MP_OBJ_FROM_PTR(&mp_const_ellipsis_obj);
+                } else {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    } else {
+        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t*)pn;
+        if (MP_PARSE_NODE_STRUCT_KIND(pns) == PN_const_object) {
+            o = get_const_object(pns);
+        } else if (MP_PARSE_NODE_STRUCT_KIND(pns) == PN_atom_paren) {
+            if (MP_PARSE_NODE_IS_NULL(pns->nodes[0])) {
+                // an empty tuple
+                o = mp_const_empty_tuple;
+            } else if (!MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[0], PN_testlist_comp)) {
+                // a parenthesised expression
+                return c_const_literal(comp, pns->nodes[0], in_const, obj);
+            } else {
+                pns = (mp_parse_node_struct_t*)pns->nodes[0];
+                mp_parse_node_t pn_first = MP_PARSE_NODE_NULL;
+                mp_parse_node_struct_t *pns_list = pns;
+                if (MP_PARSE_NODE_IS_STRUCT(pns->nodes[1])) {
+                    mp_parse_node_struct_t *pns2 = (mp_parse_node_struct_t*)pns->nodes[1];
+                    if (MP_PARSE_NODE_STRUCT_KIND(pns2) == PN_testlist_comp_3b) {
+                        // tuple of one item, with trailing comma
+                        pn_first = pns->nodes[0];
+                        pns_list = NULL;
+                    } else if (MP_PARSE_NODE_STRUCT_KIND(pns2) == PN_testlist_comp_3c) {
+                        // tuple of many items
+                        pn_first = pns->nodes[0];
+                        pns_list = pns2;
+                    } else if (MP_PARSE_NODE_STRUCT_KIND(pns2) == PN_comp_for) {
+                        // generator expression
+                        return false;
+                    }
+                }
+                return c_const_literal_tuple(comp, pn_first, pns_list, in_const, obj);
+            }
+        } else if (in_const && MP_PARSE_NODE_STRUCT_KIND(pns) == PN_atom_brace) {
+            return c_const_literal_dict(comp, pns->nodes[0], obj);
+        } else {
+            return false;
+        }
+    }
+    if (obj != NULL) {
+        *obj = o;
+    }
+    return true;
+}
+#endif
+
 STATIC void c_tuple(compiler_t *comp, mp_parse_node_t pn, mp_parse_node_struct_t *pns_list) {
+    #if MICROPY_COMP_CONST_LITERAL
+    if ((!MP_PARSE_NODE_IS_NULL(pn) || pns_list != NULL)
+        && c_const_literal_tuple(comp, pn, pns_list, false, NULL)) {
+        // a tuple of constants, so load it as a single constant object
+        // (only create the actual object on the last pass)
+        mp_obj_t o = mp_const_none;
+        if (comp->pass == MP_PASS_EMIT) {
+            c_const_literal_tuple(comp, pn, pns_list, false, &o);
+        }
+        EMIT_ARG(load_const_obj, o);
+        return;
+    }
+    #endif
+
     int total = 0;
     if (!MP_PARSE_NODE_IS_NULL(pn)) {
         compile_node(comp, pn);
@@ -1137,6 +1330,10 @@ STATIC void compile_import_from(compiler_t *comp, mp_parse_node_struct_t *pns) {
         qstr dummy_q;
         do_import_name(comp, pn_import_source, &dummy_q);
         EMIT(import_star);
+        #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+        // an import-star can bind any name
+        comp->iter_builtin_rebound = true;
+        #endif
 
     } else {
         EMIT_ARG(load_const_small_int, import_level);
@@ -1438,6 +1635,140 @@ STATIC void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
     }
 }
 
+#if MICROPY_COMP_FOR_ENUMERATE_ZIP
+// Checks if a for-statement has the form "for a, b in enumerate(x[, start])" or
+// "for a, b in zip(x, y)", where a and b are distinct names and start is a small
+// int.  Returns the qstr of the builtin (or MP_QSTR_NULL) and fills in the args.
+STATIC qstr compile_for_stmt_enumerate_zip_form(mp_parse_node_struct_t *pns, mp_parse_node_t **args, mp_int_t *start) {
+    if (!MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[0], PN_exprlist)
+        || !MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_atom_expr_normal)) {
+        return MP_QSTR_NULL;
+    }
+    mp_parse_node_struct_t *pns_var = (mp_parse_node_struct_t*)pns->nodes[0];
+    if (MP_PARSE_NODE_STRUCT_NUM_NODES(pns_var) != 2
+        || !MP_PARSE_NODE_IS_ID(pns_var->nodes[0])
+        || !MP_PARSE_NODE_IS_ID(pns_var->nodes[1])
+        || MP_PARSE_NODE_LEAF_ARG(pns_var->nodes[0]) == MP_PARSE_NODE_LEAF_ARG(pns_var->nodes[1])) {
+        return MP_QSTR_NULL;
+    }
+    mp_parse_node_struct_t *pns_it = (mp_parse_node_struct_t*)pns->nodes[1];
+    if (!MP_PARSE_NODE_IS_ID(pns_it->nodes[0])
+        || !MP_PARSE_NODE_IS_STRUCT_KIND(pns_it->nodes[1], PN_trailer_paren)) {
+        return MP_QSTR_NULL;
+    }
+    qstr fun = MP_PARSE_NODE_LEAF_ARG(pns_it->nodes[0]);
+    mp_parse_node_t pn_args = ((mp_parse_node_struct_t*)pns_it->nodes[1])->nodes[0];
+    int n_args = mp_parse_node_extract_list(&pn_args, PN_arglist, args);
+    for (int i = 0; i < n_args; i++) {
+        if (MP_PARSE_NODE_IS_STRUCT((*args)[i])) {
+            int k = MP_PARSE_NODE_STRUCT_KIND((mp_parse_node_struct_t*)(*args)[i]);
+            if (k == PN_arglist_star || k == PN_arglist_dbl_star || k == PN_argument) {
+                return MP_QSTR_NULL;
+            }
+        }
+    }
+    #if MICROPY_PY_BUILTINS_ENUMERATE
+    if (fun == MP_QSTR_enumerate) {
+        *start = 0;
+        if (n_args == 2) {
+            if (!MP_PARSE_NODE_IS_SMALL_INT((*args)[1])) {
+                return MP_QSTR_NULL;
+            }
+            *start = MP_PARSE_NODE_LEAF_SMALL_INT((*args)[1]);
+        }
+        if ((n_args == 1 || n_args == 2) && MP_SMALL_INT_FITS(*start - 1)) {
+            return fun;
+        }
+    }
+    #endif
+    if (fun == MP_QSTR_zip && n_args == 2) {
+        return fun;
+    }
+    return MP_QSTR_NULL;
+}
+
+// Compiles the loop without the intermediate enumerate/zip object and the tuple
+// it would allocate on each iteration.  The stack holds 4 slots that look like
+// an iter_buf to FOR_ITER, namely a NULL marker followed by the iterator:
+//     enumerate: [NULL, iter, None, counter]
+//     zip:       [NULL, iter_x, NULL, iter_y]
+// so break, continue and the end of iteration behave as for a normal for-loop.
+STATIC void compile_for_stmt_enumerate_zip(compiler_t *comp, mp_parse_node_struct_t *pns, qstr fun, mp_parse_node_t *args, mp_int_t start) {
+    mp_parse_node_struct_t *pns_var = (mp_parse_node_struct_t*)pns->nodes[0];
+    qstr var_a = MP_PARSE_NODE_LEAF_ARG(pns_var->nodes[0]);
+    qstr var_b = MP_PARSE_NODE_LEAF_ARG(pns_var->nodes[1]);
+
+    START_BREAK_CONTINUE_BLOCK
+    comp->break_label |= MP_EMIT_BREAK_FROM_FOR;
+
+    uint pop_label = comp_next_label(comp);
+    uint zip_end_label = 0;
+
+    EMIT(load_null);
+    if (fun == MP_QSTR_enumerate) {
+        compile_node(comp, args[0]);
+        EMIT_ARG(get_iter, false);
+        EMIT_ARG(load_const_tok, MP_TOKEN_KW_NONE);
+        EMIT_ARG(load_const_small_int, start - 1);
+
+        EMIT_ARG(label_assign, continue_label);
+        EMIT_ARG(load_const_small_int, 1);
+        EMIT_ARG(binary_op, MP_BINARY_OP_INPLACE_ADD);
+        EMIT_ARG(for_iter, pop_label);
+        compile_store_id(comp, var_b);
+        EMIT(dup_top);
+        compile_store_id(comp, var_a);
+    } else {
+        zip_end_label = comp_next_label(comp);
+
+        // evaluate both arguments before getting their iterators, like zip does
+        compile_node(comp, args[0]);
+        compile_node(comp, args[1]);
+        EMIT(rot_two);
+        EMIT_ARG(get_iter, false);
+        EMIT(rot_two);
+        EMIT_ARG(get_iter, false);
+        EMIT(load_null);
+        EMIT(rot_two);
+
+        // the first value is kept on the stack until the second one is fetched,
+        // its copy pads the top 4 slots to [NULL, iter_y, a, a] for FOR_ITER
+        EMIT_ARG(label_assign, continue_label);
+        EMIT_ARG(for_iter, pop_label);
+        EMIT(dup_top);
+        EMIT_ARG(for_iter, zip_end_label);
+        compile_store_id(comp, var_b);
+        compile_store_id(comp, var_a);
+        EMIT(pop_top);
+    }
+
+    compile_node(comp, pns->nodes[2]); // body
+    if (!EMIT(last_emit_was_return_value)) {
+        EMIT_ARG(jump, continue_label);
+    }
+
+    if (fun == MP_QSTR_zip) {
+        // iter_y is exhausted and FOR_ITER popped it along with the first value,
+        // leaving [NULL, iter_x] to discard
+        EMIT_ARG(label_assign, zip_end_label);
+        EMIT_ARG(adjust_stack_size, -2);
+        EMIT(pop_top);
+        EMIT(pop_top);
+        EMIT_ARG(adjust_stack_size, MP_OBJ_ITER_BUF_NSLOTS);
+    }
+
+    EMIT_ARG(label_assign, pop_label);
+    EMIT(for_iter_end);
+
+    // break/continue apply to outer loop (if any) in the else block
+    END_BREAK_CONTINUE_BLOCK
+
+    compile_node(comp, pns->nodes[3]); // else (may be empty)
+
+    EMIT_ARG(label_assign, break_label);
+}
+#endif
+
 STATIC void compile_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     // this bit optimises: for <x> in range(...), turning it into an explicitly incremented variable
     // this is actually slower, but uses no heap memory
@@ -1495,6 +1826,35 @@ STATIC void compile_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
         }
     }
 
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    // this bit optimises: for <a>, <b> in enumerate(...) / zip(...)
+    // it's only done for bytecode, and only if the builtin can't be rebound by
+    // this unit, which is known once all scopes have done MP_PASS_SCOPE
+    if (comp->scope_cur->emit_options == MP_EMIT_OPT_NONE
+        || comp->scope_cur->emit_options == MP_EMIT_OPT_BYTECODE) {
+        mp_parse_node_t *args;
+        mp_int_t start;
+        qstr fun = compile_for_stmt_enumerate_zip_form(pns, &args, &start);
+        if (fun != MP_QSTR_NULL) {
+            if (comp->pass == MP_PASS_SCOPE) {
+                // compile the generic loop below so all ids are registered, and
+                // reserve the extra label that the zip form needs
+                comp_next_label(comp);
+            } else {
+                id_info_t *id = scope_find(comp->scope_cur, fun);
+                if (!comp->iter_builtin_rebound && id != NULL
+                    && (id->kind == ID_INFO_KIND_GLOBAL_IMPLICIT || id->kind == ID_INFO_KIND_GLOBAL_EXPLICIT)) {
+                    if (comp->scope_cur->kind != SCOPE_MODULE) {
+                        comp->iter_builtin_lowered = true;
+                    }
+                    compile_for_stmt_enumerate_zip(comp, pns, fun, args, start);
+                    return;
+                }
+            }
+        }
+    }
+    #endif
+
     START_BREAK_CONTINUE_BLOCK
     comp->break_label |= MP_EMIT_BREAK_FROM_FOR;
 
@@ -1945,6 +2305,34 @@ STATIC void compile_expr_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
             }
         } else {
         plain_assign:
+            #if MICROPY_COMP_CONST_LITERAL
+            if (comp->scope_cur->kind == SCOPE_MODULE
+                && MP_PARSE_NODE_IS_ID(pns->nodes[0])
+                && MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_atom_expr_normal)) {
+                // handle X = const(<tuple or dict display>), which the parser left
+                // as is, by loading a pre-built constant object
+                mp_parse_node_struct_t *pns1 = (mp_parse_node_struct_t*)pns->nodes[1];
+                if (MP_PARSE_NODE_IS_ID(pns1->nodes[0])
+                    && MP_PARSE_NODE_LEAF_ARG(pns1->nodes[0]) == MP_QSTR_const
+                    && MP_PARSE_NODE_IS_STRUCT_KIND(pns1->nodes[1], PN_trailer_paren)) {
+                    mp_parse_node_t pn_arg = ((mp_parse_node_struct_t*)pns1->nodes[1])->nodes[0];
+                    if (MP_PARSE_NODE_IS_STRUCT_KIND(pn_arg, PN_atom_paren)
+                        || MP_PARSE_NODE_IS_STRUCT_KIND(pn_arg, PN_atom_brace)) {
+                        if (!c_const_literal(comp, pn_arg, true, NULL)) {
+                            compile_syntax_error(comp, pn_arg, "constant must be a literal");
+                            return;
+                        }
+                        mp_obj_t o = mp_const_none;
+                        if (comp->pass == MP_PASS_EMIT) {
+                            c_const_literal(comp, pn_arg, true, &o);
+                        }
+                        EMIT_ARG(load_const_obj, o);
+                        c_assign(comp, pns->nodes[0], ASSIGN_STORE);
+                        return;
+                    }
+                }
+            }
+            #endif
             if (MICROPY_COMP_DOUBLE_TUPLE_ASSIGN
                 && MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_testlist_star_expr)
                 && MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[0], PN_testlist_star_expr)
@@ -3354,10 +3742,15 @@ STATIC void scope_compute_things(scope_t *scope) {
     }
 }
 
-#if !MICROPY_PERSISTENT_CODE_SAVE
-STATIC
+#if MICROPY_COMP_STREAMING
+// flags passed in and out of compile_to_raw_code for a part of a module
+#define COMP_PART_ITER_REBOUND (1) // enumerate/zip may be rebound, so aren't lowered
+#define COMP_PART_ITER_LOWERED (2) // a loop in a function was lowered
 #endif
-mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, uint emit_opt, bool is_repl) {
+
+// part_flags is NULL, except when compiling a part of a streamed module,
+// in which case the parse tree is left for the caller to free
+STATIC mp_raw_code_t *compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, uint emit_opt, bool is_repl, uint8_t *part_flags) {
     // put compiler state on the stack, it's relatively small
     compiler_t comp_state = {0};
     compiler_t *comp = &comp_state;
@@ -3372,6 +3765,16 @@ mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_f
 
     // create standard emitter; it's used at least for MP_PASS_SCOPE
     emit_t *emit_bc = emit_bc_new();
+    #if MICROPY_COMP_STREAMING
+    if (part_flags != NULL) {
+        emit_bc_set_fixed_width_consts(emit_bc);
+        #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+        comp->iter_builtin_rebound = *part_flags & COMP_PART_ITER_REBOUND;
+        #endif
+    }
+    #else
+    (void)part_flags;
+    #endif
 
     // compile pass 1
     comp->emit = emit_bc;
@@ -3496,7 +3899,16 @@ mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_f
     #endif
 
     // free the parse tree
-    mp_parse_tree_clear(parse_tree);
+    if (part_flags == NULL || comp->compile_error != MP_OBJ_NULL) {
+        mp_parse_tree_clear(parse_tree);
+    }
+
+    #if MICROPY_COMP_STREAMING && MICROPY_COMP_FOR_ENUMERATE_ZIP
+    if (part_flags != NULL) {
+        *part_flags = (comp->iter_builtin_rebound ? COMP_PART_ITER_REBOUND : 0)
+            | (comp->iter_builtin_lowered ? COMP_PART_ITER_LOWERED : 0);
+    }
+    #endif
 
     // free the scopes
     mp_raw_code_t *outer_raw_code = module_scope->raw_code;
@@ -3513,10 +3925,327 @@ mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_f
     }
 }
 
+#if !MICROPY_PERSISTENT_CODE_SAVE
+STATIC
+#endif
+mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, uint emit_opt, bool is_repl) {
+    return compile_to_raw_code(parse_tree, source_file, emit_opt, is_repl, NULL);
+}
+
 mp_obj_t mp_compile(mp_parse_tree_t *parse_tree, qstr source_file, uint emit_opt, bool is_repl) {
     mp_raw_code_t *rc = mp_compile_to_raw_code(parse_tree, source_file, emit_opt, is_repl);
     // return function that executes the outer module
     return mp_make_function_from_raw_code(rc, MP_OBJ_NULL, MP_OBJ_NULL);
 }
 
+#if MICROPY_COMP_STREAMING
+
+// State for assembling the bytecode of a module from parts that are each
+// compiled from a group of its top-level statements.  Bytecode is position
+// independent (jumps are relative) and each part starts and ends with an empty
+// stack, so the parts can be concatenated, dropping the "return None" at the end
+// of each of them.  What needs fixing up is the line number info and the
+// indices into the constant table, which are written with a fixed width so they
+// can be renumbered in place.
+typedef struct _module_asm_t {
+    qstr source_file;
+    size_t n_state;
+    size_t n_exc_stack;
+    byte scope_flags;
+    vstr_t code; // bytecode following the cell list
+    #if MICROPY_ENABLE_SOURCE_LINE
+    vstr_t lines; // encoded line number info
+    size_t last_offset;
+    size_t last_line;
+    #endif
+    size_t n_obj;
+    size_t n_raw_code;
+    mp_uint_t *objs;
+    mp_uint_t *raw_codes;
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    // Loops over enumerate/zip in functions are lowered if no part so far may
+    // rebind these names.  A later part may still do so before the functions
+    // are called, so they are also compiled without lowering, and swapped in
+    // at the end if a part did rebind the names.
+    bool iter_builtin_rebound;
+    mp_uint_t *alt_raw_codes; // for each raw code, the alternative or 0
+    #endif
+} module_asm_t;
+
+STATIC bool is_make_function_op(byte op) {
+    return op == MP_BC_MAKE_FUNCTION || op == MP_BC_MAKE_FUNCTION_DEFARGS
+        || op == MP_BC_MAKE_CLOSURE || op == MP_BC_MAKE_CLOSURE_DEFARGS;
+}
+
+STATIC size_t module_asm_uint_len(mp_uint_t val) {
+    size_t n = 1;
+    while ((val >>= 7) != 0) {
+        ++n;
+    }
+    return n;
+}
+
+// this uses the same encoding as emit_write_uint
+STATIC byte *module_asm_write_uint(byte *p, mp_uint_t val) {
+    size_t n = module_asm_uint_len(val);
+    for (size_t i = n; i > 0; --i) {
+        p[i - 1] = (val & 0x7f) | (i == n ? 0 : 0x80);
+        val >>= 7;
+    }
+    return p + n;
+}
+
+#if MICROPY_ENABLE_SOURCE_LINE
+// this uses the same encoding as emit_write_code_info_bytes_lines
+STATIC void module_asm_add_line(module_asm_t *ma, size_t offset, size_t line) {
+    size_t bytes_to_skip = offset - ma->last_offset;
+    size_t lines_to_skip = line > ma->last_line ? line - ma->last_line : 0;
+    ma->last_offset = offset;
+    ma->last_line += lines_to_skip;
+    while (bytes_to_skip > 0 || lines_to_skip > 0) {
+        size_t b, l;
+        if (lines_to_skip <= 6 || bytes_to_skip > 0xf) {
+            b = MIN(bytes_to_skip, 0x1f);
+            l = b < bytes_to_skip ? 0 : MIN(lines_to_skip, 0x3);
+            vstr_add_byte(&ma->lines, b | (l << 5));
+        } else {
+            b = MIN(bytes_to_skip, 0xf);
+            l = MIN(lines_to_skip, 0x7ff);
+            vstr_add_byte(&ma->lines, 0x80 | b | ((l >> 4) & 0x70));
+            vstr_add_byte(&ma->lines, l);
+        }
+        bytes_to_skip -= b;
+        lines_to_skip -= l;
+    }
+}
+#endif
+
+// append the bytecode compiled from the given part of the module
+STATIC void module_asm_add_part(void *env, mp_parse_tree_t *parse_tree) {
+    module_asm_t *ma = env;
+    uint8_t part_flags = 0;
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    if (ma->iter_builtin_rebound) {
+        part_flags = COMP_PART_ITER_REBOUND;
+    }
+    #endif
+    mp_raw_code_t *rc = compile_to_raw_code(parse_tree, ma->source_file, MP_EMIT_OPT_NONE, false, &part_flags);
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    mp_raw_code_t *alt_rc = NULL;
+    if (part_flags & COMP_PART_ITER_REBOUND) {
+        ma->iter_builtin_rebound = true;
+    } else if (part_flags & COMP_PART_ITER_LOWERED) {
+        part_flags = COMP_PART_ITER_REBOUND;
+        alt_rc = compile_to_raw_code(parse_tree, ma->source_file, MP_EMIT_OPT_NONE, false, &part_flags);
+    }
+    #endif
+    mp_parse_tree_clear(parse_tree);
+    const byte *bytecode = rc->data.u_byte.bytecode;
+    const mp_uint_t *const_table = rc->data.u_byte.const_table;
+
+    // take the maximum state and exception stack sizes of all parts
+    const byte *ip = bytecode;
+    size_t n_state = mp_decode_uint(&ip);
+    size_t n_exc_stack = mp_decode_uint(&ip);
+    ma->n_state = MAX(ma->n_state, n_state);
+    ma->n_exc_stack = MAX(ma->n_exc_stack, n_exc_stack);
+    ma->scope_flags = *ip;
+    ip += 4; // skip scope_flags, n_pos_args, n_kwonly_args, n_def_pos_args
+    const byte *cells = ip + mp_decode_uint_value(ip);
+    ip = mp_decode_uint_skip(ip);
+    ip += 4; // skip simple_name and source_file
+
+    // offsets in the line number info are relative to the cell list, which is
+    // just the 255 sentinel for a module, so are the same in the whole module
+    // after adding the length of the code that comes before this part
+    size_t code_pos = ma->code.len;
+    #if MICROPY_ENABLE_SOURCE_LINE
+    size_t offset = 0;
+    size_t line = 1;
+    while (*ip) {
+        if ((*ip & 0x80) == 0) {
+            offset += *ip & 0x1f;
+            line += *ip >> 5;
+            ip += 1;
+        } else {
+            offset += *ip & 0xf;
+            line += ((*ip << 4) & 0x700) | ip[1];
+            ip += 2;
+        }
+        module_asm_add_line(ma, code_pos + offset, line);
+    }
+    #endif
+
+    // copy the code up to the final return, renumbering the constants: objects
+    // get their final index, raw code is numbered from the start of the raw
+    // code and gets the number of objects added once that's known
+    assert(cells[0] == 255);
+    const byte *code = cells + 1;
+    size_t n_obj = 0;
+    size_t n_raw_code = 0;
+    ip = code;
+    while (*ip != MP_BC_RETURN_VALUE) {
+        size_t sz;
+        mp_opcode_format(ip, &sz);
+        if (*ip == MP_BC_LOAD_CONST_OBJ) {
+            ++n_obj;
+        } else if (is_make_function_op(*ip)) {
+            ++n_raw_code;
+        }
+        ip += sz;
+    }
+    assert(ip[-1] == MP_BC_LOAD_CONST_NONE);
+    size_t code_len = ip - 1 - code;
+    vstr_add_strn(&ma->code, (const char*)code, code_len);
+    ma->objs = m_renew(mp_uint_t, ma->objs, ma->n_obj, ma->n_obj + n_obj);
+    ma->raw_codes = m_renew(mp_uint_t, ma->raw_codes, ma->n_raw_code, ma->n_raw_code + n_raw_code);
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    ma->alt_raw_codes = m_renew(mp_uint_t, ma->alt_raw_codes, ma->n_raw_code, ma->n_raw_code + n_raw_code);
+    memset(ma->alt_raw_codes + ma->n_raw_code, 0, n_raw_code * sizeof(mp_uint_t));
+    #endif
+    for (byte *op = (byte*)ma->code.buf + code_pos; op < (byte*)ma->code.buf + ma->code.len;) {
+        size_t sz;
+        mp_opcode_format(op, &sz);
+        if (*op == MP_BC_LOAD_CONST_OBJ) {
+            const byte *arg = op + 1;
+            ma->objs[ma->n_obj] = const_table[mp_decode_uint(&arg)];
+            mp_emit_bc_write_fixed_uint(op + 1, ma->n_obj++);
+        } else if (is_make_function_op(*op)) {
+            const byte *arg = op + 1;
+            ma->raw_codes[ma->n_raw_code] = const_table[mp_decode_uint(&arg)];
+            mp_emit_bc_write_fixed_uint(op + 1, ma->n_raw_code++);
+        }
+        op += sz;
+    }
+
+    // the part is no longer needed
+    m_del(byte, (byte*)bytecode, ip + 1 - bytecode);
+    m_del(mp_uint_t, (mp_uint_t*)const_table, n_obj + n_raw_code);
+    m_del_obj(mp_raw_code_t, rc);
+
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    if (alt_rc != NULL) {
+        // the two compilations differ only in the code of loops, so they make
+        // the same functions in the same order
+        bytecode = alt_rc->data.u_byte.bytecode;
+        const_table = alt_rc->data.u_byte.const_table;
+        ip = mp_decode_uint_skip(mp_decode_uint_skip(bytecode)) + 4;
+        ip += mp_decode_uint_value(ip) + 1; // skip code info and cell list
+        n_obj = 0;
+        size_t i = ma->n_raw_code - n_raw_code;
+        while (*ip != MP_BC_RETURN_VALUE) {
+            size_t sz;
+            mp_opcode_format(ip, &sz);
+            if (*ip == MP_BC_LOAD_CONST_OBJ) {
+                ++n_obj;
+            } else if (is_make_function_op(*ip)) {
+                const byte *arg = ip + 1;
+                ma->alt_raw_codes[i++] = const_table[mp_decode_uint(&arg)];
+            }
+            ip += sz;
+        }
+        assert(i == ma->n_raw_code);
+        m_del(byte, (byte*)bytecode, ip + 1 - bytecode);
+        m_del(mp_uint_t, (mp_uint_t*)const_table, n_obj + n_raw_code);
+        m_del_obj(mp_raw_code_t, alt_rc);
+    }
+    #endif
+}
+
+mp_raw_code_t *mp_compile_stream_to_raw_code(mp_lexer_t *lex) {
+    module_asm_t ma;
+    memset(&ma, 0, sizeof(ma));
+    ma.source_file = lex->source_name;
+    vstr_init(&ma.code, 64);
+    #if MICROPY_ENABLE_SOURCE_LINE
+    vstr_init(&ma.lines, 16);
+    ma.last_line = 1;
+    #endif
+
+    // parse and compile each top-level statement, and append its bytecode
+    mp_parse_streaming(lex, module_asm_add_part, &ma);
+
+    #if MICROPY_COMP_FOR_ENUMERATE_ZIP
+    if (ma.iter_builtin_rebound) {
+        for (size_t i = 0; i < ma.n_raw_code; ++i) {
+            if (ma.alt_raw_codes[i] != 0) {
+                ma.raw_codes[i] = ma.alt_raw_codes[i];
+            }
+        }
+    }
+    m_del(mp_uint_t, ma.alt_raw_codes, ma.n_raw_code);
+    #endif
+
+    // now that all objects are known, add their number to raw code indices
+    byte *code = (byte*)ma.code.buf;
+    for (byte *op = code; op < code + ma.code.len;) {
+        size_t sz;
+        mp_opcode_format(op, &sz);
+        if (is_make_function_op(*op)) {
+            const byte *arg = op + 1;
+            mp_emit_bc_write_fixed_uint(op + 1, ma.n_obj + mp_decode_uint(&arg));
+        }
+        op += sz;
+    }
+    vstr_add_byte(&ma.code, MP_BC_LOAD_CONST_NONE);
+    vstr_add_byte(&ma.code, MP_BC_RETURN_VALUE);
+
+    // build the prelude, as written by mp_emit_bc_start_pass, in front of the
+    // code; the code info size counts the bytes of its own encoding
+    size_t lines_len = 0;
+    #if MICROPY_ENABLE_SOURCE_LINE
+    lines_len = ma.lines.len;
+    #endif
+    size_t code_info_size = 4 + lines_len + 1;
+    while (module_asm_uint_len(code_info_size) + 4 + lines_len + 1 > code_info_size) {
+        ++code_info_size;
+    }
+    size_t prelude_len = module_asm_uint_len(ma.n_state) + module_asm_uint_len(ma.n_exc_stack)
+        + 4 + code_info_size + 1;
+    size_t code_len = ma.code.len;
+    vstr_add_len(&ma.code, prelude_len);
+    code = (byte*)ma.code.buf;
+    memmove(code + prelude_len, code, code_len);
+    byte *p = code;
+    p = module_asm_write_uint(p, ma.n_state);
+    p = module_asm_write_uint(p, ma.n_exc_stack);
+    *p++ = ma.scope_flags;
+    *p++ = 0; // n_pos_args
+    *p++ = 0; // n_kwonly_args
+    *p++ = 0; // n_def_pos_args
+    byte *code_info = p;
+    p = module_asm_write_uint(p, code_info_size);
+    *p++ = MP_QSTR__lt_module_gt_; *p++ = MP_QSTR__lt_module_gt_ >> 8;
+    *p++ = ma.source_file; *p++ = ma.source_file >> 8;
+    #if MICROPY_ENABLE_SOURCE_LINE
+    memcpy(p, ma.lines.buf, lines_len);
+    p += lines_len;
+    vstr_clear(&ma.lines);
+    #endif
+    while (p < code_info + code_info_size) {
+        *p++ = 0; // end of line number info, and any padding
+    }
+    *p++ = 255; // end of cell list
+    assert(p == code + prelude_len);
+
+    // build the constant table, objects then raw code
+    mp_uint_t *const_table = m_new(mp_uint_t, ma.n_obj + ma.n_raw_code);
+    memcpy(const_table, ma.objs, ma.n_obj * sizeof(mp_uint_t));
+    memcpy(const_table + ma.n_obj, ma.raw_codes, ma.n_raw_code * sizeof(mp_uint_t));
+    m_del(mp_uint_t, ma.objs, ma.n_obj);
+    m_del(mp_uint_t, ma.raw_codes, ma.n_raw_code);
+
+    size_t len = ma.code.len;
+    code = (byte*)m_renew(char, ma.code.buf, ma.code.alloc, len);
+    mp_raw_code_t *rc = mp_emit_glue_new_raw_code();
+    mp_emit_glue_assign_bytecode(rc, code, len, const_table,
+        #if MICROPY_PERSISTENT_CODE_SAVE
+        ma.n_obj, ma.n_raw_code,
+        #endif
+        ma.scope_flags);
+    return rc;
+}
+
+#endif // MICROPY_COMP_STREAMING
+
 #endif // MICROPY_ENABLE_COMPILER
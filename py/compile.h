@@ -48,6 +48,12 @@ mp_obj_t mp_compile(mp_parse_tree_t *parse_tree, qstr source_file, uint emit_opt
 mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, uint emit_opt, bool is_repl);
 #endif
 
+#if MICROPY_COMP_STREAMING
+// parses and compiles a module one top-level statement at a time, so only the
+// parse tree of a single statement is held in memory at once
+mp_raw_code_t *mp_compile_stream_to_raw_code(mp_lexer_t *lex);
+#endif
+
 // this is implemented in runtime.c
 mp_obj_t mp_parse_compile_execute(mp_lexer_t *lex, mp_parse_input_kind_t parse_input_kind, mp_obj_dict_t *globals, mp_obj_dict_t *locals);
 
@@ -167,6 +167,12 @@ emit_t *emit_native_arm_new(mp_obj_t *error_slot, mp_uint_t max_num_labels);
 emit_t *emit_native_xtensa_new(mp_obj_t *error_slot, mp_uint_t max_num_labels);
 
 void emit_bc_set_max_num_labels(emit_t* emit, mp_uint_t max_num_labels);
+#if MICROPY_COMP_STREAMING
+// makes module-level constant table indices a fixed width, so they can be renumbered
+#define MP_EMIT_BC_FIXED_UINT_LEN (3)
+void emit_bc_set_fixed_width_consts(emit_t *emit);
+void mp_emit_bc_write_fixed_uint(byte *c, mp_uint_t val);
+#endif
 
 void emit_bc_free(emit_t *emit);
 void emit_native_x64_free(emit_t *emit);
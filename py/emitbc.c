@@ -69,6 +69,9 @@ struct _emit_t {
     uint16_t ct_num_obj;
     uint16_t ct_cur_raw_code;
     #endif
+    #if MICROPY_COMP_STREAMING
+    bool fixed_width_consts;
+    #endif
     mp_uint_t *const_table;
 };
 
@@ -82,6 +85,20 @@ void emit_bc_set_max_num_labels(emit_t *emit, mp_uint_t max_num_labels) {
     emit->label_offsets = m_new(mp_uint_t, emit->max_num_labels);
 }
 
+#if MICROPY_COMP_STREAMING
+void emit_bc_set_fixed_width_consts(emit_t *emit) {
+    emit->fixed_width_consts = true;
+}
+
+void mp_emit_bc_write_fixed_uint(byte *c, mp_uint_t val) {
+    assert(val < (1 << (7 * MP_EMIT_BC_FIXED_UINT_LEN)));
+    for (int i = MP_EMIT_BC_FIXED_UINT_LEN - 1; i > 0; --i) {
+        *c++ = 0x80 | ((val >> (7 * i)) & 0x7f);
+    }
+    *c = val & 0x7f;
+}
+#endif
+
 void emit_bc_free(emit_t *emit) {
     m_del(mp_uint_t, emit->label_offsets, emit->max_num_labels);
     m_del_obj(emit_t, emit);
@@ -230,6 +247,13 @@ STATIC void emit_write_bytecode_byte_const(emit_t *emit, byte b, mp_uint_t n, mp
     if (emit->pass == MP_PASS_EMIT) {
         emit->const_table[n] = c;
     }
+    #if MICROPY_COMP_STREAMING
+    if (emit->fixed_width_consts && emit->scope->kind == SCOPE_MODULE) {
+        emit_write_bytecode_byte(emit, b);
+        mp_emit_bc_write_fixed_uint(emit_get_cur_to_write_bytecode(emit, MP_EMIT_BC_FIXED_UINT_LEN), n);
+        return;
+    }
+    #endif
     emit_write_bytecode_byte_uint(emit, b, n);
 }
 #endif
@@ -30,6 +30,9 @@
 
 #if MICROPY_PY_BUILTINS_FLOAT
 int mp_format_float(mp_float_t f, char *buf, size_t bufSize, char fmt, int prec, char sign);
+#if MICROPY_FLOAT_REPR_SHORTEST
+int mp_format_float_repr(mp_float_t f, char *buf, size_t bufSize);
+#endif
 #endif
 
 #endif // MICROPY_INCLUDED_PY_FORMATFLOAT_H
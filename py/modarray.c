@@ -24,13 +24,520 @@
  * THE SOFTWARE.
  */
 
+#include <stdint.h>
+#include <limits.h>
+
 #include "py/builtin.h"
+#include "py/binary.h"
+#include "py/objint.h"
+#include "py/runtime0.h"
+#include "py/runtime.h"
+#include "py/smallint.h"
 
 #if MICROPY_PY_ARRAY
 
+#if MICROPY_PY_ARRAY_BULK_OPS
+
+// Bulk operations work directly on the memory of any object with the buffer
+// protocol (array.array, bytearray, memoryview), using a table of kernels
+// specialised for each element type.  Integer results wrap around like C
+// arithmetic on the element type, except for clip() and scale() which
+// saturate.
+
+typedef union _array_bulk_val_t {
+    long long i;
+    #if MICROPY_PY_BUILTINS_FLOAT
+    mp_float_t f;
+    #endif
+} array_bulk_val_t;
+
+typedef struct _array_bulk_kernels_t {
+    bool is_float;
+    void (*add)(void *dest, const void *src, size_t n);
+    void (*mul)(void *dest, const void *src, size_t n);
+    void (*add_scalar)(void *dest, array_bulk_val_t val, size_t n);
+    void (*mul_scalar)(void *dest, array_bulk_val_t val, size_t n);
+    void (*clip)(void *dest, array_bulk_val_t lo, array_bulk_val_t hi, size_t n);
+    #if MICROPY_PY_BUILTINS_FLOAT
+    void (*scale)(void *dest, mp_float_t factor, mp_float_t offset, size_t n);
+    #endif
+    mp_obj_t (*sum)(const void *src, size_t n);
+    void (*min_max)(const void *src, size_t n, array_bulk_val_t *min, array_bulk_val_t *max);
+    mp_obj_t (*dot)(const void *src1, const void *src2, size_t n);
+} array_bulk_kernels_t;
+
+STATIC mp_obj_t array_bulk_new_int_signed(long long val) {
+    if (val >= MP_SMALL_INT_MIN && val <= MP_SMALL_INT_MAX) {
+        return MP_OBJ_NEW_SMALL_INT(val);
+    }
+    return mp_obj_new_int_from_ll(val);
+}
+
+STATIC mp_obj_t array_bulk_new_int_unsigned(unsigned long long val) {
+    if (val <= MP_SMALL_INT_MAX) {
+        return MP_OBJ_NEW_SMALL_INT(val);
+    }
+    return mp_obj_new_int_from_ull(val);
+}
+
+// Sums and dot products accumulate in a long long, which is moved into a
+// big-int total whenever the next addition would overflow it.  total is
+// MP_OBJ_NULL until then.
+STATIC void array_bulk_acc_signed(mp_obj_t *total, long long *acc, long long val) {
+    if ((val > 0 && *acc > LLONG_MAX - val) || (val < 0 && *acc < LLONG_MIN - val)) {
+        mp_obj_t acc_obj = mp_obj_new_int_from_ll(*acc);
+        *total = *total == MP_OBJ_NULL ? acc_obj : mp_binary_op(MP_BINARY_OP_ADD, *total, acc_obj);
+        *acc = 0;
+    }
+    *acc += val;
+}
+
+STATIC void array_bulk_acc_unsigned(mp_obj_t *total, unsigned long long *acc, unsigned long long val) {
+    if (*acc > ULLONG_MAX - val) {
+        mp_obj_t acc_obj = mp_obj_new_int_from_ull(*acc);
+        *total = *total == MP_OBJ_NULL ? acc_obj : mp_binary_op(MP_BINARY_OP_ADD, *total, acc_obj);
+        *acc = 0;
+    }
+    *acc += val;
+}
+
+STATIC mp_obj_t array_bulk_total_signed(mp_obj_t total, long long acc) {
+    mp_obj_t acc_obj = array_bulk_new_int_signed(acc);
+    return total == MP_OBJ_NULL ? acc_obj : mp_binary_op(MP_BINARY_OP_ADD, total, acc_obj);
+}
+
+STATIC mp_obj_t array_bulk_total_unsigned(mp_obj_t total, unsigned long long acc) {
+    mp_obj_t acc_obj = array_bulk_new_int_unsigned(acc);
+    return total == MP_OBJ_NULL ? acc_obj : mp_binary_op(MP_BINARY_OP_ADD, total, acc_obj);
+}
+
+// Adds 8- or 16-bit lanes a machine word at a time, without carries crossing
+// between lanes.  high_bits has the top bit of each lane set.  src may be
+// NULL, in which case the word val is added to each word of dest.  Returns
+// the number of bytes processed, which is zero if the buffers are unaligned.
+STATIC size_t array_bulk_add_lanes(void *dest, const void *src, mp_uint_t val, size_t len, mp_uint_t high_bits) {
+    if (((uintptr_t)dest | (uintptr_t)src) % sizeof(mp_uint_t) != 0) {
+        return 0;
+    }
+    mp_uint_t *d = dest;
+    const mp_uint_t *s = src;
+    size_t n = len / sizeof(mp_uint_t);
+    for (size_t i = 0; i < n; ++i) {
+        mp_uint_t x = d[i];
+        mp_uint_t y = s == NULL ? val : s[i];
+        d[i] = ((x & ~high_bits) + (y & ~high_bits)) ^ ((x ^ y) & high_bits);
+    }
+    return n * sizeof(mp_uint_t);
+}
+
+#define ARRAY_BULK_INT_WRAPPING_KERNELS(name, type) \
+    STATIC void array_bulk_add_##name(void *dest, const void *src, size_t n) { \
+        type *d = dest; \
+        const type *s = src; \
+        size_t done = 0; \
+        if (sizeof(type) <= 2) { \
+            done = array_bulk_add_lanes(dest, src, 0, n * sizeof(type), ARRAY_BULK_HIGH_BITS(type)) / sizeof(type); \
+        } \
+        for (size_t i = done; i < n; ++i) { \
+            d[i] = (mp_uint_t)d[i] + (mp_uint_t)s[i]; \
+        } \
+    } \
+    STATIC void array_bulk_mul_##name(void *dest, const void *src, size_t n) { \
+        type *d = dest; \
+        const type *s = src; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] = (mp_uint_t)d[i] * (mp_uint_t)s[i]; \
+        } \
+    } \
+    STATIC void array_bulk_add_scalar_##name(void *dest, array_bulk_val_t val, size_t n) { \
+        type *d = dest; \
+        type v = (type)val.i; \
+        size_t done = 0; \
+        if (sizeof(type) <= 2) { \
+            mp_uint_t word = (mp_uint_t)-1 / (type)-1 * v; \
+            done = array_bulk_add_lanes(dest, NULL, word, n * sizeof(type), ARRAY_BULK_HIGH_BITS(type)) / sizeof(type); \
+        } \
+        for (size_t i = done; i < n; ++i) { \
+            d[i] = (mp_uint_t)d[i] + (mp_uint_t)v; \
+        } \
+    } \
+    STATIC void array_bulk_mul_scalar_##name(void *dest, array_bulk_val_t val, size_t n) { \
+        type *d = dest; \
+        mp_uint_t v = (mp_uint_t)val.i; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] = (mp_uint_t)d[i] * v; \
+        } \
+    }
+
+// a word with the top bit of each lane of the given unsigned type set
+#define ARRAY_BULK_HIGH_BITS(type) ((mp_uint_t)-1 / (type)-1 * (((type)-1 >> 1) + 1))
+
+#if MICROPY_PY_BUILTINS_FLOAT
+#define ARRAY_BULK_INT_SCALE_KERNEL(name, type, min_val, max_val) \
+    STATIC void array_bulk_scale_##name(void *dest, mp_float_t factor, mp_float_t offset, size_t n) { \
+        type *d = dest; \
+        for (size_t i = 0; i < n; ++i) { \
+            mp_float_t v = d[i] * factor + offset; \
+            if (!(v >= (mp_float_t)(min_val))) { \
+                d[i] = (min_val); \
+            } else if (v >= (mp_float_t)(max_val)) { \
+                d[i] = (max_val); \
+            } else { \
+                d[i] = (type)v; \
+            } \
+        } \
+    }
+#else
+#define ARRAY_BULK_INT_SCALE_KERNEL(name, type, min_val, max_val)
+#endif
+
+// sign is signed or unsigned, and selects the accumulator for sums
+#define ARRAY_BULK_INT_KERNELS(name, type, sign, min_val, max_val) \
+    STATIC void array_bulk_clip_##name(void *dest, array_bulk_val_t lo, array_bulk_val_t hi, size_t n) { \
+        type *d = dest; \
+        type l = lo.i < (min_val) ? (min_val) : lo.i > (max_val) ? (max_val) : (type)lo.i; \
+        type h = hi.i < (min_val) ? (min_val) : hi.i > (max_val) ? (max_val) : (type)hi.i; \
+        for (size_t i = 0; i < n; ++i) { \
+            type v = d[i]; \
+            d[i] = v < l ? l : v > h ? h : v; \
+        } \
+    } \
+    ARRAY_BULK_INT_SCALE_KERNEL(name, type, min_val, max_val) \
+    STATIC mp_obj_t array_bulk_sum_##name(const void *src, size_t n) { \
+        const type *s = src; \
+        mp_obj_t total = MP_OBJ_NULL; \
+        sign long long acc = 0; \
+        for (size_t i = 0; i < n; ++i) { \
+            array_bulk_acc_##sign(&total, &acc, s[i]); \
+        } \
+        return array_bulk_total_##sign(total, acc); \
+    } \
+    STATIC void array_bulk_min_max_##name(const void *src, size_t n, array_bulk_val_t *min, array_bulk_val_t *max) { \
+        const type *s = src; \
+        type lo = s[0]; \
+        type hi = s[0]; \
+        for (size_t i = 1; i < n; ++i) { \
+            type v = s[i]; \
+            lo = v < lo ? v : lo; \
+            hi = v > hi ? v : hi; \
+        } \
+        min->i = lo; \
+        max->i = hi; \
+    } \
+    STATIC mp_obj_t array_bulk_dot_##name(const void *src1, const void *src2, size_t n) { \
+        const type *s1 = src1; \
+        const type *s2 = src2; \
+        mp_obj_t total = MP_OBJ_NULL; \
+        sign long long acc = 0; \
+        for (size_t i = 0; i < n; ++i) { \
+            array_bulk_acc_##sign(&total, &acc, (sign long long)s1[i] * s2[i]); \
+        } \
+        return array_bulk_total_##sign(total, acc); \
+    }
+
+#define ARRAY_BULK_INT_KERNELS_TABLE(name, wrap_name) \
+    STATIC const array_bulk_kernels_t array_bulk_kernels_##name = { \
+        false, \
+        array_bulk_add_##wrap_name, \
+        array_bulk_mul_##wrap_name, \
+        array_bulk_add_scalar_##wrap_name, \
+        array_bulk_mul_scalar_##wrap_name, \
+        array_bulk_clip_##name, \
+        ARRAY_BULK_SCALE_ENTRY(name) \
+        array_bulk_sum_##name, \
+        array_bulk_min_max_##name, \
+        array_bulk_dot_##name, \
+    };
+
+#if MICROPY_PY_BUILTINS_FLOAT
+#define ARRAY_BULK_SCALE_ENTRY(name) array_bulk_scale_##name,
+#else
+#define ARRAY_BULK_SCALE_ENTRY(name)
+#endif
+
+// signed and unsigned types of the same size share the wrapping kernels
+ARRAY_BULK_INT_WRAPPING_KERNELS(u8, uint8_t)
+ARRAY_BULK_INT_WRAPPING_KERNELS(u16, uint16_t)
+ARRAY_BULK_INT_WRAPPING_KERNELS(u32, uint32_t)
+ARRAY_BULK_INT_KERNELS(i8, int8_t, signed, INT8_MIN, INT8_MAX)
+ARRAY_BULK_INT_KERNELS(u8, uint8_t, unsigned, 0, UINT8_MAX)
+ARRAY_BULK_INT_KERNELS(i16, int16_t, signed, INT16_MIN, INT16_MAX)
+ARRAY_BULK_INT_KERNELS(u16, uint16_t, unsigned, 0, UINT16_MAX)
+ARRAY_BULK_INT_KERNELS(i32, int32_t, signed, INT32_MIN, INT32_MAX)
+ARRAY_BULK_INT_KERNELS(u32, uint32_t, unsigned, 0, UINT32_MAX)
+ARRAY_BULK_INT_KERNELS_TABLE(i8, u8)
+ARRAY_BULK_INT_KERNELS_TABLE(u8, u8)
+ARRAY_BULK_INT_KERNELS_TABLE(i16, u16)
+ARRAY_BULK_INT_KERNELS_TABLE(u16, u16)
+ARRAY_BULK_INT_KERNELS_TABLE(i32, u32)
+ARRAY_BULK_INT_KERNELS_TABLE(u32, u32)
+
+#if MICROPY_PY_BUILTINS_FLOAT
+
+#define ARRAY_BULK_FLOAT_KERNELS(name, type) \
+    STATIC void array_bulk_add_##name(void *dest, const void *src, size_t n) { \
+        type *d = dest; \
+        const type *s = src; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] += s[i]; \
+        } \
+    } \
+    STATIC void array_bulk_mul_##name(void *dest, const void *src, size_t n) { \
+        type *d = dest; \
+        const type *s = src; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] *= s[i]; \
+        } \
+    } \
+    STATIC void array_bulk_add_scalar_##name(void *dest, array_bulk_val_t val, size_t n) { \
+        type *d = dest; \
+        type v = val.f; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] += v; \
+        } \
+    } \
+    STATIC void array_bulk_mul_scalar_##name(void *dest, array_bulk_val_t val, size_t n) { \
+        type *d = dest; \
+        type v = val.f; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] *= v; \
+        } \
+    } \
+    STATIC void array_bulk_clip_##name(void *dest, array_bulk_val_t lo, array_bulk_val_t hi, size_t n) { \
+        type *d = dest; \
+        type l = lo.f; \
+        type h = hi.f; \
+        for (size_t i = 0; i < n; ++i) { \
+            type v = d[i]; \
+            d[i] = v < l ? l : v > h ? h : v; \
+        } \
+    } \
+    STATIC void array_bulk_scale_##name(void *dest, mp_float_t factor, mp_float_t offset, size_t n) { \
+        type *d = dest; \
+        type f = factor; \
+        type o = offset; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] = d[i] * f + o; \
+        } \
+    } \
+    STATIC mp_obj_t array_bulk_sum_##name(const void *src, size_t n) { \
+        const type *s = src; \
+        mp_float_t acc = 0; \
+        for (size_t i = 0; i < n; ++i) { \
+            acc += s[i]; \
+        } \
+        return mp_obj_new_float(acc); \
+    } \
+    STATIC void array_bulk_min_max_##name(const void *src, size_t n, array_bulk_val_t *min, array_bulk_val_t *max) { \
+        const type *s = src; \
+        type lo = s[0]; \
+        type hi = s[0]; \
+        for (size_t i = 1; i < n; ++i) { \
+            type v = s[i]; \
+            lo = v < lo ? v : lo; \
+            hi = v > hi ? v : hi; \
+        } \
+        min->f = lo; \
+        max->f = hi; \
+    } \
+    STATIC mp_obj_t array_bulk_dot_##name(const void *src1, const void *src2, size_t n) { \
+        const type *s1 = src1; \
+        const type *s2 = src2; \
+        mp_float_t acc = 0; \
+        for (size_t i = 0; i < n; ++i) { \
+            acc += (mp_float_t)s1[i] * s2[i]; \
+        } \
+        return mp_obj_new_float(acc); \
+    } \
+    STATIC const array_bulk_kernels_t array_bulk_kernels_##name = { \
+        true, \
+        array_bulk_add_##name, \
+        array_bulk_mul_##name, \
+        array_bulk_add_scalar_##name, \
+        array_bulk_mul_scalar_##name, \
+        array_bulk_clip_##name, \
+        array_bulk_scale_##name, \
+        array_bulk_sum_##name, \
+        array_bulk_min_max_##name, \
+        array_bulk_dot_##name, \
+    };
+
+ARRAY_BULK_FLOAT_KERNELS(f32, float)
+#if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+ARRAY_BULK_FLOAT_KERNELS(f64, double)
+#endif
+
+#endif // MICROPY_PY_BUILTINS_FLOAT
+
+// gets the buffer of obj and the kernels for its element type
+STATIC const array_bulk_kernels_t *array_bulk_get(mp_obj_t obj, mp_buffer_info_t *bufinfo, mp_uint_t flags, size_t *n) {
+    mp_get_buffer_raise(obj, bufinfo, flags);
+    const array_bulk_kernels_t *k = NULL;
+    size_t size = mp_binary_get_size('@', bufinfo->typecode, NULL);
+    switch (bufinfo->typecode) {
+        case 'b': k = &array_bulk_kernels_i8; break;
+        case BYTEARRAY_TYPECODE: case 'B': k = &array_bulk_kernels_u8; break;
+        case 'h': k = &array_bulk_kernels_i16; break;
+        case 'H': k = &array_bulk_kernels_u16; break;
+        case 'i': case 'l': k = size == 4 ? &array_bulk_kernels_i32 : NULL; break;
+        case 'I': case 'L': k = size == 4 ? &array_bulk_kernels_u32 : NULL; break;
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case 'f': k = &array_bulk_kernels_f32; break;
+        #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+        case 'd': k = &array_bulk_kernels_f64; break;
+        #endif
+        #endif
+    }
+    if (k == NULL) {
+        mp_raise_TypeError("unsupported array type");
+    }
+    *n = bufinfo->len / size;
+    return k;
+}
+
+// gets a scalar argument in the representation used by the kernels k
+STATIC array_bulk_val_t array_bulk_get_val(const array_bulk_kernels_t *k, mp_obj_t obj) {
+    array_bulk_val_t val;
+    #if MICROPY_PY_BUILTINS_FLOAT
+    if (k->is_float) {
+        val.f = mp_obj_get_float(obj);
+        return val;
+    }
+    #else
+    (void)k;
+    #endif
+    val.i = mp_obj_get_int_truncated(obj);
+    // a positive int too big for mp_int_t keeps its low bits, which are unsigned
+    // (eg 0xffffffff for 'I' on 32-bit ports)
+    if (val.i < 0 && MP_OBJ_IS_INT(obj) && mp_obj_int_sign(obj) > 0) {
+        val.i = (mp_uint_t)val.i;
+    }
+    return val;
+}
+
+STATIC mp_obj_t array_bulk_new_val(const array_bulk_kernels_t *k, array_bulk_val_t val) {
+    #if MICROPY_PY_BUILTINS_FLOAT
+    if (k->is_float) {
+        return mp_obj_new_float(val.f);
+    }
+    #else
+    (void)k;
+    #endif
+    return array_bulk_new_int_signed(val.i);
+}
+
+// gets the buffer of a second array, which must match the first in type and length
+STATIC const void *array_bulk_get_other(const array_bulk_kernels_t *k, size_t n, mp_obj_t obj) {
+    mp_buffer_info_t bufinfo;
+    size_t n2;
+    if (array_bulk_get(obj, &bufinfo, MP_BUFFER_READ, &n2) != k || n2 != n) {
+        mp_raise_ValueError("arrays must have same type and length");
+    }
+    return bufinfo.buf;
+}
+
+STATIC mp_obj_t array_bulk_binop(mp_obj_t dest_in, mp_obj_t src_in, bool is_mul) {
+    mp_buffer_info_t bufinfo;
+    size_t n;
+    const array_bulk_kernels_t *k = array_bulk_get(dest_in, &bufinfo, MP_BUFFER_WRITE, &n);
+    mp_buffer_info_t src_bufinfo;
+    if (mp_get_buffer(src_in, &src_bufinfo, MP_BUFFER_READ)) {
+        const void *src = array_bulk_get_other(k, n, src_in);
+        (is_mul ? k->mul : k->add)(bufinfo.buf, src, n);
+    } else {
+        array_bulk_val_t val = array_bulk_get_val(k, src_in);
+        (is_mul ? k->mul_scalar : k->add_scalar)(bufinfo.buf, val, n);
+    }
+    return mp_const_none;
+}
+
+STATIC mp_obj_t array_bulk_add(mp_obj_t dest_in, mp_obj_t src_in) {
+    return array_bulk_binop(dest_in, src_in, false);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(array_bulk_add_obj, array_bulk_add);
+
+STATIC mp_obj_t array_bulk_mul(mp_obj_t dest_in, mp_obj_t src_in) {
+    return array_bulk_binop(dest_in, src_in, true);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(array_bulk_mul_obj, array_bulk_mul);
+
+#if MICROPY_PY_BUILTINS_FLOAT
+STATIC mp_obj_t array_bulk_scale(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    size_t n;
+    const array_bulk_kernels_t *k = array_bulk_get(args[0], &bufinfo, MP_BUFFER_WRITE, &n);
+    mp_float_t offset = n_args > 2 ? mp_obj_get_float(args[2]) : 0;
+    k->scale(bufinfo.buf, mp_obj_get_float(args[1]), offset, n);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(array_bulk_scale_obj, 2, 3, array_bulk_scale);
+#endif
+
+STATIC mp_obj_t array_bulk_clip(mp_obj_t dest_in, mp_obj_t lo_in, mp_obj_t hi_in) {
+    mp_buffer_info_t bufinfo;
+    size_t n;
+    const array_bulk_kernels_t *k = array_bulk_get(dest_in, &bufinfo, MP_BUFFER_WRITE, &n);
+    k->clip(bufinfo.buf, array_bulk_get_val(k, lo_in), array_bulk_get_val(k, hi_in), n);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(array_bulk_clip_obj, array_bulk_clip);
+
+STATIC mp_obj_t array_bulk_asum(mp_obj_t src_in) {
+    mp_buffer_info_t bufinfo;
+    size_t n;
+    const array_bulk_kernels_t *k = array_bulk_get(src_in, &bufinfo, MP_BUFFER_READ, &n);
+    return k->sum(bufinfo.buf, n);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(array_bulk_asum_obj, array_bulk_asum);
+
+STATIC mp_obj_t array_bulk_min_max(mp_obj_t src_in, bool is_max) {
+    mp_buffer_info_t bufinfo;
+    size_t n;
+    const array_bulk_kernels_t *k = array_bulk_get(src_in, &bufinfo, MP_BUFFER_READ, &n);
+    if (n == 0) {
+        mp_raise_ValueError("empty array");
+    }
+    array_bulk_val_t min, max;
+    k->min_max(bufinfo.buf, n, &min, &max);
+    return array_bulk_new_val(k, is_max ? max : min);
+}
+
+STATIC mp_obj_t array_bulk_amin(mp_obj_t src_in) {
+    return array_bulk_min_max(src_in, false);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(array_bulk_amin_obj, array_bulk_amin);
+
+STATIC mp_obj_t array_bulk_amax(mp_obj_t src_in) {
+    return array_bulk_min_max(src_in, true);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(array_bulk_amax_obj, array_bulk_amax);
+
+STATIC mp_obj_t array_bulk_dot(mp_obj_t src1_in, mp_obj_t src2_in) {
+    mp_buffer_info_t bufinfo;
+    size_t n;
+    const array_bulk_kernels_t *k = array_bulk_get(src1_in, &bufinfo, MP_BUFFER_READ, &n);
+    const void *src2 = array_bulk_get_other(k, n, src2_in);
+    return k->dot(bufinfo.buf, src2, n);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(array_bulk_dot_obj, array_bulk_dot);
+
+#endif // MICROPY_PY_ARRAY_BULK_OPS
+
 STATIC const mp_rom_map_elem_t mp_module_array_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_array) },
     { MP_ROM_QSTR(MP_QSTR_array), MP_ROM_PTR(&mp_type_array) },
+    #if MICROPY_PY_ARRAY_BULK_OPS
+    { MP_ROM_QSTR(MP_QSTR_add), MP_ROM_PTR(&array_bulk_add_obj) },
+    { MP_ROM_QSTR(MP_QSTR_mul), MP_ROM_PTR(&array_bulk_mul_obj) },
+    #if MICROPY_PY_BUILTINS_FLOAT
+    { MP_ROM_QSTR(MP_QSTR_scale), MP_ROM_PTR(&array_bulk_scale_obj) },
+    #endif
+    { MP_ROM_QSTR(MP_QSTR_clip), MP_ROM_PTR(&array_bulk_clip_obj) },
+    { MP_ROM_QSTR(MP_QSTR_asum), MP_ROM_PTR(&array_bulk_asum_obj) },
+    { MP_ROM_QSTR(MP_QSTR_amin), MP_ROM_PTR(&array_bulk_amin_obj) },
+    { MP_ROM_QSTR(MP_QSTR_amax), MP_ROM_PTR(&array_bulk_amax_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dot), MP_ROM_PTR(&array_bulk_dot_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_array_globals, mp_module_array_globals_table);
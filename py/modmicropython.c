@@ -28,8 +28,10 @@
 
 #include "py/mpstate.h"
 #include "py/builtin.h"
+#include "py/runtime0.h"
 #include "py/stackctrl.h"
 #include "py/runtime.h"
+#include "py/objstr.h"
 #include "py/gc.h"
 #include "py/mphal.h"
 
@@ -46,6 +48,18 @@ STATIC mp_obj_t mp_micropython_opt_level(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_opt_level_obj, 0, 1, mp_micropython_opt_level);
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+STATIC mp_obj_t mp_micropython_bytecode_cache(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 0) {
+        return mp_obj_new_bool(MP_STATE_VM(persistent_code_cache));
+    } else {
+        MP_STATE_VM(persistent_code_cache) = mp_obj_is_true(args[0]);
+        return mp_const_none;
+    }
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_bytecode_cache_obj, 0, 1, mp_micropython_bytecode_cache);
+#endif
+
 #if MICROPY_PY_MICROPYTHON_MEM_INFO
 
 #if MICROPY_MEM_STATS
@@ -149,10 +163,101 @@ STATIC mp_obj_t mp_micropython_schedule(mp_obj_t function, mp_obj_t arg) {
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_micropython_schedule_obj, mp_micropython_schedule);
 #endif
 
+#if MICROPY_PY_MICROPYTHON_STRINGBUILDER
+// StringBuilder accumulates str data in a vstr (which grows geometrically)
+// and build() hands the buffer over to a new str object without copying.
+
+typedef struct _mp_obj_stringbuilder_t {
+    mp_obj_base_t base;
+    vstr_t vstr;
+} mp_obj_stringbuilder_t;
+
+STATIC mp_obj_t stringbuilder_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 0, 1, false);
+    mp_obj_stringbuilder_t *o = m_new_obj(mp_obj_stringbuilder_t);
+    o->base.type = type;
+    vstr_init(&o->vstr, n_args == 0 ? 16 : mp_obj_get_int(args[0]));
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC void stringbuilder_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    mp_obj_stringbuilder_t *self = MP_OBJ_TO_PTR(self_in);
+    if (kind == PRINT_STR) {
+        mp_print_strn(print, self->vstr.buf, self->vstr.len, 0, 0, 0);
+    } else {
+        mp_printf(print, "<StringBuilder 0x%x>", self);
+    }
+}
+
+STATIC mp_obj_t stringbuilder_unary_op(mp_uint_t op, mp_obj_t self_in) {
+    mp_obj_stringbuilder_t *self = MP_OBJ_TO_PTR(self_in);
+    switch (op) {
+        case MP_UNARY_OP_BOOL: return mp_obj_new_bool(self->vstr.len != 0);
+        case MP_UNARY_OP_LEN: return MP_OBJ_NEW_SMALL_INT(unichar_charlen(self->vstr.buf, self->vstr.len));
+        default: return MP_OBJ_NULL; // op not supported
+    }
+}
+
+STATIC mp_obj_t stringbuilder_binary_op(mp_uint_t op, mp_obj_t lhs_in, mp_obj_t rhs_in) {
+    if (op == MP_BINARY_OP_INPLACE_ADD && MP_OBJ_IS_STR(rhs_in)) {
+        mp_obj_stringbuilder_t *self = MP_OBJ_TO_PTR(lhs_in);
+        GET_STR_DATA_LEN(rhs_in, data, len);
+        vstr_add_strn(&self->vstr, (const char*)data, len);
+        return lhs_in;
+    }
+    return MP_OBJ_NULL; // op not supported
+}
+
+// append(s, ...) adds each of the given str objects
+STATIC mp_obj_t stringbuilder_append(size_t n_args, const mp_obj_t *args) {
+    mp_obj_stringbuilder_t *self = MP_OBJ_TO_PTR(args[0]);
+    for (size_t i = 1; i < n_args; i++) {
+        if (!MP_OBJ_IS_STR(args[i])) {
+            mp_raise_TypeError("can only append str");
+        }
+        GET_STR_DATA_LEN(args[i], data, len);
+        vstr_add_strn(&self->vstr, (const char*)data, len);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR(stringbuilder_append_obj, 1, stringbuilder_append);
+
+// build() returns the accumulated str and leaves the builder empty
+STATIC mp_obj_t stringbuilder_build(mp_obj_t self_in) {
+    mp_obj_stringbuilder_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t str = mp_obj_new_str_from_vstr(&mp_type_str, &self->vstr);
+    // the buffer now belongs to the str; start again with no buffer, the
+    // next append will allocate a new one
+    self->vstr.len = 0;
+    return str;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(stringbuilder_build_obj, stringbuilder_build);
+
+STATIC const mp_rom_map_elem_t stringbuilder_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_append), MP_ROM_PTR(&stringbuilder_append_obj) },
+    { MP_ROM_QSTR(MP_QSTR_build), MP_ROM_PTR(&stringbuilder_build_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(stringbuilder_locals_dict, stringbuilder_locals_dict_table);
+
+STATIC const mp_obj_type_t mp_type_stringbuilder = {
+    { &mp_type_type },
+    .name = MP_QSTR_StringBuilder,
+    .print = stringbuilder_print,
+    .make_new = stringbuilder_make_new,
+    .unary_op = stringbuilder_unary_op,
+    .binary_op = stringbuilder_binary_op,
+    .locals_dict = (mp_obj_dict_t*)&stringbuilder_locals_dict,
+};
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_micropython) },
     { MP_ROM_QSTR(MP_QSTR_const), MP_ROM_PTR(&mp_identity_obj) },
     { MP_ROM_QSTR(MP_QSTR_opt_level), MP_ROM_PTR(&mp_micropython_opt_level_obj) },
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    { MP_ROM_QSTR(MP_QSTR_bytecode_cache), MP_ROM_PTR(&mp_micropython_bytecode_cache_obj) },
+    #endif
 #if MICROPY_PY_MICROPYTHON_MEM_INFO
 #if MICROPY_MEM_STATS
     { MP_ROM_QSTR(MP_QSTR_mem_total), MP_ROM_PTR(&mp_micropython_mem_total_obj) },
@@ -178,6 +283,9 @@ STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_ENABLE_SCHEDULER
     { MP_ROM_QSTR(MP_QSTR_schedule), MP_ROM_PTR(&mp_micropython_schedule_obj) },
     #endif
+    #if MICROPY_PY_MICROPYTHON_STRINGBUILDER
+    { MP_ROM_QSTR(MP_QSTR_StringBuilder), MP_ROM_PTR(&mp_type_stringbuilder) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_micropython_globals, mp_module_micropython_globals_table);
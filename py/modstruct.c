@@ -247,6 +247,264 @@ STATIC mp_obj_t struct_pack_into(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_pack_into);
 
+#if MICROPY_PY_STRUCT_STRUCT
+
+// A Struct object holds the format string parsed into one descriptor per
+// format character, so packing and unpacking don't need to parse it again.
+
+typedef struct _struct_field_t {
+    char code;
+    byte size; // size of one item; 1 for 's'
+    byte align;
+    mp_uint_t count; // repeat count, or length for 's'
+} struct_field_t;
+
+typedef struct _mp_obj_struct_t {
+    mp_obj_base_t base;
+    mp_obj_t format;
+    char fmt_type;
+    size_t size;
+    size_t num_items;
+    size_t num_fields;
+    struct_field_t fields[];
+} mp_obj_struct_t;
+
+STATIC const mp_obj_type_t struct_Struct_type;
+
+STATIC mp_obj_t struct_Struct_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    (void)type;
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    const char *fmt = mp_obj_str_get_str(args[0]);
+    char fmt_type = get_fmt_type(&fmt);
+
+    size_t num_fields = 0;
+    for (const char *f = fmt; *f; ++f) {
+        if (!unichar_isdigit(*f)) {
+            ++num_fields;
+        }
+    }
+
+    mp_obj_struct_t *o = m_new_obj_var(mp_obj_struct_t, struct_field_t, num_fields);
+    o->base.type = &struct_Struct_type;
+    o->format = args[0];
+    o->fmt_type = fmt_type;
+    o->size = 0;
+    o->num_items = 0;
+    o->num_fields = num_fields;
+
+    for (struct_field_t *field = o->fields; *fmt; ++fmt, ++field) {
+        mp_uint_t cnt = 1;
+        if (unichar_isdigit(*fmt)) {
+            cnt = get_fmt_num(&fmt);
+            if (*fmt == '\0') {
+                mp_raise_ValueError("bad typecode");
+            }
+        }
+        field->code = *fmt;
+        field->count = cnt;
+        if (*fmt == 's') {
+            field->size = 1;
+            field->align = 1;
+            o->size += cnt;
+            o->num_items += 1;
+        } else {
+            mp_uint_t align;
+            field->size = mp_binary_get_size(fmt_type, *fmt, &align);
+            field->align = align;
+            for (; cnt > 0; --cnt) {
+                o->size = (o->size + align - 1) & ~(align - 1);
+                o->size += field->size;
+            }
+            o->num_items += field->count;
+        }
+    }
+
+    return MP_OBJ_FROM_PTR(o);
+}
+
+// gets the buffer of buf_in and applies the (possibly negative) offset
+STATIC byte *struct_get_buf(mp_obj_t buf_in, mp_obj_t offset_in, mp_uint_t flags, byte **end_p) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, flags);
+    mp_int_t offset = 0;
+    if (offset_in != MP_OBJ_NULL) {
+        offset = mp_obj_get_int(offset_in);
+        if (offset < 0) {
+            // negative offsets are relative to the end of the buffer
+            offset += bufinfo.len;
+        }
+        if (offset < 0 || (size_t)offset > bufinfo.len) {
+            mp_raise_ValueError("buffer too small");
+        }
+    }
+    *end_p = (byte*)bufinfo.buf + bufinfo.len;
+    return (byte*)bufinfo.buf + offset;
+}
+
+// aligns p for the given field and checks that the whole field fits before end_p
+STATIC byte *struct_check_field(const struct_field_t *field, byte *p, byte *end_p) {
+    p = (byte*)MP_ALIGN(p, (size_t)field->align);
+    if (p > end_p || field->count > (size_t)(end_p - p) / field->size) {
+        mp_raise_ValueError("buffer too small");
+    }
+    return p;
+}
+
+STATIC mp_obj_t struct_Struct_unpack_buf(mp_obj_struct_t *self, byte *p, byte *end_p) {
+    mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->num_items, NULL));
+    mp_obj_t *item = res->items;
+    for (size_t i = 0; i < self->num_fields; ++i) {
+        const struct_field_t *field = &self->fields[i];
+        p = struct_check_field(field, p, end_p);
+        if (field->code == 's') {
+            *item++ = mp_obj_new_bytes(p, field->count);
+            p += field->count;
+        } else {
+            for (mp_uint_t n = field->count; n > 0; --n) {
+                *item++ = mp_binary_get_val(self->fmt_type, field->code, &p);
+            }
+        }
+    }
+    return MP_OBJ_FROM_PTR(res);
+}
+
+STATIC void struct_Struct_pack_buf(mp_obj_struct_t *self, byte *p, byte *end_p, size_t n_args, const mp_obj_t *args) {
+    if (n_args != self->num_items) {
+        nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
+            "pack expected %d items (got %d)", (int)self->num_items, (int)n_args));
+    }
+    for (size_t i = 0; i < self->num_fields; ++i) {
+        const struct_field_t *field = &self->fields[i];
+        p = struct_check_field(field, p, end_p);
+        if (field->code == 's') {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(*args++, &bufinfo, MP_BUFFER_READ);
+            size_t to_copy = MIN(bufinfo.len, field->count);
+            memcpy(p, bufinfo.buf, to_copy);
+            memset(p + to_copy, 0, field->count - to_copy);
+            p += field->count;
+        } else {
+            for (mp_uint_t n = field->count; n > 0; --n) {
+                mp_binary_set_val(self->fmt_type, field->code, *args++, &p);
+            }
+        }
+    }
+}
+
+STATIC mp_obj_t struct_Struct_pack(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    vstr_t vstr;
+    vstr_init_len(&vstr, self->size);
+    byte *p = (byte*)vstr.buf;
+    memset(p, 0, self->size);
+    struct_Struct_pack_buf(self, p, p + self->size, n_args - 1, args + 1);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_Struct_pack_obj, 1, MP_OBJ_FUN_ARGS_MAX, struct_Struct_pack);
+
+STATIC mp_obj_t struct_Struct_pack_into(size_t n_args, const mp_obj_t *args) {
+    byte *end_p;
+    byte *p = struct_get_buf(args[1], args[2], MP_BUFFER_WRITE, &end_p);
+    struct_Struct_pack_buf(MP_OBJ_TO_PTR(args[0]), p, end_p, n_args - 3, args + 3);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_Struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_Struct_pack_into);
+
+STATIC mp_obj_t struct_Struct_unpack_from(size_t n_args, const mp_obj_t *args) {
+    byte *end_p;
+    byte *p = struct_get_buf(args[1], n_args > 2 ? args[2] : MP_OBJ_NULL, MP_BUFFER_READ, &end_p);
+    return struct_Struct_unpack_buf(MP_OBJ_TO_PTR(args[0]), p, end_p);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_Struct_unpack_from_obj, 2, 3, struct_Struct_unpack_from);
+
+typedef struct _struct_iter_t {
+    mp_obj_base_t base;
+    mp_obj_struct_t *st;
+    mp_obj_t buf;
+    size_t offset;
+} struct_iter_t;
+
+STATIC mp_obj_t struct_iter_iternext(mp_obj_t self_in) {
+    struct_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(self->buf, &bufinfo, MP_BUFFER_READ);
+    if (self->offset > bufinfo.len || bufinfo.len - self->offset < self->st->size) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    byte *p = (byte*)bufinfo.buf + self->offset;
+    self->offset += self->st->size;
+    return struct_Struct_unpack_buf(self->st, p, p + self->st->size);
+}
+
+STATIC const mp_obj_type_t struct_iter_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_iterator,
+    .getiter = mp_identity_getiter,
+    .iternext = struct_iter_iternext,
+};
+
+STATIC mp_obj_t struct_Struct_iter_unpack(mp_obj_t self_in, mp_obj_t buf_in) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    if (self->size == 0 || bufinfo.len % self->size != 0) {
+        mp_raise_ValueError("buffer size must be a multiple of struct size");
+    }
+    struct_iter_t *o = m_new_obj(struct_iter_t);
+    o->base.type = &struct_iter_type;
+    o->st = self;
+    o->buf = buf_in;
+    o->offset = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(struct_Struct_iter_unpack_obj, struct_Struct_iter_unpack);
+
+STATIC const mp_rom_map_elem_t struct_Struct_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_pack), MP_ROM_PTR(&struct_Struct_pack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_Struct_pack_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_Struct_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_Struct_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_Struct_iter_unpack_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(struct_Struct_locals_dict, struct_Struct_locals_dict_table);
+
+STATIC void struct_Struct_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (dest[0] != MP_OBJ_NULL) {
+        // not a load
+        return;
+    }
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    if (attr == MP_QSTR_size) {
+        dest[0] = MP_OBJ_NEW_SMALL_INT(self->size);
+    } else if (attr == MP_QSTR_format) {
+        dest[0] = self->format;
+    } else {
+        // methods, looked up here because a type with attr doesn't use its locals_dict
+        mp_map_elem_t *elem = mp_map_lookup((mp_map_t*)&struct_Struct_locals_dict.map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem != NULL) {
+            dest[0] = elem->value;
+            dest[1] = self_in;
+        }
+    }
+}
+
+STATIC const mp_obj_type_t struct_Struct_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Struct,
+    .make_new = struct_Struct_make_new,
+    .attr = struct_Struct_attr,
+    .locals_dict = (mp_obj_dict_t*)&struct_Struct_locals_dict,
+};
+
+STATIC mp_obj_t struct_iter_unpack(mp_obj_t fmt_in, mp_obj_t buf_in) {
+    mp_obj_t st = struct_Struct_make_new(&struct_Struct_type, 1, 0, &fmt_in);
+    return struct_Struct_iter_unpack(st, buf_in);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(struct_iter_unpack_obj, struct_iter_unpack);
+
+#endif // MICROPY_PY_STRUCT_STRUCT
+
 STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ustruct) },
     { MP_ROM_QSTR(MP_QSTR_calcsize), MP_ROM_PTR(&struct_calcsize_obj) },
@@ -254,6 +512,10 @@ STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_pack_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_unpack_from_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_unpack_from_obj) },
+    #if MICROPY_PY_STRUCT_STRUCT
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_iter_unpack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_Struct), MP_ROM_PTR(&struct_Struct_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_struct_globals, mp_module_struct_globals_table);
@@ -241,11 +241,27 @@
 #define MICROPY_PERSISTENT_CODE_LOAD (0)
 #endif
 
+// Whether .mpy files can be loaded from a writable, private memory mapping of
+// the file (eg mmap on POSIX), so that bytecode is linked and executed in place
+// instead of being copied to the heap; requires the port's reader to support it.
+// A mapping is released by a GC finaliser once its code is no longer reachable,
+// so without MICROPY_ENABLE_FINALISER it is kept until exit.
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+#define MICROPY_PERSISTENT_CODE_LOAD_MAPPED (0)
+#endif
+
 // Whether to support saving of persistent code
 #ifndef MICROPY_PERSISTENT_CODE_SAVE
 #define MICROPY_PERSISTENT_CODE_SAVE (0)
 #endif
 
+// Whether importing a .py file caches its compiled bytecode in a .mpc file
+// next to the source, to be reused while the source is unchanged; requires
+// MICROPY_PERSISTENT_CODE_LOAD and MICROPY_PERSISTENT_CODE_SAVE
+#ifndef MICROPY_PERSISTENT_CODE_CACHE
+#define MICROPY_PERSISTENT_CODE_CACHE (0)
+#endif
+
 // Whether generated code can persist independently of the VM/runtime instance
 // This is enabled automatically when needed by other features
 #ifndef MICROPY_PERSISTENT_CODE
@@ -358,6 +374,25 @@
 #define MICROPY_COMP_RETURN_IF_EXPR (0)
 #endif
 
+// Whether to compile "for a, b in enumerate(x)" and "for a, b in zip(x, y)"
+// so that no tuple is allocated per iteration; only plain bytecode is emitted
+#ifndef MICROPY_COMP_FOR_ENUMERATE_ZIP
+#define MICROPY_COMP_FOR_ENUMERATE_ZIP (0)
+#endif
+
+// Whether to compile tuples of constants, and dicts wrapped in const(), to a
+// single pre-built constant object instead of building them at run time
+#ifndef MICROPY_COMP_CONST_LITERAL
+#define MICROPY_COMP_CONST_LITERAL (0)
+#endif
+
+// Whether to parse and compile a module one top-level statement at a time,
+// freeing each parse tree as soon as it is compiled, which lowers the peak
+// memory needed to compile a large module; requires MICROPY_PERSISTENT_CODE
+#ifndef MICROPY_COMP_STREAMING
+#define MICROPY_COMP_STREAMING (0)
+#endif
+
 /*****************************************************************************/
 /* Internal debugging stuff                                                  */
 
@@ -395,6 +430,43 @@
 #define MICROPY_OPT_MPZ_BITWISE (0)
 #endif
 
+// Whether to multiply large mpz integers using the Karatsuba algorithm.  The
+// size above which it is used can be set with MPZ_KARATSUBA_THRESHOLD (in digits).
+#ifndef MICROPY_OPT_MPZ_KARATSUBA
+#define MICROPY_OPT_MPZ_KARATSUBA (0)
+#endif
+
+// Whether to use Montgomery multiplication for 3-arg pow() with an odd modulus
+#ifndef MICROPY_OPT_MPZ_MONTGOMERY
+#define MICROPY_OPT_MPZ_MONTGOMERY (0)
+#endif
+
+// Whether range, array and map iterators report how many items they have
+// left, so that list(), tuple(), bytes() etc can preallocate their storage
+#ifndef MICROPY_OPT_ITER_LEN_HINT
+#define MICROPY_OPT_ITER_LEN_HINT (0)
+#endif
+
+// Whether list.sort and sorted use an adaptive, stable merge sort (timsort)
+// that calls the key function once per item, instead of a quicksort
+#ifndef MICROPY_OPT_LIST_TIMSORT
+#define MICROPY_OPT_LIST_TIMSORT (0)
+#endif
+
+// Whether to cache parsed str.format and % templates for format strings that
+// are interned (eg constant strings in scripts).  Uses two small tables of root
+// pointers and heap for the templates, but avoids re-parsing the format
+// string (and its format_specs) on every call.
+#ifndef MICROPY_OPT_STR_FORMAT_CACHE
+#define MICROPY_OPT_STR_FORMAT_CACHE (0)
+#endif
+
+// Number of entries in each (2-way set associative) template cache, must be a
+// multiple of 2
+#ifndef MICROPY_OPT_STR_FORMAT_CACHE_SIZE
+#define MICROPY_OPT_STR_FORMAT_CACHE_SIZE (8)
+#endif
+
 /*****************************************************************************/
 /* Python internal features                                                  */
 
@@ -559,6 +631,24 @@ typedef double mp_float_t;
 #define MICROPY_FLOAT_HIGH_QUALITY_HASH (0)
 #endif
 
+// Whether repr/str of a float gives the shortest string that parses back to
+// the same value (using the Ryu algorithm), rather than a fixed number of
+// significant digits.  This is faster and matches CPython, but needs tables
+// of about 10k of ROM for double precision floats (600 bytes for single).
+// Requires full precision floats so can't be used with MICROPY_OBJ_REPR_C.
+#ifndef MICROPY_FLOAT_REPR_SHORTEST
+#define MICROPY_FLOAT_REPR_SHORTEST (0)
+#endif
+
+// Whether a decimal string is parsed to the correctly rounded float.  The
+// result is checked against the halfway points to its neighbours using exact
+// integer arithmetic, which needs up to 450 bytes of stack.  Digits after the
+// first 19 (9 for single precision) are only used to break ties.  Without
+// this, numbers with a large exponent may be off by a unit in the last place.
+#ifndef MICROPY_FLOAT_PARSE_EXACT
+#define MICROPY_FLOAT_PARSE_EXACT (0)
+#endif
+
 // Enable features which improve CPython compatibility
 // but may lead to more code size/memory usage.
 // TODO: Originally intended as generic category to not
@@ -711,6 +801,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_BUILTINS_MEMORYVIEW (0)
 #endif
 
+// Whether memoryview of bytes supports find, rfind, count, startswith,
+// endswith, split and decode, so buffers can be parsed without copying
+#ifndef MICROPY_PY_BUILTINS_MEMORYVIEW_BYTES_METHODS
+#define MICROPY_PY_BUILTINS_MEMORYVIEW_BYTES_METHODS (0)
+#endif
+
 // Whether to support set object
 #ifndef MICROPY_PY_BUILTINS_SET
 #define MICROPY_PY_BUILTINS_SET (1)
@@ -832,6 +928,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_MICROPYTHON_MEM_INFO (0)
 #endif
 
+// Whether to provide micropython.StringBuilder, for building up str
+// objects piece by piece without creating intermediate objects
+#ifndef MICROPY_PY_MICROPYTHON_STRINGBUILDER
+#define MICROPY_PY_MICROPYTHON_STRINGBUILDER (0)
+#endif
+
 // Whether to provide "array" module. Note that large chunk of the
 // underlying code is shared with "bytearray" builtin type, so to
 // get real savings, it should be disabled too.
@@ -845,6 +947,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_ARRAY_SLICE_ASSIGN (0)
 #endif
 
+// Whether to provide bulk operations on typed arrays in the "array" module:
+// add, mul, scale, clip, sum, min, max and dot.  Adds a few K of code.
+#ifndef MICROPY_PY_ARRAY_BULK_OPS
+#define MICROPY_PY_ARRAY_BULK_OPS (0)
+#endif
+
 // Whether to support attrtuple type (MicroPython extension)
 // It provides space-efficient tuples with attribute access
 #ifndef MICROPY_PY_ATTRTUPLE
@@ -918,6 +1026,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_STRUCT (1)
 #endif
 
+// Whether to provide "ustruct.Struct" type, which parses its format once,
+// and the "iter_unpack" function
+#ifndef MICROPY_PY_STRUCT_STRUCT
+#define MICROPY_PY_STRUCT_STRUCT (0)
+#endif
+
 // Whether to provide "sys" module
 #ifndef MICROPY_PY_SYS
 #define MICROPY_PY_SYS (1)
@@ -970,6 +1084,13 @@ typedef double mp_float_t;
 #define MICROPY_PY_USELECT (0)
 #endif
 
+// Whether uselect waits for objects that have a file descriptor (see
+// MP_STREAM_GET_FILENO) with the port's mp_uselect_wait_fds, instead of
+// polling each of them in turn until one is ready
+#ifndef MICROPY_PY_USELECT_WAIT_FDS
+#define MICROPY_PY_USELECT_WAIT_FDS (0)
+#endif
+
 // Whether to provide "utime" module functions implementation
 // in terms of mp_hal_* functions.
 #ifndef MICROPY_PY_UTIME_MP_HAL
@@ -1013,14 +1134,56 @@ typedef double mp_float_t;
 #define MICROPY_PY_UZLIB (0)
 #endif
 
+// Whether uzlib decodes huffman codes with lookup tables, which is faster
+// but adds 2KB to each decompressor
+#ifndef MICROPY_PY_UZLIB_FAST_DECODE
+#define MICROPY_PY_UZLIB_FAST_DECODE (0)
+#endif
+
+// Whether uzlib provides compress() and CompressIO
+#ifndef MICROPY_PY_UZLIB_COMPRESS
+#define MICROPY_PY_UZLIB_COMPRESS (0)
+#endif
+
 #ifndef MICROPY_PY_UJSON
 #define MICROPY_PY_UJSON (0)
 #endif
 
+// Whether ujson.dump/dumps support the "separators" argument
+#ifndef MICROPY_PY_UJSON_SEPARATORS
+#define MICROPY_PY_UJSON_SEPARATORS (0)
+#endif
+
 #ifndef MICROPY_PY_URE
 #define MICROPY_PY_URE (0)
 #endif
 
+// Whether to provide the sub() function and method
+#ifndef MICROPY_PY_URE_SUB
+#define MICROPY_PY_URE_SUB (0)
+#endif
+
+// Whether to provide the finditer() function and method
+#ifndef MICROPY_PY_URE_FINDITER
+#define MICROPY_PY_URE_FINDITER (0)
+#endif
+
+// Whether match objects have groups(), span(), start() and end()
+#ifndef MICROPY_PY_URE_MATCH_SPAN
+#define MICROPY_PY_URE_MATCH_SPAN (0)
+#endif
+
+// Whether to keep recently compiled regexes, so that the module-level
+// functions don't compile the same pattern again
+#ifndef MICROPY_PY_URE_CACHE
+#define MICROPY_PY_URE_CACHE (0)
+#endif
+
+// Number of entries in the regex cache
+#ifndef MICROPY_PY_URE_CACHE_SIZE
+#define MICROPY_PY_URE_CACHE_SIZE (8)
+#endif
+
 #ifndef MICROPY_PY_UHEAPQ
 #define MICROPY_PY_UHEAPQ (0)
 #endif
@@ -1030,6 +1193,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_UTIMEQ (0)
 #endif
 
+// Event loop core for running coroutines, using utimeq and uselect.poll
+#ifndef MICROPY_PY_UEVENTLOOP
+#define MICROPY_PY_UEVENTLOOP (0)
+#endif
+
 #ifndef MICROPY_PY_UHASHLIB
 #define MICROPY_PY_UHASHLIB (0)
 #endif
@@ -1085,6 +1253,17 @@ typedef double mp_float_t;
 #define MICROPY_PY_BTREE (0)
 #endif
 
+// Whether to provide btree stats(); berkeley-db must then be built with
+// STATISTICS, which the MICROPY_PY_BTREE_STATS make variable does
+#ifndef MICROPY_PY_BTREE_STATS
+#define MICROPY_PY_BTREE_STATS (0)
+#endif
+
+// Log-structured key/value store on a stream, needs MICROPY_PY_UZLIB
+#ifndef MICROPY_PY_KVLOG
+#define MICROPY_PY_KVLOG (0)
+#endif
+
 /*****************************************************************************/
 /* Hooks for a port to add builtins                                          */
 
@@ -162,6 +162,11 @@ typedef struct _mp_state_vm_t {
     mp_obj_dict_t *mp_module_builtins_override_dict;
     #endif
 
+    #if MICROPY_OPT_STR_FORMAT_CACHE
+    struct _str_template_t *str_format_cache[MICROPY_OPT_STR_FORMAT_CACHE_SIZE];
+    struct _str_template_t *str_modulo_cache[MICROPY_OPT_STR_FORMAT_CACHE_SIZE];
+    #endif
+
     // include any root pointers defined by a port
     MICROPY_PORT_ROOT_POINTERS
 
@@ -176,6 +181,10 @@ typedef struct _mp_state_vm_t {
     mp_obj_t lwip_slip_stream;
     #endif
 
+    #if MICROPY_PY_URE && MICROPY_PY_URE_CACHE
+    mp_obj_t ure_cache[MICROPY_PY_URE_CACHE_SIZE];
+    #endif
+
     #if MICROPY_VFS
     struct _mp_vfs_mount_t *vfs_cur;
     struct _mp_vfs_mount_t *vfs_mount_table;
@@ -198,6 +207,11 @@ typedef struct _mp_state_vm_t {
 
     mp_uint_t mp_optimise_value;
 
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    // whether imports read and write cached bytecode
+    bool persistent_code_cache;
+    #endif
+
     // size of the emergency exception buf, if it's dynamically allocated
     #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0
     mp_int_t mp_emergency_exception_buf_size;
@@ -36,6 +36,16 @@
 #define DIG_MSB  (MPZ_LONG_1 << (DIG_SIZE - 1))
 #define DIG_BASE (MPZ_LONG_1 << DIG_SIZE)
 
+#if MICROPY_OPT_MPZ_KARATSUBA
+// operands with at least this many digits are multiplied using Karatsuba
+#ifndef MPZ_KARATSUBA_THRESHOLD
+#define MPZ_KARATSUBA_THRESHOLD (48)
+#endif
+#endif
+
+// denominators up to this many digits are normalised on the stack in mpn_div
+#define MPZ_DIV_STACK_DIGS (16)
+
 /*
  mpz is an arbitrary precision integer type with a public API.
 
@@ -424,7 +434,7 @@ STATIC size_t mpn_mul_dig_add_dig(mpz_dig_t *idig, size_t ilen, mpz_dig_t dmul,
    assumes enough memory in i; assumes i is zeroed; assumes normalised j, k
    can have j, k point to same memory
 */
-STATIC size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *kdig, size_t klen) {
+STATIC size_t mpn_mul(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, const mpz_dig_t *kdig, size_t klen) {
     mpz_dig_t *oidig = idig;
     size_t ilen = 0;
 
@@ -433,7 +443,7 @@ STATIC size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *
         mpz_dbl_dig_t carry = 0;
 
         size_t jl = jlen;
-        for (mpz_dig_t *jd = jdig; jl > 0; --jl, ++jd, ++id) {
+        for (const mpz_dig_t *jd = jdig; jl > 0; --jl, ++jd, ++id) {
             carry += (mpz_dbl_dig_t)*id + (mpz_dbl_dig_t)*jd * (mpz_dbl_dig_t)*kdig; // will never overflow so long as DIG_SIZE <= 8*sizeof(mpz_dbl_dig_t)/2
             *id = carry & DIG_MASK;
             carry >>= DIG_SIZE;
@@ -449,6 +459,158 @@ STATIC size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *
     return ilen;
 }
 
+#if MICROPY_OPT_MPZ_KARATSUBA
+
+/* returns the number of scratch digits needed by mpn_mul_karatsuba for
+   n-digit operands
+*/
+STATIC size_t mpn_mul_karatsuba_scratch(size_t n) {
+    size_t s = 0;
+    while (n >= MPZ_KARATSUBA_THRESHOLD) {
+        n = (n + 1) / 2 + 1;
+        s += 4 * n;
+    }
+    return s;
+}
+
+/* computes i = j * k using Karatsuba multiplication, where j, k have n digits
+   each (they need not be normalised) and i has room for exactly 2 * n digits
+   scratch must have mpn_mul_karatsuba_scratch(n) digits
+   can have j, k point to same memory
+*/
+STATIC void mpn_mul_karatsuba(mpz_dig_t *idig, const mpz_dig_t *jdig, const mpz_dig_t *kdig, size_t n, mpz_dig_t *scratch) {
+    if (n < MPZ_KARATSUBA_THRESHOLD) {
+        memset(idig, 0, 2 * n * sizeof(mpz_dig_t));
+        mpn_mul(idig, jdig, n, kdig, n);
+        return;
+    }
+
+    // split j = j1 * B^h + j0 and k = k1 * B^h + k0, where j1, k1 have hh >= h digits
+    size_t h = n / 2;
+    size_t hh = n - h;
+
+    // i = z2 * B^(2h) + z0, where z0 = j0 * k0 and z2 = j1 * k1
+    mpz_dig_t *sj = scratch;
+    mpz_dig_t *sk = sj + hh + 1;
+    mpz_dig_t *z1 = sk + hh + 1;
+    mpz_dig_t *next_scratch = z1 + 2 * (hh + 1);
+    mpn_mul_karatsuba(idig, jdig, kdig, h, next_scratch);
+    mpn_mul_karatsuba(idig + 2 * h, jdig + h, kdig + h, hh, next_scratch);
+
+    // z1 = (j0 + j1) * (k0 + k1) - z0 - z2
+    sj[hh] = 0;
+    mpn_add(sj, jdig + h, hh, jdig, h);
+    sk[hh] = 0;
+    mpn_add(sk, kdig + h, hh, kdig, h);
+    mpn_mul_karatsuba(z1, sj, sk, hh + 1, next_scratch);
+    mpn_sub(z1, z1, 2 * (hh + 1), idig, 2 * h);
+    size_t z1_len = mpn_sub(z1, z1, 2 * (hh + 1), idig + 2 * h, 2 * hh);
+
+    // i += z1 * B^h; the result fits in 2 * n digits so there is no final carry
+    mpn_add(idig + h, idig + h, 2 * n - h, z1, z1_len);
+}
+
+/* computes i = j * k, using Karatsuba on klen-digit chunks of j when the
+   operands are large enough
+   returns number of digits in i
+   assumes enough memory in i; assumes normalised j, k; assumes jlen >= klen
+   i must be zeroed and must not overlap j or k
+*/
+STATIC size_t mpn_mul_fast(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, const mpz_dig_t *kdig, size_t klen) {
+    if (klen < MPZ_KARATSUBA_THRESHOLD) {
+        return mpn_mul(idig, jdig, jlen, kdig, klen);
+    }
+
+    // buffer holds the product of one chunk, a zero-padded final chunk, and the scratch space
+    size_t buf_len = 3 * klen + mpn_mul_karatsuba_scratch(klen);
+    mpz_dig_t *buf = m_new(mpz_dig_t, buf_len);
+    mpz_dig_t *prod = buf;
+    mpz_dig_t *pad = prod + 2 * klen;
+    mpz_dig_t *scratch = pad + klen;
+
+    for (size_t o = 0; o < jlen; o += klen) {
+        const mpz_dig_t *chunk = jdig + o;
+        if (jlen - o < klen) {
+            memcpy(pad, chunk, (jlen - o) * sizeof(mpz_dig_t));
+            memset(pad + jlen - o, 0, (klen - jlen + o) * sizeof(mpz_dig_t));
+            chunk = pad;
+        }
+        mpn_mul_karatsuba(prod, chunk, kdig, klen, scratch);
+        size_t prod_len = mpn_remove_trailing_zeros(prod, prod + 2 * klen);
+
+        // digits of i above o + klen are still zero, so the sum fits in 2 * klen digits
+        size_t ilen = MIN(jlen + klen - o, 2 * klen);
+        mpn_add(idig + o, idig + o, ilen, prod, prod_len);
+    }
+
+    m_del(mpz_dig_t, buf, buf_len);
+
+    return mpn_remove_trailing_zeros(idig, idig + jlen + klen);
+}
+
+#endif
+
+#if MICROPY_OPT_MPZ_MONTGOMERY
+
+/* returns -m^-1 mod 2^DIG_SIZE, for odd m0 (the least significant digit of m)
+*/
+STATIC mpz_dig_t mpn_mont_inv(mpz_dig_t m0) {
+    // m0 is its own inverse modulo 8, and each Newton step doubles the number of correct bits
+    mpz_dbl_dig_t inv = m0;
+    for (int i = 0; i < 5; ++i) {
+        inv = (inv * (2 - m0 * inv)) & DIG_MASK;
+    }
+    return (0 - inv) & DIG_MASK;
+}
+
+/* computes i = j * k * B^-n mod m (Montgomery multiplication, CIOS method)
+   j, k must be less than m, which is odd and has exactly n digits; i has n digits
+   minv is mpn_mont_inv(m[0]); t is scratch space with n + 2 digits
+   can have i, j, k point to same memory
+*/
+STATIC void mpn_mont_mul(mpz_dig_t *idig, const mpz_dig_t *jdig, const mpz_dig_t *kdig, const mpz_dig_t *mdig, size_t n, mpz_dig_t minv, mpz_dig_t *t) {
+    memset(t, 0, (n + 2) * sizeof(mpz_dig_t));
+
+    for (size_t i = 0; i < n; ++i) {
+        // t += j[i] * k
+        mpz_dbl_dig_t carry = 0;
+        for (size_t x = 0; x < n; ++x) {
+            carry += (mpz_dbl_dig_t)t[x] + (mpz_dbl_dig_t)jdig[i] * kdig[x];
+            t[x] = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+        carry += t[n];
+        t[n] = carry & DIG_MASK;
+        t[n + 1] = carry >> DIG_SIZE;
+
+        // t = (t + u * m) / B, where u is chosen so the division is exact
+        mpz_dbl_dig_t u = ((mpz_dbl_dig_t)t[0] * minv) & DIG_MASK;
+        carry = ((mpz_dbl_dig_t)t[0] + u * mdig[0]) >> DIG_SIZE;
+        for (size_t x = 1; x < n; ++x) {
+            carry += (mpz_dbl_dig_t)t[x] + u * mdig[x];
+            t[x - 1] = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+        carry += t[n];
+        t[n - 1] = carry & DIG_MASK;
+        t[n] = t[n + 1] + (carry >> DIG_SIZE);
+    }
+
+    // t < 2 * m, so at most one subtraction of m is needed
+    if (t[n] != 0 || mpn_cmp(t, n, mdig, n) >= 0) {
+        mpz_dbl_dig_signed_t borrow = 0;
+        for (size_t x = 0; x < n; ++x) {
+            borrow += (mpz_dbl_dig_t)t[x] - (mpz_dbl_dig_t)mdig[x];
+            idig[x] = borrow & DIG_MASK;
+            borrow >>= DIG_SIZE;
+        }
+    } else {
+        memcpy(idig, t, n * sizeof(mpz_dig_t));
+    }
+}
+
+#endif
+
 /* natural_div - quo * den + new_num = old_num (ie num is replaced with rem)
    assumes den != 0
    assumes num_dig has enough memory to be extended by 1 digit
@@ -459,7 +621,6 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
     mpz_dig_t *orig_num_dig = num_dig;
     mpz_dig_t *orig_quo_dig = quo_dig;
     mpz_dig_t norm_shift = 0;
-    mpz_dbl_dig_t lead_den_digit;
 
     // handle simple cases
     {
@@ -476,10 +637,28 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
         }
     }
 
+    // a single digit denominator needs only one pass of short division
+    if (den_len == 1) {
+        mpz_dbl_dig_t den = den_dig[0];
+        mpz_dbl_dig_t rem = 0;
+        for (size_t i = *num_len; i > 0; --i) {
+            rem = (rem << DIG_SIZE) | num_dig[i - 1];
+            quo_dig[i - 1] = rem / den;
+            rem %= den;
+        }
+        *quo_len = *num_len;
+        while (*quo_len > 0 && quo_dig[*quo_len - 1] == 0) {
+            --(*quo_len);
+        }
+        num_dig[0] = rem;
+        *num_len = rem != 0;
+        return;
+    }
+
     // We need to normalise the denominator (leading bit of leading digit is 1)
-    // so that the division routine works.  Since the denominator memory is
-    // read-only we do the normalisation on the fly, each time a digit of the
-    // denominator is needed.  We need to know is how many bits to shift by.
+    // so that the quotient estimate below is off by at most one.  The
+    // denominator memory is read-only so the normalised copy goes in a
+    // temporary buffer, on the stack if it is small enough.
 
     // count number of leading zeros in leading digit of denominator
     {
@@ -490,6 +669,19 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
         }
     }
 
+    mpz_dig_t den_stack[MPZ_DIV_STACK_DIGS];
+    mpz_dig_t *den = den_stack;
+    if (den_len > MPZ_DIV_STACK_DIGS) {
+        den = m_new(mpz_dig_t, den_len);
+    }
+    {
+        mpz_dbl_dig_t d_norm = 0;
+        for (size_t i = 0; i < den_len; ++i) {
+            d_norm = ((mpz_dbl_dig_t)den_dig[i] << norm_shift) | (d_norm >> DIG_SIZE);
+            den[i] = d_norm & DIG_MASK;
+        }
+    }
+
     // now need to shift numerator by same amount as denominator
     // first, increase length of numerator in case we need more room to shift
     num_dig[*num_len] = 0;
@@ -500,11 +692,9 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
         carry = (mpz_dbl_dig_t)n >> (DIG_SIZE - norm_shift);
     }
 
-    // cache the leading digit of the denominator
-    lead_den_digit = (mpz_dbl_dig_t)den_dig[den_len - 1] << norm_shift;
-    if (den_len >= 2) {
-        lead_den_digit |= (mpz_dbl_dig_t)den_dig[den_len - 2] >> (DIG_SIZE - norm_shift);
-    }
+    // cache the two leading digits of the denominator
+    mpz_dbl_dig_t lead_den_digit = den[den_len - 1];
+    mpz_dbl_dig_t next_den_digit = den[den_len - 2];
 
     // point num_dig to last digit in numerator
     num_dig += *num_len - 1;
@@ -517,103 +707,47 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
 
     // keep going while we have enough digits to divide
     while (*num_len > den_len) {
+        // estimate the quotient digit from the leading two digits of the
+        // numerator, then refine it using the second digit of the denominator
+        // (Knuth, TAOCP vol 2, 4.3.1, algorithm D, step D3)
         mpz_dbl_dig_t quo = ((mpz_dbl_dig_t)*num_dig << DIG_SIZE) | num_dig[-1];
-
-        // get approximate quotient
+        mpz_dbl_dig_t rem = quo % lead_den_digit;
         quo /= lead_den_digit;
-
-        // Multiply quo by den and subtract from num to get remainder.
-        // We have different code here to handle different compile-time
-        // configurations of mpz:
-        //
-        //   1. DIG_SIZE is stricly less than half the number of bits
-        //      available in mpz_dbl_dig_t.  In this case we can use a
-        //      slightly more optimal (in time and space) routine that
-        //      uses the extra bits in mpz_dbl_dig_signed_t to store a
-        //      sign bit.
-        //
-        //   2. DIG_SIZE is exactly half the number of bits available in
-        //      mpz_dbl_dig_t.  In this (common) case we need to be careful
-        //      not to overflow the borrow variable.  And the shifting of
-        //      borrow needs some special logic (it's a shift right with
-        //      round up).
-
-        if (DIG_SIZE < 8 * sizeof(mpz_dbl_dig_t) / 2) {
-            const mpz_dig_t *d = den_dig;
-            mpz_dbl_dig_t d_norm = 0;
-            mpz_dbl_dig_signed_t borrow = 0;
-
-            for (mpz_dig_t *n = num_dig - den_len; n < num_dig; ++n, ++d) {
-                d_norm = ((mpz_dbl_dig_t)*d << norm_shift) | (d_norm >> DIG_SIZE);
-                borrow += (mpz_dbl_dig_t)*n - (mpz_dbl_dig_t)quo * (d_norm & DIG_MASK); // will overflow if DIG_SIZE >= 8*sizeof(mpz_dbl_dig_t)/2
-                *n = borrow & DIG_MASK;
-                borrow >>= DIG_SIZE;
-            }
-            borrow += *num_dig; // will overflow if DIG_SIZE >= 8*sizeof(mpz_dbl_dig_t)/2
-            *num_dig = borrow & DIG_MASK;
-            borrow >>= DIG_SIZE;
-
-            // adjust quotient if it is too big
-            for (; borrow != 0; --quo) {
-                d = den_dig;
-                d_norm = 0;
-                mpz_dbl_dig_t carry = 0;
-                for (mpz_dig_t *n = num_dig - den_len; n < num_dig; ++n, ++d) {
-                    d_norm = ((mpz_dbl_dig_t)*d << norm_shift) | (d_norm >> DIG_SIZE);
-                    carry += (mpz_dbl_dig_t)*n + (d_norm & DIG_MASK);
-                    *n = carry & DIG_MASK;
-                    carry >>= DIG_SIZE;
-                }
-                carry += *num_dig;
-                *num_dig = carry & DIG_MASK;
-                carry >>= DIG_SIZE;
-
-                borrow += carry;
-            }
-        } else { // DIG_SIZE == 8 * sizeof(mpz_dbl_dig_t) / 2
-            const mpz_dig_t *d = den_dig;
-            mpz_dbl_dig_t d_norm = 0;
-            mpz_dbl_dig_t borrow = 0;
-
-            for (mpz_dig_t *n = num_dig - den_len; n < num_dig; ++n, ++d) {
-                d_norm = ((mpz_dbl_dig_t)*d << norm_shift) | (d_norm >> DIG_SIZE);
-                mpz_dbl_dig_t x = (mpz_dbl_dig_t)quo * (d_norm & DIG_MASK);
-                if (x >= *n || *n - x <= borrow) {
-                    borrow += (mpz_dbl_dig_t)x - (mpz_dbl_dig_t)*n;
-                    *n = (-borrow) & DIG_MASK;
-                    borrow = (borrow >> DIG_SIZE) + ((borrow & DIG_MASK) == 0 ? 0 : 1); // shift-right with round-up
-                } else {
-                    *n = ((mpz_dbl_dig_t)*n - (mpz_dbl_dig_t)x - (mpz_dbl_dig_t)borrow) & DIG_MASK;
-                    borrow = 0;
-                }
-            }
-            if (borrow >= *num_dig) {
-                borrow -= (mpz_dbl_dig_t)*num_dig;
-                *num_dig = (-borrow) & DIG_MASK;
-                borrow = (borrow >> DIG_SIZE) + ((borrow & DIG_MASK) == 0 ? 0 : 1); // shift-right with round-up
-            } else {
-                *num_dig = (*num_dig - borrow) & DIG_MASK;
-                borrow = 0;
+        while (quo >= DIG_BASE || quo * next_den_digit > ((rem << DIG_SIZE) | num_dig[-2])) {
+            --quo;
+            rem += lead_den_digit;
+            if (rem >= DIG_BASE) {
+                break;
             }
+        }
 
-            // adjust quotient if it is too big
-            for (; borrow != 0; --quo) {
-                d = den_dig;
-                d_norm = 0;
-                mpz_dbl_dig_t carry = 0;
-                for (mpz_dig_t *n = num_dig - den_len; n < num_dig; ++n, ++d) {
-                    d_norm = ((mpz_dbl_dig_t)*d << norm_shift) | (d_norm >> DIG_SIZE);
-                    carry += (mpz_dbl_dig_t)*n + (d_norm & DIG_MASK);
-                    *n = carry & DIG_MASK;
-                    carry >>= DIG_SIZE;
-                }
-                carry += (mpz_dbl_dig_t)*num_dig;
-                *num_dig = carry & DIG_MASK;
+        // multiply quo by den and subtract from num, keeping the carry of the
+        // product separate from the borrow of the subtraction so that neither
+        // can overflow mpz_dbl_dig_t
+        mpz_dig_t *n = num_dig - den_len;
+        mpz_dbl_dig_t carry = 0;
+        mpz_dig_t borrow = 0;
+        for (size_t i = 0; i < den_len; ++i) {
+            mpz_dbl_dig_t prod = quo * den[i] + carry;
+            carry = prod >> DIG_SIZE;
+            mpz_dbl_dig_t diff = (mpz_dbl_dig_t)n[i] - (prod & DIG_MASK) - borrow;
+            n[i] = diff & DIG_MASK;
+            borrow = (diff >> DIG_SIZE) != 0;
+        }
+        carry += borrow;
+        borrow = carry > *num_dig;
+        *num_dig = (*num_dig - carry) & DIG_MASK;
+
+        // the estimate is rarely one too big; if so add back the denominator
+        if (borrow) {
+            --quo;
+            carry = 0;
+            for (size_t i = 0; i < den_len; ++i) {
+                carry += (mpz_dbl_dig_t)n[i] + den[i];
+                n[i] = carry & DIG_MASK;
                 carry >>= DIG_SIZE;
-
-                //assert(borrow >= carry); // enable this to check the logic
-                borrow -= carry;
             }
+            *num_dig = (*num_dig + carry) & DIG_MASK;
         }
 
         // store this digit of the quotient
@@ -625,6 +759,10 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
         --(*num_len);
     }
 
+    if (den != den_stack) {
+        m_del(mpz_dig_t, den, den_len);
+    }
+
     // unnormalise numerator (remainder now)
     for (mpz_dig_t *num = orig_num_dig + *num_len - 1, carry = 0; num >= orig_num_dig; --num) {
         mpz_dig_t n = *num;
@@ -884,6 +1022,12 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
         z->neg = 0;
     }
 
+    // Accumulate as many characters as fit in one digit, so that the
+    // (quadratic) multiply-add over the whole number is done once per chunk
+    // rather than once per character.
+    mpz_dig_t chunk_mul = 1;
+    mpz_dig_t chunk_val = 0;
+
     z->len = 0;
     for (; cur < top; ++cur) { // XXX UTF8 next char
         //mp_uint_t v = char_to_numeric(cur#); // XXX UTF8 get char
@@ -900,7 +1044,16 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
         if (v >= base) {
             break;
         }
-        z->len = mpn_mul_dig_add_dig(z->dig, z->len, base, v);
+        chunk_mul *= base;
+        chunk_val = chunk_val * base + v;
+        if (chunk_mul > DIG_MASK / base) {
+            z->len = mpn_mul_dig_add_dig(z->dig, z->len, chunk_mul, chunk_val);
+            chunk_mul = 1;
+            chunk_val = 0;
+        }
+    }
+    if (chunk_mul > 1) {
+        z->len = mpn_mul_dig_add_dig(z->dig, z->len, chunk_mul, chunk_val);
     }
 
     return cur - str;
@@ -1341,7 +1494,15 @@ void mpz_mul_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
 
     mpz_need_dig(dest, lhs->len + rhs->len); // min mem l+r-1, max mem l+r
     memset(dest->dig, 0, dest->alloc * sizeof(mpz_dig_t));
+    #if MICROPY_OPT_MPZ_KARATSUBA
+    if (lhs->len >= rhs->len) {
+        dest->len = mpn_mul_fast(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    } else {
+        dest->len = mpn_mul_fast(dest->dig, rhs->dig, rhs->len, lhs->dig, lhs->len);
+    }
+    #else
     dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    #endif
 
     if (lhs->neg == rhs->neg) {
         dest->neg = 0;
@@ -1389,6 +1550,88 @@ void mpz_pow_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
 /* computes dest = (lhs ** rhs) % mod
    can have dest, lhs, rhs the same; mod can't be the same as dest
 */
+#if MICROPY_OPT_MPZ_MONTGOMERY
+
+// returns the w-bit window of z starting at bit pos
+STATIC mp_uint_t mpz_get_bits(const mpz_t *z, size_t pos, unsigned int w) {
+    mp_uint_t v = 0;
+    for (size_t p = pos + w; p-- > pos;) {
+        v <<= 1;
+        if (p / DIG_SIZE < z->len) {
+            v |= (z->dig[p / DIG_SIZE] >> (p % DIG_SIZE)) & 1;
+        }
+    }
+    return v;
+}
+
+/* computes dest = lhs ** rhs % mod using Montgomery multiplication and a
+   fixed window over the bits of rhs
+   assumes mod is positive and odd, and rhs is positive
+*/
+STATIC void mpz_pow3_mont(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t *mod) {
+    size_t n = mod->len;
+    mpz_dig_t minv = mpn_mont_inv(mod->dig[0]);
+
+    size_t num_bits = (rhs->len - 1) * DIG_SIZE;
+    for (mpz_dig_t top = rhs->dig[rhs->len - 1]; top != 0; top >>= 1) {
+        ++num_bits;
+    }
+    unsigned int w = num_bits > 64 ? 4 : 1;
+
+    // buffer holds the table of lhs ** i for i < 2 ** w, the accumulator and the scratch space
+    size_t buf_len = ((1 << w) + 1) * n + n + 2;
+    mpz_dig_t *buf = m_new0(mpz_dig_t, buf_len);
+    mpz_dig_t *table = buf;
+    mpz_dig_t *acc = table + (n << w);
+    mpz_dig_t *t = acc + n;
+
+    // convert 1 and lhs to Montgomery form (multiplied by B^n, mod m)
+    {
+        mpz_t temp, quo;
+        mpz_init_zero(&temp);
+        mpz_init_zero(&quo);
+        mpz_set_from_int(&temp, 1);
+        mpz_shl_inpl(&temp, &temp, n * DIG_SIZE);
+        mpz_divmod_inpl(&quo, &temp, &temp, mod);
+        memcpy(table, temp.dig, temp.len * sizeof(mpz_dig_t));
+        mpz_shl_inpl(&temp, lhs, n * DIG_SIZE);
+        mpz_divmod_inpl(&quo, &temp, &temp, mod);
+        memcpy(table + n, temp.dig, temp.len * sizeof(mpz_dig_t));
+        mpz_deinit(&temp);
+        mpz_deinit(&quo);
+    }
+    for (size_t i = 2; i < ((size_t)1 << w); ++i) {
+        mpn_mont_mul(table + i * n, table + (i - 1) * n, table + n, mod->dig, n, minv, t);
+    }
+
+    // left-to-right exponentiation, starting with the most significant window
+    size_t pos = (num_bits - 1) / w * w;
+    memcpy(acc, table + mpz_get_bits(rhs, pos, w) * n, n * sizeof(mpz_dig_t));
+    while (pos > 0) {
+        pos -= w;
+        for (unsigned int i = 0; i < w; ++i) {
+            mpn_mont_mul(acc, acc, acc, mod->dig, n, minv, t);
+        }
+        mp_uint_t bits = mpz_get_bits(rhs, pos, w);
+        if (bits != 0) {
+            mpn_mont_mul(acc, acc, table + bits * n, mod->dig, n, minv, t);
+        }
+    }
+
+    // convert back from Montgomery form by multiplying by 1
+    memset(table, 0, n * sizeof(mpz_dig_t));
+    table[0] = 1;
+    mpn_mont_mul(acc, acc, table, mod->dig, n, minv, t);
+    mpz_need_dig(dest, n);
+    memcpy(dest->dig, acc, n * sizeof(mpz_dig_t));
+    dest->len = mpn_remove_trailing_zeros(dest->dig, dest->dig + n);
+    dest->neg = 0;
+
+    m_del(mpz_dig_t, buf, buf_len);
+}
+
+#endif
+
 void mpz_pow3_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t *mod) {
     if (lhs->len == 0 || rhs->neg != 0) {
         mpz_set_from_int(dest, 0);
@@ -1400,6 +1643,13 @@ void mpz_pow3_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t
         return;
     }
 
+    #if MICROPY_OPT_MPZ_MONTGOMERY
+    if (mod->neg == 0 && mod->len > 0 && (mod->dig[0] & 1) != 0) {
+        mpz_pow3_mont(dest, lhs, rhs, mod);
+        return;
+    }
+    #endif
+
     mpz_t *x = mpz_clone(lhs);
     mpz_t *n = mpz_clone(rhs);
     mpz_t quo; mpz_init_zero(&quo);
@@ -1676,6 +1926,21 @@ char *mpz_as_str(const mpz_t *i, unsigned int base) {
 
 // assumes enough space as calculated by mp_int_format_size
 // returns length of string, not including null byte
+// appends a character for the numeric value v to the reversed string s,
+// inserting a comma before every group of 3 characters after the first
+STATIC char *mpz_as_str_put_char(char *s, char **last_comma, mpz_dbl_dig_t v, char base_char, char comma) {
+    if (comma && (s - *last_comma) == 3) {
+        *s++ = comma;
+        *last_comma = s;
+    }
+    v += '0';
+    if (v > '9') {
+        v += base_char - '9' - 1;
+    }
+    *s++ = v;
+    return s;
+}
+
 size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, char base_char, char comma, char *str) {
     if (str == NULL) {
         return 0;
@@ -1698,48 +1963,69 @@ size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, ch
         return s - str;
     }
 
-    // make a copy of mpz digits, so we can do the div/mod calculation
-    mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
-    memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
-
-    // convert
+    // convert, generating characters from least to most significant
     char *last_comma = str;
-    bool done;
-    do {
-        mpz_dig_t *d = dig + ilen;
-        mpz_dbl_dig_t a = 0;
-
-        // compute next remainder
-        while (--d >= dig) {
-            a = (a << DIG_SIZE) | *d;
-            *d = a / base;
-            a %= base;
-        }
 
-        // convert to character
-        a += '0';
-        if (a > '9') {
-            a += base_char - '9' - 1;
+    if ((base & (base - 1)) == 0) {
+        // power-of-2 base: extract the bits of each character directly
+        unsigned int bits = 0;
+        while ((1U << bits) < base) {
+            ++bits;
         }
-        *s++ = a;
-
-        // check if number is zero
-        done = true;
-        for (d = dig; d < dig + ilen; ++d) {
-            if (*d != 0) {
-                done = false;
-                break;
+        size_t num_bits = (ilen - 1) * DIG_SIZE;
+        for (mpz_dig_t top = i->dig[ilen - 1]; top != 0; top >>= 1) {
+            ++num_bits;
+        }
+        for (size_t pos = 0; pos < num_bits; pos += bits) {
+            size_t n = pos / DIG_SIZE;
+            mpz_dbl_dig_t a = i->dig[n];
+            if (n + 1 < ilen) {
+                a |= (mpz_dbl_dig_t)i->dig[n + 1] << DIG_SIZE;
             }
+            a = (a >> (pos % DIG_SIZE)) & (base - 1);
+            s = mpz_as_str_put_char(s, &last_comma, a, base_char, comma);
         }
-        if (comma && (s - last_comma) == 3) {
-            *s++ = comma;
-            last_comma = s;
+    } else {
+        // find the largest power of the base that fits in a digit, so that
+        // each (quadratic) division pass over the number yields many characters
+        mpz_dig_t chunk_base = base;
+        unsigned int chunk_chars = 1;
+        while (chunk_base <= DIG_MASK / base) {
+            chunk_base *= base;
+            ++chunk_chars;
         }
-    }
-    while (!done);
 
-    // free the copy of the digits array
-    m_del(mpz_dig_t, dig, ilen);
+        // make a copy of mpz digits, so we can do the div/mod calculation
+        size_t alloc = ilen;
+        mpz_dig_t *dig = m_new(mpz_dig_t, alloc);
+        memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
+
+        while (ilen > 0) {
+            mpz_dig_t *d = dig + ilen;
+            mpz_dbl_dig_t a = 0;
+
+            // compute next remainder
+            while (--d >= dig) {
+                a = (a << DIG_SIZE) | *d;
+                *d = a / chunk_base;
+                a %= chunk_base;
+            }
+
+            // drop the leading digits that are now zero
+            while (ilen > 0 && dig[ilen - 1] == 0) {
+                --ilen;
+            }
+
+            // convert to characters, without leading zeros in the last chunk
+            for (unsigned int n = 0; n < chunk_chars && (ilen > 0 || a != 0); ++n) {
+                s = mpz_as_str_put_char(s, &last_comma, a % base, base_char, comma);
+                a /= base;
+            }
+        }
+
+        // free the copy of the digits array
+        m_del(mpz_dig_t, dig, alloc);
+    }
 
     if (prefix) {
         const char *p = &prefix[strlen(prefix)];
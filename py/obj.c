@@ -442,6 +442,26 @@ mp_obj_t mp_obj_len_maybe(mp_obj_t o_in) {
     }
 }
 
+// Returns the number of items that iterating over o_in is expected to yield,
+// or 0 if that is not known.  It's only used to preallocate storage so callers
+// must still handle any number of items.  No user code is run to compute it.
+size_t mp_obj_len_hint(mp_obj_t o_in) {
+    mp_obj_type_t *type = mp_obj_get_type(o_in);
+    if (mp_obj_is_instance_type(type)) {
+        return 0;
+    }
+    mp_obj_t len = mp_obj_len_maybe(o_in);
+    #if MICROPY_OPT_ITER_LEN_HINT
+    if (len == MP_OBJ_NULL && type->unary_op != NULL) {
+        len = type->unary_op(MP_UNARY_OP_LEN_HINT, o_in);
+    }
+    #endif
+    if (MP_OBJ_IS_SMALL_INT(len) && MP_OBJ_SMALL_INT_VALUE(len) > 0) {
+        return MP_OBJ_SMALL_INT_VALUE(len);
+    }
+    return 0;
+}
+
 mp_obj_t mp_obj_subscr(mp_obj_t base, mp_obj_t index, mp_obj_t value) {
     mp_obj_type_t *type = mp_obj_get_type(base);
     if (type->subscr != NULL) {
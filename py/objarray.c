@@ -130,26 +130,23 @@ STATIC mp_obj_t array_construct(char typecode, mp_obj_t initializer) {
         return MP_OBJ_FROM_PTR(o);
     }
 
-    size_t len;
-    // Try to create array of exact len if initializer len is known
-    mp_obj_t len_in = mp_obj_len_maybe(initializer);
-    if (len_in == MP_OBJ_NULL) {
-        len = 0;
-    } else {
-        len = MP_OBJ_SMALL_INT_VALUE(len_in);
+    // Preallocate the array if the number of items is (likely) known; it's
+    // filled by appending in case the iterable yields a different number
+    mp_obj_array_t *array = array_new(typecode, 0);
+    size_t len = mp_obj_len_hint(initializer);
+    size_t sz = mp_binary_get_size('@', typecode, NULL);
+    if (len > 0 && len <= SIZE_MAX / sz) {
+        byte *items = m_renew_maybe(byte, array->items, 0, sz * len, true);
+        if (items != NULL) {
+            array->items = items;
+            array->free = len;
+        }
     }
 
-    mp_obj_array_t *array = array_new(typecode, len);
-
     mp_obj_t iterable = mp_getiter(initializer, NULL);
     mp_obj_t item;
-    size_t i = 0;
     while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
-        if (len == 0) {
-            array_append(MP_OBJ_FROM_PTR(array), item);
-        } else {
-            mp_binary_set_val_array(typecode, array->items, i++, item);
-        }
+        array_append(MP_OBJ_FROM_PTR(array), item);
     }
 
     return MP_OBJ_FROM_PTR(array);
@@ -229,6 +226,16 @@ STATIC mp_obj_t memoryview_make_new(const mp_obj_type_t *type_in, size_t n_args,
 
     return MP_OBJ_FROM_PTR(self);
 }
+
+// Make a new memoryview referring to a sub-range of the given one
+STATIC mp_obj_t memoryview_new_slice(mp_obj_t self_in, size_t start, size_t len) {
+    mp_obj_array_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_array_t *res = m_new_obj(mp_obj_array_t);
+    *res = *self;
+    res->free += start;
+    res->len = len;
+    return MP_OBJ_FROM_PTR(res);
+}
 #endif
 
 STATIC mp_obj_t array_unary_op(mp_uint_t op, mp_obj_t o_in) {
@@ -276,12 +283,17 @@ STATIC mp_obj_t array_binary_op(mp_uint_t op, mp_obj_t lhs_in, mp_obj_t rhs_in)
             mp_buffer_info_t lhs_bufinfo;
             mp_buffer_info_t rhs_bufinfo;
 
-            // Can search string only in bytearray
+            // Can search string only in bytearray (or memoryview of bytes)
             if (mp_get_buffer(rhs_in, &rhs_bufinfo, MP_BUFFER_READ)) {
-                if (!MP_OBJ_IS_TYPE(lhs_in, &mp_type_bytearray)) {
+                array_get_buffer(lhs_in, &lhs_bufinfo, MP_BUFFER_READ);
+                if (!MP_OBJ_IS_TYPE(lhs_in, &mp_type_bytearray)
+                    #if MICROPY_PY_BUILTINS_MEMORYVIEW_BYTES_METHODS
+                    && !(MP_OBJ_IS_TYPE(lhs_in, &mp_type_memoryview)
+                        && mp_binary_get_size('@', lhs_bufinfo.typecode, NULL) == 1)
+                    #endif
+                    ) {
                     return mp_const_false;
                 }
-                array_get_buffer(lhs_in, &lhs_bufinfo, MP_BUFFER_READ);
                 return mp_obj_new_bool(
                     find_subbytes(lhs_bufinfo.buf, lhs_bufinfo.len, rhs_bufinfo.buf, rhs_bufinfo.len, 1) != NULL);
             }
@@ -318,8 +330,8 @@ STATIC mp_obj_t array_append(mp_obj_t self_in, mp_obj_t arg) {
 
     if (self->free == 0) {
         size_t item_sz = mp_binary_get_size('@', self->typecode, NULL);
-        // TODO: alloc policy
-        self->free = 8;
+        // grow by half the current length so repeated appends are amortised O(1)
+        self->free = 8 + self->len / 2;
         self->items = m_renew(byte, self->items, item_sz * self->len, item_sz * (self->len + self->free));
         mp_seq_clear(self->items, self->len + 1, self->len + self->free, item_sz);
     }
@@ -458,10 +470,7 @@ STATIC mp_obj_t array_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value
                 // dummy
             #if MICROPY_PY_BUILTINS_MEMORYVIEW
             } else if (o->base.type == &mp_type_memoryview) {
-                res = m_new_obj(mp_obj_array_t);
-                *res = *o;
-                res->free += slice.start;
-                res->len = slice.stop - slice.start;
+                return memoryview_new_slice(self_in, slice.start, slice.stop - slice.start);
             #endif
             } else {
                 res = array_new(o->typecode, slice.stop - slice.start);
@@ -551,6 +560,187 @@ const mp_obj_type_t mp_type_bytearray = {
 };
 #endif
 
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_BYTES_METHODS
+// These methods mirror those of bytes but work directly on the underlying
+// buffer, and split returns memoryviews, so data such as network frames can
+// be parsed without making copies of it.
+
+STATIC const byte *memoryview_get_bytes(mp_obj_t self_in, size_t *len) {
+    mp_buffer_info_t bufinfo;
+    array_get_buffer(self_in, &bufinfo, MP_BUFFER_READ);
+    if (mp_binary_get_size('@', bufinfo.typecode, NULL) != 1) {
+        mp_raise_TypeError("memoryview item size must be 1");
+    }
+    *len = bufinfo.len;
+    return bufinfo.buf;
+}
+
+// Get the optional start/end arguments at args[2] and args[3]
+STATIC void memoryview_get_range(size_t len, size_t n_args, const mp_obj_t *args, size_t *start, size_t *end) {
+    *start = 0;
+    *end = len;
+    if (n_args >= 3 && args[2] != mp_const_none) {
+        *start = mp_get_index(&mp_type_memoryview, len, args[2], true);
+    }
+    if (n_args >= 4 && args[3] != mp_const_none) {
+        *end = mp_get_index(&mp_type_memoryview, len, args[3], true);
+    }
+}
+
+STATIC mp_obj_t memoryview_finder(size_t n_args, const mp_obj_t *args, int direction) {
+    size_t len;
+    const byte *buf = memoryview_get_bytes(args[0], &len);
+    mp_buffer_info_t needle;
+    mp_get_buffer_raise(args[1], &needle, MP_BUFFER_READ);
+    size_t start, end;
+    memoryview_get_range(len, n_args, args, &start, &end);
+
+    const byte *p = NULL;
+    if (start <= end) {
+        p = find_subbytes(buf + start, end - start, needle.buf, needle.len, direction);
+    }
+    if (p == NULL) {
+        return MP_OBJ_NEW_SMALL_INT(-1);
+    }
+    return MP_OBJ_NEW_SMALL_INT(p - buf);
+}
+
+STATIC mp_obj_t memoryview_find(size_t n_args, const mp_obj_t *args) {
+    return memoryview_finder(n_args, args, 1);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memoryview_find_obj, 2, 4, memoryview_find);
+
+STATIC mp_obj_t memoryview_rfind(size_t n_args, const mp_obj_t *args) {
+    return memoryview_finder(n_args, args, -1);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memoryview_rfind_obj, 2, 4, memoryview_rfind);
+
+STATIC mp_obj_t memoryview_count(size_t n_args, const mp_obj_t *args) {
+    size_t len;
+    const byte *buf = memoryview_get_bytes(args[0], &len);
+    mp_buffer_info_t needle;
+    mp_get_buffer_raise(args[1], &needle, MP_BUFFER_READ);
+    size_t start, end;
+    memoryview_get_range(len, n_args, args, &start, &end);
+
+    if (start > end) {
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    if (needle.len == 0) {
+        return MP_OBJ_NEW_SMALL_INT(end - start + 1);
+    }
+    mp_int_t num_occurrences = 0;
+    for (const byte *p = buf + start, *top = buf + end;
+        (p = find_subbytes(p, top - p, needle.buf, needle.len, 1)) != NULL;
+        p += needle.len) {
+        num_occurrences++;
+    }
+    return MP_OBJ_NEW_SMALL_INT(num_occurrences);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memoryview_count_obj, 2, 4, memoryview_count);
+
+STATIC mp_obj_t memoryview_startswith(size_t n_args, const mp_obj_t *args) {
+    size_t len;
+    const byte *buf = memoryview_get_bytes(args[0], &len);
+    mp_buffer_info_t prefix;
+    mp_get_buffer_raise(args[1], &prefix, MP_BUFFER_READ);
+    size_t start, end;
+    memoryview_get_range(len, n_args, args, &start, &end);
+    if (start > end || prefix.len > end - start) {
+        return mp_const_false;
+    }
+    return mp_obj_new_bool(memcmp(buf + start, prefix.buf, prefix.len) == 0);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memoryview_startswith_obj, 2, 4, memoryview_startswith);
+
+STATIC mp_obj_t memoryview_endswith(size_t n_args, const mp_obj_t *args) {
+    size_t len;
+    const byte *buf = memoryview_get_bytes(args[0], &len);
+    mp_buffer_info_t suffix;
+    mp_get_buffer_raise(args[1], &suffix, MP_BUFFER_READ);
+    size_t start, end;
+    memoryview_get_range(len, n_args, args, &start, &end);
+    if (start > end || suffix.len > end - start) {
+        return mp_const_false;
+    }
+    return mp_obj_new_bool(memcmp(buf + end - suffix.len, suffix.buf, suffix.len) == 0);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memoryview_endswith_obj, 2, 4, memoryview_endswith);
+
+// Like bytes.split, but the pieces are memoryviews into the same buffer
+STATIC mp_obj_t memoryview_split(size_t n_args, const mp_obj_t *args) {
+    size_t len;
+    const byte *buf = memoryview_get_bytes(args[0], &len);
+    mp_int_t splits = -1;
+    mp_obj_t sep = mp_const_none;
+    if (n_args > 1) {
+        sep = args[1];
+        if (n_args > 2) {
+            splits = mp_obj_get_int(args[2]);
+        }
+    }
+
+    mp_obj_t res = mp_obj_new_list(0, NULL);
+    const byte *s = buf;
+    const byte *top = buf + len;
+
+    if (sep == mp_const_none) {
+        // sep not given, so separate on whitespace
+        while (s < top && unichar_isspace(*s)) s++;
+        while (s < top && splits != 0) {
+            const byte *start = s;
+            while (s < top && !unichar_isspace(*s)) s++;
+            mp_obj_list_append(res, memoryview_new_slice(args[0], start - buf, s - start));
+            if (s >= top) {
+                break;
+            }
+            while (s < top && unichar_isspace(*s)) s++;
+            if (splits > 0) {
+                splits--;
+            }
+        }
+        if (s < top) {
+            mp_obj_list_append(res, memoryview_new_slice(args[0], s - buf, top - s));
+        }
+    } else {
+        mp_buffer_info_t sepinfo;
+        mp_get_buffer_raise(sep, &sepinfo, MP_BUFFER_READ);
+        if (sepinfo.len == 0) {
+            mp_raise_ValueError("empty separator");
+        }
+        for (;;) {
+            const byte *start = s;
+            if (splits == 0 || (s = find_subbytes(s, top - s, sepinfo.buf, sepinfo.len, 1)) == NULL) {
+                s = top;
+            }
+            mp_obj_list_append(res, memoryview_new_slice(args[0], start - buf, s - start));
+            if (s >= top) {
+                break;
+            }
+            s += sepinfo.len;
+            if (splits > 0) {
+                splits--;
+            }
+        }
+    }
+
+    return res;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memoryview_split_obj, 1, 3, memoryview_split);
+
+STATIC const mp_rom_map_elem_t memoryview_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_find), MP_ROM_PTR(&memoryview_find_obj) },
+    { MP_ROM_QSTR(MP_QSTR_rfind), MP_ROM_PTR(&memoryview_rfind_obj) },
+    { MP_ROM_QSTR(MP_QSTR_count), MP_ROM_PTR(&memoryview_count_obj) },
+    { MP_ROM_QSTR(MP_QSTR_startswith), MP_ROM_PTR(&memoryview_startswith_obj) },
+    { MP_ROM_QSTR(MP_QSTR_endswith), MP_ROM_PTR(&memoryview_endswith_obj) },
+    { MP_ROM_QSTR(MP_QSTR_split), MP_ROM_PTR(&memoryview_split_obj) },
+    { MP_ROM_QSTR(MP_QSTR_decode), MP_ROM_PTR(&bytes_decode_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(memoryview_locals_dict, memoryview_locals_dict_table);
+#endif
+
 #if MICROPY_PY_BUILTINS_MEMORYVIEW
 const mp_obj_type_t mp_type_memoryview = {
     { &mp_type_type },
@@ -561,6 +751,9 @@ const mp_obj_type_t mp_type_memoryview = {
     .binary_op = array_binary_op,
     .subscr = array_subscr,
     .buffer_p = { .get_buffer = array_get_buffer },
+    #if MICROPY_PY_BUILTINS_MEMORYVIEW_BYTES_METHODS
+    .locals_dict = (mp_obj_dict_t*)&memoryview_locals_dict,
+    #endif
 };
 #endif
 
@@ -608,9 +801,23 @@ STATIC mp_obj_t array_it_iternext(mp_obj_t self_in) {
     }
 }
 
+#if MICROPY_OPT_ITER_LEN_HINT
+STATIC mp_obj_t array_it_unary_op(mp_uint_t op, mp_obj_t self_in) {
+    mp_obj_array_it_t *self = MP_OBJ_TO_PTR(self_in);
+    switch (op) {
+        case MP_UNARY_OP_LEN_HINT:
+            return MP_OBJ_NEW_SMALL_INT(self->cur < self->array->len ? self->array->len - self->cur : 0);
+        default: return MP_OBJ_NULL; // op not supported
+    }
+}
+#endif
+
 STATIC const mp_obj_type_t array_it_type = {
     { &mp_type_type },
     .name = MP_QSTR_iterator,
+    #if MICROPY_OPT_ITER_LEN_HINT
+    .unary_op = array_it_unary_op,
+    #endif
     .getiter = mp_identity_getiter,
     .iternext = array_it_iternext,
 };
@@ -64,7 +64,7 @@ STATIC mp_obj_t bool_make_new(const mp_obj_type_t *type_in, size_t n_args, size_
 }
 
 STATIC mp_obj_t bool_unary_op(mp_uint_t op, mp_obj_t o_in) {
-    if (op == MP_UNARY_OP_LEN) {
+    if (op == MP_UNARY_OP_LEN || op == MP_UNARY_OP_LEN_HINT) {
         return MP_OBJ_NULL;
     }
     mp_obj_bool_t *self = MP_OBJ_TO_PTR(o_in);
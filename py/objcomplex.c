@@ -45,30 +45,45 @@ typedef struct _mp_obj_complex_t {
     mp_float_t imag;
 } mp_obj_complex_t;
 
-STATIC void complex_print(const mp_print_t *print, mp_obj_t o_in, mp_print_kind_t kind) {
-    (void)kind;
-    mp_obj_complex_t *o = MP_OBJ_TO_PTR(o_in);
+#if MICROPY_FLOAT_REPR_SHORTEST
+#define COMPLEX_PRINT_BUF_SIZE (32)
+#elif MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
+#define COMPLEX_PRINT_BUF_SIZE (16)
+#else
+#define COMPLEX_PRINT_BUF_SIZE (32)
+#endif
+
+STATIC void complex_format_part(mp_float_t f, char *buf) {
+#if MICROPY_FLOAT_REPR_SHORTEST
+    mp_format_float_repr(f, buf, COMPLEX_PRINT_BUF_SIZE);
+#else
 #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
-    char buf[16];
     #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_C
     const int precision = 6;
     #else
     const int precision = 7;
     #endif
 #else
-    char buf[32];
     const int precision = 16;
 #endif
+    mp_format_float(f, buf, COMPLEX_PRINT_BUF_SIZE, 'g', precision, '\0');
+#endif
+}
+
+STATIC void complex_print(const mp_print_t *print, mp_obj_t o_in, mp_print_kind_t kind) {
+    (void)kind;
+    mp_obj_complex_t *o = MP_OBJ_TO_PTR(o_in);
+    char buf[COMPLEX_PRINT_BUF_SIZE];
     if (o->real == 0) {
-        mp_format_float(o->imag, buf, sizeof(buf), 'g', precision, '\0');
+        complex_format_part(o->imag, buf);
         mp_printf(print, "%sj", buf);
     } else {
-        mp_format_float(o->real, buf, sizeof(buf), 'g', precision, '\0');
+        complex_format_part(o->real, buf);
         mp_printf(print, "(%s", buf);
         if (o->imag >= 0 || isnan(o->imag)) {
             mp_print_str(print, "+");
         }
-        mp_format_float(o->imag, buf, sizeof(buf), 'g', precision, '\0');
+        complex_format_part(o->imag, buf);
         mp_printf(print, "%sj)", buf);
     }
 }
@@ -55,11 +55,52 @@ STATIC mp_map_elem_t *dict_iter_next(mp_obj_dict_t *dict, size_t *cur) {
     return NULL;
 }
 
+// Dicts with a fixed table (eg in ROM, or made by const()) are read-only
+STATIC void dict_ensure_not_fixed(const mp_obj_dict_t *dict) {
+    if (dict->map.is_fixed) {
+        mp_raise_TypeError("dict is read-only");
+    }
+}
+
+// Keys of different types are only compared when both are numbers, because
+// other mixed comparisons may warn (str and bytes) and are never equal anyway.
+STATIC bool dict_fixed_key_equal(mp_obj_t key1, mp_obj_t key2) {
+    if (mp_obj_get_type(key1) != mp_obj_get_type(key2)
+        && !((mp_obj_is_integer(key1) || mp_obj_is_float(key1))
+            && (mp_obj_is_integer(key2) || mp_obj_is_float(key2)))) {
+        return false;
+    }
+    return mp_obj_equal(key1, key2);
+}
+
+// Look up a key for reading.  The keys of a dict made by const() may be of
+// mixed types, so its table is scanned with dict_fixed_key_equal: comparing
+// eg a float key with a tuple would otherwise raise TypeError.
+STATIC mp_map_elem_t *dict_lookup(mp_obj_dict_t *self, mp_obj_t index) {
+    mp_map_t *map = &self->map;
+    if (map->is_fixed && map->is_ordered && !map->all_keys_are_qstrs) {
+        for (mp_map_elem_t *elem = &map->table[0], *top = &map->table[map->used]; elem < top; elem++) {
+            if (elem->key == index || dict_fixed_key_equal(elem->key, index)) {
+                return elem;
+            }
+        }
+        return NULL;
+    }
+    return mp_map_lookup(map, index, MP_MAP_LOOKUP);
+}
+
 STATIC void dict_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
     bool first = true;
+    const char *item_separator = ", ";
+    const char *key_separator = ": ";
     if (!(MICROPY_PY_UJSON && kind == PRINT_JSON)) {
         kind = PRINT_REPR;
+    } else {
+        #if MICROPY_PY_UJSON_SEPARATORS
+        item_separator = MP_PRINT_GET_EXT(print)->item_separator;
+        key_separator = MP_PRINT_GET_EXT(print)->key_separator;
+        #endif
     }
     if (MICROPY_PY_COLLECTIONS_ORDEREDDICT && self->base.type != &mp_type_dict) {
         mp_printf(print, "%q(", self->base.type->name);
@@ -69,11 +110,11 @@ STATIC void dict_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_
     mp_map_elem_t *next = NULL;
     while ((next = dict_iter_next(self, &cur)) != NULL) {
         if (!first) {
-            mp_print_str(print, ", ");
+            mp_print_str(print, item_separator);
         }
         first = false;
         mp_obj_print_helper(print, next->key, kind);
-        mp_print_str(print, ": ");
+        mp_print_str(print, key_separator);
         mp_obj_print_helper(print, next->value, kind);
     }
     mp_print_str(print, "}");
@@ -113,7 +154,7 @@ STATIC mp_obj_t dict_binary_op(mp_uint_t op, mp_obj_t lhs_in, mp_obj_t rhs_in) {
     mp_obj_dict_t *o = MP_OBJ_TO_PTR(lhs_in);
     switch (op) {
         case MP_BINARY_OP_IN: {
-            mp_map_elem_t *elem = mp_map_lookup(&o->map, rhs_in, MP_MAP_LOOKUP);
+            mp_map_elem_t *elem = dict_lookup(o, rhs_in);
             return mp_obj_new_bool(elem != NULL);
         }
         case MP_BINARY_OP_EQUAL: {
@@ -160,7 +201,7 @@ STATIC mp_obj_t dict_binary_op(mp_uint_t op, mp_obj_t lhs_in, mp_obj_t rhs_in) {
 // TODO: Make sure this is inlined in dict_subscr() below.
 mp_obj_t mp_obj_dict_get(mp_obj_t self_in, mp_obj_t index) {
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
-    mp_map_elem_t *elem = mp_map_lookup(&self->map, index, MP_MAP_LOOKUP);
+    mp_map_elem_t *elem = dict_lookup(self, index);
     if (elem == NULL) {
         nlr_raise(mp_obj_new_exception_arg1(&mp_type_KeyError, index));
     } else {
@@ -176,7 +217,7 @@ STATIC mp_obj_t dict_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     } else if (value == MP_OBJ_SENTINEL) {
         // load
         mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
-        mp_map_elem_t *elem = mp_map_lookup(&self->map, index, MP_MAP_LOOKUP);
+        mp_map_elem_t *elem = dict_lookup(self, index);
         if (elem == NULL) {
             nlr_raise(mp_obj_new_exception_arg1(&mp_type_KeyError, index));
         } else {
@@ -226,6 +267,7 @@ STATIC mp_obj_t dict_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
 STATIC mp_obj_t dict_clear(mp_obj_t self_in) {
     mp_check_self(MP_OBJ_IS_DICT_TYPE(self_in));
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
+    dict_ensure_not_fixed(self);
 
     mp_map_clear(&self->map);
 
@@ -281,7 +323,15 @@ STATIC MP_DEFINE_CONST_CLASSMETHOD_OBJ(dict_fromkeys_obj, MP_ROM_PTR(&dict_fromk
 STATIC mp_obj_t dict_get_helper(size_t n_args, const mp_obj_t *args, mp_map_lookup_kind_t lookup_kind) {
     mp_check_self(MP_OBJ_IS_DICT_TYPE(args[0]));
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(args[0]);
-    mp_map_elem_t *elem = mp_map_lookup(&self->map, args[1], lookup_kind);
+    if (lookup_kind != MP_MAP_LOOKUP) {
+        dict_ensure_not_fixed(self);
+    }
+    mp_map_elem_t *elem;
+    if (lookup_kind == MP_MAP_LOOKUP) {
+        elem = dict_lookup(self, args[1]);
+    } else {
+        elem = mp_map_lookup(&self->map, args[1], lookup_kind);
+    }
     mp_obj_t value;
     if (elem == NULL || elem->value == MP_OBJ_NULL) {
         if (n_args == 2) {
@@ -323,6 +373,7 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(dict_setdefault_obj, 2, 3, dict_setde
 STATIC mp_obj_t dict_popitem(mp_obj_t self_in) {
     mp_check_self(MP_OBJ_IS_DICT_TYPE(self_in));
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
+    dict_ensure_not_fixed(self);
     size_t cur = 0;
     mp_map_elem_t *next = dict_iter_next(self, &cur);
     if (next == NULL) {
@@ -341,6 +392,7 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(dict_popitem_obj, dict_popitem);
 STATIC mp_obj_t dict_update(size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
     mp_check_self(MP_OBJ_IS_DICT_TYPE(args[0]));
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(args[0]);
+    dict_ensure_not_fixed(self);
 
     mp_arg_check_num(n_args, kwargs->used, 1, 2, true);
 
@@ -584,6 +636,32 @@ mp_obj_t mp_obj_new_dict(size_t n_args) {
     return MP_OBJ_FROM_PTR(o);
 }
 
+// Make a read-only dict that takes ownership of the given heap-allocated table
+// of n key/value pairs.  Duplicate keys are merged, keeping the last value, so
+// the result matches evaluating the equivalent dict display.
+mp_obj_t mp_obj_new_dict_fixed(size_t n, mp_obj_t *table) {
+    size_t used = 0;
+    bool all_keys_are_qstrs = true;
+    for (size_t i = 0; i < n; ++i) {
+        mp_obj_t key = table[2 * i];
+        size_t j = 0;
+        while (j < used && !dict_fixed_key_equal(table[2 * j], key)) {
+            ++j;
+        }
+        if (j == used) {
+            table[2 * used] = key;
+            all_keys_are_qstrs &= MP_OBJ_IS_QSTR(key);
+            ++used;
+        }
+        table[2 * j + 1] = table[2 * i + 1];
+    }
+    mp_obj_dict_t *o = m_new_obj(mp_obj_dict_t);
+    o->base.type = &mp_type_dict;
+    mp_map_init_fixed_table(&o->map, used, table);
+    o->map.all_keys_are_qstrs = all_keys_are_qstrs;
+    return MP_OBJ_FROM_PTR(o);
+}
+
 size_t mp_obj_dict_len(mp_obj_t self_in) {
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
     return self->map.used;
@@ -592,6 +670,7 @@ size_t mp_obj_dict_len(mp_obj_t self_in) {
 mp_obj_t mp_obj_dict_store(mp_obj_t self_in, mp_obj_t key, mp_obj_t value) {
     mp_check_self(MP_OBJ_IS_DICT_TYPE(self_in));
     mp_obj_dict_t *self = MP_OBJ_TO_PTR(self_in);
+    dict_ensure_not_fixed(self);
     mp_map_lookup(&self->map, key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = value;
     return self_in;
 }
@@ -46,20 +46,70 @@ STATIC mp_obj_t list_pop(size_t n_args, const mp_obj_t *args);
 
 STATIC void list_print(const mp_print_t *print, mp_obj_t o_in, mp_print_kind_t kind) {
     mp_obj_list_t *o = MP_OBJ_TO_PTR(o_in);
+    const char *item_separator = ", ";
     if (!(MICROPY_PY_UJSON && kind == PRINT_JSON)) {
         kind = PRINT_REPR;
+    } else {
+        #if MICROPY_PY_UJSON_SEPARATORS
+        item_separator = MP_PRINT_GET_EXT(print)->item_separator;
+        #endif
     }
     mp_print_str(print, "[");
     for (size_t i = 0; i < o->len; i++) {
         if (i > 0) {
-            mp_print_str(print, ", ");
+            mp_print_str(print, item_separator);
         }
         mp_obj_print_helper(print, o->items[i], kind);
     }
     mp_print_str(print, "]");
 }
 
+// Make room for at least n items.  Growth is geometric so that a sequence of
+// extends stays amortised O(1), unless exact is set (eg when the final size is
+// known) in which case failing to allocate is not an error.
+STATIC void list_reserve(mp_obj_list_t *self, size_t n, bool exact) {
+    if (n <= self->alloc) {
+        return;
+    }
+    size_t new_alloc = n;
+    mp_obj_t *items;
+    if (exact) {
+        items = m_renew_maybe(mp_obj_t, self->items, self->alloc, new_alloc, true);
+        if (items == NULL) {
+            return;
+        }
+    } else {
+        if (new_alloc < self->alloc * 2) {
+            new_alloc = self->alloc * 2;
+        }
+        items = m_renew(mp_obj_t, self->items, self->alloc, new_alloc);
+    }
+    self->items = items;
+    self->alloc = new_alloc;
+    mp_seq_clear(self->items, self->len, self->alloc, sizeof(*self->items));
+}
+
+// Give memory back to the heap once less than a quarter of it is used.  The
+// list keeps room to double in size so alternating appends and pops don't
+// reallocate every time.
+STATIC void list_shrink(mp_obj_list_t *self) {
+    if (self->alloc > LIST_MIN_ALLOC && self->len < self->alloc / 4) {
+        size_t new_alloc = self->len * 2;
+        if (new_alloc < LIST_MIN_ALLOC) {
+            new_alloc = LIST_MIN_ALLOC;
+        }
+        self->items = m_renew(mp_obj_t, self->items, self->alloc, new_alloc);
+        self->alloc = new_alloc;
+    }
+}
+
 STATIC mp_obj_t list_extend_from_iter(mp_obj_t list, mp_obj_t iterable) {
+    mp_obj_list_t *self = MP_OBJ_TO_PTR(list);
+    size_t hint = mp_obj_len_hint(iterable);
+    // a hint too large to allocate is ignored, and the list grows as usual
+    if (hint <= SIZE_MAX / sizeof(mp_obj_t) - self->len) {
+        list_reserve(self, self->len + hint, true);
+    }
     mp_obj_t iter = mp_getiter(iterable, NULL);
     mp_obj_t item;
     while ((item = mp_iternext(iter)) != MP_OBJ_STOP_ITERATION) {
@@ -79,8 +129,13 @@ STATIC mp_obj_t list_make_new(const mp_obj_type_t *type_in, size_t n_args, size_
 
         case 1:
         default: {
-            // make list from iterable
-            // TODO: optimize list/tuple
+            // make list from iterable, copying the items directly from a list/tuple
+            if (MP_OBJ_IS_TYPE(args[0], &mp_type_list) || MP_OBJ_IS_TYPE(args[0], &mp_type_tuple)) {
+                size_t len;
+                mp_obj_t *items;
+                mp_obj_get_array(args[0], &len, &items);
+                return mp_obj_new_list(len, items);
+            }
             mp_obj_t list = mp_obj_new_list(0, NULL);
             return list_extend_from_iter(list, args[0]);
         }
@@ -166,6 +221,7 @@ STATIC mp_obj_t list_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
             // Clear "freed" elements at the end of list
             mp_seq_clear(self->items, self->len + len_adj, self->len, sizeof(*self->items));
             self->len += len_adj;
+            list_shrink(self);
             return mp_const_none;
         }
 #endif
@@ -201,12 +257,7 @@ STATIC mp_obj_t list_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
             mp_int_t len_adj = value_len - (slice_out.stop - slice_out.start);
             //printf("Len adj: %d\n", len_adj);
             if (len_adj > 0) {
-                if (self->len + len_adj > self->alloc) {
-                    // TODO: Might optimize memory copies here by checking if block can
-                    // be grown inplace or not
-                    self->items = m_renew(mp_obj_t, self->items, self->alloc, self->len + len_adj);
-                    self->alloc = self->len + len_adj;
-                }
+                list_reserve(self, self->len + len_adj, false);
                 mp_seq_replace_slice_grow_inplace(self->items, self->len,
                     slice_out.start, slice_out.stop, value_items, value_len, len_adj, sizeof(*self->items));
             } else {
@@ -214,9 +265,9 @@ STATIC mp_obj_t list_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
                     slice_out.start, slice_out.stop, value_items, value_len, sizeof(*self->items));
                 // Clear "freed" elements at the end of list
                 mp_seq_clear(self->items, self->len + len_adj, self->len, sizeof(*self->items));
-                // TODO: apply allocation policy re: alloc_size
             }
             self->len += len_adj;
+            list_shrink(self);
             return mp_const_none;
         }
 #endif
@@ -247,13 +298,7 @@ STATIC mp_obj_t list_extend(mp_obj_t self_in, mp_obj_t arg_in) {
         mp_obj_list_t *self = MP_OBJ_TO_PTR(self_in);
         mp_obj_list_t *arg = MP_OBJ_TO_PTR(arg_in);
 
-        if (self->len + arg->len > self->alloc) {
-            // TODO: use alloc policy for "4"
-            self->items = m_renew(mp_obj_t, self->items, self->alloc, self->len + arg->len + 4);
-            self->alloc = self->len + arg->len + 4;
-            mp_seq_clear(self->items, self->len + arg->len, self->alloc, sizeof(*self->items));
-        }
-
+        list_reserve(self, self->len + arg->len, false);
         memcpy(self->items + self->len, arg->items, sizeof(mp_obj_t) * arg->len);
         self->len += arg->len;
     } else {
@@ -274,13 +319,571 @@ STATIC mp_obj_t list_pop(size_t n_args, const mp_obj_t *args) {
     memmove(self->items + index, self->items + index + 1, (self->len - index) * sizeof(mp_obj_t));
     // Clear stale pointer from slot which just got freed to prevent GC issues
     self->items[self->len] = MP_OBJ_NULL;
-    if (self->alloc > LIST_MIN_ALLOC && self->alloc > 2 * self->len) {
-        self->items = m_renew(mp_obj_t, self->items, self->alloc, self->alloc/2);
-        self->alloc /= 2;
-    }
+    list_shrink(self);
     return ret;
 }
 
+#if MICROPY_OPT_LIST_TIMSORT
+
+// An adaptive, stable merge sort following Tim Peters' listsort.  Runs that are
+// already in order are detected and merged, short runs are extended with a
+// binary insertion sort, and merges switch to galloping (exponential search)
+// when one run keeps winning.  It's iterative, using a fixed size stack of
+// pending runs, and needs a temporary buffer of at most half the elements.
+//
+// Elements are `stride` objects wide: just the object, or the cached key
+// followed by the object when a key function is used.  Only the first object
+// of an element is compared.
+
+#define TIMSORT_MIN_MERGE (64)
+#define TIMSORT_MIN_GALLOP (7)
+// run lengths grow at least as fast as the Fibonacci numbers
+#define TIMSORT_MAX_PENDING (4 * sizeof(size_t) * 8 / 3)
+
+typedef struct _timsort_run_t {
+    mp_obj_t *base;
+    size_t len;
+} timsort_run_t;
+
+typedef struct _timsort_t {
+    size_t stride;
+    size_t min_gallop;
+    mp_obj_t *tmp;
+    size_t tmp_alloc; // number of elements that fit in tmp
+    // State of the merge in progress: copying n elements from src to dest
+    // completes the merge, which is also how the array is restored to a
+    // permutation of its elements if a comparison raises an exception.
+    mp_obj_t *merge_src;
+    mp_obj_t *merge_dest;
+    size_t merge_n;
+    size_t n_pending;
+    timsort_run_t pending[TIMSORT_MAX_PENDING];
+} timsort_t;
+
+#define TS_AT(ts, p, i) ((p) + (mp_int_t)(i) * (mp_int_t)(ts)->stride)
+
+STATIC bool timsort_lt(mp_obj_t *a, mp_obj_t *b) {
+    if (MP_OBJ_IS_SMALL_INT(a[0]) && MP_OBJ_IS_SMALL_INT(b[0])) {
+        return MP_OBJ_SMALL_INT_VALUE(a[0]) < MP_OBJ_SMALL_INT_VALUE(b[0]);
+    }
+    return mp_obj_is_true(mp_binary_op(MP_BINARY_OP_LESS, a[0], b[0]));
+}
+
+STATIC void timsort_copy(timsort_t *ts, mp_obj_t *dest, const mp_obj_t *src, size_t n) {
+    memmove(dest, src, n * ts->stride * sizeof(mp_obj_t));
+}
+
+STATIC void timsort_reverse(timsort_t *ts, mp_obj_t *lo, mp_obj_t *hi) {
+    // hi is the last element (inclusive)
+    while (lo < hi) {
+        for (size_t i = 0; i < ts->stride; i++) {
+            mp_obj_t t = lo[i];
+            lo[i] = hi[i];
+            hi[i] = t;
+        }
+        lo += ts->stride;
+        hi -= ts->stride;
+    }
+}
+
+// Sort a[0:n] given that a[0:start] is already sorted.
+STATIC void timsort_binary_insertion(timsort_t *ts, mp_obj_t *a, size_t n, size_t start) {
+    mp_obj_t pivot[2];
+    for (; start < n; start++) {
+        mp_obj_t *p = TS_AT(ts, a, start);
+        timsort_copy(ts, pivot, p, 1);
+        // find the first element greater than pivot, to keep the sort stable
+        size_t l = 0;
+        size_t r = start;
+        while (l < r) {
+            size_t m = l + (r - l) / 2;
+            if (timsort_lt(pivot, TS_AT(ts, a, m))) {
+                r = m;
+            } else {
+                l = m + 1;
+            }
+        }
+        timsort_copy(ts, TS_AT(ts, a, l + 1), TS_AT(ts, a, l), start - l);
+        timsort_copy(ts, TS_AT(ts, a, l), pivot, 1);
+    }
+}
+
+// Return the length of the run starting at a, reversing it if it's strictly
+// descending (strictly so that reversing it keeps the sort stable).
+STATIC size_t timsort_count_run(timsort_t *ts, mp_obj_t *a, size_t n) {
+    if (n == 1) {
+        return 1;
+    }
+    size_t k = 2;
+    if (timsort_lt(TS_AT(ts, a, 1), a)) {
+        while (k < n && timsort_lt(TS_AT(ts, a, k), TS_AT(ts, a, k - 1))) {
+            k++;
+        }
+        timsort_reverse(ts, a, TS_AT(ts, a, k - 1));
+    } else {
+        while (k < n && !timsort_lt(TS_AT(ts, a, k), TS_AT(ts, a, k - 1))) {
+            k++;
+        }
+    }
+    return k;
+}
+
+// Return k such that a[k - 1] < key <= a[k], starting the search at a[hint].
+STATIC size_t timsort_gallop_left(timsort_t *ts, mp_obj_t *key, mp_obj_t *a, mp_int_t n, mp_int_t hint) {
+    mp_obj_t *ah = TS_AT(ts, a, hint);
+    mp_int_t lastofs = 0;
+    mp_int_t ofs = 1;
+    if (timsort_lt(ah, key)) {
+        // a[hint] < key: gallop right until a[hint + lastofs] < key <= a[hint + ofs]
+        mp_int_t maxofs = n - hint;
+        while (ofs < maxofs && timsort_lt(TS_AT(ts, ah, ofs), key)) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) {
+            ofs = maxofs;
+        }
+        lastofs += hint;
+        ofs += hint;
+    } else {
+        // key <= a[hint]: gallop left until a[hint - ofs] < key <= a[hint - lastofs]
+        mp_int_t maxofs = hint + 1;
+        while (ofs < maxofs && !timsort_lt(TS_AT(ts, ah, -ofs), key)) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) {
+            ofs = maxofs;
+        }
+        mp_int_t k = lastofs;
+        lastofs = hint - ofs;
+        ofs = hint - k;
+    }
+    // now a[lastofs] < key <= a[ofs], so binary search in between
+    lastofs += 1;
+    while (lastofs < ofs) {
+        mp_int_t m = lastofs + ((ofs - lastofs) >> 1);
+        if (timsort_lt(TS_AT(ts, a, m), key)) {
+            lastofs = m + 1;
+        } else {
+            ofs = m;
+        }
+    }
+    return ofs;
+}
+
+// Return k such that a[k - 1] <= key < a[k], starting the search at a[hint].
+STATIC size_t timsort_gallop_right(timsort_t *ts, mp_obj_t *key, mp_obj_t *a, mp_int_t n, mp_int_t hint) {
+    mp_obj_t *ah = TS_AT(ts, a, hint);
+    mp_int_t lastofs = 0;
+    mp_int_t ofs = 1;
+    if (timsort_lt(key, ah)) {
+        // key < a[hint]: gallop left until a[hint - ofs] <= key < a[hint - lastofs]
+        mp_int_t maxofs = hint + 1;
+        while (ofs < maxofs && timsort_lt(key, TS_AT(ts, ah, -ofs))) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) {
+            ofs = maxofs;
+        }
+        mp_int_t k = lastofs;
+        lastofs = hint - ofs;
+        ofs = hint - k;
+    } else {
+        // a[hint] <= key: gallop right until a[hint + lastofs] <= key < a[hint + ofs]
+        mp_int_t maxofs = n - hint;
+        while (ofs < maxofs && !timsort_lt(key, TS_AT(ts, ah, ofs))) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) {
+            ofs = maxofs;
+        }
+        lastofs += hint;
+        ofs += hint;
+    }
+    // now a[lastofs] <= key < a[ofs], so binary search in between
+    lastofs += 1;
+    while (lastofs < ofs) {
+        mp_int_t m = lastofs + ((ofs - lastofs) >> 1);
+        if (timsort_lt(key, TS_AT(ts, a, m))) {
+            ofs = m;
+        } else {
+            lastofs = m + 1;
+        }
+    }
+    return ofs;
+}
+
+STATIC void timsort_ensure_tmp(timsort_t *ts, size_t n) {
+    if (n > ts->tmp_alloc) {
+        // the old contents aren't needed so don't use m_renew, and clear the
+        // fields first so they're consistent if the allocation fails
+        m_del(mp_obj_t, ts->tmp, ts->tmp_alloc * ts->stride);
+        ts->tmp = NULL;
+        ts->tmp_alloc = 0;
+        ts->tmp = m_new(mp_obj_t, n * ts->stride);
+        ts->tmp_alloc = n;
+    }
+}
+
+STATIC void timsort_merge_finish(timsort_t *ts) {
+    timsort_copy(ts, ts->merge_dest, ts->merge_src, ts->merge_n);
+    ts->merge_n = 0;
+}
+
+// Merge the adjacent runs a[0:na] and b[0:nb], where na <= nb, b[0] < a[0]
+// and a[na - 1] > b[nb - 1].  a is moved to tmp and merged from the left.
+STATIC void timsort_merge_lo(timsort_t *ts, mp_obj_t *a, size_t na, mp_obj_t *b, size_t nb) {
+    size_t st = ts->stride;
+    timsort_ensure_tmp(ts, na);
+    timsort_copy(ts, ts->tmp, a, na);
+    // the elements of a left to merge are at merge_src, and there's a gap of
+    // the same size at merge_dest just before the remaining elements of b
+    ts->merge_src = ts->tmp;
+    ts->merge_dest = a;
+    ts->merge_n = na;
+
+    // b[0] is known to come first
+    timsort_copy(ts, ts->merge_dest, b, 1);
+    ts->merge_dest += st;
+    b += st;
+    nb -= 1;
+
+    size_t min_gallop = ts->min_gallop;
+    while (nb > 0 && ts->merge_n > 0) {
+        // one element at a time until one run wins consistently
+        size_t acount = 0;
+        size_t bcount = 0;
+        do {
+            if (timsort_lt(b, ts->merge_src)) {
+                timsort_copy(ts, ts->merge_dest, b, 1);
+                ts->merge_dest += st;
+                b += st;
+                acount = 0;
+                if (--nb == 0) {
+                    goto done;
+                }
+                bcount += 1;
+            } else {
+                timsort_copy(ts, ts->merge_dest, ts->merge_src, 1);
+                ts->merge_dest += st;
+                ts->merge_src += st;
+                bcount = 0;
+                if (--ts->merge_n == 0) {
+                    goto done;
+                }
+                acount += 1;
+            }
+        } while ((acount | bcount) < min_gallop);
+
+        // gallop until neither run wins by at least TIMSORT_MIN_GALLOP
+        min_gallop += 1;
+        do {
+            min_gallop -= min_gallop > 1;
+            acount = timsort_gallop_right(ts, b, ts->merge_src, ts->merge_n, 0);
+            if (acount > 0) {
+                timsort_copy(ts, ts->merge_dest, ts->merge_src, acount);
+                ts->merge_dest += acount * st;
+                ts->merge_src += acount * st;
+                ts->merge_n -= acount;
+                if (ts->merge_n == 0) {
+                    goto done;
+                }
+            }
+            timsort_copy(ts, ts->merge_dest, b, 1);
+            ts->merge_dest += st;
+            b += st;
+            if (--nb == 0) {
+                goto done;
+            }
+
+            bcount = timsort_gallop_left(ts, ts->merge_src, b, nb, 0);
+            if (bcount > 0) {
+                timsort_copy(ts, ts->merge_dest, b, bcount);
+                ts->merge_dest += bcount * st;
+                b += bcount * st;
+                nb -= bcount;
+                if (nb == 0) {
+                    goto done;
+                }
+            }
+            timsort_copy(ts, ts->merge_dest, ts->merge_src, 1);
+            ts->merge_dest += st;
+            ts->merge_src += st;
+            if (--ts->merge_n == 0) {
+                goto done;
+            }
+        } while (acount >= TIMSORT_MIN_GALLOP || bcount >= TIMSORT_MIN_GALLOP);
+        min_gallop += 1; // penalise leaving galloping mode
+    }
+done:
+    ts->min_gallop = min_gallop;
+    timsort_merge_finish(ts);
+}
+
+// Merge the adjacent runs a[0:na] and b[0:nb], where na >= nb, b[0] < a[0]
+// and a[na - 1] > b[nb - 1].  b is moved to tmp and merged from the right.
+STATIC void timsort_merge_hi(timsort_t *ts, mp_obj_t *a, size_t na, mp_obj_t *b, size_t nb) {
+    size_t st = ts->stride;
+    timsort_ensure_tmp(ts, nb);
+    timsort_copy(ts, ts->tmp, b, nb);
+    // the elements of b left to merge are tmp[0:merge_n], and there's a gap
+    // of the same size at merge_dest just after the remaining elements of a
+    ts->merge_src = ts->tmp;
+    ts->merge_dest = TS_AT(ts, a, na);
+    ts->merge_n = nb;
+    mp_obj_t *pa = TS_AT(ts, a, na - 1); // last remaining element of a
+    #define TS_LAST_B() TS_AT(ts, ts->tmp, ts->merge_n - 1)
+    #define TS_TAKE_A(n) do { \
+        pa -= (n) * st; \
+        ts->merge_dest -= (n) * st; \
+        timsort_copy(ts, TS_AT(ts, ts->merge_dest, ts->merge_n), pa + st, (n)); \
+        na -= (n); \
+    } while (0)
+    #define TS_TAKE_B(n) do { \
+        timsort_copy(ts, TS_AT(ts, ts->merge_dest, ts->merge_n - (n)), TS_AT(ts, ts->tmp, ts->merge_n - (n)), (n)); \
+        ts->merge_n -= (n); \
+    } while (0)
+
+    // a[na - 1] is known to come last
+    TS_TAKE_A(1);
+
+    size_t min_gallop = ts->min_gallop;
+    while (na > 0 && ts->merge_n > 0) {
+        // one element at a time until one run wins consistently
+        size_t acount = 0;
+        size_t bcount = 0;
+        do {
+            if (timsort_lt(TS_LAST_B(), pa)) {
+                TS_TAKE_A(1);
+                bcount = 0;
+                if (na == 0) {
+                    goto done;
+                }
+                acount += 1;
+            } else {
+                TS_TAKE_B(1);
+                acount = 0;
+                if (ts->merge_n == 0) {
+                    goto done;
+                }
+                bcount += 1;
+            }
+        } while ((acount | bcount) < min_gallop);
+
+        // gallop until neither run wins by at least TIMSORT_MIN_GALLOP
+        min_gallop += 1;
+        do {
+            min_gallop -= min_gallop > 1;
+            acount = na - timsort_gallop_right(ts, TS_LAST_B(), a, na, na - 1);
+            if (acount > 0) {
+                TS_TAKE_A(acount);
+                if (na == 0) {
+                    goto done;
+                }
+            }
+            TS_TAKE_B(1);
+            if (ts->merge_n == 0) {
+                goto done;
+            }
+
+            bcount = ts->merge_n - timsort_gallop_left(ts, pa, ts->tmp, ts->merge_n, ts->merge_n - 1);
+            if (bcount > 0) {
+                TS_TAKE_B(bcount);
+                if (ts->merge_n == 0) {
+                    goto done;
+                }
+            }
+            TS_TAKE_A(1);
+            if (na == 0) {
+                goto done;
+            }
+        } while (acount >= TIMSORT_MIN_GALLOP || bcount >= TIMSORT_MIN_GALLOP);
+        min_gallop += 1; // penalise leaving galloping mode
+    }
+done:
+    ts->min_gallop = min_gallop;
+    // the remaining elements of b go in the gap at the start
+    ts->merge_dest = TS_AT(ts, a, na);
+    timsort_merge_finish(ts);
+
+    #undef TS_LAST_B
+    #undef TS_TAKE_A
+    #undef TS_TAKE_B
+}
+
+// Merge the pending runs i and i + 1.
+STATIC void timsort_merge_at(timsort_t *ts, size_t i) {
+    mp_obj_t *a = ts->pending[i].base;
+    size_t na = ts->pending[i].len;
+    mp_obj_t *b = ts->pending[i + 1].base;
+    size_t nb = ts->pending[i + 1].len;
+
+    ts->pending[i].len = na + nb;
+    if (i == ts->n_pending - 3) {
+        ts->pending[i + 1] = ts->pending[i + 2];
+    }
+    ts->n_pending -= 1;
+
+    // elements of a that are <= b[0] are already in place
+    size_t k = timsort_gallop_right(ts, b, a, na, 0);
+    a = TS_AT(ts, a, k);
+    na -= k;
+    if (na == 0) {
+        return;
+    }
+    // elements of b that are >= a[na - 1] are already in place
+    nb = timsort_gallop_left(ts, TS_AT(ts, a, na - 1), b, nb, nb - 1);
+    if (nb == 0) {
+        return;
+    }
+
+    if (na <= nb) {
+        timsort_merge_lo(ts, a, na, b, nb);
+    } else {
+        timsort_merge_hi(ts, a, na, b, nb);
+    }
+}
+
+// Merge pending runs until the run lengths satisfy, from the top of the stack,
+// len[i - 2] > len[i - 1] + len[i] and len[i - 1] > len[i], which keeps the
+// merges balanced and the stack short.
+STATIC void timsort_merge_collapse(timsort_t *ts) {
+    timsort_run_t *p = ts->pending;
+    while (ts->n_pending > 1) {
+        size_t n = ts->n_pending - 2;
+        if ((n > 0 && p[n - 1].len <= p[n].len + p[n + 1].len)
+            || (n > 1 && p[n - 2].len <= p[n - 1].len + p[n].len)) {
+            if (p[n - 1].len < p[n + 1].len) {
+                n -= 1;
+            }
+            timsort_merge_at(ts, n);
+        } else if (p[n].len <= p[n + 1].len) {
+            timsort_merge_at(ts, n);
+        } else {
+            break;
+        }
+    }
+}
+
+STATIC size_t timsort_min_run(size_t n) {
+    size_t r = 0;
+    while (n >= TIMSORT_MIN_MERGE) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+STATIC void timsort(timsort_t *ts, mp_obj_t *a, size_t n) {
+    size_t min_run = timsort_min_run(n);
+    while (n > 0) {
+        size_t run = timsort_count_run(ts, a, n);
+        if (run < min_run) {
+            // extend a short run to min_run elements
+            size_t force = n < min_run ? n : min_run;
+            timsort_binary_insertion(ts, a, force, run);
+            run = force;
+        }
+        ts->pending[ts->n_pending].base = a;
+        ts->pending[ts->n_pending].len = run;
+        ts->n_pending += 1;
+        timsort_merge_collapse(ts);
+        a = TS_AT(ts, a, run);
+        n -= run;
+    }
+    // merge all remaining runs
+    while (ts->n_pending > 1) {
+        size_t i = ts->n_pending - 2;
+        if (i > 0 && ts->pending[i - 1].len < ts->pending[i + 1].len) {
+            i -= 1;
+        }
+        timsort_merge_at(ts, i);
+    }
+}
+
+STATIC void list_timsort(mp_obj_list_t *self, mp_obj_t key_fn, bool reverse) {
+    size_t n = self->len;
+    timsort_t ts;
+    ts.stride = 1;
+    ts.min_gallop = TIMSORT_MIN_GALLOP;
+    ts.tmp = NULL;
+    ts.tmp_alloc = 0;
+    ts.merge_n = 0;
+    ts.n_pending = 0;
+
+    // with a key function, sort (key, item) pairs so each key is computed once
+    mp_obj_t *pairs = NULL;
+    if (key_fn != mp_const_none) {
+        pairs = m_new(mp_obj_t, 2 * n);
+        for (size_t i = 0; i < n && self->len == n; i++) {
+            pairs[2 * i + 1] = self->items[i];
+            pairs[2 * i] = mp_call_function_1(key_fn, pairs[2 * i + 1]);
+        }
+        if (self->len != n) {
+            m_del(mp_obj_t, pairs, 2 * n);
+            mp_raise_ValueError("list modified during sort");
+        }
+        ts.stride = 2;
+    }
+
+    // detach the items while comparisons run user code, so that changes to
+    // the list can't move or free the memory being sorted
+    mp_obj_t *list_items = self->items;
+    size_t list_alloc = self->alloc;
+    mp_obj_t *empty_items = m_new0(mp_obj_t, LIST_MIN_ALLOC);
+    self->items = empty_items;
+    self->alloc = LIST_MIN_ALLOC;
+    self->len = 0;
+
+    mp_obj_t *items = pairs != NULL ? pairs : list_items;
+
+    // a reverse sort is stable if done as a forward sort of the reversed list
+    if (reverse) {
+        timsort_reverse(&ts, items, TS_AT(&ts, items, n - 1));
+    }
+
+    nlr_buf_t nlr;
+    mp_obj_t exc = MP_OBJ_NULL;
+    if (nlr_push(&nlr) == 0) {
+        timsort(&ts, items, n);
+        nlr_pop();
+    } else {
+        // a comparison raised: complete the merge in progress so that no
+        // elements are lost, and re-raise below
+        timsort_merge_finish(&ts);
+        exc = MP_OBJ_FROM_PTR(nlr.ret_val);
+    }
+
+    if (reverse) {
+        timsort_reverse(&ts, items, TS_AT(&ts, items, n - 1));
+    }
+    m_del(mp_obj_t, ts.tmp, ts.tmp_alloc * ts.stride);
+
+    // reattach the items, discarding anything the comparisons added
+    bool modified = self->items != empty_items || self->len != 0;
+    m_del(mp_obj_t, self->items, self->alloc);
+    self->items = list_items;
+    self->alloc = list_alloc;
+    self->len = n;
+    if (pairs != NULL) {
+        for (size_t i = 0; i < n; i++) {
+            list_items[i] = pairs[2 * i + 1];
+        }
+        m_del(mp_obj_t, pairs, 2 * n);
+    }
+    if (exc != MP_OBJ_NULL) {
+        nlr_jump(MP_OBJ_TO_PTR(exc));
+    }
+    if (modified) {
+        mp_raise_ValueError("list modified during sort");
+    }
+}
+
+#else
+
 STATIC void mp_quicksort(mp_obj_t *head, mp_obj_t *tail, mp_obj_t key_fn, mp_obj_t binop_less_result) {
     MP_STACK_CHECK();
     while (head < tail) {
@@ -309,7 +912,8 @@ STATIC void mp_quicksort(mp_obj_t *head, mp_obj_t *tail, mp_obj_t key_fn, mp_obj
     }
 }
 
-// TODO Python defines sort to be stable but ours is not
+#endif
+
 mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_key, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
@@ -326,11 +930,17 @@ mp_obj_t mp_obj_list_sort(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
     mp_check_self(MP_OBJ_IS_TYPE(pos_args[0], &mp_type_list));
     mp_obj_list_t *self = MP_OBJ_TO_PTR(pos_args[0]);
 
+    #if MICROPY_OPT_LIST_TIMSORT
+    if (self->len > 1) {
+        list_timsort(self, args.key.u_obj, args.reverse.u_bool);
+    }
+    #else
     if (self->len > 1) {
         mp_quicksort(self->items, self->items + self->len - 1,
                      args.key.u_obj == mp_const_none ? MP_OBJ_NULL : args.key.u_obj,
                      args.reverse.u_bool ? mp_const_false : mp_const_true);
     }
+    #endif
 
     return mp_const_none;
 }
@@ -27,22 +27,40 @@
 #include <stdlib.h>
 #include <assert.h>
 
+#include "py/runtime0.h"
 #include "py/runtime.h"
 
 typedef struct _mp_obj_map_t {
     mp_obj_base_t base;
     size_t n_iters;
+    #if MICROPY_OPT_ITER_LEN_HINT
+    size_t len_hint; // items left, if all the iterables were sized
+    #endif
     mp_obj_t fun;
     mp_obj_t iters[];
 } mp_obj_map_t;
 
+// Number of arguments that map_iternext can pass to the function without
+// allocating a temporary array on the heap
+#define MAP_ITERNEXT_STACK_ARGS (4)
+
 STATIC mp_obj_t map_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 2, MP_OBJ_FUN_ARGS_MAX, false);
     mp_obj_map_t *o = m_new_obj_var(mp_obj_map_t, mp_obj_t, n_args - 1);
     o->base.type = type;
     o->n_iters = n_args - 1;
     o->fun = args[0];
+    #if MICROPY_OPT_ITER_LEN_HINT
+    o->len_hint = (size_t)-1;
+    #endif
     for (size_t i = 0; i < n_args - 1; i++) {
+        #if MICROPY_OPT_ITER_LEN_HINT
+        // map stops at the shortest iterable
+        size_t len = mp_obj_len_hint(args[i + 1]);
+        if (len < o->len_hint) {
+            o->len_hint = len;
+        }
+        #endif
         o->iters[i] = mp_getiter(args[i + 1], NULL);
     }
     return MP_OBJ_FROM_PTR(o);
@@ -51,23 +69,47 @@ STATIC mp_obj_t map_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_
 STATIC mp_obj_t map_iternext(mp_obj_t self_in) {
     mp_check_self(MP_OBJ_IS_TYPE(self_in, &mp_type_map));
     mp_obj_map_t *self = MP_OBJ_TO_PTR(self_in);
-    mp_obj_t *nextses = m_new(mp_obj_t, self->n_iters);
+    mp_obj_t nextses_buf[MAP_ITERNEXT_STACK_ARGS];
+    mp_obj_t *nextses = nextses_buf;
+    if (self->n_iters > MAP_ITERNEXT_STACK_ARGS) {
+        nextses = m_new(mp_obj_t, self->n_iters);
+    }
 
     for (size_t i = 0; i < self->n_iters; i++) {
         mp_obj_t next = mp_iternext(self->iters[i]);
         if (next == MP_OBJ_STOP_ITERATION) {
-            m_del(mp_obj_t, nextses, self->n_iters);
+            if (nextses != nextses_buf) {
+                m_del(mp_obj_t, nextses, self->n_iters);
+            }
             return MP_OBJ_STOP_ITERATION;
         }
         nextses[i] = next;
     }
+    #if MICROPY_OPT_ITER_LEN_HINT
+    if (self->len_hint > 0) {
+        self->len_hint -= 1;
+    }
+    #endif
     return mp_call_function_n_kw(self->fun, self->n_iters, 0, nextses);
 }
 
+#if MICROPY_OPT_ITER_LEN_HINT
+STATIC mp_obj_t map_unary_op(mp_uint_t op, mp_obj_t self_in) {
+    mp_obj_map_t *self = MP_OBJ_TO_PTR(self_in);
+    switch (op) {
+        case MP_UNARY_OP_LEN_HINT: return MP_OBJ_NEW_SMALL_INT(self->len_hint);
+        default: return MP_OBJ_NULL; // op not supported
+    }
+}
+#endif
+
 const mp_obj_type_t mp_type_map = {
     { &mp_type_type },
     .name = MP_QSTR_map,
     .make_new = map_make_new,
+    #if MICROPY_OPT_ITER_LEN_HINT
+    .unary_op = map_unary_op,
+    #endif
     .getiter = mp_identity_getiter,
     .iternext = map_iternext,
 };
@@ -52,9 +52,30 @@ STATIC mp_obj_t range_it_iternext(mp_obj_t o_in) {
     }
 }
 
+#if MICROPY_OPT_ITER_LEN_HINT
+STATIC mp_obj_t range_it_unary_op(mp_uint_t op, mp_obj_t o_in) {
+    mp_obj_range_it_t *o = MP_OBJ_TO_PTR(o_in);
+    switch (op) {
+        case MP_UNARY_OP_LEN_HINT: {
+            mp_int_t len = 0;
+            if (o->step > 0 && o->cur < o->stop) {
+                len = (o->stop - o->cur - 1) / o->step + 1;
+            } else if (o->step < 0 && o->cur > o->stop) {
+                len = (o->cur - o->stop - 1) / -o->step + 1;
+            }
+            return MP_OBJ_NEW_SMALL_INT(len);
+        }
+        default: return MP_OBJ_NULL; // op not supported
+    }
+}
+#endif
+
 STATIC const mp_obj_type_t range_it_type = {
     { &mp_type_type },
     .name = MP_QSTR_iterator,
+    #if MICROPY_OPT_ITER_LEN_HINT
+    .unary_op = range_it_unary_op,
+    #endif
     .getiter = mp_identity_getiter,
     .iternext = range_it_iternext,
 };
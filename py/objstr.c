@@ -223,13 +223,8 @@ STATIC mp_obj_t bytes_make_new(const mp_obj_type_t *type_in, size_t n_args, size
 
     vstr_t vstr;
     // Try to create array of exact len if initializer len is known
-    mp_obj_t len_in = mp_obj_len_maybe(args[0]);
-    if (len_in == MP_OBJ_NULL) {
-        vstr_init(&vstr, 16);
-    } else {
-        mp_int_t len = MP_OBJ_SMALL_INT_VALUE(len_in);
-        vstr_init(&vstr, len);
-    }
+    size_t len = mp_obj_len_hint(args[0]);
+    vstr_init(&vstr, len == 0 ? 16 : len);
 
     mp_obj_iter_buf_t iter_buf;
     mp_obj_t iterable = mp_getiter(args[0], &iter_buf);
@@ -250,28 +245,87 @@ wrong_args:
     mp_raise_TypeError("wrong number of arguments");
 }
 
+// Needles at least this long, searched for in haystacks at least
+// FIND_SUBBYTES_HORSPOOL_MIN_HLEN long, use Boyer-Moore-Horspool; shorter
+// searches use memchr to skip straight to candidate positions.
+#define FIND_SUBBYTES_HORSPOOL_MIN_NLEN (4)
+#define FIND_SUBBYTES_HORSPOOL_MIN_HLEN (128)
+
+// Boyer-Moore-Horspool search, requires 2 <= nlen <= hlen.  The shift table
+// is stored as bytes (saturating at 255) so it only needs 256 bytes of stack.
+STATIC const byte *find_subbytes_horspool(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction) {
+    byte shift[256];
+    size_t max_shift = nlen < 255 ? nlen : 255;
+    memset(shift, max_shift, sizeof(shift));
+    if (direction > 0) {
+        // shift is the distance from the last occurrence of a byte in
+        // needle[0:nlen - 1] to the end of the needle
+        for (size_t i = nlen - max_shift; i < nlen - 1; i++) {
+            shift[needle[i]] = nlen - 1 - i;
+        }
+        byte last = needle[nlen - 1];
+        for (const byte *p = haystack, *top = haystack + hlen - nlen; p <= top;) {
+            byte c = p[nlen - 1];
+            if (c == last && memcmp(p, needle, nlen - 1) == 0) {
+                return p;
+            }
+            p += shift[c];
+        }
+    } else {
+        // mirror image: shift is the distance from the start of the needle
+        // to the first occurrence of a byte in needle[1:]
+        for (size_t i = max_shift - 1; i > 0; i--) {
+            shift[needle[i]] = i;
+        }
+        byte first = needle[0];
+        for (size_t pos = hlen - nlen;;) {
+            const byte *p = haystack + pos;
+            if (*p == first && memcmp(p + 1, needle + 1, nlen - 1) == 0) {
+                return p;
+            }
+            size_t s = shift[*p];
+            if (s > pos) {
+                break;
+            }
+            pos -= s;
+        }
+    }
+    return NULL;
+}
+
 // like strstr but with specified length and allows \0 bytes
-// TODO replace with something more efficient/standard
 const byte *find_subbytes(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction) {
-    if (hlen >= nlen) {
-        size_t str_index, str_index_end;
-        if (direction > 0) {
-            str_index = 0;
-            str_index_end = hlen - nlen;
-        } else {
-            str_index = hlen - nlen;
-            str_index_end = 0;
+    if (hlen < nlen) {
+        return NULL;
+    }
+    if (nlen == 0) {
+        return direction > 0 ? haystack : haystack + hlen;
+    }
+    if (nlen >= FIND_SUBBYTES_HORSPOOL_MIN_NLEN && hlen >= FIND_SUBBYTES_HORSPOOL_MIN_HLEN) {
+        return find_subbytes_horspool(haystack, hlen, needle, nlen, direction);
+    }
+    byte first = needle[0];
+    if (direction > 0) {
+        // let memchr (which is word-at-a-time in any decent libc) find each
+        // candidate first byte, then verify the rest of the needle
+        const byte *top = haystack + hlen - nlen;
+        for (const byte *p = haystack; p <= top; p++) {
+            p = memchr(p, first, top - p + 1);
+            if (p == NULL) {
+                break;
+            }
+            if (memcmp(p + 1, needle + 1, nlen - 1) == 0) {
+                return p;
+            }
         }
-        for (;;) {
-            if (memcmp(&haystack[str_index], needle, nlen) == 0) {
-                //found
-                return haystack + str_index;
+    } else {
+        for (const byte *p = haystack + hlen - nlen;; p--) {
+            if (*p == first && memcmp(p + 1, needle + 1, nlen - 1) == 0) {
+                return p;
             }
-            if (str_index == str_index_end) {
-                //not found
+            if (p == haystack) {
                 break;
             }
-            str_index += direction;
         }
     }
     return NULL;
@@ -523,14 +577,8 @@ mp_obj_t mp_obj_str_split(size_t n_args, const mp_obj_t *args) {
 
         for (;;) {
             const byte *start = s;
-            for (;;) {
-                if (splits == 0 || s + sep_len > top) {
-                    s = top;
-                    break;
-                } else if (memcmp(s, sep_str, sep_len) == 0) {
-                    break;
-                }
-                s++;
+            if (splits == 0 || (s = find_subbytes(s, top - s, (const byte*)sep_str, sep_len, 1)) == NULL) {
+                s = top;
             }
             mp_obj_list_append(res, mp_obj_new_str_of_type(self_type, start, s - start));
             if (s >= top) {
@@ -629,16 +677,11 @@ STATIC mp_obj_t str_rsplit(size_t n_args, const mp_obj_t *args) {
         const byte *beg = s;
         const byte *last = s + len;
         for (;;) {
-            s = last - sep_len;
-            for (;;) {
-                if (splits == 0 || s < beg) {
-                    break;
-                } else if (memcmp(s, sep_str, sep_len) == 0) {
-                    break;
-                }
-                s--;
+            s = NULL;
+            if (splits != 0) {
+                s = find_subbytes(beg, last - beg, (const byte*)sep_str, sep_len, -1);
             }
-            if (s < beg || splits == 0) {
+            if (s == NULL) {
                 res->items[idx] = mp_obj_new_str_of_type(self_type, beg, last - beg);
                 break;
             }
@@ -682,7 +725,10 @@ STATIC mp_obj_t str_finder(size_t n_args, const mp_obj_t *args, int direction, b
         end = str_index_to_ptr(self_type, haystack, haystack_len, args[3], true);
     }
 
-    const byte *p = find_subbytes(start, end - start, needle, needle_len, direction);
+    const byte *p = NULL;
+    if (start <= end) {
+        p = find_subbytes(start, end - start, needle, needle_len, direction);
+    }
     if (p == NULL) {
         // not found
         if (is_index) {
@@ -909,10 +955,318 @@ STATIC NORETURN void terse_str_format_value_error(void) {
 #define terse_str_format_value_error()
 #endif
 
+// The parsed form of the format_spec of a replacement field
+typedef struct _str_format_spec_t {
+    char fill;
+    char align;
+    char type;
+    int flags;
+    int width;
+    int precision;
+} str_format_spec_t;
+
+// Parse a format_spec (with any nested replacement fields already substituted)
+// from s up to stop.  Returns false if the format_spec is invalid.
+STATIC bool str_format_parse_spec(const char *s, const char *stop, str_format_spec_t *spec) {
+    // The format specifier (from http://docs.python.org/2/library/string.html#formatspec)
+    //
+    // [[fill]align][sign][#][0][width][,][.precision][type]
+    // fill        ::=  <any character>
+    // align       ::=  "<" | ">" | "=" | "^"
+    // sign        ::=  "+" | "-" | " "
+    // width       ::=  integer
+    // precision   ::=  integer
+    // type        ::=  "b" | "c" | "d" | "e" | "E" | "f" | "F" | "g" | "G" | "n" | "o" | "s" | "x" | "X" | "%"
+
+    spec->fill = '\0';
+    spec->align = '\0';
+    spec->type = '\0';
+    spec->flags = 0;
+    spec->width = -1;
+    spec->precision = -1;
+
+    if (s < stop && isalignment(*s)) {
+        spec->align = *s++;
+    } else if (s + 1 < stop && isalignment(s[1])) {
+        spec->fill = *s++;
+        spec->align = *s++;
+    }
+    if (s < stop && (*s == '+' || *s == '-' || *s == ' ')) {
+        if (*s == '+') {
+            spec->flags |= PF_FLAG_SHOW_SIGN;
+        } else if (*s == ' ') {
+            spec->flags |= PF_FLAG_SPACE_SIGN;
+        }
+        s++;
+    }
+    if (s < stop && *s == '#') {
+        spec->flags |= PF_FLAG_SHOW_PREFIX;
+        s++;
+    }
+    if (s < stop && *s == '0') {
+        if (!spec->align) {
+            spec->align = '=';
+        }
+        if (!spec->fill) {
+            spec->fill = '0';
+        }
+    }
+    s = str_to_int(s, stop, &spec->width);
+    if (s < stop && *s == ',') {
+        spec->flags |= PF_FLAG_SHOW_COMMA;
+        s++;
+    }
+    if (s < stop && *s == '.') {
+        s++;
+        s = str_to_int(s, stop, &spec->precision);
+    }
+    if (s < stop && istype(*s)) {
+        spec->type = *s++;
+    }
+    return s == stop;
+}
+
+// Output a single argument of str.format.  If conversion is non-zero then
+// the argument is first converted to a str using str() or repr().  spec may
+// be NULL if the replacement field has no format_spec.
+STATIC void str_format_arg(const mp_print_t *print, mp_obj_t arg, char conversion, const str_format_spec_t *spec) {
+    if (spec != NULL && spec->fill == '\0' && spec->align == '\0' && spec->type == '\0'
+        && spec->flags == 0 && spec->width < 0 && spec->precision < 0) {
+        // an empty format_spec, eg {:{}} with '', is the same as none, like {:}
+        spec = NULL;
+    }
+    if (spec == NULL) {
+        // {}, {!s} and {!r} print the object directly, there is nothing to
+        // pad or truncate so there's no need to make an intermediate str
+        mp_obj_print_helper(print, arg, conversion == 'r' ? PRINT_REPR : PRINT_STR);
+        return;
+    }
+
+    if (conversion) {
+        mp_print_kind_t print_kind;
+        if (conversion == 's') {
+            print_kind = PRINT_STR;
+        } else {
+            assert(conversion == 'r');
+            print_kind = PRINT_REPR;
+        }
+        vstr_t arg_vstr;
+        mp_print_t arg_print;
+        vstr_init_print(&arg_vstr, 16, &arg_print);
+        mp_obj_print_helper(&arg_print, arg, print_kind);
+        arg = mp_obj_new_str_from_vstr(&mp_type_str, &arg_vstr);
+    }
+
+    char fill = spec->fill;
+    char align = spec->align;
+    int width = spec->width;
+    int precision = spec->precision;
+    char type = spec->type;
+    int flags = spec->flags;
+
+    if (!align) {
+        if (arg_looks_numeric(arg)) {
+            align = '>';
+        } else {
+            align = '<';
+        }
+    }
+    if (!fill) {
+        fill = ' ';
+    }
+
+    if (flags & (PF_FLAG_SHOW_SIGN | PF_FLAG_SPACE_SIGN)) {
+        if (type == 's') {
+            if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                terse_str_format_value_error();
+            } else {
+                mp_raise_ValueError("sign not allowed in string format specifier");
+            }
+        }
+        if (type == 'c') {
+            if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                terse_str_format_value_error();
+            } else {
+                mp_raise_ValueError(
+                    "sign not allowed with integer format specifier 'c'");
+            }
+        }
+    }
+
+    switch (align) {
+        case '<': flags |= PF_FLAG_LEFT_ADJUST;     break;
+        case '=': flags |= PF_FLAG_PAD_AFTER_SIGN;  break;
+        case '^': flags |= PF_FLAG_CENTER_ADJUST;   break;
+    }
+
+    if (arg_looks_integer(arg)) {
+        switch (type) {
+            case 'b':
+                mp_print_mp_int(print, arg, 2, 'a', flags, fill, width, 0);
+                return;
+
+            case 'c':
+            {
+                char ch = mp_obj_get_int(arg);
+                mp_print_strn(print, &ch, 1, flags, fill, width);
+                return;
+            }
+
+            case '\0':  // No explicit format type implies 'd'
+            case 'n':   // I don't think we support locales in uPy so use 'd'
+            case 'd':
+                mp_print_mp_int(print, arg, 10, 'a', flags, fill, width, 0);
+                return;
+
+            case 'o':
+                if (flags & PF_FLAG_SHOW_PREFIX) {
+                    flags |= PF_FLAG_SHOW_OCTAL_LETTER;
+                }
+
+                mp_print_mp_int(print, arg, 8, 'a', flags, fill, width, 0);
+                return;
+
+            case 'X':
+            case 'x':
+                mp_print_mp_int(print, arg, 16, type - ('X' - 'A'), flags, fill, width, 0);
+                return;
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case '%':
+                // The floating point formatters all work with anything that
+                // looks like an integer
+                break;
+
+            default:
+                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                    terse_str_format_value_error();
+                } else {
+                    nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
+                        "unknown format code '%c' for object of type '%s'",
+                        type, mp_obj_get_type_str(arg)));
+                }
+        }
+    }
+
+    // NOTE: no else here. We need the e, f, g etc formats for integer
+    //       arguments (from above if) to take this if.
+    if (arg_looks_numeric(arg)) {
+        if (!type) {
+
+            // Even though the docs say that an unspecified type is the same
+            // as 'g', there is one subtle difference, when the exponent
+            // is one less than the precision.
+            //
+            // '{:10.1}'.format(0.0) ==> '0e+00'
+            // '{:10.1g}'.format(0.0) ==> '0'
+            //
+            // TODO: Figure out how to deal with this.
+            //
+            // A proper solution would involve adding a special flag
+            // or something to format_float, and create a format_double
+            // to deal with doubles. In order to fix this when using
+            // sprintf, we'd need to use the e format and tweak the
+            // returned result to strip trailing zeros like the g format
+            // does.
+            //
+            // {:10.3} and {:10.2e} with 1.23e2 both produce 1.23e+02
+            // but with 1.e2 you get 1e+02 and 1.00e+02
+            //
+            // Stripping the trailing 0's (like g) does would make the
+            // e format give us the right format.
+            //
+            // CPython sources say:
+            //   Omitted type specifier.  Behaves in the same way as repr(x)
+            //   and str(x) if no precision is given, else like 'g', but with
+            //   at least one digit after the decimal point. */
+
+            type = 'g';
+        }
+        if (type == 'n') {
+            type = 'g';
+        }
+
+        switch (type) {
+#if MICROPY_PY_BUILTINS_FLOAT
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+                mp_print_float(print, mp_obj_get_float(arg), type, flags, fill, width, precision);
+                break;
+
+            case '%':
+                flags |= PF_FLAG_ADD_PERCENT;
+                #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
+                #define F100 100.0F
+                #else
+                #define F100 100.0
+                #endif
+                mp_print_float(print, mp_obj_get_float(arg) * F100, 'f', flags, fill, width, precision);
+                #undef F100
+                break;
+#endif
+
+            default:
+                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                    terse_str_format_value_error();
+                } else {
+                    nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
+                        "unknown format code '%c' for object of type 'float'",
+                        type, mp_obj_get_type_str(arg)));
+                }
+        }
+    } else {
+        // arg doesn't look like a number
+
+        if (align == '=') {
+            if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                terse_str_format_value_error();
+            } else {
+                mp_raise_ValueError(
+                    "'=' alignment not allowed in string format specifier");
+            }
+        }
+
+        switch (type) {
+            case '\0': // no explicit format type implies 's'
+            case 's': {
+                size_t slen;
+                const char *s = mp_obj_str_get_data(arg, &slen);
+                if (precision < 0) {
+                    precision = slen;
+                }
+                if (slen > (size_t)precision) {
+                    slen = precision;
+                }
+                mp_print_strn(print, s, slen, flags, fill, width);
+                break;
+            }
+
+            default:
+                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                    terse_str_format_value_error();
+                } else {
+                    nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
+                        "unknown format code '%c' for object of type 'str'",
+                        type, mp_obj_get_type_str(arg)));
+                }
+        }
+    }
+}
+
 STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *arg_i, size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
     vstr_t vstr;
     mp_print_t print;
-    vstr_init_print(&vstr, 16, &print);
+    // the result is usually at least as long as the format string
+    vstr_init_print(&vstr, (top - str) + 16, &print);
 
     for (; str < top; str++) {
         if (*str == '}') {
@@ -928,7 +1282,12 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
             }
         }
         if (*str != '{') {
-            vstr_add_byte(&vstr, *str);
+            // add a run of literal text in one go
+            const char *lit = str;
+            while (str + 1 < top && str[1] != '{' && str[1] != '}') {
+                str++;
+            }
+            vstr_add_strn(&vstr, lit, str + 1 - lit);
             continue;
         }
 
@@ -1060,320 +1419,561 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
             arg = args[(*arg_i) + 1];
             (*arg_i)++;
         }
-        if (!format_spec && !conversion) {
-            conversion = 's';
-        }
-        if (conversion) {
-            mp_print_kind_t print_kind;
-            if (conversion == 's') {
-                print_kind = PRINT_STR;
-            } else {
-                assert(conversion == 'r');
-                print_kind = PRINT_REPR;
-            }
-            vstr_t arg_vstr;
-            mp_print_t arg_print;
-            vstr_init_print(&arg_vstr, 16, &arg_print);
-            mp_obj_print_helper(&arg_print, arg, print_kind);
-            arg = mp_obj_new_str_from_vstr(&mp_type_str, &arg_vstr);
-        }
-
-        char fill = '\0';
-        char align = '\0';
-        int width = -1;
-        int precision = -1;
-        char type = '\0';
-        int flags = 0;
-
-        if (format_spec) {
-            // The format specifier (from http://docs.python.org/2/library/string.html#formatspec)
-            //
-            // [[fill]align][sign][#][0][width][,][.precision][type]
-            // fill        ::=  <any character>
-            // align       ::=  "<" | ">" | "=" | "^"
-            // sign        ::=  "+" | "-" | " "
-            // width       ::=  integer
-            // precision   ::=  integer
-            // type        ::=  "b" | "c" | "d" | "e" | "E" | "f" | "F" | "g" | "G" | "n" | "o" | "s" | "x" | "X" | "%"
 
+        if (format_spec == NULL) {
+            str_format_arg(&print, arg, conversion, NULL);
+        } else {
             // recursively call the formatter to format any nested specifiers
             MP_STACK_CHECK();
             vstr_t format_spec_vstr = mp_obj_str_format_helper(format_spec, str, arg_i, n_args, args, kwargs);
-            const char *s = vstr_null_terminated_str(&format_spec_vstr);
-            const char *stop = s + format_spec_vstr.len;
-            if (isalignment(*s)) {
-                align = *s++;
-            } else if (*s && isalignment(s[1])) {
-                fill = *s++;
-                align = *s++;
-            }
-            if (*s == '+' || *s == '-' || *s == ' ') {
-                if (*s == '+') {
-                    flags |= PF_FLAG_SHOW_SIGN;
-                } else if (*s == ' ') {
-                    flags |= PF_FLAG_SPACE_SIGN;
+            str_format_spec_t spec;
+            if (!str_format_parse_spec(format_spec_vstr.buf, format_spec_vstr.buf + format_spec_vstr.len, &spec)) {
+                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                    terse_str_format_value_error();
+                } else {
+                    mp_raise_ValueError("invalid format specifier");
                 }
-                s++;
             }
-            if (*s == '#') {
-                flags |= PF_FLAG_SHOW_PREFIX;
-                s++;
+            vstr_clear(&format_spec_vstr);
+            str_format_arg(&print, arg, conversion, &spec);
+        }
+    }
+
+    return vstr;
+}
+
+#if MICROPY_OPT_STR_FORMAT_CACHE
+
+// A str.format template that has been parsed ahead of time.  Each item is a
+// run of literal text (a range of the format string) followed by an optional
+// replacement field.  Templates are only made for format strings that are
+// qstrs, which includes all constant strings in a script, so the literal
+// text can be referenced from the qstr data.
+enum {
+    STR_FORMAT_FIELD_NONE,
+    STR_FORMAT_FIELD_POS,
+    STR_FORMAT_FIELD_KW,
+};
+
+typedef struct _str_format_item_t {
+    uint16_t lit_offset;
+    uint16_t lit_len;
+    byte field;
+    char conversion;
+    bool has_spec;
+    mp_uint_t arg; // positional index or keyword qstr
+    str_format_spec_t spec;
+} str_format_item_t;
+
+// The str.format and % templates start with this, so that both kinds can be
+// looked up by str_template_lookup.
+typedef struct _str_template_t {
+    qstr fmt;
+    // n_items is 0 if the format string can't be compiled
+    size_t n_items;
+} str_template_t;
+
+typedef struct _str_format_template_t {
+    str_template_t base;
+    str_format_item_t items[];
+} str_format_template_t;
+
+// Compile the given format string into a template.  Format strings which use
+// nested replacement fields in a format_spec, attribute lookup, or are invalid
+// get a template with no items, and are handled by mp_obj_str_format_helper
+// (which will raise the appropriate error).
+STATIC str_template_t *str_format_compile(qstr fmt) {
+    size_t len;
+    const char *str0 = (const char*)qstr_data(fmt, &len);
+    const char *top = str0 + len;
+
+    // each brace can end at most one item
+    size_t max_items = 1;
+    for (const char *str = str0; str < top; str++) {
+        if (*str == '{' || *str == '}') {
+            max_items++;
+        }
+    }
+
+    str_format_template_t *t = m_new_obj_var(str_format_template_t, str_format_item_t, max_items);
+    t->base.fmt = fmt;
+    t->base.n_items = 0;
+    if (len > 0xffff) {
+        return &t->base;
+    }
+
+    int numbering = 0; // 1 for automatic, -1 for manual
+    size_t auto_index = 0;
+    const char *lit = str0;
+    str_format_item_t *item = &t->items[0];
+    for (const char *str = str0; str < top; str++) {
+        if (*str != '{' && *str != '}') {
+            continue;
+        }
+        if (str + 1 < top && str[1] == *str) {
+            // escaped brace, end the literal text after the first one
+            item->lit_offset = lit - str0;
+            item->lit_len = str + 1 - lit;
+            item->field = STR_FORMAT_FIELD_NONE;
+            item++;
+            lit = ++str + 1;
+            continue;
+        }
+        if (*str == '}') {
+            goto fail;
+        }
+
+        // replacement field
+        item->lit_offset = lit - str0;
+        item->lit_len = str - lit;
+        item->conversion = '\0';
+        item->has_spec = false;
+        const char *field_name = ++str;
+        while (str < top && *str != '}' && *str != '!' && *str != ':') {
+            ++str;
+        }
+        if (field_name == str) {
+            if (numbering < 0) {
+                goto fail;
+            }
+            numbering = 1;
+            item->field = STR_FORMAT_FIELD_POS;
+            item->arg = auto_index++;
+        } else if (unichar_isdigit(*field_name)) {
+            if (numbering > 0) {
+                goto fail;
             }
-            if (*s == '0') {
-                if (!align) {
-                    align = '=';
-                }
-                if (!fill) {
-                    fill = '0';
+            numbering = -1;
+            int index;
+            if (str_to_int(field_name, str, &index) != str) {
+                goto fail;
+            }
+            item->field = STR_FORMAT_FIELD_POS;
+            item->arg = index;
+        } else {
+            for (const char *s = field_name; s < str; s++) {
+                if (*s == '.' || *s == '[') {
+                    goto fail;
                 }
             }
-            s = str_to_int(s, stop, &width);
-            if (*s == ',') {
-                flags |= PF_FLAG_SHOW_COMMA;
-                s++;
+            item->field = STR_FORMAT_FIELD_KW;
+            item->arg = qstr_from_strn(field_name, str - field_name);
+        }
+        if (str < top && *str == '!') {
+            if (++str < top && (*str == 'r' || *str == 's')) {
+                item->conversion = *str++;
+            } else {
+                goto fail;
             }
-            if (*s == '.') {
-                s++;
-                s = str_to_int(s, stop, &precision);
+        }
+        if (str < top && *str == ':') {
+            const char *spec = ++str;
+            while (str < top && *str != '{' && *str != '}') {
+                ++str;
             }
-            if (istype(*s)) {
-                type = *s++;
+            if (str < top && *str == '{') {
+                goto fail;
             }
-            if (*s) {
-                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                    terse_str_format_value_error();
-                } else {
-                    mp_raise_ValueError("invalid format specifier");
+            if (str > spec) {
+                if (!str_format_parse_spec(spec, str, &item->spec)) {
+                    goto fail;
                 }
+                item->has_spec = true;
             }
-            vstr_clear(&format_spec_vstr);
         }
-        if (!align) {
-            if (arg_looks_numeric(arg)) {
-                align = '>';
-            } else {
-                align = '<';
-            }
+        if (str >= top || *str != '}') {
+            goto fail;
         }
-        if (!fill) {
-            fill = ' ';
+        if (!item->has_spec && !item->conversion) {
+            item->conversion = 's';
         }
+        item++;
+        lit = str + 1;
+    }
+    item->lit_offset = lit - str0;
+    item->lit_len = top - lit;
+    item->field = STR_FORMAT_FIELD_NONE;
+    t->base.n_items = item - t->items + 1;
+    return &t->base;
 
-        if (flags & (PF_FLAG_SHOW_SIGN | PF_FLAG_SPACE_SIGN)) {
-            if (type == 's') {
-                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                    terse_str_format_value_error();
-                } else {
-                    mp_raise_ValueError("sign not allowed in string format specifier");
-                }
+fail:
+    t->base.n_items = 0;
+    return &t->base;
+}
+
+STATIC const str_template_t *str_template_lookup(str_template_t **cache, qstr fmt, str_template_t *(*compile)(qstr)) {
+    // the cache is 2-way set associative on the qstr value, so two format
+    // strings in the same set don't evict each other on every call; the most
+    // recently used entry of a set is kept first, and the other one is evicted
+    str_template_t **set = &cache[fmt % (MICROPY_OPT_STR_FORMAT_CACHE_SIZE / 2) * 2];
+    str_template_t *t = set[0];
+    if (t != NULL && t->fmt == fmt) {
+        return t;
+    }
+    t = set[1];
+    if (t == NULL || t->fmt != fmt) {
+        t = compile(fmt);
+    }
+    set[1] = set[0];
+    set[0] = t;
+    return t;
+}
+
+STATIC mp_obj_t str_format_from_template(const str_format_template_t *t, size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
+    const char *str = (const char*)qstr_str(t->base.fmt);
+    vstr_t vstr;
+    mp_print_t print;
+    vstr_init_print(&vstr, qstr_len(t->base.fmt) + 16, &print);
+    for (const str_format_item_t *item = t->items, *top = t->items + t->base.n_items; item < top; item++) {
+        vstr_add_strn(&vstr, str + item->lit_offset, item->lit_len);
+        mp_obj_t arg;
+        if (item->field == STR_FORMAT_FIELD_POS) {
+            if (item->arg >= n_args - 1) {
+                mp_raise_msg(&mp_type_IndexError, "tuple index out of range");
             }
-            if (type == 'c') {
-                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                    terse_str_format_value_error();
-                } else {
-                    mp_raise_ValueError(
-                        "sign not allowed with integer format specifier 'c'");
-                }
+            arg = args[item->arg + 1];
+        } else if (item->field == STR_FORMAT_FIELD_KW) {
+            mp_map_elem_t *key_elem = mp_map_lookup(kwargs, MP_OBJ_NEW_QSTR(item->arg), MP_MAP_LOOKUP);
+            if (key_elem == NULL) {
+                nlr_raise(mp_obj_new_exception_arg1(&mp_type_KeyError, MP_OBJ_NEW_QSTR(item->arg)));
             }
+            arg = key_elem->value;
+        } else {
+            continue;
         }
+        str_format_arg(&print, arg, item->conversion, item->has_spec ? &item->spec : NULL);
+    }
+    return mp_obj_new_str_from_vstr(&mp_type_str, &vstr);
+}
 
-        switch (align) {
-            case '<': flags |= PF_FLAG_LEFT_ADJUST;     break;
-            case '=': flags |= PF_FLAG_PAD_AFTER_SIGN;  break;
-            case '^': flags |= PF_FLAG_CENTER_ADJUST;   break;
+#endif // MICROPY_OPT_STR_FORMAT_CACHE
+
+mp_obj_t mp_obj_str_format(size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
+    mp_check_self(MP_OBJ_IS_STR_OR_BYTES(args[0]));
+
+    #if MICROPY_OPT_STR_FORMAT_CACHE
+    if (MP_OBJ_IS_QSTR(args[0])) {
+        const str_format_template_t *t = (const str_format_template_t*)str_template_lookup(
+            MP_STATE_VM(str_format_cache), MP_OBJ_QSTR_VALUE(args[0]), str_format_compile);
+        if (t->base.n_items != 0) {
+            return str_format_from_template(t, n_args, args, kwargs);
         }
+    }
+    #endif
 
-        if (arg_looks_integer(arg)) {
-            switch (type) {
-                case 'b':
-                    mp_print_mp_int(&print, arg, 2, 'a', flags, fill, width, 0);
-                    continue;
+    GET_STR_DATA_LEN(args[0], str, len);
+    int arg_i = 0;
+    vstr_t vstr = mp_obj_str_format_helper((const char*)str, (const char*)str + len, &arg_i, n_args, args, kwargs);
+    return mp_obj_new_str_from_vstr(&mp_type_str, &vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(str_format_obj, 1, mp_obj_str_format);
 
-                case 'c':
-                {
-                    char ch = mp_obj_get_int(arg);
-                    mp_print_strn(&print, &ch, 1, flags, fill, width);
-                    continue;
+// Format arg for a single % conversion, returning false if the conversion
+// type isn't supported.
+STATIC bool str_modulo_format_arg(const mp_print_t *print, mp_obj_t arg, char type, int flags, char fill, int alt, int width, int prec, bool is_bytes) {
+    switch (type) {
+        case 'c':
+            if (MP_OBJ_IS_STR(arg)) {
+                size_t slen;
+                const char *s = mp_obj_str_get_data(arg, &slen);
+                if (slen != 1) {
+                    mp_raise_TypeError("%%c requires int or char");
                 }
+                mp_print_strn(print, s, 1, flags, ' ', width);
+            } else if (arg_looks_integer(arg)) {
+                char ch = mp_obj_get_int(arg);
+                mp_print_strn(print, &ch, 1, flags, ' ', width);
+            } else {
+                mp_raise_TypeError("integer required");
+            }
+            break;
 
-                case '\0':  // No explicit format type implies 'd'
-                case 'n':   // I don't think we support locales in uPy so use 'd'
-                case 'd':
-                    mp_print_mp_int(&print, arg, 10, 'a', flags, fill, width, 0);
-                    continue;
+        case 'd':
+        case 'i':
+        case 'u':
+            mp_print_mp_int(print, arg_as_int(arg), 10, 'a', flags, fill, width, prec);
+            break;
 
-                case 'o':
-                    if (flags & PF_FLAG_SHOW_PREFIX) {
-                        flags |= PF_FLAG_SHOW_OCTAL_LETTER;
-                    }
+#if MICROPY_PY_BUILTINS_FLOAT
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+            mp_print_float(print, mp_obj_get_float(arg), type, flags, fill, width, prec);
+            break;
+#endif
 
-                    mp_print_mp_int(&print, arg, 8, 'a', flags, fill, width, 0);
-                    continue;
-
-                case 'X':
-                case 'x':
-                    mp_print_mp_int(&print, arg, 16, type - ('X' - 'A'), flags, fill, width, 0);
-                    continue;
-
-                case 'e':
-                case 'E':
-                case 'f':
-                case 'F':
-                case 'g':
-                case 'G':
-                case '%':
-                    // The floating point formatters all work with anything that
-                    // looks like an integer
-                    break;
+        case 'o':
+            if (alt) {
+                flags |= (PF_FLAG_SHOW_PREFIX | PF_FLAG_SHOW_OCTAL_LETTER);
+            }
+            mp_print_mp_int(print, arg, 8, 'a', flags, fill, width, prec);
+            break;
 
-                default:
-                    if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                        terse_str_format_value_error();
-                    } else {
-                        nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
-                            "unknown format code '%c' for object of type '%s'",
-                            type, mp_obj_get_type_str(arg)));
-                    }
+        case 'r':
+        case 's': {
+            vstr_t arg_vstr;
+            mp_print_t arg_print;
+            vstr_init_print(&arg_vstr, 16, &arg_print);
+            mp_print_kind_t print_kind = (type == 'r' ? PRINT_REPR : PRINT_STR);
+            if (print_kind == PRINT_STR && is_bytes && MP_OBJ_IS_TYPE(arg, &mp_type_bytes)) {
+                // If we have something like b"%s" % b"1", bytes arg should be
+                // printed undecorated.
+                print_kind = PRINT_RAW;
             }
+            mp_obj_print_helper(&arg_print, arg, print_kind);
+            uint vlen = arg_vstr.len;
+            if (prec < 0) {
+                prec = vlen;
+            }
+            if (vlen > (uint)prec) {
+                vlen = prec;
+            }
+            mp_print_strn(print, arg_vstr.buf, vlen, flags, ' ', width);
+            vstr_clear(&arg_vstr);
+            break;
         }
 
-        // NOTE: no else here. We need the e, f, g etc formats for integer
-        //       arguments (from above if) to take this if.
-        if (arg_looks_numeric(arg)) {
-            if (!type) {
-
-                // Even though the docs say that an unspecified type is the same
-                // as 'g', there is one subtle difference, when the exponent
-                // is one less than the precision.
-                //
-                // '{:10.1}'.format(0.0) ==> '0e+00'
-                // '{:10.1g}'.format(0.0) ==> '0'
-                //
-                // TODO: Figure out how to deal with this.
-                //
-                // A proper solution would involve adding a special flag
-                // or something to format_float, and create a format_double
-                // to deal with doubles. In order to fix this when using
-                // sprintf, we'd need to use the e format and tweak the
-                // returned result to strip trailing zeros like the g format
-                // does.
-                //
-                // {:10.3} and {:10.2e} with 1.23e2 both produce 1.23e+02
-                // but with 1.e2 you get 1e+02 and 1.00e+02
-                //
-                // Stripping the trailing 0's (like g) does would make the
-                // e format give us the right format.
-                //
-                // CPython sources say:
-                //   Omitted type specifier.  Behaves in the same way as repr(x)
-                //   and str(x) if no precision is given, else like 'g', but with
-                //   at least one digit after the decimal point. */
-
-                type = 'g';
-            }
-            if (type == 'n') {
-                type = 'g';
-            }
-
-            switch (type) {
-#if MICROPY_PY_BUILTINS_FLOAT
-                case 'e':
-                case 'E':
-                case 'f':
-                case 'F':
-                case 'g':
-                case 'G':
-                    mp_print_float(&print, mp_obj_get_float(arg), type, flags, fill, width, precision);
-                    break;
+        case 'X':
+        case 'x':
+            mp_print_mp_int(print, arg, 16, type - ('X' - 'A'), flags | alt, fill, width, prec);
+            break;
 
-                case '%':
-                    flags |= PF_FLAG_ADD_PERCENT;
-                    #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
-                    #define F100 100.0F
-                    #else
-                    #define F100 100.0
-                    #endif
-                    mp_print_float(&print, mp_obj_get_float(arg) * F100, 'f', flags, fill, width, precision);
-                    #undef F100
-                    break;
-#endif
+        default:
+            return false;
+    }
+    return true;
+}
+
+#if MICROPY_OPT_STR_FORMAT_CACHE
+
+// A parsed % format template, made the same way as a str.format template.
+// Each item is a run of literal text followed by an optional conversion.
+#define STR_MODULO_STAR_WIDTH (1)
+#define STR_MODULO_STAR_PREC (2)
+
+typedef struct _str_modulo_item_t {
+    uint16_t lit_offset;
+    uint16_t lit_len;
+    char type; // '\0' if there's no conversion after the literal text
+    char fill;
+    byte alt;
+    byte star;
+    uint16_t flags;
+    int width;
+    int prec;
+    qstr key; // MP_QSTR_NULL if the value isn't looked up in the dict
+} str_modulo_item_t;
+
+typedef struct _str_modulo_template_t {
+    str_template_t base;
+    str_modulo_item_t items[];
+} str_modulo_template_t;
+
+STATIC const char str_modulo_types[] = "cdiuorsxX"
+    #if MICROPY_PY_BUILTINS_FLOAT
+    "eEfFgG"
+    #endif
+;
+
+// Compile the given % format string into a template.  Invalid format strings
+// get a template with no items, and are handled by the code in
+// str_modulo_format (which will raise the appropriate error).
+STATIC str_template_t *str_modulo_compile(qstr fmt) {
+    size_t len;
+    const byte *str0 = qstr_data(fmt, &len);
+    const byte *top = str0 + len;
+
+    // each % can end at most one item
+    size_t max_items = 1;
+    for (const byte *str = str0; str < top; str++) {
+        if (*str == '%') {
+            max_items++;
+        }
+    }
 
-                default:
-                    if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                        terse_str_format_value_error();
-                    } else {
-                        nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
-                            "unknown format code '%c' for object of type 'float'",
-                            type, mp_obj_get_type_str(arg)));
-                    }
+    str_modulo_template_t *t = m_new_obj_var(str_modulo_template_t, str_modulo_item_t, max_items);
+    t->base.fmt = fmt;
+    t->base.n_items = 0;
+    if (len > 0xffff) {
+        return &t->base;
+    }
+
+    const byte *lit = str0;
+    str_modulo_item_t *item = &t->items[0];
+    for (const byte *str = str0; str < top; str++) {
+        if (*str != '%') {
+            continue;
+        }
+        if (str + 1 < top && str[1] == '%') {
+            // escaped %, end the literal text after the first one
+            item->lit_offset = lit - str0;
+            item->lit_len = str + 1 - lit;
+            item->type = '\0';
+            item++;
+            lit = ++str + 1;
+            continue;
+        }
+
+        item->lit_offset = lit - str0;
+        item->lit_len = str - lit;
+        item->key = MP_QSTR_NULL;
+        if (++str >= top) {
+            goto fail;
+        }
+        if (*str == '(') {
+            const byte *key = ++str;
+            while (str < top && *str != ')') {
+                ++str;
             }
-        } else {
-            // arg doesn't look like a number
+            if (str >= top) {
+                goto fail;
+            }
+            item->key = qstr_from_strn((const char*)key, str - key);
+            str++;
+        }
 
-            if (align == '=') {
-                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                    terse_str_format_value_error();
+        int flags = 0;
+        item->fill = ' ';
+        item->alt = 0;
+        while (str < top) {
+            if (*str == '-')      flags |= PF_FLAG_LEFT_ADJUST;
+            else if (*str == '+') flags |= PF_FLAG_SHOW_SIGN;
+            else if (*str == ' ') flags |= PF_FLAG_SPACE_SIGN;
+            else if (*str == '#') item->alt = PF_FLAG_SHOW_PREFIX;
+            else if (*str == '0') {
+                flags |= PF_FLAG_PAD_AFTER_SIGN;
+                item->fill = '0';
+            } else break;
+            str++;
+        }
+        item->flags = flags;
+        item->star = 0;
+        item->width = 0;
+        if (str < top) {
+            if (*str == '*') {
+                item->star |= STR_MODULO_STAR_WIDTH;
+                str++;
+            } else {
+                str = (const byte*)str_to_int((const char*)str, (const char*)top, &item->width);
+            }
+        }
+        item->prec = -1;
+        if (str < top && *str == '.') {
+            if (++str < top) {
+                if (*str == '*') {
+                    item->star |= STR_MODULO_STAR_PREC;
+                    str++;
                 } else {
-                    mp_raise_ValueError(
-                        "'=' alignment not allowed in string format specifier");
+                    item->prec = 0;
+                    str = (const byte*)str_to_int((const char*)str, (const char*)top, &item->prec);
                 }
             }
+        }
+        if (str >= top || *str == '\0' || strchr(str_modulo_types, *str) == NULL) {
+            goto fail;
+        }
+        item->type = *str;
+        item++;
+        lit = str + 1;
+    }
+    item->lit_offset = lit - str0;
+    item->lit_len = top - lit;
+    item->type = '\0';
+    t->base.n_items = item - t->items + 1;
+    return &t->base;
 
-            switch (type) {
-                case '\0': // no explicit format type implies 's'
-                case 's': {
-                    size_t slen;
-                    const char *s = mp_obj_str_get_data(arg, &slen);
-                    if (precision < 0) {
-                        precision = slen;
-                    }
-                    if (slen > (size_t)precision) {
-                        slen = precision;
-                    }
-                    mp_print_strn(&print, s, slen, flags, fill, width);
-                    break;
-                }
+fail:
+    t->base.n_items = 0;
+    return &t->base;
+}
 
-                default:
-                    if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                        terse_str_format_value_error();
-                    } else {
-                        nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
-                            "unknown format code '%c' for object of type 'str'",
-                            type, mp_obj_get_type_str(arg)));
-                    }
+STATIC mp_obj_t str_modulo_from_template(const str_modulo_template_t *t, size_t n_args, const mp_obj_t *args, mp_obj_t dict) {
+    const char *str = (const char*)qstr_str(t->base.fmt);
+    size_t arg_i = 0;
+    vstr_t vstr;
+    mp_print_t print;
+    vstr_init_print(&vstr, qstr_len(t->base.fmt) + 16, &print);
+    for (const str_modulo_item_t *item = t->items, *top = t->items + t->base.n_items; item < top; item++) {
+        vstr_add_strn(&vstr, str + item->lit_offset, item->lit_len);
+        if (item->type == '\0') {
+            continue;
+        }
+        mp_obj_t arg = MP_OBJ_NULL;
+        if (item->key != MP_QSTR_NULL) {
+            if (dict == MP_OBJ_NULL) {
+                mp_raise_TypeError("format requires a dict");
+            }
+            arg_i = 1; // we used up the single dict argument
+            arg = mp_obj_dict_get(dict, MP_OBJ_NEW_QSTR(item->key));
+        }
+        int width = item->width;
+        if (item->star & STR_MODULO_STAR_WIDTH) {
+            if (arg_i >= n_args) {
+                goto not_enough_args;
             }
+            width = mp_obj_get_int(args[arg_i++]);
         }
+        int prec = item->prec;
+        if (item->star & STR_MODULO_STAR_PREC) {
+            if (arg_i >= n_args) {
+                goto not_enough_args;
+            }
+            prec = mp_obj_get_int(args[arg_i++]);
+        }
+        if (arg == MP_OBJ_NULL) {
+            if (arg_i >= n_args) {
+not_enough_args:
+                mp_raise_TypeError("not enough arguments for format string");
+            }
+            arg = args[arg_i++];
+        }
+        str_modulo_format_arg(&print, arg, item->type, item->flags, item->fill, item->alt, width, prec, false);
     }
 
-    return vstr;
-}
-
-mp_obj_t mp_obj_str_format(size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
-    mp_check_self(MP_OBJ_IS_STR_OR_BYTES(args[0]));
+    if (arg_i != n_args) {
+        mp_raise_TypeError("not all arguments converted during string formatting");
+    }
 
-    GET_STR_DATA_LEN(args[0], str, len);
-    int arg_i = 0;
-    vstr_t vstr = mp_obj_str_format_helper((const char*)str, (const char*)str + len, &arg_i, n_args, args, kwargs);
     return mp_obj_new_str_from_vstr(&mp_type_str, &vstr);
 }
-MP_DEFINE_CONST_FUN_OBJ_KW(str_format_obj, 1, mp_obj_str_format);
+
+#endif // MICROPY_OPT_STR_FORMAT_CACHE
 
 STATIC mp_obj_t str_modulo_format(mp_obj_t pattern, size_t n_args, const mp_obj_t *args, mp_obj_t dict) {
     mp_check_self(MP_OBJ_IS_STR_OR_BYTES(pattern));
 
+    #if MICROPY_OPT_STR_FORMAT_CACHE
+    // only str constants are interned, so a template is never made for bytes
+    if (MP_OBJ_IS_QSTR(pattern)) {
+        const str_modulo_template_t *t = (const str_modulo_template_t*)str_template_lookup(
+            MP_STATE_VM(str_modulo_cache), MP_OBJ_QSTR_VALUE(pattern), str_modulo_compile);
+        if (t->base.n_items != 0) {
+            return str_modulo_from_template(t, n_args, args, dict);
+        }
+    }
+    #endif
+
     GET_STR_DATA_LEN(pattern, str, len);
     const byte *start_str = str;
     bool is_bytes = MP_OBJ_IS_TYPE(pattern, &mp_type_bytes);
     size_t arg_i = 0;
     vstr_t vstr;
     mp_print_t print;
-    vstr_init_print(&vstr, 16, &print);
+    // the result is usually at least as long as the format string
+    vstr_init_print(&vstr, len + 16, &print);
 
     for (const byte *top = str + len; str < top; str++) {
         mp_obj_t arg = MP_OBJ_NULL;
         if (*str != '%') {
-            vstr_add_byte(&vstr, *str);
+            // add a run of literal text in one go
+            const byte *lit = str;
+            while (str + 1 < top && str[1] != '%') {
+                str++;
+            }
+            vstr_add_strn(&vstr, (const char*)lit, str + 1 - lit);
             continue;
         }
         if (++str >= top) {
@@ -1466,85 +2066,14 @@ not_enough_args:
             }
             arg = args[arg_i++];
         }
-        switch (*str) {
-            case 'c':
-                if (MP_OBJ_IS_STR(arg)) {
-                    size_t slen;
-                    const char *s = mp_obj_str_get_data(arg, &slen);
-                    if (slen != 1) {
-                        mp_raise_TypeError("%%c requires int or char");
-                    }
-                    mp_print_strn(&print, s, 1, flags, ' ', width);
-                } else if (arg_looks_integer(arg)) {
-                    char ch = mp_obj_get_int(arg);
-                    mp_print_strn(&print, &ch, 1, flags, ' ', width);
-                } else {
-                    mp_raise_TypeError("integer required");
-                }
-                break;
-
-            case 'd':
-            case 'i':
-            case 'u':
-                mp_print_mp_int(&print, arg_as_int(arg), 10, 'a', flags, fill, width, prec);
-                break;
-
-#if MICROPY_PY_BUILTINS_FLOAT
-            case 'e':
-            case 'E':
-            case 'f':
-            case 'F':
-            case 'g':
-            case 'G':
-                mp_print_float(&print, mp_obj_get_float(arg), *str, flags, fill, width, prec);
-                break;
-#endif
-
-            case 'o':
-                if (alt) {
-                    flags |= (PF_FLAG_SHOW_PREFIX | PF_FLAG_SHOW_OCTAL_LETTER);
-                }
-                mp_print_mp_int(&print, arg, 8, 'a', flags, fill, width, prec);
-                break;
-
-            case 'r':
-            case 's':
-            {
-                vstr_t arg_vstr;
-                mp_print_t arg_print;
-                vstr_init_print(&arg_vstr, 16, &arg_print);
-                mp_print_kind_t print_kind = (*str == 'r' ? PRINT_REPR : PRINT_STR);
-                if (print_kind == PRINT_STR && is_bytes && MP_OBJ_IS_TYPE(arg, &mp_type_bytes)) {
-                    // If we have something like b"%s" % b"1", bytes arg should be
-                    // printed undecorated.
-                    print_kind = PRINT_RAW;
-                }
-                mp_obj_print_helper(&arg_print, arg, print_kind);
-                uint vlen = arg_vstr.len;
-                if (prec < 0) {
-                    prec = vlen;
-                }
-                if (vlen > (uint)prec) {
-                    vlen = prec;
-                }
-                mp_print_strn(&print, arg_vstr.buf, vlen, flags, ' ', width);
-                vstr_clear(&arg_vstr);
-                break;
+        if (!str_modulo_format_arg(&print, arg, *str, flags, fill, alt, width, prec, is_bytes)) {
+            if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
+                terse_str_format_value_error();
+            } else {
+                nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
+                    "unsupported format character '%c' (0x%x) at index %d",
+                    *str, *str, str - start_str));
             }
-
-            case 'X':
-            case 'x':
-                mp_print_mp_int(&print, arg, 16, *str - ('X' - 'A'), flags | alt, fill, width, prec);
-                break;
-
-            default:
-                if (MICROPY_ERROR_REPORTING == MICROPY_ERROR_REPORTING_TERSE) {
-                    terse_str_format_value_error();
-                } else {
-                    nlr_raise(mp_obj_new_exception_msg_varg(&mp_type_ValueError,
-                        "unsupported format character '%c' (0x%x) at index %d",
-                        *str, *str, str - start_str));
-                }
         }
     }
 
@@ -1684,6 +2213,11 @@ STATIC mp_obj_t str_count(size_t n_args, const mp_obj_t *args) {
         end = str_index_to_ptr(self_type, haystack, haystack_len, args[3], true);
     }
 
+    // an empty range can't contain anything
+    if (end < start) {
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+
     // if needle_len is zero then we count each gap between characters as an occurrence
     if (needle_len == 0) {
         return MP_OBJ_NEW_SMALL_INT(unichar_charlen((const char*)start, end - start) + 1);
@@ -1691,13 +2225,10 @@ STATIC mp_obj_t str_count(size_t n_args, const mp_obj_t *args) {
 
     // count the occurrences
     mp_int_t num_occurrences = 0;
-    for (const byte *haystack_ptr = start; haystack_ptr + needle_len <= end;) {
-        if (memcmp(haystack_ptr, needle, needle_len) == 0) {
-            num_occurrences++;
-            haystack_ptr += needle_len;
-        } else {
-            haystack_ptr = utf8_next_char(haystack_ptr);
-        }
+    for (const byte *haystack_ptr = start;
+        (haystack_ptr = find_subbytes(haystack_ptr, end - haystack_ptr, needle, needle_len, 1)) != NULL;
+        haystack_ptr += needle_len) {
+        num_occurrences++;
     }
 
     return MP_OBJ_NEW_SMALL_INT(num_occurrences);
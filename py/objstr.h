@@ -75,6 +75,7 @@ const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, s
 const byte *find_subbytes(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction);
 
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(str_encode_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(bytes_decode_obj);
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(str_find_obj);
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(str_rfind_obj);
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(str_index_obj);
@@ -37,15 +37,19 @@
 
 void mp_obj_tuple_print(const mp_print_t *print, mp_obj_t o_in, mp_print_kind_t kind) {
     mp_obj_tuple_t *o = MP_OBJ_TO_PTR(o_in);
+    const char *item_separator = ", ";
     if (MICROPY_PY_UJSON && kind == PRINT_JSON) {
         mp_print_str(print, "[");
+        #if MICROPY_PY_UJSON_SEPARATORS
+        item_separator = MP_PRINT_GET_EXT(print)->item_separator;
+        #endif
     } else {
         mp_print_str(print, "(");
         kind = PRINT_REPR;
     }
     for (size_t i = 0; i < o->len; i++) {
         if (i > 0) {
-            mp_print_str(print, ", ");
+            mp_print_str(print, item_separator);
         }
         mp_obj_print_helper(print, o->items[i], kind);
     }
@@ -76,26 +80,44 @@ STATIC mp_obj_t mp_obj_tuple_make_new(const mp_obj_type_t *type_in, size_t n_arg
                 return args[0];
             }
 
-            // TODO optimise for cases where we know the length of the iterator
-
-            size_t alloc = 4;
-            size_t len = 0;
-            mp_obj_t *items = m_new(mp_obj_t, alloc);
+            // build the tuple in place, sized by the length hint of the iterable
+            // if there is one, then trim it to the number of items received
+            size_t alloc = mp_obj_len_hint(args[0]);
+            mp_obj_tuple_t *tuple = NULL;
+            if (alloc > 0 && alloc <= (SIZE_MAX - sizeof(mp_obj_tuple_t)) / sizeof(mp_obj_t)) {
+                tuple = m_new_obj_var_maybe(mp_obj_tuple_t, mp_obj_t, alloc);
+            }
+            if (tuple == NULL) {
+                alloc = 4;
+                tuple = m_new_obj_var(mp_obj_tuple_t, mp_obj_t, alloc);
+            }
+            tuple->base.type = &mp_type_tuple;
+            tuple->len = 0;
 
             mp_obj_t iterable = mp_getiter(args[0], NULL);
             mp_obj_t item;
             while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
-                if (len >= alloc) {
-                    items = m_renew(mp_obj_t, items, alloc, alloc * 2);
+                if (tuple->len >= alloc) {
+                    tuple = (mp_obj_tuple_t*)m_renew(byte, tuple,
+                        sizeof(mp_obj_tuple_t) + alloc * sizeof(mp_obj_t),
+                        sizeof(mp_obj_tuple_t) + 2 * alloc * sizeof(mp_obj_t));
                     alloc *= 2;
                 }
-                items[len++] = item;
+                tuple->items[tuple->len++] = item;
             }
 
-            mp_obj_t tuple = mp_obj_new_tuple(len, items);
-            m_del(mp_obj_t, items, alloc);
+            if (tuple->len == 0) {
+                m_del_var(mp_obj_tuple_t, mp_obj_t, alloc, tuple);
+                return mp_const_empty_tuple;
+            }
+            if (tuple->len < alloc) {
+                // shrinking is done in place so can't fail
+                m_renew_maybe(byte, tuple,
+                    sizeof(mp_obj_tuple_t) + alloc * sizeof(mp_obj_t),
+                    sizeof(mp_obj_tuple_t) + tuple->len * sizeof(mp_obj_t), false);
+            }
 
-            return tuple;
+            return MP_OBJ_FROM_PTR(tuple);
         }
     }
 }
@@ -339,7 +339,8 @@ const qstr mp_unary_op_method_name[] = {
     [MP_UNARY_OP_NEGATIVE] = MP_QSTR___neg__,
     [MP_UNARY_OP_INVERT] = MP_QSTR___invert__,
     #endif
-    [MP_UNARY_OP_NOT] = MP_QSTR_, // don't need to implement this, used to make sure array has full size
+    [MP_UNARY_OP_NOT] = MP_QSTR_, // don't need to implement this
+    [MP_UNARY_OP_LEN_HINT] = MP_QSTR_, // not looked up on instances, used to make sure array has full size
 };
 
 STATIC mp_obj_t instance_unary_op(mp_uint_t op, mp_obj_t self_in) {
@@ -164,6 +164,11 @@ typedef struct _parser_t {
     #if MICROPY_COMP_CONST
     mp_map_t consts;
     #endif
+
+    #if MICROPY_COMP_STREAMING
+    mp_parse_stmt_fun_t stmt_fun;
+    void *stmt_fun_env;
+    #endif
 } parser_t;
 
 STATIC void *parser_alloc(parser_t *parser, size_t num_bytes) {
@@ -620,6 +625,14 @@ STATIC bool fold_constants(parser_t *parser, const rule_t *rule, size_t num_args
                 mp_parse_node_t pn_value = ((mp_parse_node_struct_t*)((mp_parse_node_struct_t*)pn1)->nodes[1])->nodes[0];
                 mp_obj_t value;
                 if (!mp_parse_node_get_int_maybe(pn_value, &value)) {
+                    #if MICROPY_COMP_CONST_LITERAL
+                    if (MP_PARSE_NODE_IS_STRUCT_KIND(pn_value, RULE_atom_paren)
+                        || MP_PARSE_NODE_IS_STRUCT_KIND(pn_value, RULE_atom_brace)) {
+                        // leave const(<tuple or dict>) for the compiler to build,
+                        // which it does only at module level
+                        return false;
+                    }
+                    #endif
                     mp_obj_t exc = mp_obj_new_exception_msg(&mp_type_SyntaxError,
                         "constant must be an integer");
                     mp_obj_exception_add_traceback(exc, parser->lexer->source_name,
@@ -733,7 +746,38 @@ STATIC void push_result_rule(parser_t *parser, size_t src_line, const rule_t *ru
     push_result_node(parser, (mp_parse_node_t)pn);
 }
 
-mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
+// truncate the chunk currently being filled and link it into the chain of chunks
+STATIC void parser_finish_chunk(parser_t *parser) {
+    if (parser->cur_chunk != NULL) {
+        (void)m_renew_maybe(byte, parser->cur_chunk,
+            sizeof(mp_parse_chunk_t) + parser->cur_chunk->alloc,
+            sizeof(mp_parse_chunk_t) + parser->cur_chunk->union_.used,
+            false);
+        parser->cur_chunk->alloc = parser->cur_chunk->union_.used;
+        parser->cur_chunk->union_.next = parser->tree.chunk;
+        parser->tree.chunk = parser->cur_chunk;
+        parser->cur_chunk = NULL;
+    }
+}
+
+#if MICROPY_COMP_STREAMING
+// Pass the top-level statements parsed so far, which are the given number of
+// nodes on the result stack, to the statement function, which takes ownership
+// of their parse tree.  They are replaced by a newline token, which is a leaf
+// that uses no memory and is ignored by the compiler, so the parse can carry on
+// as if nothing happened.  Because it's not a statement it also means that only
+// the very first statement of the input can be seen as a doc string.
+STATIC void parser_flush_stmts(parser_t *parser, size_t src_line, size_t num_stmts) {
+    push_result_rule(parser, src_line, rules[RULE_file_input_2], num_stmts);
+    parser->tree.root = pop_result(parser);
+    parser_finish_chunk(parser);
+    parser->stmt_fun(parser->stmt_fun_env, &parser->tree);
+    parser->tree.chunk = NULL;
+    push_result_node(parser, mp_parse_node_new_leaf(MP_PARSE_NODE_TOKEN, MP_TOKEN_NEWLINE));
+}
+#endif
+
+STATIC mp_parse_tree_t parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind, mp_parse_stmt_fun_t stmt_fun, void *stmt_fun_env) {
 
     // initialise parser and allocate memory for its stacks
 
@@ -756,6 +800,14 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     mp_map_init(&parser.consts, 0);
     #endif
 
+    #if MICROPY_COMP_STREAMING
+    parser.stmt_fun = stmt_fun;
+    parser.stmt_fun_env = stmt_fun_env;
+    #else
+    (void)stmt_fun;
+    (void)stmt_fun_env;
+    #endif
+
     // work out the top-level rule to use, and push it on the stack
     size_t top_level_rule;
     switch (input_kind) {
@@ -970,6 +1022,16 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
                         }
                     }
                 } else {
+                    #if MICROPY_COMP_STREAMING
+                    if (rule->rule_id == RULE_file_input_2 && parser.stmt_fun != NULL && i > 0
+                        && !MP_PARSE_NODE_IS_TOKEN_KIND(peek_result(&parser, 0), MP_TOKEN_NEWLINE)) {
+                        // a top-level statement was just parsed (and there are i
+                        // items in the list), so hand the items over and continue
+                        // the list with just the placeholder node
+                        parser_flush_stmts(&parser, rule_src_line, i);
+                        i = 1;
+                    }
+                    #endif
                     for (;;) {
                         size_t arg = rule->arg[i & 1 & n];
                         if ((arg & RULE_ARG_KIND_MASK) == RULE_ARG_TOK) {
@@ -1026,15 +1088,7 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     #endif
 
     // truncate final chunk and link into chain of chunks
-    if (parser.cur_chunk != NULL) {
-        (void)m_renew_maybe(byte, parser.cur_chunk,
-            sizeof(mp_parse_chunk_t) + parser.cur_chunk->alloc,
-            sizeof(mp_parse_chunk_t) + parser.cur_chunk->union_.used,
-            false);
-        parser.cur_chunk->alloc = parser.cur_chunk->union_.used;
-        parser.cur_chunk->union_.next = parser.tree.chunk;
-        parser.tree.chunk = parser.cur_chunk;
-    }
+    parser_finish_chunk(&parser);
 
     if (
         lex->tok_kind != MP_TOKEN_END // check we are at the end of the token stream
@@ -1072,6 +1126,18 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     return parser.tree;
 }
 
+mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
+    return parse(lex, input_kind, NULL, NULL);
+}
+
+#if MICROPY_COMP_STREAMING
+void mp_parse_streaming(mp_lexer_t *lex, mp_parse_stmt_fun_t stmt_fun, void *env) {
+    mp_parse_tree_t tree = parse(lex, MP_PARSE_FILE_INPUT, stmt_fun, env);
+    // pass on whatever remains (at least the placeholder)
+    stmt_fun(env, &tree);
+}
+#endif
+
 void mp_parse_tree_clear(mp_parse_tree_t *tree) {
     mp_parse_chunk_t *chunk = tree->chunk;
     while (chunk != NULL) {
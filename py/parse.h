@@ -104,4 +104,12 @@ typedef struct _mp_parse_t {
 mp_parse_tree_t mp_parse(struct _mp_lexer_t *lex, mp_parse_input_kind_t input_kind);
 void mp_parse_tree_clear(mp_parse_tree_t *tree);
 
+// parse file input, passing the parse tree of each top-level statement to the
+// given function as soon as it's complete; the function must consume the tree
+// and then clear it, so that memory for the whole tree is never needed
+typedef void (*mp_parse_stmt_fun_t)(void *env, mp_parse_tree_t *tree);
+#if MICROPY_COMP_STREAMING
+void mp_parse_streaming(struct _mp_lexer_t *lex, mp_parse_stmt_fun_t stmt_fun, void *env);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_PARSE_H
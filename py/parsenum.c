@@ -26,6 +26,7 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "py/runtime.h"
 #include "py/parsenumbase.h"
@@ -168,6 +169,279 @@ typedef enum {
     PARSE_DEC_IN_EXP,
 } parse_dec_in_t;
 
+#if MICROPY_PY_BUILTINS_FLOAT
+
+// The digits of a decimal number are accumulated in an integer mantissa,
+// and if both it and the power of 10 are exactly representable as a float
+// then a single multiply or divide gives the correctly rounded result.
+#if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
+typedef uint32_t parse_dec_mant_t;
+#define DEC_MANT_DIGITS_MAX (9)
+#define DEC_MANT_EXACT_MAX (1UL << 24)
+#define DEC_POW10_MAX (38)
+#define DEC_POW10_MIN (-55) // below this any mantissa rounds to zero
+#define DEC_BIN_MANT_BITS (24)
+#define DEC_BIN_EXP_MIN (-149)
+#define DEC_BIN_EXP_MAX (104) // a mantissa of 1 << 24 with this is infinity
+#define DEC_BIG_WORDS (8)
+#else
+typedef uint64_t parse_dec_mant_t;
+#define DEC_MANT_DIGITS_MAX (19)
+#define DEC_MANT_EXACT_MAX (1ULL << 53)
+#define DEC_POW10_MAX (308)
+#define DEC_POW10_MIN (-343)
+#define DEC_BIN_MANT_BITS (53)
+#define DEC_BIN_EXP_MIN (-1074)
+#define DEC_BIN_EXP_MAX (971)
+#define DEC_BIG_WORDS (36)
+#endif
+
+// Exponents beyond this over/underflow for any mantissa
+#define DEC_EXP_MAX (100000)
+
+STATIC const mp_float_t dec_pow10_exact[] = {
+    MICROPY_FLOAT_CONST(1e0), MICROPY_FLOAT_CONST(1e1), MICROPY_FLOAT_CONST(1e2),
+    MICROPY_FLOAT_CONST(1e3), MICROPY_FLOAT_CONST(1e4), MICROPY_FLOAT_CONST(1e5),
+    MICROPY_FLOAT_CONST(1e6), MICROPY_FLOAT_CONST(1e7), MICROPY_FLOAT_CONST(1e8),
+    MICROPY_FLOAT_CONST(1e9), MICROPY_FLOAT_CONST(1e10),
+    #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    #endif
+};
+
+#if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+// Returns a * b, with the rounding error (a * b - result) stored in *err.
+// Uses Dekker's algorithm, splitting each number into two 26-bit halves.
+STATIC double dec_mul_exact(double a, double b, double *err) {
+    double p = a * b;
+    double t = 134217729.0 * a;
+    double ah = t - (t - a);
+    double al = a - ah;
+    t = 134217729.0 * b;
+    double bh = t - (t - b);
+    double bl = b - bh;
+    *err = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    return p;
+}
+
+// Scale a mantissa that doesn't fit in a double by an exact power of 10,
+// keeping the intermediate results to about twice double precision so that
+// the result is rounded only once.
+STATIC double dec_scale_wide(parse_dec_mant_t mant, mp_int_t exp_val) {
+    // mant == hi + lo exactly
+    double hi = (double)mant;
+    double lo = (double)(int64_t)(mant - (uint64_t)hi);
+    double err;
+    if (exp_val < 0) {
+        double p = dec_pow10_exact[-exp_val];
+        double q = hi / p;
+        // the remainder hi - q * p is exact
+        double qp = dec_mul_exact(q, p, &err);
+        return q + (((hi - qp) - err) + lo) / p;
+    } else {
+        double p = dec_pow10_exact[exp_val];
+        double r = dec_mul_exact(hi, p, &err);
+        return r + (err + lo * p);
+    }
+}
+#endif
+
+#if MICROPY_FLOAT_PARSE_EXACT
+
+// An unsigned integer with the least significant word first, big enough for
+// the numbers compared by dec_cmp_half.
+typedef struct _dec_big_t {
+    size_t len;
+    uint32_t d[DEC_BIG_WORDS];
+} dec_big_t;
+
+STATIC void dec_big_set(dec_big_t *a, uint64_t v) {
+    a->len = 0;
+    for (; v != 0; v >>= 32) {
+        a->d[a->len++] = (uint32_t)v;
+    }
+}
+
+STATIC void dec_big_mul(dec_big_t *a, uint32_t m) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a->len; i++) {
+        carry += (uint64_t)a->d[i] * m;
+        a->d[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    if (carry != 0) {
+        a->d[a->len++] = (uint32_t)carry;
+    }
+}
+
+// Set r = a * m
+STATIC void dec_big_mul64(dec_big_t *r, const dec_big_t *a, uint64_t m) {
+    uint32_t m0 = (uint32_t)m;
+    uint32_t m1 = (uint32_t)(m >> 32);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a->len; i++) {
+        carry += (uint64_t)a->d[i] * m0;
+        r->d[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    r->d[a->len] = (uint32_t)carry;
+    r->len = a->len + 1;
+    if (m1 != 0) {
+        // add a * m1 one word up, which can't overflow the 64-bit sum
+        carry = 0;
+        for (size_t i = 0; i < a->len; i++) {
+            carry += (uint64_t)a->d[i] * m1 + r->d[i + 1];
+            r->d[i + 1] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        r->d[a->len + 1] = (uint32_t)carry;
+        r->len = a->len + 2;
+    }
+    while (r->len > 0 && r->d[r->len - 1] == 0) {
+        r->len--;
+    }
+}
+
+STATIC void dec_big_mul_pow5(dec_big_t *a, mp_int_t n) {
+    // 5^13 is the largest power of 5 that fits in 32 bits
+    for (; n >= 13; n -= 13) {
+        dec_big_mul(a, 1220703125);
+    }
+    uint32_t m = 1;
+    for (; n > 0; n--) {
+        m *= 5;
+    }
+    dec_big_mul(a, m);
+}
+
+STATIC void dec_big_shl(dec_big_t *a, mp_int_t n) {
+    if (a->len == 0) {
+        return;
+    }
+    size_t words = n / 32;
+    unsigned int bits = n % 32;
+    if (bits != 0) {
+        a->d[a->len] = 0;
+        for (size_t i = a->len; i > 0; i--) {
+            a->d[i] |= a->d[i - 1] >> (32 - bits);
+            a->d[i - 1] <<= bits;
+        }
+        a->len += a->d[a->len] != 0;
+    }
+    if (words != 0) {
+        memmove(a->d + words, a->d, a->len * sizeof(uint32_t));
+        memset(a->d, 0, words * sizeof(uint32_t));
+        a->len += words;
+    }
+}
+
+STATIC int dec_big_cmp(const dec_big_t *a, const dec_big_t *b) {
+    if (a->len != b->len) {
+        return a->len < b->len ? -1 : 1;
+    }
+    for (size_t i = a->len; i > 0; i--) {
+        if (a->d[i - 1] != b->d[i - 1]) {
+            return a->d[i - 1] < b->d[i - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// Compare the decimal mant * 10^exp10 with half * 2^exp2.  10^exp10 is
+// 5^exp10 * 2^exp10, so with both sides scaled by 5^-exp10 if it is negative,
+// only powers of 2 are left.  The power of 5 is done once by the caller:
+// scaled is mant * 5^exp10 if exp10 >= 0, otherwise 5^-exp10.  If digits were
+// dropped from the end of the mantissa then the decimal is a little larger.
+STATIC int dec_cmp_half(const dec_big_t *scaled, parse_dec_mant_t mant, mp_int_t exp10, bool dropped, parse_dec_mant_t half, mp_int_t exp2) {
+    dec_big_t a, b;
+    if (exp10 >= 0) {
+        a = *scaled;
+        dec_big_set(&b, half);
+    } else {
+        dec_big_set(&a, mant);
+        dec_big_mul64(&b, scaled, half);
+    }
+    if (exp10 >= exp2) {
+        dec_big_shl(&a, exp10 - exp2);
+    } else {
+        dec_big_shl(&b, exp2 - exp10);
+    }
+    int cmp = dec_big_cmp(&a, &b);
+    if (cmp == 0 && dropped) {
+        cmp = 1;
+    }
+    return cmp;
+}
+
+// Given an approximation to mant * 10^exp10 that is off by at most a few
+// units in the last place, return the correctly rounded float.  The result
+// is stepped towards the decimal until the decimal lies between the halfway
+// points to its neighbours, with ties going to an even mantissa.
+STATIC mp_float_t dec_round_exact(parse_dec_mant_t mant, mp_int_t exp10, bool dropped, mp_float_t approx) {
+    const parse_dec_mant_t bin_mant_min = (parse_dec_mant_t)1 << (DEC_BIN_MANT_BITS - 1);
+    const parse_dec_mant_t bin_mant_top = (parse_dec_mant_t)1 << DEC_BIN_MANT_BITS;
+    parse_dec_mant_t m;
+    int e;
+    if (isinf(approx)) {
+        m = bin_mant_top;
+        e = DEC_BIN_EXP_MAX;
+    } else if (approx == 0) {
+        m = 0;
+        e = DEC_BIN_EXP_MIN;
+    } else {
+        mp_float_t f = MICROPY_FLOAT_C_FUN(frexp)(approx, &e);
+        m = (parse_dec_mant_t)MICROPY_FLOAT_C_FUN(ldexp)(f, DEC_BIN_MANT_BITS);
+        e -= DEC_BIN_MANT_BITS;
+        if (e < DEC_BIN_EXP_MIN) {
+            // subnormal, the low bits are zero
+            m >>= DEC_BIN_EXP_MIN - e;
+            e = DEC_BIN_EXP_MIN;
+        }
+    }
+
+    dec_big_t scaled;
+    dec_big_set(&scaled, exp10 >= 0 ? mant : 1);
+    dec_big_mul_pow5(&scaled, exp10 >= 0 ? exp10 : -exp10);
+
+    for (;;) {
+        // m == bin_mant_top is infinity, with nothing above it
+        if (m < bin_mant_top) {
+            int cmp = dec_cmp_half(&scaled, mant, exp10, dropped, 2 * m + 1, e - 1);
+            if (cmp > 0 || (cmp == 0 && (m & 1))) {
+                if (++m == bin_mant_top && e < DEC_BIN_EXP_MAX) {
+                    m >>= 1;
+                    ++e;
+                }
+                continue;
+            }
+        }
+        if (m == 0) {
+            break;
+        }
+        // the gap below a power of 2 is half the size of the one above
+        int cmp;
+        if (m == bin_mant_min && e > DEC_BIN_EXP_MIN) {
+            cmp = dec_cmp_half(&scaled, mant, exp10, dropped, 4 * m - 1, e - 2);
+        } else {
+            cmp = dec_cmp_half(&scaled, mant, exp10, dropped, 2 * m - 1, e - 1);
+        }
+        if (cmp < 0 || (cmp == 0 && (m & 1))) {
+            if (--m < bin_mant_min && e > DEC_BIN_EXP_MIN) {
+                m = 2 * m + 1;
+                --e;
+            }
+            continue;
+        }
+        break;
+    }
+
+    return MICROPY_FLOAT_C_FUN(ldexp)((mp_float_t)m, e);
+}
+
+#endif // MICROPY_FLOAT_PARSE_EXACT
+
+#endif
+
 mp_obj_t mp_parse_num_decimal(const char *str, size_t len, bool allow_imag, bool force_complex, mp_lexer_t *lex) {
 #if MICROPY_PY_BUILTINS_FLOAT
     const char *top = str + len;
@@ -214,20 +488,35 @@ mp_obj_t mp_parse_num_decimal(const char *str, size_t len, bool allow_imag, bool
         // string should be a decimal number
         parse_dec_in_t in = PARSE_DEC_IN_INTG;
         bool exp_neg = false;
-        mp_float_t frac_mult = 0.1;
+        parse_dec_mant_t dec_mant = 0;
+        size_t dec_digits = 0;
+        #if MICROPY_FLOAT_PARSE_EXACT
+        bool dec_dropped = false;
+        #endif
+        mp_int_t exp_extra = 0;
         mp_int_t exp_val = 0;
         while (str < top) {
             mp_uint_t dig = *str++;
             if ('0' <= dig && dig <= '9') {
                 dig -= '0';
                 if (in == PARSE_DEC_IN_EXP) {
-                    exp_val = 10 * exp_val + dig;
+                    if (exp_val < DEC_EXP_MAX) {
+                        exp_val = 10 * exp_val + dig;
+                    }
                 } else {
-                    if (in == PARSE_DEC_IN_FRAC) {
-                        dec_val += dig * frac_mult;
-                        frac_mult *= MICROPY_FLOAT_CONST(0.1);
+                    if (dec_digits < DEC_MANT_DIGITS_MAX) {
+                        dec_mant = 10 * dec_mant + dig;
+                        // leading zeros are not significant
+                        dec_digits += dec_mant != 0;
                     } else {
-                        dec_val = 10 * dec_val + dig;
+                        // mantissa is full, drop the digit but keep its weight
+                        exp_extra += 1;
+                        #if MICROPY_FLOAT_PARSE_EXACT
+                        dec_dropped |= dig != 0;
+                        #endif
+                    }
+                    if (in == PARSE_DEC_IN_FRAC) {
+                        exp_extra -= 1;
                     }
                 }
             } else if (in == PARSE_DEC_IN_INTG && dig == '.') {
@@ -259,9 +548,63 @@ mp_obj_t mp_parse_num_decimal(const char *str, size_t len, bool allow_imag, bool
         if (exp_neg) {
             exp_val = -exp_val;
         }
+        exp_val += exp_extra;
+
+        if (dec_mant != 0) {
+            // remove trailing zeros so the mantissa is more likely to be exact
+            while (dec_mant % 10 == 0) {
+                dec_mant /= 10;
+                exp_val += 1;
+            }
+            // move any excess power of 10 into the mantissa while it stays exact
+            while (exp_val >= (mp_int_t)MP_ARRAY_SIZE(dec_pow10_exact) && dec_mant <= DEC_MANT_EXACT_MAX / 10) {
+                dec_mant *= 10;
+                exp_val -= 1;
+            }
+        }
 
         // apply the exponent
-        dec_val *= MICROPY_FLOAT_C_FUN(pow)(10, exp_val);
+        dec_val = (mp_float_t)dec_mant;
+        if (dec_mant == 0) {
+            // zero with any exponent is zero
+        } else if (dec_mant <= DEC_MANT_EXACT_MAX
+            && -(mp_int_t)MP_ARRAY_SIZE(dec_pow10_exact) < exp_val
+            && exp_val < (mp_int_t)MP_ARRAY_SIZE(dec_pow10_exact)) {
+            // fast path, the result is exact
+            if (exp_val < 0) {
+                dec_val /= dec_pow10_exact[-exp_val];
+            } else {
+                dec_val *= dec_pow10_exact[exp_val];
+            }
+        } else {
+            #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+            if (-(mp_int_t)MP_ARRAY_SIZE(dec_pow10_exact) < exp_val
+                && exp_val < (mp_int_t)MP_ARRAY_SIZE(dec_pow10_exact)) {
+                // 16 to 19 digit mantissa, as produced by repr
+                dec_val = dec_scale_wide(dec_mant, exp_val);
+            } else
+            #endif
+            if (exp_val < 0) {
+                // divide by a positive power of 10 because it is more accurate
+                // than multiplying by a negative one, in two steps if needed to
+                // get down to subnormal numbers
+                mp_int_t exp_div = -exp_val;
+                if (exp_div > DEC_POW10_MAX) {
+                    dec_val /= MICROPY_FLOAT_C_FUN(pow)(10, DEC_POW10_MAX);
+                    exp_div -= DEC_POW10_MAX;
+                }
+                dec_val /= MICROPY_FLOAT_C_FUN(pow)(10, exp_div);
+            } else {
+                dec_val *= MICROPY_FLOAT_C_FUN(pow)(10, exp_val);
+            }
+            #if MICROPY_FLOAT_PARSE_EXACT
+            // the above may be off by a unit in the last place, so round it
+            // properly, unless it is certain to be zero or infinity
+            if (DEC_POW10_MIN <= exp_val && exp_val <= DEC_POW10_MAX) {
+                dec_val = dec_round_exact(dec_mant, exp_val, dec_dropped, dec_val);
+            }
+            #endif
+        }
     }
 
     // negate value if needed
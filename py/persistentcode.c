@@ -33,13 +33,14 @@
 #include "py/emitglue.h"
 #include "py/persistentcode.h"
 #include "py/bc.h"
+#include "py/objtuple.h"
 
 #if MICROPY_PERSISTENT_CODE_LOAD || MICROPY_PERSISTENT_CODE_SAVE
 
 #include "py/smallint.h"
 
 // The current version of .mpy files
-#define MPY_VERSION (2)
+#define MPY_VERSION (3)
 
 // The feature flags byte encodes the compile-time config options that
 // affect the generate bytecode.
@@ -136,6 +137,29 @@ STATIC mp_obj_t load_obj(mp_reader_t *reader) {
     byte obj_type = read_byte(reader);
     if (obj_type == 'e') {
         return MP_OBJ_FROM_PTR(&mp_const_ellipsis_obj);
+    } else if (obj_type == 'N') {
+        return mp_const_none;
+    } else if (obj_type == 'F') {
+        return mp_const_false;
+    } else if (obj_type == 'T') {
+        return mp_const_true;
+    } else if (obj_type == 'q') {
+        return MP_OBJ_NEW_QSTR(load_qstr(reader));
+    } else if (obj_type == 't') {
+        size_t len = read_uint(reader);
+        mp_obj_tuple_t *tuple = MP_OBJ_TO_PTR(mp_obj_new_tuple(len, NULL));
+        for (size_t i = 0; i < len; ++i) {
+            tuple->items[i] = load_obj(reader);
+        }
+        return MP_OBJ_FROM_PTR(tuple);
+    } else if (obj_type == 'd') {
+        // a constant dict, which is read-only
+        size_t len = read_uint(reader);
+        mp_obj_t *table = m_new(mp_obj_t, 2 * len);
+        for (size_t i = 0; i < 2 * len; ++i) {
+            table[i] = load_obj(reader);
+        }
+        return mp_obj_new_dict_fixed(len, table);
     } else {
         size_t len = read_uint(reader);
         vstr_t vstr;
@@ -165,11 +189,53 @@ STATIC void load_bytecode_qstrs(mp_reader_t *reader, byte *ip, byte *ip_top) {
     }
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+
+// A reader over a writable buffer that holds the whole .mpy file, from which
+// bytecode can be used in place rather than being copied to the heap.
+typedef struct _mp_reader_mapped_t {
+    byte *cur;
+    byte *end;
+    mp_obj_t owner;
+} mp_reader_mapped_t;
+
+STATIC mp_uint_t mp_reader_mapped_readbyte(void *data) {
+    mp_reader_mapped_t *reader = (mp_reader_mapped_t*)data;
+    if (reader->cur < reader->end) {
+        return *reader->cur++;
+    } else {
+        return MP_READER_EOF;
+    }
+}
+
+STATIC void mp_reader_mapped_close(void *data) {
+    (void)data;
+}
+
+#endif
+
+STATIC byte *load_bytecode(mp_reader_t *reader, size_t len) {
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    if (reader->readbyte == mp_reader_mapped_readbyte) {
+        // link the bytecode where it is, qstrs are written into the buffer
+        mp_reader_mapped_t *rm = (mp_reader_mapped_t*)reader->data;
+        if ((size_t)(rm->end - rm->cur) < len) {
+            mp_raise_ValueError("incompatible .mpy file");
+        }
+        byte *bytecode = rm->cur;
+        rm->cur += len;
+        return bytecode;
+    }
+    #endif
+    byte *bytecode = m_new(byte, len);
+    read_bytes(reader, bytecode, len);
+    return bytecode;
+}
+
 STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
     // load bytecode
     size_t bc_len = read_uint(reader);
-    byte *bytecode = m_new(byte, bc_len);
-    read_bytes(reader, bytecode, bc_len);
+    byte *bytecode = load_bytecode(reader, bc_len);
 
     // extract prelude
     const byte *ip = bytecode;
@@ -187,7 +253,21 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader) {
     // load constant table
     size_t n_obj = read_uint(reader);
     size_t n_raw_code = read_uint(reader);
-    mp_uint_t *const_table = m_new(mp_uint_t, prelude.n_pos_args + prelude.n_kwonly_args + n_obj + n_raw_code);
+    size_t n_const = prelude.n_pos_args + prelude.n_kwonly_args + n_obj + n_raw_code;
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    // bytecode used in place refers to the owner of its buffer from an extra
+    // slot at the end of the table, which keeps the buffer alive with the code
+    mp_obj_t owner = MP_OBJ_NULL;
+    if (reader->readbyte == mp_reader_mapped_readbyte) {
+        owner = ((mp_reader_mapped_t*)reader->data)->owner;
+    }
+    mp_uint_t *const_table = m_new(mp_uint_t, n_const + (owner != MP_OBJ_NULL));
+    if (owner != MP_OBJ_NULL) {
+        const_table[n_const] = (mp_uint_t)owner;
+    }
+    #else
+    mp_uint_t *const_table = m_new(mp_uint_t, n_const);
+    #endif
     mp_uint_t *ct = const_table;
     for (size_t i = 0; i < prelude.n_pos_args + prelude.n_kwonly_args; ++i) {
         *ct++ = (mp_uint_t)MP_OBJ_NEW_QSTR(load_qstr(reader));
@@ -229,10 +309,99 @@ mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len) {
     return mp_raw_code_load(&reader);
 }
 
-mp_raw_code_t *mp_raw_code_load_file(const char *filename) {
+#if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+
+// The buffer must stay valid, and not be modified, for as long as the loaded
+// code may run.  The bytecode is linked in place so the buffer is written to.
+// If owner is not MP_OBJ_NULL then the loaded code refers to it, so that it can
+// free the buffer from a finaliser once the code is no longer reachable.
+mp_raw_code_t *mp_raw_code_load_mapped(byte *buf, size_t len, mp_obj_t owner) {
+    mp_reader_mapped_t rm = {buf, buf + len, owner};
+    mp_reader_t reader = {&rm, mp_reader_mapped_readbyte, mp_reader_mapped_close};
+    return mp_raw_code_load(&reader);
+}
+
+// A mapped file that is unmapped when it is freed by the GC, or explicitly
+typedef struct _mp_obj_mapped_file_t {
+    mp_obj_base_t base;
+    byte *buf;
+    size_t len;
+} mp_obj_mapped_file_t;
+
+STATIC mp_obj_t mapped_file_del(mp_obj_t self_in) {
+    mp_obj_mapped_file_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->buf != NULL) {
+        mp_reader_unmap_file(self->buf, self->len);
+        self->buf = NULL;
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mapped_file_del_obj, mapped_file_del);
+
+STATIC const mp_rom_map_elem_t mapped_file_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&mapped_file_del_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(mapped_file_locals_dict, mapped_file_locals_dict_table);
+
+STATIC const mp_obj_type_t mp_type_mapped_file = {
+    { &mp_type_type },
+    .name = MP_QSTR_mapped_file,
+    .locals_dict = (mp_obj_dict_t*)&mapped_file_locals_dict,
+};
+
+#endif
+
+// Load a .mpy file whose contents follow the given prefix bytes, returning
+// NULL if the file doesn't start with the prefix.
+STATIC mp_raw_code_t *load_file(const char *filename, const byte *prefix, size_t prefix_len) {
+    #if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+    size_t len;
+    byte *buf = mp_reader_map_file(filename, &len);
+    if (buf != NULL) {
+        mp_obj_mapped_file_t *file = m_new_obj_with_finaliser(mp_obj_mapped_file_t);
+        file->base.type = &mp_type_mapped_file;
+        file->buf = buf;
+        file->len = len;
+        if (len < prefix_len || (prefix_len > 0 && memcmp(buf, prefix, prefix_len) != 0)) {
+            mapped_file_del(MP_OBJ_FROM_PTR(file));
+            return NULL;
+        }
+        // on success the mapping is kept until the code is no longer reachable
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            mp_raw_code_t *rc = mp_raw_code_load_mapped(buf + prefix_len, len - prefix_len, MP_OBJ_FROM_PTR(file));
+            nlr_pop();
+            return rc;
+        } else {
+            mapped_file_del(MP_OBJ_FROM_PTR(file));
+            nlr_jump(nlr.ret_val);
+        }
+    }
+    #endif
     mp_reader_t reader;
     mp_reader_new_file(&reader, filename);
-    return mp_raw_code_load(&reader);
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_raw_code_t *rc = NULL;
+        size_t i = 0;
+        while (i < prefix_len && read_byte(&reader) == prefix[i]) {
+            ++i;
+        }
+        if (i == prefix_len) {
+            rc = mp_raw_code_load(&reader);
+        } else {
+            reader.close(reader.data);
+        }
+        nlr_pop();
+        return rc;
+    } else {
+        reader.close(reader.data);
+        nlr_jump(nlr.ret_val);
+    }
+}
+
+mp_raw_code_t *mp_raw_code_load_file(const char *filename) {
+    return load_file(filename, NULL, 0);
 }
 
 #endif // MICROPY_PERSISTENT_CODE_LOAD
@@ -265,7 +434,34 @@ STATIC void save_qstr(mp_print_t *print, qstr qst) {
 }
 
 STATIC void save_obj(mp_print_t *print, mp_obj_t o) {
-    if (MP_OBJ_IS_STR_OR_BYTES(o)) {
+    if (MP_OBJ_IS_QSTR(o)) {
+        // interned strings only appear within constant tuples and dicts
+        byte obj_type = 'q';
+        mp_print_bytes(print, &obj_type, 1);
+        save_qstr(print, MP_OBJ_QSTR_VALUE(o));
+    } else if (o == mp_const_none || o == mp_const_false || o == mp_const_true) {
+        byte obj_type = o == mp_const_none ? 'N' : o == mp_const_false ? 'F' : 'T';
+        mp_print_bytes(print, &obj_type, 1);
+    } else if (MP_OBJ_IS_TYPE(o, &mp_type_tuple)) {
+        mp_obj_tuple_t *tuple = MP_OBJ_TO_PTR(o);
+        byte obj_type = 't';
+        mp_print_bytes(print, &obj_type, 1);
+        mp_print_uint(print, tuple->len);
+        for (size_t i = 0; i < tuple->len; ++i) {
+            save_obj(print, tuple->items[i]);
+        }
+    } else if (MP_OBJ_IS_TYPE(o, &mp_type_dict)) {
+        mp_map_t *map = mp_obj_dict_get_map(o);
+        byte obj_type = 'd';
+        mp_print_bytes(print, &obj_type, 1);
+        mp_print_uint(print, map->used);
+        for (size_t i = 0; i < map->alloc; ++i) {
+            if (MP_MAP_SLOT_IS_FILLED(map, i)) {
+                save_obj(print, map->table[i].key);
+                save_obj(print, map->table[i].value);
+            }
+        }
+    } else if (MP_OBJ_IS_STR_OR_BYTES(o)) {
         byte obj_type;
         if (MP_OBJ_IS_STR(o)) {
             obj_type = 's';
@@ -284,7 +480,7 @@ STATIC void save_obj(mp_print_t *print, mp_obj_t o) {
         // we save numbers using a simplistic text representation
         // TODO could be improved
         byte obj_type;
-        if (MP_OBJ_IS_TYPE(o, &mp_type_int)) {
+        if (MP_OBJ_IS_INT(o)) {
             obj_type = 'i';
         #if MICROPY_PY_BUILTINS_COMPLEX
         } else if (MP_OBJ_IS_TYPE(o, &mp_type_complex)) {
@@ -371,11 +567,13 @@ void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print) {
     save_raw_code(print, rc);
 }
 
-// here we define mp_raw_code_save_file depending on the port
+// here we define how to write and stat files depending on the port
 // TODO abstract this away properly
 
 #if defined(__i386__) || defined(__x86_64__) || (defined(__arm__) && (defined(__unix__)))
 
+#include <errno.h>
+#include <stdio.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -386,15 +584,218 @@ STATIC void fd_print_strn(void *env, const char *str, size_t len) {
     (void)ret;
 }
 
-void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename) {
+STATIC void file_open_print(mp_print_t *print, const char *filename) {
     int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-    mp_print_t fd_print = {(void*)(intptr_t)fd, fd_print_strn};
-    mp_raw_code_save(rc, &fd_print);
-    close(fd);
+    if (fd < 0) {
+        mp_raise_OSError(errno);
+    }
+    print->data = (void*)(intptr_t)fd;
+    print->print_strn = fd_print_strn;
+}
+
+STATIC void file_close_print(mp_print_t *print) {
+    close((intptr_t)print->data);
+}
+
+#if MICROPY_PERSISTENT_CODE_CACHE
+STATIC bool file_stat(const char *filename, size_t *size) {
+    struct stat st;
+    if (stat(filename, &st) != 0) {
+        return false;
+    }
+    *size = st.st_size;
+    return true;
+}
+
+STATIC void file_rename(const char *old_filename, const char *new_filename) {
+    if (rename(old_filename, new_filename) != 0) {
+        mp_raise_OSError(errno);
+    }
+}
+#endif
+
+#elif MICROPY_VFS
+
+#include "py/stream.h"
+#include "extmod/vfs.h"
+
+STATIC void file_open_print(mp_print_t *print, const char *filename) {
+    mp_obj_t args[2] = {
+        mp_obj_new_str(filename, strlen(filename), false),
+        MP_OBJ_NEW_QSTR(MP_QSTR_wb),
+    };
+    mp_obj_t file = mp_vfs_open(MP_ARRAY_SIZE(args), &args[0], (mp_map_t*)&mp_const_empty_map);
+    print->data = MP_OBJ_TO_PTR(file);
+    print->print_strn = mp_stream_write_adaptor;
+}
+
+STATIC void file_close_print(mp_print_t *print) {
+    mp_stream_close(MP_OBJ_FROM_PTR(print->data));
+}
+
+#if MICROPY_PERSISTENT_CODE_CACHE
+STATIC bool file_stat(const char *filename, size_t *size) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_t st = mp_vfs_stat(mp_obj_new_str(filename, strlen(filename), false));
+        mp_obj_t *items;
+        mp_obj_get_array_fixed_n(st, 10, &items);
+        *size = mp_obj_get_int(items[6]);
+        nlr_pop();
+        return true;
+    } else {
+        return false;
+    }
 }
 
+STATIC void file_rename(const char *old_filename, const char *new_filename) {
+    mp_vfs_rename(mp_obj_new_str(old_filename, strlen(old_filename), false),
+        mp_obj_new_str(new_filename, strlen(new_filename), false));
+}
+#endif
+
 #else
 #error mp_raw_code_save_file not implemented for this platform
 #endif
 
+void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename) {
+    mp_print_t file_print;
+    file_open_print(&file_print, filename);
+    mp_raw_code_save(rc, &file_print);
+    file_close_print(&file_print);
+}
+
 #endif // MICROPY_PERSISTENT_CODE_SAVE
+
+#if MICROPY_PERSISTENT_CODE_CACHE
+
+#include "py/compile.h"
+
+// A cache file holds a header followed by the .mpy data of the compiled source.
+// The header records the size and CRC-32 of the source and the optimisation
+// level it was compiled with, along with the length of the .mpy data so that a
+// partially written cache file is never used.  A CRC is used rather than the
+// mtime because an edit may keep the size and mtime (which may only have a
+// resolution of seconds, or come from an unset clock).
+#define CACHE_HEADER_LEN (14)
+
+STATIC uint32_t file_crc32(const char *filename) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    mp_reader_t reader;
+    mp_reader_new_file(&reader, filename);
+    uint32_t crc = 0xffffffff;
+    for (mp_uint_t c; (c = reader.readbyte(reader.data)) != MP_READER_EOF;) {
+        crc ^= c;
+        crc = table[crc & 0xf] ^ (crc >> 4);
+        crc = table[crc & 0xf] ^ (crc >> 4);
+    }
+    reader.close(reader.data);
+    return crc ^ 0xffffffff;
+}
+
+STATIC void make_cache_header(byte *header, size_t src_size, uint32_t src_crc, size_t mpy_len) {
+    const uint32_t fields[3] = {src_size, src_crc, mpy_len};
+    header[0] = 'C';
+    header[1] = MP_STATE_VM(mp_optimise_value);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            header[2 + 4 * i + j] = fields[i] >> (8 * j);
+        }
+    }
+}
+
+mp_raw_code_t *mp_raw_code_load_py_cached(const char *filename) {
+    // the cache file for "mod.py" is "mod.mpc"
+    size_t len = strlen(filename);
+    vstr_t cache_filename;
+    vstr_init(&cache_filename, len + 2);
+    vstr_add_strn(&cache_filename, filename, len - 2);
+    vstr_add_str(&cache_filename, "mpc");
+    const char *cache_str = vstr_null_terminated_str(&cache_filename);
+
+    // the CRC of the source is taken before it's compiled, so that changes to
+    // it made while it's being compiled invalidate the cache file
+    size_t src_size, cache_size;
+    uint32_t src_crc = 0;
+    bool can_cache = file_stat(filename, &src_size);
+    if (can_cache) {
+        src_crc = file_crc32(filename);
+    }
+    byte header[CACHE_HEADER_LEN];
+
+    if (can_cache && file_stat(cache_str, &cache_size) && cache_size > CACHE_HEADER_LEN) {
+        make_cache_header(header, src_size, src_crc, cache_size - CACHE_HEADER_LEN);
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            mp_raw_code_t *rc = load_file(cache_str, header, CACHE_HEADER_LEN);
+            nlr_pop();
+            if (rc != NULL) {
+                vstr_clear(&cache_filename);
+                return rc;
+            }
+        } else {
+            // the cache file is invalid, eg it was made by an incompatible
+            // version of the runtime, so it will be replaced
+        }
+    }
+
+    // compile the source
+    mp_lexer_t *lex = mp_lexer_new_from_file(filename);
+    #if MICROPY_COMP_STREAMING
+    mp_raw_code_t *rc = mp_compile_stream_to_raw_code(lex);
+    #else
+    qstr source_name = lex->source_name;
+    mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+    mp_raw_code_t *rc = mp_compile_to_raw_code(&parse_tree, source_name, MP_EMIT_OPT_NONE, false);
+    #endif
+
+    // try to write a new cache file; the .mpy data is built first because its
+    // length goes in the header, and also so that code which can't be saved
+    // (eg native code) doesn't leave a file behind
+    if (can_cache) {
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            vstr_t mpy;
+            mp_print_t mpy_print;
+            vstr_init_print(&mpy, 256, &mpy_print);
+            mp_raw_code_save(rc, &mpy_print);
+            make_cache_header(header, src_size, src_crc, mpy.len);
+
+            // the old cache file may still be mapped and executing (eg it was
+            // loaded before the source changed), so it must not be modified;
+            // instead the new one is written alongside and renamed over it
+            vstr_t tmp_filename;
+            vstr_init(&tmp_filename, cache_filename.len + 5);
+            vstr_add_strn(&tmp_filename, cache_filename.buf, cache_filename.len);
+            vstr_add_str(&tmp_filename, ".tmp");
+            const char *tmp_str = vstr_null_terminated_str(&tmp_filename);
+            mp_print_t file_print;
+            file_open_print(&file_print, tmp_str);
+            nlr_buf_t nlr_write;
+            if (nlr_push(&nlr_write) == 0) {
+                mp_print_bytes(&file_print, header, CACHE_HEADER_LEN);
+                mp_print_bytes(&file_print, (const byte*)mpy.buf, mpy.len);
+                nlr_pop();
+            } else {
+                file_close_print(&file_print);
+                nlr_jump(nlr_write.ret_val);
+            }
+            file_close_print(&file_print);
+            file_rename(tmp_str, cache_str);
+            vstr_clear(&tmp_filename);
+            vstr_clear(&mpy);
+            nlr_pop();
+        } else {
+            // the cache file can't be written, eg the filesystem is read-only,
+            // which is not an error
+        }
+    }
+
+    vstr_clear(&cache_filename);
+    return rc;
+}
+
+#endif // MICROPY_PERSISTENT_CODE_CACHE
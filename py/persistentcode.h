@@ -32,9 +32,13 @@
 
 mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader);
 mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len);
+mp_raw_code_t *mp_raw_code_load_mapped(byte *buf, size_t len, mp_obj_t owner);
 mp_raw_code_t *mp_raw_code_load_file(const char *filename);
 
 void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print);
 void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename);
 
+// load a .py file as raw code, using and updating its cached bytecode
+mp_raw_code_t *mp_raw_code_load_py_cached(const char *filename);
+
 #endif // MICROPY_INCLUDED_PY_PERSISTENTCODE_H
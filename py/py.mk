@@ -94,6 +94,11 @@ btree/bt_utils.c \
 mpool/mpool.c \
 	)
 CFLAGS_MOD += -DMICROPY_PY_BTREE=1
+ifeq ($(MICROPY_PY_BTREE_STATS),1)
+# page cache counters, for the btree stats() method
+BTREE_DEFS += -DSTATISTICS=1
+CFLAGS_MOD += -DMICROPY_PY_BTREE_STATS=1
+endif
 # we need to suppress certain warnings to get berkeley-db to compile cleanly
 # and we have separate BTREE_DEFS so the definitions don't interfere with other source code
 $(BUILD)/$(BTREE_DIR)/%.o: CFLAGS += -Wno-old-style-definition -Wno-sign-compare -Wno-unused-parameter $(BTREE_DEFS)
@@ -217,6 +222,7 @@ PY_O_BASENAME = \
 	../extmod/moduzlib.o \
 	../extmod/moduheapq.o \
 	../extmod/modutimeq.o \
+	../extmod/modueventloop.o \
 	../extmod/moduhashlib.o \
 	../extmod/modubinascii.o \
 	../extmod/virtpin.o \
@@ -233,6 +239,7 @@ PY_O_BASENAME = \
 	../extmod/modwebsocket.o \
 	../extmod/modwebrepl.o \
 	../extmod/modframebuf.o \
+	../extmod/modkvlog.o \
 	../extmod/vfs.o \
 	../extmod/vfs_reader.o \
 	../extmod/vfs_native.o \
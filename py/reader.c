@@ -132,4 +132,34 @@ void mp_reader_new_file(mp_reader_t *reader, const char *filename) {
     mp_reader_new_file_from_fd(reader, fd, true);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_MAPPED
+
+#include <sys/mman.h>
+
+byte *mp_reader_map_file(const char *filename, size_t *len) {
+    int fd = open(filename, O_RDONLY, 0644);
+    if (fd < 0) {
+        mp_raise_OSError(errno);
+    }
+    struct stat st;
+    void *buf = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        // a private mapping so that writes (eg linking qstrs) are not written
+        // back to the file; only the pages that are written to get copied
+        buf = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (buf == MAP_FAILED) {
+        return NULL;
+    }
+    *len = st.st_size;
+    return buf;
+}
+
+void mp_reader_unmap_file(byte *buf, size_t len) {
+    munmap(buf, len);
+}
+
+#endif
+
 #endif
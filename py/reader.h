@@ -43,4 +43,9 @@ void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t
 void mp_reader_new_file(mp_reader_t *reader, const char *filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
+// map a file into memory as a writable, private (copy-on-write) buffer;
+// returns NULL if the file can't be mapped
+byte *mp_reader_map_file(const char *filename, size_t *len);
+void mp_reader_unmap_file(byte *buf, size_t len);
+
 #endif // MICROPY_INCLUDED_PY_READER_H
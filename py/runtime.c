@@ -89,6 +89,10 @@ void mp_init(void) {
     // optimization disabled by default
     MP_STATE_VM(mp_optimise_value) = 0;
 
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    MP_STATE_VM(persistent_code_cache) = true;
+    #endif
+
     // init global module dict
     mp_obj_dict_init(&MP_STATE_VM(mp_loaded_modules_dict), 3);
 
@@ -105,6 +109,17 @@ void mp_init(void) {
     MP_STATE_VM(mp_module_builtins_override_dict) = NULL;
     #endif
 
+    #if MICROPY_OPT_STR_FORMAT_CACHE
+    // start with no cached str.format and % templates
+    memset(MP_STATE_VM(str_format_cache), 0, sizeof(MP_STATE_VM(str_format_cache)));
+    memset(MP_STATE_VM(str_modulo_cache), 0, sizeof(MP_STATE_VM(str_modulo_cache)));
+    #endif
+
+    #if MICROPY_PY_URE && MICROPY_PY_URE_CACHE
+    // start with no cached regexes
+    memset(MP_STATE_VM(ure_cache), 0, sizeof(MP_STATE_VM(ure_cache)));
+    #endif
+
     #if MICROPY_FSUSERMOUNT
     // zero out the pointers to the user-mounted devices
     memset(MP_STATE_VM(fs_user_mount), 0, sizeof(MP_STATE_VM(fs_user_mount)));
@@ -1380,9 +1395,17 @@ mp_obj_t mp_parse_compile_execute(mp_lexer_t *lex, mp_parse_input_kind_t parse_i
 
     nlr_buf_t nlr;
     if (nlr_push(&nlr) == 0) {
-        qstr source_name = lex->source_name;
-        mp_parse_tree_t parse_tree = mp_parse(lex, parse_input_kind);
-        mp_obj_t module_fun = mp_compile(&parse_tree, source_name, MP_EMIT_OPT_NONE, false);
+        mp_obj_t module_fun;
+        #if MICROPY_COMP_STREAMING
+        if (parse_input_kind == MP_PARSE_FILE_INPUT) {
+            module_fun = mp_make_function_from_raw_code(mp_compile_stream_to_raw_code(lex), MP_OBJ_NULL, MP_OBJ_NULL);
+        } else
+        #endif
+        {
+            qstr source_name = lex->source_name;
+            mp_parse_tree_t parse_tree = mp_parse(lex, parse_input_kind);
+            module_fun = mp_compile(&parse_tree, source_name, MP_EMIT_OPT_NONE, false);
+        }
 
         mp_obj_t ret;
         if (MICROPY_PY_BUILTINS_COMPILE && globals == NULL) {
@@ -50,6 +50,9 @@ typedef enum {
     MP_UNARY_OP_NEGATIVE,
     MP_UNARY_OP_INVERT,
     MP_UNARY_OP_NOT,
+    // not emitted by the compiler: number of items an iterator is likely to
+    // yield, passed directly to the unary_op slot by mp_obj_len_hint
+    MP_UNARY_OP_LEN_HINT,
 } mp_unary_op_t;
 
 typedef enum {
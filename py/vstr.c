@@ -106,7 +106,9 @@ STATIC bool vstr_ensure_extra(vstr_t *vstr, size_t size) {
         if (vstr->fixed_buf) {
             return false;
         }
-        size_t new_alloc = ROUND_ALLOC((vstr->len + size) + 16);
+        // grow geometrically (by half again) so that building a string with
+        // many small appends takes amortised linear time
+        size_t new_alloc = ROUND_ALLOC((vstr->len + size) + (vstr->len >> 1) + 16);
         char *new_buf = m_renew(char, vstr->buf, vstr->alloc, new_alloc);
         vstr->alloc = new_alloc;
         vstr->buf = new_buf;
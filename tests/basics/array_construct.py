@@ -18,3 +18,11 @@ print(array('i', bytearray(4)))
 # convert from other arrays
 print(array('H', array('b', [1, 2])))
 print(array('b', array('I', [1, 2])))
+
+# from iterators, with and without a length hint
+a = array('h', range(10))
+print(array('b', iter(a)), array('i', map(lambda x: x * 2, a)))
+it = iter(a)
+next(it)
+print(list(it), tuple(iter(a)))
+print(array('I', range(0)), array('H', (x for x in range(3))))
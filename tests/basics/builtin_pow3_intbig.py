@@ -20,3 +20,14 @@ print(hex(pow(2, x-1, x))) # Should be 1, since x is prime
 print(hex(pow(y, x-1, x))) # Should be 1, since x is prime
 print(hex(pow(y, y-1, x))) # Should be a 'big value'
 print(hex(pow(y, y-1, y))) # Should be a 'big value'
+
+# negative and reduced bases, even and single-digit moduli
+z = 0xd9d2a1b8e4ff8e06cee42e1c8e8d5f6f1ef1ee77da0ea3bbc0d4d5a1f6f1c5d2b1e2a9f8b7c6d5e4f3a2b1c0d9e8f7a6b5c4d3e2f1a0
+print(hex(pow(-y, x - 1, x)))
+print(hex(pow(y + 5 * x, z, x)))
+print(hex(pow(y, z, x + 1)))
+print(hex(pow(y, z, 1000003)))
+print(hex(pow(x, z, 2 ** 127 - 1)))
+print(hex(pow(y, 65537, z)))
+print(pow(y, z, 1))
+print(pow(x, 1, y))
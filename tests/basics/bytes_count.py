@@ -46,3 +46,6 @@ def t():
     return True
 
 print(b"0000".count(b'0', t()))
+
+# counting must not skip over bytes that look like UTF-8 continuation bytes
+print(b"\xc3\xa9\xa9".count(b"\xa9"))
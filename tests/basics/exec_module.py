@@ -0,0 +1,44 @@
+# test exec of code with many top-level statements, which may be compiled one
+# statement at a time
+
+src = """
+x = 1.5
+"not a doc string"
+def f(a, b=2.5):
+    return (a, b, x, "f")
+class C:
+    y = (1, 2, 3)
+    def m(self):
+        return f(self.y)
+for i in range(2):
+    print(i, f(i))
+try:
+    raise ValueError("v")
+except ValueError as e:
+    print("caught", e)
+print(C().m(), [j * 0.5 for j in range(3)], (lambda: 7)())
+def g():
+    for i, v in enumerate("ab"):
+        print(i, v)
+g()
+enumerate = lambda s: [(9, c) for c in s]
+g()
+"""
+d = {}
+exec(src, d)
+print(sorted(k for k in d if not k.startswith("__")))
+
+# many constants and functions
+src = "".join("c%d = %d.5\ndef f%d():\n    return c%d + %d.25\n" % (i, i, i, i, i) for i in range(200))
+d = {}
+exec(src, d)
+print(sum(d["f%d" % i]() for i in range(200)))
+
+# errors in later statements are still reported
+for src in ("x = 1\ny = 2\nz = 1 / 0\n", "x = 1\n\n\ny = (\n", "x = 1\ny = 2\nreturn\n"):
+    try:
+        exec(src)
+    except ZeroDivisionError:
+        print("ZeroDivisionError")
+    except SyntaxError:
+        print("SyntaxError")
@@ -0,0 +1,101 @@
+# test for+enumerate and for+zip, mostly to check optimisation of these pairs
+
+def f(seq):
+    for i, x in enumerate(seq):
+        print(i, x)
+
+    # start, continue, break and else
+    for i, x in enumerate(seq, 5):
+        if i == 6:
+            continue
+        print(i, x)
+        if x == 'c':
+            break
+    else:
+        print('else')
+    for i, x in enumerate([], -1):
+        print('never')
+    else:
+        print('else', i, x)
+
+    for a, b in zip(seq, range(2)):
+        print(a, b)
+    else:
+        print('else')
+    for a, b in zip(range(5), seq):
+        print(a, b)
+        if a == 1:
+            break
+    else:
+        print('else')
+
+    # the first value is not bound when the second iterator is exhausted
+    for a, b in zip([1, 2, 3], [4, 5]):
+        pass
+    print(a, b)
+
+    # nested loops
+    for i, x in enumerate(seq):
+        for a, b in zip(seq, range(i)):
+            print(i, x, a, b)
+
+    # break through a finally
+    for i, x in enumerate(seq):
+        try:
+            if i == 1:
+                break
+        finally:
+            print('finally', i)
+    print(i, x)
+
+f(['a', 'b', 'c', 'd'])
+
+# in a generator, and return from inside the loop
+def gen(seq):
+    for i, x in enumerate(seq, -3):
+        yield i, x
+print(list(gen('abcd')))
+def ret():
+    for a, b in zip('ab', 'xyz'):
+        return a + b
+print(ret())
+
+# at module level
+for i, x in enumerate('xy'):
+    print(i, x)
+
+# non-iterable arguments
+try:
+    for i, x in enumerate(1):
+        pass
+except TypeError:
+    print('TypeError')
+try:
+    for a, b in zip([1], 1):
+        pass
+except TypeError:
+    print('TypeError')
+
+# the names can be rebound
+def myenumerate(seq, start=0):
+    print('myenumerate')
+    return [(9, x) for x in seq]
+def g():
+    for i, x in enumerate('ab'):
+        print(i, x)
+def h(zip):
+    for a, b in zip:
+        print(a, b)
+def outer():
+    enumerate = myenumerate
+    def inner():
+        for i, x in enumerate('ab'):
+            print(i, x)
+    inner()
+g()
+h([(1, 2)])
+outer()
+enumerate = myenumerate
+g()
+del enumerate
+g()
@@ -0,0 +1,25 @@
+# test division of large ints
+
+def show(x):
+    h = hex(x)
+    print(len(h), h[:40], h[-40:])
+
+def check(a, b):
+    q, r = divmod(a, b)
+    show(q)
+    show(r)
+    print(q * b + r == a, q == a // b, r == a % b)
+
+for bits in (100, 1000, 5000, 20000):
+    a = 3 ** (bits * 100 // 79) + 12345
+    for b in (7, 1 << 31, (1 << 32) - 1, 10 ** 9, 7 ** (bits * 100 // 281) - 67890, (1 << bits) - 1, (1 << bits) + 1):
+        check(a, b)
+        check(-a, b)
+        check(a, -b)
+
+# values where the quotient estimate needs correcting
+for k in (16, 32, 48, 64, 96, 128):
+    b = (1 << k) - 1
+    check((1 << (3 * k)) - 1, b)
+    check(b << (2 * k), (1 << (k - 1)) + 1)
+    check((1 << (4 * k)) - (1 << (2 * k)), (1 << (2 * k)) - (1 << k) + 1)
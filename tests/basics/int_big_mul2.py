@@ -0,0 +1,29 @@
+# test multiplication of large ints, including sizes that use Karatsuba
+
+def show(x):
+    h = hex(x)
+    print(len(h), h[:40], h[-40:])
+
+def check(a, b):
+    c = a * b
+    show(c)
+    print(c == b * a, (a + b) * (a + b) - (a - b) * (a - b) == 4 * c)
+
+for bits in (1000, 1024, 2000, 2047, 5000, 10000, 30000):
+    a = 3 ** (bits * 100 // 158) + 12345
+    b = 7 ** (bits * 100 // 281) - 67890
+    check(a, b)
+    check(a, a)
+    check(-a, b)
+    check(a, -a)
+
+    # all-ones values have long runs of carries
+    m = (1 << bits) - 1
+    check(m, m)
+    check(m, m + 2)
+
+# unbalanced operands
+a = 5 ** 20000 + 1
+for b in (3, 1 << 100, 3 ** 600, 3 ** 2000, (1 << 5000) - 1, 7 ** 10000):
+    check(a, b)
+    check(b, -a)
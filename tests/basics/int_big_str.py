@@ -0,0 +1,24 @@
+# test conversion of large ints to and from strings
+
+x = 3 ** 2000 + 12345
+for base in (2, 8, 10, 16):
+    s = ('{:b}', '{:o}', '{:d}', '{:x}')[(2, 8, 10, 16).index(base)].format(x)
+    print(len(s), s[:30], s[-30:], int(s, base) == x)
+
+# other bases only round trip through int()
+for base in (3, 7, 12, 31, 36):
+    s = ''
+    n = x
+    while n:
+        s = '0123456789abcdefghijklmnopqrstuvwxyz'[n % base] + s
+        n //= base
+    print(base, len(s), int(s, base) == x, int(s.upper(), base) == x)
+
+# numbers of every length around a chunk boundary
+for e in range(1, 45):
+    n = 10 ** e
+    print(n - 1, n, -(n + 1), hex(n - 1))
+
+# comma separators
+for e in range(15, 31):
+    print('{:,}'.format(10 ** e + 1), '{:,}'.format(-(10 ** e - 1)))
@@ -0,0 +1,51 @@
+# test construction from iterators that give a length hint, and list growth/shrinking
+
+# range iterators, including partially consumed ones
+for r in (range(0), range(5), range(2, 11, 3), range(10, 0, -3), range(5, 0)):
+    print(list(r), tuple(r), list(iter(r)), tuple(iter(r)))
+it = iter(range(10))
+next(it)
+next(it)
+print(list(it), list(it))
+it = iter(range(10, -10, -7))
+next(it)
+print(tuple(it))
+
+# map over sized and unsized iterables, stopping at the shortest
+def gen(n):
+    for i in range(n):
+        yield i
+print(list(map(lambda x: x + 1, [1, 2, 3])))
+print(tuple(map(lambda x, y: x * y, [1, 2, 3], 'abcd')))
+print(list(map(lambda x, y: x + y, range(10), gen(3))))
+print(tuple(map(lambda a, b, c, d, e: a + b + c + d + e, *([range(4)] * 5))))
+print(bytes(map(lambda x: x, range(5))), bytearray(map(lambda x: x, range(5))))
+m = map(lambda x: x, [1, 2, 3, 4])
+next(m)
+print(list(m))
+
+# extend with iterators
+l = [1]
+l.extend(range(3))
+l.extend(map(str, range(2)))
+l.extend(gen(2))
+l += (7, 8)
+print(l)
+
+# growing and shrinking
+l = list(range(100))
+while len(l) > 3:
+    l.pop()
+print(l)
+l = list(range(100))
+del l[5:]
+print(l)
+l = list(range(100))
+l[2:] = [1]
+print(l)
+l[1:1] = list(range(10))
+print(l)
+for i in range(20):
+    l.append(i)
+    l.pop(0)
+print(l)
@@ -0,0 +1,28 @@
+# test that length hints too large to allocate don't overflow
+
+import sys
+try:
+    if sys.maxsize < 2**62:
+        raise AttributeError
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+def test(f):
+    try:
+        f()
+    except MemoryError:
+        print("MemoryError")
+
+test(lambda: tuple(range(2**61)))
+test(lambda: tuple(range(2**62 - 1)))
+test(lambda: list(range(2**62 - 1)))
+test(lambda: [1, 2].extend(range(2**62 - 1)))
+
+try:
+    import array
+except ImportError:
+    pass
+else:
+    test(lambda: array.array('q', range(2**61)))
+    test(lambda: array.array('i', range(2**62 - 1)))
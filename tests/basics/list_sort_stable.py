@@ -0,0 +1,93 @@
+# test that list.sort is stable and handles runs in the input
+
+# pseudo-random data without depending on the random module
+def lcg(n, m):
+    x = 1
+    out = []
+    for _ in range(n):
+        x = (x * 1103515245 + 12345) & 0x7fffffff
+        out.append((x >> 8) % m)
+    return out
+
+def check(l, **kw):
+    p = [(v, i) for i, v in enumerate(l)]
+    p.sort(key=lambda t: t[0], **kw)
+    rev = kw.get('reverse', False)
+    for a, b in zip(p, p[1:]):
+        if (a[0] > b[0] if not rev else a[0] < b[0]) or (a[0] == b[0] and a[1] > b[1]):
+            return False
+    return True
+
+# random data with many equal keys, sized to exercise merging
+for n in (10, 64, 65, 300, 2000):
+    l = lcg(n, 7)
+    print(n, check(l), check(l, reverse=True))
+
+# ascending, descending and mixed runs
+l = list(range(500))
+print(check(l), check(l, reverse=True))
+l = list(range(500, 0, -1))
+print(check(l), check(l, reverse=True))
+l = []
+for i in range(20):
+    r = range(i * 7, i * 7 + 40)
+    l.extend(r if i % 2 else reversed(r))
+print(check(l), check(l, reverse=True), sorted(l) == sorted(l, reverse=True)[::-1])
+
+# key function is called exactly once per element
+calls = [0]
+def key(x):
+    calls[0] += 1
+    return -x
+l = lcg(1000, 1000)
+l.sort(key=key)
+print(calls[0], all(a >= b for a, b in zip(l, l[1:])))
+
+# an exception from a comparison leaves every element in the list
+class E:
+    def __init__(self, x):
+        self.x = x
+    def __lt__(self, other):
+        if self.x == 13 or other.x == 13:
+            raise ValueError('bad')
+        return self.x < other.x
+l = [E(x) for x in lcg(300, 300)] + [E(13)] + [E(x) for x in lcg(50, 300)]
+before = sorted(e.x for e in l)
+try:
+    l.sort()
+except ValueError as e:
+    print('ValueError', e)
+print(sorted(e.x for e in l) == before)
+
+# an exception from the key function leaves the list unchanged
+l = lcg(20, 10)
+copy = l[:]
+bad = l[10]
+def bad_key(x):
+    if x == bad:
+        raise TypeError
+    return x
+try:
+    l.sort(key=bad_key)
+except TypeError:
+    print('TypeError')
+print(l == copy)
+
+# comparisons that change the list don't touch the items being sorted, and
+# the sort raises ValueError once the items are back in place
+class A:
+    def __init__(self, x):
+        self.x = x
+    def __lt__(self, other):
+        lens.append(len(l))
+        if len(lens) % 50 == 0:
+            l.extend(range(100))
+        return self.x < other.x
+lens = []
+l = [A(x) for x in lcg(200, 1000)]
+before = sorted(a.x for a in l)
+try:
+    l.sort()
+except ValueError:
+    print('ValueError')
+print(max(lens), len(l), sorted(a.x for a in l) == before)
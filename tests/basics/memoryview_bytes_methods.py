@@ -0,0 +1,42 @@
+# test bytes-like methods of memoryview (a MicroPython extension)
+try:
+    memoryview(b'').find
+except:
+    print("SKIP")
+    raise SystemExit
+
+buf = bytearray(b"GET /index.html HTTP/1.1\r\nHost: example.com\r\n\r\nbody")
+m = memoryview(buf)
+
+# searching
+print(m.find(b"\r\n\r\n"), m.rfind(b"\r\n"), m.find(b"zz"), m.rfind(b"zz"))
+print(m.find(b"H", 10), m.find(b"H", 10, 20), m.rfind(b"H", 0, -10), m.find(b"x", 3, 1))
+print(m.count(b"\r\n"), m.count(b"e"), m.count(b"e", 30), m.count(b""), m[:0].count(b""))
+print(b"Host" in m, b"Hostx" in m, bytearray(b"/index") in m[4:])
+
+# prefix and suffix
+print(m.startswith(b"GET"), m.startswith(b"Host", 26), m.startswith(b"GET", 1))
+print(m.endswith(b"body"), m.endswith(b"x"), m.endswith(b"GET", 0, 3))
+
+# splitting returns views into the same buffer
+line = m[:m.find(b"\r\n")]
+parts = line.split()
+print(type(parts[0]).__name__, [bytes(p) for p in parts])
+print([bytes(p) for p in m.split(b"\r\n")])
+print([bytes(p) for p in m.split(b"\r\n", 1)])
+print([bytes(p) for p in memoryview(b"  a b  c ").split(None, 1)])
+parts[0][0] = ord("P")
+print(buf[:4])
+
+# decoding
+print(parts[1].decode(), m[4:15].decode("utf-8"))
+
+# errors
+try:
+    m.split(b"")
+except ValueError:
+    print("ValueError")
+try:
+    m.find(1)
+except TypeError:
+    print("TypeError")
@@ -0,0 +1,27 @@
+# test searching in long strings, which can use a different algorithm
+
+s = "abcd" * 100 + "xyzzy" + "abcd" * 50 + "xyzzy" + "abcdab"
+print(s.find("xyzzy"), s.rfind("xyzzy"))
+print(s.find("abcdx"), s.rfind("abcdx"))
+print(s.find("dabcdab"), s.rfind("dabcdab"))
+print(s.find("zzyabc", 405), s.rfind("zzyabc", 0, 500))
+print(s.find("abcdabce"), s.rfind("abcdabce"))
+print(s.count("xyzzy"), s.count("abcdabcd"), s.count("dabc", 10, 300))
+print(s.index("yabcd"), s.rindex("yabcd"))
+print([len(x) for x in s.split("xyzzy")])
+print([len(x) for x in s.rsplit("xyzzy", 1)])
+print(len(s.replace("abcd", "")), len(s.replace("xyzzy", "!", 1)))
+print("zzyab" in s, "zzyac" in s)
+
+# needle longer than the shift table
+n = "".join(chr(65 + i % 26) for i in range(300))
+s = "ABC" * 200 + n + "XYZ" * 200
+print(s.find(n), s.rfind(n), s.count(n), s.find(n[1:] + "!"))
+
+# bytes and bytearray share the same search code
+b = b"\x00\x01" * 100 + b"\xff\xfe\x00" + b"\x00\x01" * 100
+print(b.find(b"\xfe\x00\x00\x01"), b.rfind(b"\x01\x00\x01\x00"), b.count(b"\x00\x01\x00\x01"))
+print(b"\xfe\x00\x00\x01" in bytearray(b), b"\xfe\x01" in bytearray(b))
+
+# start past end
+print("abcabc".find("bc", 5, 1), "abcabc".rfind("a", 4, 2), "abc".count("a", 2, 1))
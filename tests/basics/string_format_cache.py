@@ -0,0 +1,83 @@
+# test str.format with the same format string used repeatedly, and with
+# many different format strings, so any caching of parsed formats is exercised
+
+fmts = [
+    "{}",
+    "{} {}",
+    "a{}b{}c",
+    "{0}{1}{0}",
+    "{x}-{y}",
+    "{!r}",
+    "{:>6}|{:<6}|{:^6}",
+    "{:08.3f}",
+    "{:+d} {:x} {:#o} {:b}",
+    "{{}} {} {{",
+    "{:*^11s}",
+    "{0!r:>10}",
+    "{:,}",
+    "",
+    "no fields",
+]
+args = (1.5, "ab", -3, True)
+for n in range(3):
+    for fmt in fmts:
+        try:
+            print(repr(fmt.format(*args, x=1, y="2")))
+        except (ValueError, IndexError, KeyError, TypeError) as er:
+            print(fmt, type(er).__name__)
+
+# same format string with different argument types
+for a in (1, -2, 3.25, "s", None, (1, 2)):
+    for i in range(2):
+        print("[{:>8}]".format(str(a)), "[{}]".format(a), "[{!r}]".format(a))
+
+# errors must still be raised for a previously successful format string
+for args in ((1, 2), (1,), ()):
+    try:
+        print("{} {}".format(*args))
+    except IndexError:
+        print("IndexError")
+for kw in ({"a": 1}, {}):
+    try:
+        print("{a}".format(**kw))
+    except KeyError:
+        print("KeyError")
+
+# invalid format strings, tried more than once
+for i in range(2):
+    for fmt in ("{", "}", "{0}{}", "{}{0}", "{!x}", "{:w}", "{:d}"):
+        try:
+            fmt.format("x")
+        except (ValueError, IndexError) as er:
+            print(fmt, type(er).__name__)
+
+# nested format_specs
+for w in (3, 5, 7):
+    print("[{:>{}}]".format("x", w), "[{:{}.{}f}]".format(3.14159, w, 2))
+
+# an empty format_spec is the same as none, whichever way it's given
+for a in (1.0, 0.25, -0.0, True, "s"):
+    print("{:}".format(a), "{:{}}".format(a, ""), ("%s{:}" % "").format(a), "{!r:{}}".format(a, ""))
+
+# % formatting with long literal runs
+print("literal text %d literal %s literal text %% end" % (42, "str"))
+print("%s" % "only", "no format" % (), "%%")
+
+# % templates are reused, and give the same errors as the uncached path
+for i in range(2):
+    print("%(a)s-%(b)5d|" % {"a": "A", "b": i}, "%*d|%-*.*s|" % (4, i, 6, 2, "xyz"))
+    print("%c%c %#o %#X %+d % d %05d" % ("a", 98, 8, 255, i, i, -i))
+    for args in ((), (1, 2), ("s",), 1):
+        try:
+            print("%d" % args)
+        except TypeError:
+            print("TypeError")
+    try:
+        print("%(a)s" % (1,))
+    except TypeError:
+        print("TypeError")
+    for f in ("%", "%q", "%5"):
+        try:
+            print(f % (1,))
+        except ValueError:
+            print("ValueError")
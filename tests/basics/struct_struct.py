@@ -0,0 +1,67 @@
+# test ustruct.Struct and iter_unpack
+
+try:
+    import ustruct as struct
+except:
+    try:
+        import struct
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+try:
+    struct.Struct
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+s = struct.Struct("<hHbB3sI")
+print(s.format, s.size)
+data = s.pack(-2, 65000, -3, 250, b"ab", 0x12345678)
+print(data)
+print(s.unpack(data))
+print(s.unpack_from(b"xx" + data, 2))
+print(s.unpack_from(b"xx" + data, -s.size))
+
+buf = bytearray(s.size + 4)
+s.pack_into(buf, 4, 1, 2, 3, 4, b"xyzw", 5)
+print(buf)
+s.pack_into(buf, -s.size, 6, 7, 8, 9, b"", 10)
+print(buf)
+
+# big endian and repeat counts
+s = struct.Struct(">2H3b")
+print(s.size, s.pack(1, 2, -1, -2, -3), s.unpack(b"\x00\x01\x00\x02\xff\xfe\xfd"))
+
+# native alignment is included in the size
+s = struct.Struct("bi")
+print(s.size == struct.calcsize("bi"))
+
+# reuse of a Struct object
+s = struct.Struct("<HH")
+for i in range(3):
+    print(s.unpack(s.pack(i, i * 1000)))
+
+# iter_unpack
+s = struct.Struct("<hb")
+for t in s.iter_unpack(b"\x01\x00\x02\x03\x00\x04\xff\xff\xfb"):
+    print(t)
+print(list(struct.iter_unpack("<H", b"\x01\x00\x02\x00")))
+print(list(struct.iter_unpack("<H", b"")))
+
+# errors (CPython raises struct.error, MicroPython raises ValueError)
+try:
+    struct.Struct("<H").unpack(b"\x00")
+except Exception:
+    print("Exception")
+try:
+    struct.Struct("<H").unpack_from(b"\x00\x00", 1)
+except Exception:
+    print("Exception")
+try:
+    struct.Struct("<H").pack_into(bytearray(3), 2, 1)
+except Exception:
+    print("Exception")
+try:
+    list(struct.iter_unpack("<H", b"\x00\x00\x00"))
+except Exception:
+    print("Exception")
@@ -0,0 +1,12 @@
+# Array operation
+# Type: bytearray, inplace operation using array.add. Same work as
+# arrayop-3, done by a single call into C.
+import bench
+import array
+
+def test(num):
+    for i in iter(range(num//10000)):
+        arr = bytearray(b"\0" * 1000)
+        array.add(arr, 1)
+
+bench.run(test)
@@ -0,0 +1,20 @@
+# Array operation
+# Type: array('h') of samples, offset removal, sum and dot product using
+# for loops.
+import bench
+import array
+
+def test(num):
+    samples = array.array('h', range(-500, 500))
+    for i in iter(range(num//10000)):
+        arr = array.array('h', samples)
+        for i in range(len(arr)):
+            arr[i] -= 12
+        s = 0
+        for v in arr:
+            s += v
+        d = 0
+        for i in range(len(arr)):
+            d += arr[i] * samples[i]
+
+bench.run(test)
@@ -0,0 +1,15 @@
+# Array operation
+# Type: array('h') of samples, offset removal, sum and dot product using
+# the bulk operations in the array module. Same work as arrayop-6.
+import bench
+import array
+
+def test(num):
+    samples = array.array('h', range(-500, 500))
+    for i in iter(range(num//10000)):
+        arr = array.array('h', samples)
+        array.add(arr, -12)
+        s = array.asum(arr)
+        d = array.dot(arr, samples)
+
+bench.run(test)
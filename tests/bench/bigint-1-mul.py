@@ -0,0 +1,11 @@
+# Big integer arithmetic
+# Type: multiplication of two ~20000-bit integers.
+import bench
+
+def test(num):
+    a = 3 ** 12600 + 12345
+    b = 7 ** 7100 + 67890
+    for i in iter(range(num // 10000)):
+        c = a * b
+
+bench.run(test)
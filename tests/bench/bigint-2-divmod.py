@@ -0,0 +1,11 @@
+# Big integer arithmetic
+# Type: divmod of a ~40000-bit integer by a ~20000-bit integer.
+import bench
+
+def test(num):
+    a = 3 ** 25200 + 12345
+    b = 7 ** 7100 + 67890
+    for i in iter(range(num // 20000)):
+        q, r = divmod(a, b)
+
+bench.run(test)
@@ -0,0 +1,13 @@
+# Big integer arithmetic
+# Type: conversion of a ~6000-digit integer to and from decimal and hex strings.
+import bench
+
+def test(num):
+    a = 3 ** 12600 + 12345
+    for i in iter(range(num // 1000000)):
+        s = str(a)
+        b = int(s)
+        h = hex(b)
+        c = int(h, 16)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# Big integer arithmetic
+# Type: 3-argument pow with a 1024-bit odd modulus, as used in RSA.
+import bench
+
+def test(num):
+    m = 7 ** 365 + 2
+    e = 5 ** 440 + 1
+    x = 3 ** 600
+    for i in iter(range(num // 200000)):
+        y = pow(x, e, m)
+
+bench.run(test)
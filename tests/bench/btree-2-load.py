@@ -0,0 +1,12 @@
+# Building a database of sensor readings
+# Type: btree, storing 100k entries with db.load() in key order
+import bench
+import btree
+import uio
+
+def test(num):
+    db = btree.open(uio.BytesIO(), pagesize=1024, cachesize=32768)
+    db.load((b"%08d" % i, b"temp=21.5 rh=40") for i in iter(range(num // 200)))
+    db.close()
+
+bench.run(test)
@@ -0,0 +1,16 @@
+# Scanning a database of sensor readings
+# Type: btree, iterating over items() of 100k entries, allocating each key and value
+import bench
+import btree
+import uio
+
+def test(num):
+    db = btree.open(uio.BytesIO(), pagesize=1024, cachesize=32768)
+    db.load((b"%08d" % i, b"temp=21.5 rh=40") for i in iter(range(num // 200)))
+    n = 0
+    for k, v in db.items():
+        n += len(v)
+    assert n == num // 200 * 15
+    db.close()
+
+bench.run(test)
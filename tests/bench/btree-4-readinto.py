@@ -0,0 +1,22 @@
+# Scanning a database of sensor readings
+# Type: btree, iterating over 100k entries with readinto() into reused buffers
+import bench
+import btree
+import uio
+
+def test(num):
+    db = btree.open(uio.BytesIO(), pagesize=1024, cachesize=32768)
+    db.load((b"%08d" % i, b"temp=21.5 rh=40") for i in iter(range(num // 200)))
+    k = bytearray(8)
+    v = bytearray(16)
+    n = 0
+    db.items()
+    while True:
+        r = db.readinto(k, v)
+        if r is None:
+            break
+        n += r[1]
+    assert n == num // 200 * 15
+    db.close()
+
+bench.run(test)
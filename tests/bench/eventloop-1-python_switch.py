@@ -0,0 +1,22 @@
+# Switching between coroutines
+# Type: pure Python loop over a list, in the style of uasyncio.core
+import bench
+
+def task(n):
+    for i in range(n):
+        yield
+
+def run(runq):
+    while runq:
+        t = runq.pop(0)
+        try:
+            next(t)
+        except StopIteration:
+            continue
+        runq.append(t)
+
+def test(num):
+    n = num // 200
+    run([task(n // 10) for i in range(10)])
+
+bench.run(test)
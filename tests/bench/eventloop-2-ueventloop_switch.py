@@ -0,0 +1,17 @@
+# Switching between coroutines
+# Type: ueventloop.EventLoop run queue in C
+import bench
+import ueventloop
+
+def task(n):
+    for i in range(n):
+        yield
+
+def test(num):
+    n = num // 200
+    loop = ueventloop.EventLoop()
+    for i in range(10):
+        loop.create_task(task(n // 10))
+    loop.run_forever()
+
+bench.run(test)
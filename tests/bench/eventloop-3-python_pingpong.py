@@ -0,0 +1,57 @@
+# Waking coroutines on socket events
+# Type: pure Python loop with uselect.poll, UDP ping-pong
+import bench
+import usocket as socket
+import uselect as select
+
+def bound_socket(port):
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    while True:
+        addr = socket.getaddrinfo("127.0.0.1", port)[0][-1]
+        try:
+            s.bind(addr)
+            return s, addr, port
+        except OSError:
+            port += 1
+
+class IORead:
+    def __init__(self, obj):
+        self.obj = obj
+
+def run(runq):
+    poller = select.poll()
+    objmap = {}
+    while runq or objmap:
+        for i in range(len(runq)):
+            t = runq.pop(0)
+            try:
+                ret = next(t)
+            except StopIteration:
+                continue
+            if isinstance(ret, IORead):
+                objmap[id(ret.obj)] = t
+                poller.register(ret.obj, select.POLLIN)
+            else:
+                runq.append(t)
+        if objmap:
+            for obj, ev in poller.ipoll(0 if runq else -1, 1):
+                runq.append(objmap.pop(id(obj)))
+
+def pingpong(s, peer, n, first):
+    for i in range(n):
+        if first:
+            s.sendto(b"x", peer)
+        yield IORead(s)
+        s.recv(1)
+        if not first:
+            s.sendto(b"x", peer)
+
+def test(num):
+    a, addr_a, port = bound_socket(47123)
+    b, addr_b, port = bound_socket(port + 1)
+    n = num // 2000
+    run([pingpong(a, addr_b, n, True), pingpong(b, addr_a, n, False)])
+    a.close()
+    b.close()
+
+bench.run(test)
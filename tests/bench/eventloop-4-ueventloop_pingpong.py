@@ -0,0 +1,38 @@
+# Waking coroutines on socket events
+# Type: ueventloop.EventLoop with IORead, UDP ping-pong
+import bench
+import usocket as socket
+import ueventloop
+
+def bound_socket(port):
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    while True:
+        addr = socket.getaddrinfo("127.0.0.1", port)[0][-1]
+        try:
+            s.bind(addr)
+            return s, addr, port
+        except OSError:
+            port += 1
+
+def pingpong(s, peer, n, first):
+    for i in range(n):
+        if first:
+            s.sendto(b"x", peer)
+        yield ueventloop.IORead(s)
+        s.recv(1)
+        if not first:
+            s.sendto(b"x", peer)
+    yield ueventloop.IOReadDone(s)
+
+def test(num):
+    a, addr_a, port = bound_socket(47123)
+    b, addr_b, port = bound_socket(port + 1)
+    n = num // 2000
+    loop = ueventloop.EventLoop()
+    loop.create_task(pingpong(a, addr_b, n, True))
+    loop.create_task(pingpong(b, addr_a, n, False))
+    loop.run_forever()
+    a.close()
+    b.close()
+
+bench.run(test)
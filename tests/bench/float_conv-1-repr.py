@@ -0,0 +1,13 @@
+# Float conversion
+# Type: convert floats to strings, as when logging or dumping data.
+import bench
+
+def test(num):
+    x = 0.1
+    for i in iter(range(num//50)):
+        s = repr(x)
+        s = str(x * 1.5e-3)
+        s = str(i + 0.25)
+        x += 1.0001
+
+bench.run(test)
@@ -0,0 +1,11 @@
+# Float conversion
+# Type: parse strings to floats, as when reading logged or JSON data.
+import bench
+
+def test(num):
+    l = ["0.1", "23.456", "-1.5e-3", "1234567.875", "0.30000000000000004"]
+    for i in iter(range(num//100)):
+        for s in l:
+            float(s)
+
+bench.run(test)
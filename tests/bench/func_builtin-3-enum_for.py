@@ -0,0 +1,9 @@
+import bench
+
+def test(num):
+    l = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]
+    for _ in iter(range(num//100)):
+        for i, x in enumerate(l):
+            pass
+
+bench.run(test)
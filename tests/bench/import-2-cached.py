@@ -0,0 +1,28 @@
+# Importing a .py module
+# Type: repeated import of a generated 100-function module using the bytecode cache, so only the first import compiles the source.
+import bench
+import sys
+import uos
+import micropython
+
+MOD = "bench_import_mod"
+
+def test(num):
+    f = open(MOD + ".py", "w")
+    for i in range(100):
+        f.write("def f%d(a, b):\n    return [a + b * %d, 'str%d', (a, b)]\n" % (i, i, i))
+    f.close()
+    sys.path.insert(0, "")
+    micropython.bytecode_cache(True)
+    for i in iter(range(num // 100000)):
+        __import__(MOD)
+        del sys.modules[MOD]
+    micropython.bytecode_cache(True)
+    sys.path.pop(0)
+    uos.unlink(MOD + ".py")
+    try:
+        uos.unlink(MOD + ".mpc")
+    except OSError:
+        pass
+
+bench.run(test)
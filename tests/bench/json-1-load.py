@@ -0,0 +1,29 @@
+# Decoding a JSON document
+# Type: ujson.load() of a 17KB config-like document from a file.
+import bench
+import uos
+import ujson
+
+FILE = "bench_json.json"
+
+def make_doc():
+    doc = {"version": 3, "name": "device config", "enabled": True, "items": []}
+    for i in range(100):
+        doc["items"].append({
+            "id": i, "label": "item number %d" % i, "scale": i * 0.125,
+            "tags": ["alpha", "beta", "gamma"][:i % 4], "limits": [-i, i * 1000],
+            "notes": "line one\nline \"two\"", "active": i % 3 == 0, "parent": None,
+        })
+    return ujson.dumps(doc)
+
+def test(num):
+    f = open(FILE, "w")
+    f.write(make_doc())
+    f.close()
+    for i in iter(range(num // 200000)):
+        f = open(FILE)
+        ujson.load(f)
+        f.close()
+    uos.unlink(FILE)
+
+bench.run(test)
@@ -0,0 +1,21 @@
+# Decoding a JSON document
+# Type: ujson.loads() of a 17KB config-like document held in a str.
+import bench
+import ujson
+
+def make_doc():
+    doc = {"version": 3, "name": "device config", "enabled": True, "items": []}
+    for i in range(100):
+        doc["items"].append({
+            "id": i, "label": "item number %d" % i, "scale": i * 0.125,
+            "tags": ["alpha", "beta", "gamma"][:i % 4], "limits": [-i, i * 1000],
+            "notes": "line one\nline \"two\"", "active": i % 3 == 0, "parent": None,
+        })
+    return ujson.dumps(doc)
+
+def test(num):
+    s = make_doc()
+    for i in iter(range(num // 200000)):
+        ujson.loads(s)
+
+bench.run(test)
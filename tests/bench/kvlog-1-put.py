@@ -0,0 +1,16 @@
+# Storing settings that change often, flushing after each change
+# Type: kvlog on a file, overwriting 50 keys, so segments get compacted
+import bench
+import kvlog
+import uos
+
+def test(num):
+    f = open("kvlog-bench.db", "w+b")
+    db = kvlog.open(f, segsize=4096, segments=16)
+    for i in iter(range(num // 4000)):
+        db[b"setting%d" % (i % 50)] = b"value %d" % i
+        db.flush()
+    f.close()
+    uos.unlink("kvlog-bench.db")
+
+bench.run(test)
@@ -0,0 +1,15 @@
+# Storing settings that change often, flushing after each change
+# Type: dict of 50 keys written to a file as JSON after each change, as a reference for kvlog
+import bench
+import ujson
+import uos
+
+def test(num):
+    data = {}
+    for i in iter(range(num // 4000)):
+        data["setting%d" % (i % 50)] = "value %d" % i
+        with open("kvlog-bench.json", "w") as f:
+            ujson.dump(data, f)
+    uos.unlink("kvlog-bench.json")
+
+bench.run(test)
@@ -0,0 +1,19 @@
+# Reading settings
+# Type: kvlog on a file, looking up 50 keys
+import bench
+import kvlog
+import uos
+
+def test(num):
+    f = open("kvlog-bench.db", "w+b")
+    db = kvlog.open(f)
+    for i in range(50):
+        db[b"setting%d" % i] = b"value %d" % i
+    keys = [b"setting%d" % i for i in range(50)]
+    for i in iter(range(num // 2000)):
+        for k in keys:
+            db[k]
+    f.close()
+    uos.unlink("kvlog-bench.db")
+
+bench.run(test)
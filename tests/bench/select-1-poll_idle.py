@@ -0,0 +1,32 @@
+# Waiting for socket events
+# Type: uselect.poll() with one active UDP socket among 100 idle ones.
+import bench
+import usocket as socket
+import uselect as select
+
+def bound_socket(port):
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    while True:
+        addr = socket.getaddrinfo("127.0.0.1", port)[0][-1]
+        try:
+            s.bind(addr)
+            return s, addr, port
+        except OSError:
+            port += 1
+
+def test(num):
+    a, addr, port = bound_socket(47123)
+    b = bound_socket(port + 1)[0]
+    idle = [socket.socket(socket.AF_INET, socket.SOCK_DGRAM) for i in range(100)]
+    p = select.poll()
+    for s in idle:
+        p.register(s, select.POLLIN)
+    p.register(a, select.POLLIN)
+    for i in iter(range(num // 2000)):
+        b.sendto(b"x", addr)
+        for s, ev in p.ipoll(1000):
+            s.recv(1)
+    for s in idle + [a, b]:
+        s.close()
+
+bench.run(test)
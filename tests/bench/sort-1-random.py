@@ -0,0 +1,15 @@
+# Sorting
+# Type: list.sort of 1000 pseudo-random small ints.
+import bench
+
+def test(num):
+    x = 1
+    data = []
+    for i in range(1000):
+        x = (x * 1103515245 + 12345) & 0x3fffffff
+        data.append(x >> 10)
+    for i in iter(range(num // 100000)):
+        l = data[:]
+        l.sort()
+
+bench.run(test)
@@ -0,0 +1,11 @@
+# Sorting
+# Type: list.sort of 1000 already-sorted ints (a single run).
+import bench
+
+def test(num):
+    data = list(range(1000))
+    for i in iter(range(num // 100000)):
+        l = data[:]
+        l.sort()
+
+bench.run(test)
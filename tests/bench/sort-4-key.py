@@ -0,0 +1,16 @@
+# Sorting
+# Type: list.sort with a key function over 1000 pseudo-random ints.
+import bench
+
+def test(num):
+    x = 1
+    data = []
+    for i in range(1000):
+        x = (x * 1103515245 + 12345) & 0x3fffffff
+        data.append(x >> 10)
+    key = lambda v: v % 997
+    for i in iter(range(num // 100000)):
+        l = data[:]
+        l.sort(key=key)
+
+bench.run(test)
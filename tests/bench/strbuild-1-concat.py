@@ -0,0 +1,12 @@
+# String building
+# Type: concatenate many small pieces with +=, which copies the whole
+# string each time.
+import bench
+
+def test(num):
+    for i in iter(range(num//20000)):
+        s = ""
+        for j in range(200):
+            s += "<td>%d</td>" % j
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# String building
+# Type: collect pieces in a list and join them at the end.
+import bench
+
+def test(num):
+    for i in iter(range(num//20000)):
+        l = []
+        for j in range(200):
+            l.append("<td>%d</td>" % j)
+        s = "".join(l)
+
+bench.run(test)
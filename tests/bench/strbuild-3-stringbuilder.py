@@ -0,0 +1,14 @@
+# String building
+# Type: append pieces to a micropython.StringBuilder, which grows its buffer
+# geometrically and turns it into a str without copying.
+import bench
+from micropython import StringBuilder
+
+def test(num):
+    for i in iter(range(num//20000)):
+        sb = StringBuilder()
+        for j in range(200):
+            sb += "<td>%d</td>" % j
+        s = sb.build()
+
+bench.run(test)
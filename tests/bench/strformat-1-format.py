@@ -0,0 +1,9 @@
+# String formatting
+# Type: str.format with a constant format string and several fields.
+import bench
+
+def test(num):
+    for i in iter(range(num//20)):
+        s = "<tr><td>{}</td><td>{:>8}</td><td>{:.2f}</td></tr>".format(i, "name", 1.5)
+
+bench.run(test)
@@ -0,0 +1,9 @@
+# String formatting
+# Type: % formatting with a constant format string and several fields.
+import bench
+
+def test(num):
+    for i in iter(range(num//20)):
+        s = "<tr><td>%d</td><td>%8s</td><td>%.2f</td></tr>" % (i, "name", 1.5)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# String search
+# Type: short needle in a short (line-sized) haystack, typical of
+# splitting up log lines or HTTP headers.
+import bench
+
+def test(num):
+    s = "Content-Type: text/html; charset=utf-8"
+    for i in iter(range(num//20)):
+        s.find(": ")
+        s.find("charset")
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# String search
+# Type: needle near the end of a 4KB buffer, like locating the end of
+# headers in a socket buffer.
+import bench
+
+def test(num):
+    s = b"x-some-header: abcdefghijklmnopqrstuvwxyz\r\n" * 93 + b"\r\n\r\nbody"
+    for i in iter(range(num//2000)):
+        s.find(b"\r\n\r\n")
+        s.rfind(b"x-some-header")
+
+bench.run(test)
@@ -0,0 +1,10 @@
+# String search
+# Type: split a 1KB line-oriented buffer on a multi-character separator.
+import bench
+
+def test(num):
+    s = "key=value; " * 100
+    for i in iter(range(num//5000)):
+        s.split("; ")
+
+bench.run(test)
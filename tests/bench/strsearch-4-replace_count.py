@@ -0,0 +1,11 @@
+# String search
+# Type: count and replace a multi-character substring in a 4KB buffer.
+import bench
+
+def test(num):
+    s = "<td>0</td>" * 400
+    for i in iter(range(num//10000)):
+        s.count("</td>")
+        s.replace("</td>", "</th>")
+
+bench.run(test)
@@ -0,0 +1,13 @@
+# Struct packing and unpacking
+# Type: sensor frames decoded with the module-level ustruct functions,
+# which parse the format string on each call.
+import bench
+import ustruct
+
+def test(num):
+    frame = ustruct.pack("<HhhhIB", 1, -200, 300, -400, 123456, 7)
+    for i in iter(range(num//50)):
+        t = ustruct.unpack("<HhhhIB", frame)
+        f = ustruct.pack("<HhhhIB", t[0], t[1], t[2], t[3], t[4], t[5])
+
+bench.run(test)
@@ -0,0 +1,14 @@
+# Struct packing and unpacking
+# Type: sensor frames decoded with a precompiled ustruct.Struct. Same work
+# as struct-1.
+import bench
+import ustruct
+
+def test(num):
+    s = ustruct.Struct("<HhhhIB")
+    frame = s.pack(1, -200, 300, -400, 123456, 7)
+    for i in iter(range(num//50)):
+        t = s.unpack(frame)
+        f = s.pack(t[0], t[1], t[2], t[3], t[4], t[5])
+
+bench.run(test)
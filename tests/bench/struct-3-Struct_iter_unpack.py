@@ -0,0 +1,13 @@
+# Struct packing and unpacking
+# Type: a buffer of sensor frames decoded with ustruct.Struct.iter_unpack.
+import bench
+import ustruct
+
+def test(num):
+    s = ustruct.Struct("<HhhhIB")
+    buf = s.pack(1, -200, 300, -400, 123456, 7) * 100
+    for i in iter(range(num//5000)):
+        for t in s.iter_unpack(buf):
+            pass
+
+bench.run(test)
@@ -0,0 +1,13 @@
+# Searching a long log buffer with a regex
+# Type: compiled regex starting with a literal, search()
+import bench
+import ure
+
+def test(num):
+    log = "INFO: service started id=1234 status=ok\n" * 200 + "ERROR: disk full\n"
+    r = ure.compile("ERROR: (\\w+)")
+    for i in iter(range(num // 2000)):
+        m = r.search(log)
+    assert m.group(1) == "disk"
+
+bench.run(test)
@@ -0,0 +1,13 @@
+# Searching a long log buffer with a regex
+# Type: compiled regex starting with a character class, search()
+import bench
+import ure
+
+def test(num):
+    log = "INFO: service started at noon, status ok\n" * 200 + "INFO: took 12-34 ms\n"
+    r = ure.compile("\\d+-\\d+")
+    for i in iter(range(num // 2000)):
+        m = r.search(log)
+    assert m.group(0) == "12-34"
+
+bench.run(test)
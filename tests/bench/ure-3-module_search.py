@@ -0,0 +1,15 @@
+# Filtering log lines with a regex
+# Type: module-level ure.search() on each line, so the pattern is compiled per call without a cache
+import bench
+import ure
+
+def test(num):
+    lines = ["INFO: service started id=%d status=ok" % i for i in range(100)]
+    n = 0
+    for i in iter(range(num // 20000)):
+        for l in lines:
+            if ure.search("id=\\d*7 ", l):
+                n += 1
+    assert n == num // 20000 * 10
+
+bench.run(test)
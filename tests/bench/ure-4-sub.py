@@ -0,0 +1,13 @@
+# Rewriting a long buffer with a regex
+# Type: compiled regex, sub() with a template using groups
+import bench
+import ure
+
+def test(num):
+    log = "INFO: service started id=1234 status=ok\n" * 200
+    r = ure.compile("id=(\\d+)")
+    for i in iter(range(num // 20000)):
+        s = r.sub("<\\1>", log)
+    assert s.startswith("INFO: service started <1234> ")
+
+bench.run(test)
@@ -0,0 +1,15 @@
+# Finding all matches in a long buffer with a regex
+# Type: compiled regex, finditer()
+import bench
+import ure
+
+def test(num):
+    log = "INFO: service started id=1234 status=ok\n" * 200
+    r = ure.compile("status=(\\w+)")
+    for i in iter(range(num // 200000)):
+        n = 0
+        for m in r.finditer(log):
+            n += 1
+    assert n == 200
+
+bench.run(test)
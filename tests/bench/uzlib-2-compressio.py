@@ -0,0 +1,22 @@
+# Compressing log output
+# Type: uzlib.CompressIO writing 20KB of log-like text line by line to gzip.
+import bench
+import uzlib
+import uio
+
+def make_lines():
+    lines = []
+    for i in range(400):
+        lines.append(("%08d sensor%d temp=%d.%d rh=%d status=%s\n" % (
+            i * 1375, i % 5, 20 + i % 7, i % 10, 40 + i % 13, ("ok", "ok", "warn")[i % 3])).encode())
+    return lines
+
+def test(num):
+    lines = make_lines()
+    for i in iter(range(num // 400000)):
+        s = uzlib.CompressIO(uio.BytesIO(), 6, 16 + 10)
+        for l in lines:
+            s.write(l)
+        s.close()
+
+bench.run(test)
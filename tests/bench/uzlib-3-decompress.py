@@ -0,0 +1,18 @@
+# Decompressing data
+# Type: uzlib.decompress() of 20KB of log-like text.
+import bench
+import uzlib
+
+def make_log():
+    lines = []
+    for i in range(400):
+        lines.append("%08d sensor%d temp=%d.%d rh=%d status=%s\n" % (
+            i * 1375, i % 5, 20 + i % 7, i % 10, 40 + i % 13, ("ok", "ok", "warn")[i % 3]))
+    return "".join(lines).encode()
+
+def test(num):
+    data = uzlib.compress(make_log())
+    for i in iter(range(num // 400000)):
+        uzlib.decompress(data)
+
+bench.run(test)
@@ -0,0 +1,22 @@
+# Decompressing data
+# Type: uzlib.DecompIO reading 20KB of gzip-compressed log-like text in 512 byte chunks.
+import bench
+import uzlib
+import uio
+
+def make_log():
+    lines = []
+    for i in range(400):
+        lines.append("%08d sensor%d temp=%d.%d rh=%d status=%s\n" % (
+            i * 1375, i % 5, 20 + i % 7, i % 10, 40 + i % 13, ("ok", "ok", "warn")[i % 3]))
+    return "".join(lines).encode()
+
+def test(num):
+    data = uzlib.compress(make_log(), 6, 16 + 10)
+    buf = bytearray(512)
+    for i in iter(range(num // 400000)):
+        s = uzlib.DecompIO(uio.BytesIO(data), 16 + 10)
+        while s.readinto(buf):
+            pass
+
+bench.run(test)
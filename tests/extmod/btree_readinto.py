@@ -0,0 +1,60 @@
+# test btree bulk loading and allocation-free range scans
+
+try:
+    import btree
+    import uio
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+f = uio.BytesIO()
+db = btree.open(f, pagesize=512)
+
+db.load((b"%03d" % i, b"val%d" % i) for i in range(200))
+db.load([(b"zz", b"last"), (b"aa", b"first")])
+db.load({b"mid": b"dict"}.items())
+print(len(list(db.keys())), db[b"000"], db[b"199"], db[b"aa"], db[b"zz"], db[b"mid"])
+
+try:
+    db.load([(b"x",)])
+except ValueError:
+    print("ValueError")
+
+# scan a range
+k = bytearray(3)
+v = bytearray(8)
+db.items(b"010", b"013")
+while True:
+    r = db.readinto(k, v)
+    if r is None:
+        break
+    print(r, k, v[:r[1]])
+print(db.readinto(k, v))
+
+# keys only, descending and inclusive, with a short buffer
+k = bytearray(2)
+db.keys(b"zz", b"198", btree.DESC | btree.INCL)
+while True:
+    r = db.readinto(k)
+    if r is None:
+        break
+    print(r[0], k)
+
+# a full scan gives the same entries as items(), including long values
+k = bytearray(3)
+v = bytearray(8)
+res = []
+db.items()
+while True:
+    r = db.readinto(k, v)
+    if r is None:
+        break
+    res.append((bytes(k[:r[0]]), bytes(v[:r[1]])))
+print(res == list(db.items()))
+
+# the result tuple is reused
+db.keys()
+print(db.readinto(k) is db.readinto(k))
+
+db.close()
+f.close()
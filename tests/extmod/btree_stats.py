@@ -0,0 +1,23 @@
+# test btree page cache stats, which are optional
+
+try:
+    import btree
+    import uio
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+f = uio.BytesIO()
+db = btree.open(f, pagesize=512)
+if not hasattr(db, "stats"):
+    print("SKIP")
+    raise SystemExit
+
+db.load((b"%03d" % i, b"val%d" % i) for i in range(200))
+for k in db.keys():
+    pass
+s = db.stats()
+print(len(s), s[0] > 0, all(isinstance(x, int) for x in s))
+
+db.close()
+f.close()
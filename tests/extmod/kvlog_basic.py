@@ -0,0 +1,79 @@
+# test the kvlog key/value store
+
+try:
+    import kvlog
+    import uio
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+f = uio.BytesIO()
+db = kvlog.open(f, segsize=256, segments=4)
+print(str(db)[:7], len(db), bool(db))
+
+db[b"a"] = b"1"
+db["b"] = "two"
+db.put(b"c", bytearray(b"three"))
+print(db[b"a"], db["b"], db[b"c"], len(db), bool(db))
+print(db.get(b"x"), db.get(b"x", 5), db.get("a", 5))
+print("a" in db, b"b" in db, b"x" in db)
+
+del db[b"a"]
+print(len(db), "a" in db, sorted(db))
+try:
+    db[b"a"]
+except KeyError:
+    print("KeyError")
+try:
+    del db[b"a"]
+except KeyError:
+    print("KeyError")
+
+db.update({b"d": b"4"})
+db.update([(b"e", b"5"), (b"d", b"44")])
+print(sorted(db), db[b"d"])
+
+try:
+    db[b"big"] = b"x" * 300
+except ValueError:
+    print("ValueError")
+
+# overwrite keys until segments need compacting
+ref = {b"b": b"two", b"c": b"three", b"d": b"44", b"e": b"5"}
+for i in range(500):
+    k = b"k%d" % (i % 7)
+    if i % 11 == 0 and k in ref:
+        del db[k]
+        del ref[k]
+    else:
+        db[k] = b"v" * (i % 30) + b"%d" % i
+        ref[k] = b"v" * (i % 30) + b"%d" % i
+print(len(db) == len(ref), all(db[k] == ref[k] for k in ref))
+user, written, compactions = db.stats()
+print(written > user, compactions > 0)
+
+# reopening replays the log
+db.flush()
+db = kvlog.open(f, segsize=256, segments=4)
+print(len(db) == len(ref), all(db[k] == ref[k] for k in ref), sorted(db) == sorted(ref))
+print(db.stats())
+
+# the segment size is fixed when a store is created
+try:
+    kvlog.open(f, segsize=512, segments=4)
+except ValueError:
+    print("ValueError")
+
+# running out of space
+db = kvlog.open(uio.BytesIO(), segsize=256, segments=3)
+try:
+    for i in range(100):
+        db[b"%d" % i] = b"x" * 40
+except OSError as e:
+    print("OSError", e.args[0] == 28)
+n = len(db)
+del db[b"0"]
+db.compact()
+db[b"new"] = b"1"
+print(len(db) == n, db[b"1"], db[b"new"])
+db.close()
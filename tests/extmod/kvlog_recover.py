@@ -0,0 +1,52 @@
+# test that a kvlog store recovers from writes cut short by a crash
+
+try:
+    import kvlog
+    import uio
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+def contents(data):
+    db = kvlog.open(uio.BytesIO(data), segsize=256, segments=4)
+    return {k: db[k] for k in db}
+
+f = uio.BytesIO()
+db = kvlog.open(f, segsize=256, segments=4)
+ref = {}
+prev = f.getvalue()
+ok = True
+for i in range(120):
+    old = dict(ref)
+    compactions = db.stats()[2]
+    k = b"k%d" % (i % 5)
+    if i % 7 == 3 and k in ref:
+        del db[k]
+        del ref[k]
+    else:
+        db[k] = b"v" * (i % 20) + b"%d" % i
+        ref[k] = db[k]
+    cur = f.getvalue()
+    if contents(cur) != ref:
+        ok = False
+    if db.stats()[2] == compactions:
+        # the record was appended with a single write; keep only part of it
+        start = 0
+        while start < len(prev) and cur[start] == prev[start]:
+            start += 1
+        end = len(cur)
+        while end <= len(prev) and cur[end - 1] == prev[end - 1]:
+            end -= 1
+        for n in range(start, end, 3):
+            if contents(cur[:n] + prev[n:]) != old:
+                ok = False
+    prev = cur
+print(ok, db.stats()[2] > 0)
+
+# a damaged record is detected by its CRC, and the previous value is used
+old = ref[b"k1"]
+db[b"k1"] = b"last value"
+data = f.getvalue()
+i = data.find(b"last value") + 3
+data = data[:i] + bytes([data[i] ^ 1]) + data[i + 1:]
+print(contents(data)[b"k1"] == old)
@@ -0,0 +1,125 @@
+# test ueventloop scheduling of callbacks and coroutines
+
+try:
+    import ueventloop
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+loop = ueventloop.EventLoop()
+log = []
+
+def cb(*args):
+    log.append(args)
+
+def task(name, n, delay):
+    for i in range(n):
+        log.append((name, i))
+        yield delay
+    return name
+
+# coroutines started by yielding them, sleeps ordered by time
+def main():
+    yield task("a", 3, 30)
+    yield task("b", 2, 100)
+    loop.call_soon(cb, 1, 2)
+    loop.call_later_ms(5, cb, "later")
+    loop.call_at_(loop.time(), cb)
+    yield 250
+    return "done"
+
+print(loop.run_until_complete(main()))
+print(log)
+
+# yielding None just reschedules, False parks the coroutine
+log = []
+def yielder(name, n):
+    for i in range(n):
+        log.append((name, i))
+        yield
+def parked():
+    log.append("parked")
+    yield False
+    log.append("never")
+loop.create_task(yielder("x", 3))
+loop.create_task(parked())
+loop.create_task(yielder("y", 2))
+print(loop.run_forever())
+print(log)
+
+# a coroutine given to call_soon and call_later_ms is resumed
+log = []
+loop.call_later_ms(10, yielder("later", 1))
+loop.call_soon(yielder("soon", 1))
+loop.run_forever()
+print(log)
+
+# StopLoop and stop() end run_forever
+def stopper(value):
+    yield 10
+    yield ueventloop.StopLoop(value)
+loop.create_task(stopper(42))
+print(loop.run_forever())
+print(ueventloop.StopLoop().arg)
+
+def stopper2():
+    yield
+    loop.stop()
+    yield
+    log.append("resumed")
+log = []
+loop.create_task(stopper2())
+print(loop.run_forever(), log)
+loop.run_forever()
+print(log)
+
+# current task
+def current():
+    print(loop.cur_task() is t)
+    yield
+t = current()
+loop.run_until_complete(t)
+print(loop.cur_task())
+
+# exceptions propagate out of the loop
+def bad():
+    yield "x"
+try:
+    loop.run_until_complete(bad())
+except TypeError:
+    print("TypeError")
+
+def err():
+    yield
+    raise ValueError(1)
+try:
+    loop.run_until_complete(err())
+except ValueError as e:
+    print("ValueError", e)
+
+def cb_err():
+    raise KeyError(2)
+loop.call_soon(cb_err)
+try:
+    loop.run_forever()
+except KeyError as e:
+    print("KeyError", e)
+
+# the run queue has a fixed size
+loop = ueventloop.EventLoop(2, 1)
+loop.call_soon(cb)
+loop.call_soon(cb)
+try:
+    loop.call_soon(cb)
+except IndexError:
+    print("IndexError")
+loop.call_later_ms(10, cb)
+try:
+    loop.call_later_ms(10, cb)
+except IndexError:
+    print("IndexError")
+
+try:
+    ueventloop.EventLoop(0)
+except ValueError:
+    print("ValueError")
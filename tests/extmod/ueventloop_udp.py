@@ -0,0 +1,56 @@
+# test ueventloop waking coroutines on UDP socket events
+
+try:
+    import ueventloop
+    import usocket as socket
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+def bound_socket():
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    for port in range(47123, 47323):
+        addr = socket.getaddrinfo("127.0.0.1", port)[0][-1]
+        try:
+            s.bind(addr)
+            return s, addr
+        except OSError:
+            pass
+    print("SKIP")
+    raise SystemExit
+
+s1, addr1 = bound_socket()
+s2, addr2 = bound_socket()
+
+def server():
+    while True:
+        yield ueventloop.IORead(s1)
+        data, addr = s1.recvfrom(16)
+        print("server", data)
+        if data == b"quit":
+            break
+        yield ueventloop.IOWrite(s1)
+        s1.sendto(data.upper(), addr)
+    yield ueventloop.IOReadDone(s1)
+    return "server done"
+
+def client():
+    for msg in (b"abc", b"def"):
+        # wait a little so the server is idle in poll
+        yield 10
+        yield ueventloop.IOWrite(s2)
+        s2.sendto(msg, addr1)
+        yield ueventloop.IORead(s2)
+        print("client", s2.recv(16))
+    yield ueventloop.IOReadDone(s2)
+    s2.sendto(b"quit", addr1)
+
+loop = ueventloop.EventLoop()
+loop.create_task(client())
+print(loop.run_until_complete(server()))
+
+# the loop returns once nothing is waiting any more
+print(loop.run_forever())
+
+s1.close()
+s2.close()
@@ -0,0 +1,30 @@
+try:
+    from uio import StringIO
+    import ujson as json
+except:
+    try:
+        from io import StringIO
+        import json
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+s = StringIO()
+json.dump(False, s)
+print(s.getvalue())
+
+s = StringIO()
+json.dump({"a": (2, [3, None])}, s)
+print(s.getvalue())
+
+# dump to a stream, with output longer than the internal buffer
+s = StringIO()
+json.dump([{"x": i, "s": "a" * i} for i in range(0, 200, 40)] + ["b" * 300], s)
+s.seek(0)
+print(json.load(s) == [{"x": i, "s": "a" * i} for i in range(0, 200, 40)] + ["b" * 300])
+
+# dump to a non-stream
+try:
+    json.dump(123, 1)
+except (AttributeError, OSError, TypeError): # CPython and uPython have different errors
+    print('Exception')
@@ -0,0 +1,30 @@
+try:
+    from uio import StringIO
+    import ujson as json
+except:
+    try:
+        from io import StringIO
+        import json
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+try:
+    json.dumps(1, separators=(",", ":"))
+except TypeError:
+    # separators not supported
+    print("SKIP")
+    raise SystemExit
+
+for sep in [None, (", ", ": "), (",", ":"), (";", " = ")]:
+    print(json.dumps([1, (2, {"a": [3, "s"]}), {}], separators=sep))
+    s = StringIO()
+    json.dump({"b": [None, True, []]}, s, separators=sep)
+    print(s.getvalue())
+
+# invalid separators
+for sep in [1, (1, 2), (",",), (",", ":", ";")]:
+    try:
+        json.dumps(1, separators=sep)
+    except (TypeError, ValueError):
+        print('Exception')
@@ -0,0 +1,40 @@
+# test ujson.iterload, which yields the elements of a top-level array
+try:
+    from uio import StringIO
+    import ujson
+    ujson.iterload
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+def test(s):
+    try:
+        print(list(ujson.iterload(StringIO(s))))
+    except ValueError:
+        print("ValueError")
+
+test('[]')
+test(' [ 1 , "a", {"b": [2, 3]}, null ] ')
+test('[[1], [], [[2]]]')
+
+# any other value is yielded as a whole
+test('{"a": 1}')
+test('5')
+test('"str"')
+
+# elements are produced one at a time
+it = ujson.iterload(StringIO('[1, [2], 3 '))
+print(next(it), next(it), next(it))
+try:
+    next(it)
+except ValueError:
+    print("ValueError")
+
+# invalid documents
+test('')
+test('[1, 2')
+test('[1] x')
+test('[}')
+
+# elements longer than the internal read-ahead buffer
+print([len(x) for x in ujson.iterload(StringIO('["%s", "%s"]' % ("a" * 300, "b" * 600)))])
@@ -13,3 +13,11 @@ print(json.load(StringIO('null')))
 print(json.load(StringIO('"abc\\u0064e"')))
 print(json.load(StringIO('[false, true, 1, -2]')))
 print(json.load(StringIO('{"a":true}')))
+
+# values that cross the boundaries of the read-ahead buffer
+s = "x" * 300
+print(json.load(StringIO('"%s"' % s)) == s)
+print(json.load(StringIO('"%s\\n\\u0041%s"' % (s, s))) == s + "\nA" + s)
+for n in range(250, 260):
+    print(json.load(StringIO(" " * n + '[-1234567890, 1.25e3, "ab\\"c"]')))
+print(len(json.load(StringIO("[%s]" % ", ".join('{"a": %d}' % i for i in range(100))))))
@@ -0,0 +1,38 @@
+# test re.finditer and match.span/start/end/groups
+
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+try:
+    re.finditer
+    re.match('a', 'a').span
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+def print_all(it):
+    for m in it:
+        print(m.group(0), m.span(), m.start(), m.end(), m.groups())
+
+print_all(re.finditer('[0-9]+', 'a1b22c333'))
+print_all(re.finditer('([a-z])([0-9])', 'a1 b2 c3'))
+print_all(re.finditer('x', 'abc'))
+print_all(re.finditer(b'a', b'bab'))
+
+# empty matches
+print_all(re.finditer('x*', 'axb'))
+print_all(re.compile('^').finditer('abc'))
+
+# span of groups, including one that didn't participate
+m = re.match('(a)?(b)', 'b')
+print(m.span(0), m.span(1), m.span(2), m.start(1), m.groups())
+
+# offsets are in characters for str
+m = re.search('c', 'ééc')
+print(m.span())
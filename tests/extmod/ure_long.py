@@ -0,0 +1,26 @@
+# test matching of long subjects and patterns prone to excessive backtracking
+
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+# long repetitions that need many nested backtracking points
+s = 'a' * 5000 + 'b'
+m = re.match('(a|b)*', s)
+print(m.group(0) == s, m.group(1))
+m = re.search('(a*)b', s)
+print(len(m.group(1)))
+
+# nested quantifiers that fail after exploring many alternatives
+print(re.match('(a*)*c', 'a' * 16))
+print(re.search('(a|aa)+c', 'a' * 24 + 'b'))
+
+# a match far into a long subject
+s = 'xy' * 2000 + 'z123'
+print(re.search('z([0-9]+)', s).group(1))
+print(re.search('[z0-9]+$', s).group(0))
@@ -0,0 +1,49 @@
+# test re.sub
+
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+try:
+    re.sub
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+print(re.sub('a', 'b', 'aaa'))
+print(re.sub('a', 'b', 'aaa', 2))
+print(re.sub('x', 'y', 'aaa'))
+print(re.sub(b'a+', b'-', b'caab'))
+
+# templates with group references and escapes
+print(re.sub('(a)(b)', r'\2\1', 'abcab'))
+print(re.sub('(a)(b)', r'\g<2>\g<1>\g<0>', 'abcab'))
+print(re.sub('b', r'\\\n\t', 'abc'))
+print(re.sub('([0-9]+)-([0-9]+)', r'\2:\1', 'x 12-34 y 5-6'))
+
+# compiled regex
+r = re.compile('[ ]+')
+print(r.sub(' ', 'a  b     c d'))
+print(r.sub('', 'a  b     c d', 1))
+
+# callable replacement
+print(re.sub('[0-9]+', lambda m: str(int(m.group(0)) * 2), 'a1b22c333'))
+
+# patterns that can match the empty string
+print(re.sub('x*', '-', 'abxd'))
+print(re.sub('', '-', 'abc'))
+
+# anchors
+print(re.sub('^a', 'b', 'aaa'))
+print(re.sub('a$', 'b', 'aaa'))
+
+# invalid group reference
+try:
+    re.sub('(a)', r'\2', 'a')
+except Exception:
+    print('Exception')
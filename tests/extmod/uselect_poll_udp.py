@@ -0,0 +1,76 @@
+# test uselect.poll on UDP sockets sending to each other
+
+try:
+    import usocket as socket, uselect as select
+except ImportError:
+    try:
+        import socket, select
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+def bound_socket():
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    for port in range(47123, 47323):
+        addr = socket.getaddrinfo("127.0.0.1", port)[0][-1]
+        try:
+            s.bind(addr)
+            return s, addr
+        except OSError:
+            pass
+    print("SKIP")
+    raise SystemExit
+
+s1, addr1 = bound_socket()
+s2, addr2 = bound_socket()
+idle = [bound_socket()[0] for i in range(10)]
+
+def show(res):
+    names = {id(s1): "s1", id(s2): "s2"}
+    return sorted((names.get(id(o), "idle"), e) for o, e in res)
+
+p = select.poll()
+for s in idle + [s1, s2]:
+    p.register(s, select.POLLIN)
+
+# nothing to read yet
+print(show(p.poll(0)))
+print(show(p.poll(20)))
+
+# only the socket with data is returned
+s2.sendto(b"abc", addr1)
+print(show(p.poll(1000)))
+print(show(p.poll(0)))
+print(s1.recv(10))
+print(show(p.poll(0)))
+
+# writable sockets
+p.modify(s2, select.POLLIN | select.POLLOUT)
+print(show(p.poll(0)))
+p.modify(s2, select.POLLIN)
+
+# both ready, and ipoll gives the same results
+s1.sendto(b"x", addr2)
+s2.sendto(b"y", addr1)
+print(show(p.poll(1000)))
+print(show((o, e) for o, e in p.ipoll(0)))
+
+# in oneshot mode a reported object isn't reported again until modified
+print(show(p.poll(0, 1)))
+print(show(p.poll(0, 1)))
+p.modify(s1, select.POLLIN)
+print(show(p.poll(0, 1)))
+s1.recv(10)
+s2.recv(10)
+
+# unregistered objects aren't reported
+p.modify(s1, select.POLLIN)
+p.unregister(s1)
+s2.sendto(b"z", addr1)
+print(show(p.poll(20)))
+p.register(s1, select.POLLIN)
+print(show(p.poll(0)))
+s1.recv(10)
+
+for s in idle + [s1, s2]:
+    s.close()
@@ -0,0 +1,63 @@
+try:
+    import uzlib as zlib
+    import uio as io
+    zlib.compress
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# some data with repeats, both short and far apart
+data = b''
+for i in range(300):
+    data += b'line %d: %s\n' % (i % 37, b'abcdefgh'[:i % 8])
+data += bytes((i * 7 + (i >> 3)) & 0xff for i in range(1000))
+
+# small known outputs
+print(zlib.compress(b''))
+print(zlib.compress(b'hello hello hello'))
+print(zlib.compress(b'hello', 6, -9))
+
+# round trip through decompress with zlib and raw framing
+for inp in (b'', b'a', b'aaaa' * 100, data):
+    for level in (0, 1, 6, 9):
+        for wbits in (9, 10, 15):
+            c = zlib.compress(inp, level, wbits)
+            ok = zlib.decompress(c) == inp
+            c = zlib.compress(inp, level, -wbits)
+            ok = ok and zlib.decompress(c, -wbits) == inp
+            if not ok:
+                print('fail', len(inp), level, wbits)
+print(len(zlib.compress(data)) < len(data) // 3)
+
+# gzip framing, read back with DecompIO
+c = zlib.compress(data, 6, 16 + 10)
+print(c[:4])
+print(zlib.DecompIO(io.BytesIO(c), 16 + 10).read() == data)
+
+# CompressIO gives the same output however the data is split
+buf = io.BytesIO()
+s = zlib.CompressIO(buf, 6, 16 + 10)
+for i in range(0, len(data), 100):
+    s.write(data[i:i + 100])
+print(buf.getvalue()[:4])
+s.close()
+print(buf.getvalue() == c)
+s.close()
+try:
+    s.write(b'x')
+except OSError:
+    print('OSError')
+
+# raw deflate stream written in one go
+buf = io.BytesIO()
+s = zlib.CompressIO(buf, 9, -9)
+s.write(data)
+s.close()
+print(zlib.decompress(buf.getvalue(), -9) == data)
+
+# bad arguments
+for args in ((10, 10), (-2, 10), (6, 8), (6, 16), (6, 24), (6, -8)):
+    try:
+        zlib.compress(b'', *args)
+    except ValueError:
+        print('ValueError')
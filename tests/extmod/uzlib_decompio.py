@@ -25,9 +25,22 @@ inp = zlib.DecompIO(io.BytesIO(b'x\x9c30\xa0=\x00\x00\xb3q\x12\xc1'))
 print(inp.read(10))
 print(inp.read())
 
+# zlib bitstream with small window, dictionary must still hold 512 bytes
+inp = zlib.DecompIO(io.BytesIO(b'\x18\x95\xcbH\xcd\xc9\xc9W\xc8@\x90\x00:.\x06}'))
+print(inp.read())
+
 # zlib bitstream, wrong checksum
 inp = zlib.DecompIO(io.BytesIO(b'x\x9c30\xa0=\x00\x00\xb3q\x12\xc0'))
 try:
     print(inp.read())
 except OSError as e:
     print(repr(e))
+
+# Raw DEFLATE bitstream, a literal followed by invalid length code 286
+# and by invalid distance code 30
+for z in (b'K\x1c\x03', b'K\x04>'):
+    inp = zlib.DecompIO(io.BytesIO(z), -15)
+    try:
+        print(inp.read(100))
+    except OSError as e:
+        print(repr(e))
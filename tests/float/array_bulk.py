@@ -0,0 +1,38 @@
+# test bulk operations on float arrays in the array module
+
+try:
+    import array
+    array.scale
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+a = array.array('f', [1.5, -2.25, 3.0, 0.5, -0.75])
+b = array.array('f', [2.0, 0.5, -1.0, 4.0, 8.0])
+print(array.asum(a), array.amin(a), array.amax(a), array.dot(a, b))
+
+c = array.array('f', a)
+array.add(c, b)
+print(c)
+array.add(c, 0.25)
+print(c)
+array.mul(c, b)
+print(c)
+array.mul(c, -2)
+print(c)
+array.clip(c, -10, 10.5)
+print(c)
+array.scale(c, 0.5)
+print(c)
+array.scale(c, 2, 1)
+print(c)
+
+# scale saturates and truncates integer arrays
+h = array.array('h', [1000, -1000, 20000, -20000, 7])
+array.scale(h, 2.5)
+print(h)
+array.scale(h, 0.1, 0.5)
+print(h)
+u = array.array('B', [0, 10, 100, 200, 255])
+array.scale(u, -1, 128)
+print(u)
@@ -0,0 +1,42 @@
+# test that short decimal numbers are parsed to the closest float
+
+if repr(0.1 + 0.2) != "0.30000000000000004":
+    print("SKIP")
+    raise SystemExit
+
+for s in (
+    "0.1", "0.2", "0.3", "1.1", "2.675", "123.456", "-0.07", "1e22", "1e23",
+    "9007199254740993", "9007199254740993.0", "0.000001", "1.5e-5", "123e-20",
+    "4.35", "0.57", "1.7976931348623157e308", "0e999", "0.0e-999", "1e-400", "1e400",
+    "00001.2500", "  3.14  ", "2.5e+3", "10.5", ".5", "5.",
+    "12345678901234567890", "0.12345678901234567890123",
+):
+    print(repr(s), repr(float(s)))
+
+# values with up to 15 significant digits and small exponents are exact
+for i in range(1, 200, 7):
+    s = "%d.%03d" % (i * 12345, i)
+    print(s, float(s) == (i * 12345 * 1000 + i) / 1000)
+
+# repr round-trips over the whole exponent range, including subnormals
+try:
+    import ustruct as struct
+except ImportError:
+    import struct
+seed = 1
+bad = 0
+for i in range(2000):
+    seed = (seed * 6364136223846793005 + 1442695040888963407) & 0xffffffffffffffff
+    x = struct.unpack("<d", struct.pack("<Q", seed & 0x7fefffffffffffff))[0]
+    if float(repr(x)) != x:
+        bad += 1
+print("round-trip errors", bad)
+
+# halfway between two floats, and just either side of it
+for s in (
+    "9007199254740993", "9007199254740995", "9007199254740993.0000000000001",
+    "2.2250738585072011e-308", "2.2250738585072012e-308", "2.4703282292062327e-324",
+    "2.4703282292062328e-324", "1.7976931348623158e308", "1.7976931348623159e308",
+    "7.0064923216240854e-46", "1.2345678901234567e-300", "9.8765432109876543e+250",
+):
+    print(repr(s), repr(float(s)))
@@ -0,0 +1,26 @@
+# test that repr of a float is the shortest string that round-trips
+
+if repr(0.1 + 0.2) != "0.30000000000000004":
+    print("SKIP")
+    raise SystemExit
+
+for x in (
+    0.1, 0.2, 0.3, 1 / 3, 2 / 3, 1.1, 2.675, 100.0, 1e15, 1e16, 1.5e16,
+    123456789012345678.0, 1e22, 1e23, 1e100, 1e-4, 1e-5, 1.5e-5, 0.00012345,
+    5e-324, 2.2250738585072014e-308, 2.225073858507201e-308, 1.7976931348623157e308,
+    9007199254740993.0, 4.35, 0.57, 12345.678, 1.0, 0.5, 0.25, 2 ** 60 + 0.0,
+):
+    print(repr(x), repr(-x), str(x))
+
+# exact powers of two and ten
+for i in range(-30, 30, 3):
+    print(repr(2.0 ** i), repr(10.0 ** i))
+
+# round-trip of values built arithmetically
+x = 1.0
+for i in range(40):
+    x = x * 1.7 + 0.1
+    print(repr(x), float(repr(x)) == x)
+
+# complex numbers use the same format for each part
+print(complex(0.1, 0.2), complex(1e16, -1e-5), 0.3j)
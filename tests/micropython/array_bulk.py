@@ -0,0 +1,110 @@
+# test bulk operations on arrays in the array module
+
+try:
+    import array
+    array.add
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+def wrap(v, typecode):
+    bits = {'b': 8, 'B': 8, 'h': 16, 'H': 16, 'i': 32, 'I': 32}[typecode]
+    v &= (1 << bits) - 1
+    if typecode in 'bhi' and v >= 1 << (bits - 1):
+        v -= 1 << bits
+    return v
+
+def check(typecode, n):
+    a_vals = [(i * 37 + 11) % 200 - 100 for i in range(n)]
+    b_vals = [(i * 53 + 7) % 180 - 90 for i in range(n)]
+    if typecode in 'BHI':
+        a_vals = [abs(v) for v in a_vals]
+        b_vals = [abs(v) for v in b_vals]
+    a = array.array(typecode, a_vals)
+    b = array.array(typecode, b_vals)
+
+    print(typecode, n, array.asum(a) == sum(a_vals), array.dot(a, b) == sum(x * y for x, y in zip(a_vals, b_vals)))
+    if n:
+        print(array.amin(a) == min(a_vals), array.amax(a) == max(a_vals))
+
+    c = array.array(typecode, a)
+    array.add(c, b)
+    print(list(c) == [wrap(x + y, typecode) for x, y in zip(a_vals, b_vals)])
+    array.add(c, 120)
+    print(list(c) == [wrap(x + y + 120, typecode) for x, y in zip(a_vals, b_vals)])
+
+    c = array.array(typecode, a)
+    array.mul(c, b)
+    print(list(c) == [wrap(x * y, typecode) for x, y in zip(a_vals, b_vals)])
+    array.mul(c, 3)
+    print(list(c) == [wrap(x * y * 3, typecode) for x, y in zip(a_vals, b_vals)])
+
+    c = array.array(typecode, a)
+    array.clip(c, -20, 30)
+    print(list(c) == [min(max(x, -20), 30) for x in a_vals])
+
+# lengths either side of a machine word, to cover the word-at-a-time paths
+for typecode in 'bBhHiI':
+    for n in (0, 1, 7, 8, 9, 33):
+        check(typecode, n)
+
+# bytearray and unaligned memoryview
+b = bytearray(range(250, 256)) + bytearray(range(20))
+array.add(b, 10)
+print(b)
+m = memoryview(b)[1:]
+array.add(m, b[:len(m)])
+print(b, array.asum(m), array.amin(b), array.amax(b))
+
+# clip limits beyond the element range saturate
+a = array.array('b', [-128, 0, 127])
+array.clip(a, -1000, 1000)
+print(a)
+array.clip(a, 10, 20)
+print(a)
+
+# sums wider than the element type
+a = array.array('i', [2000000000, 2000000000, -1])
+print(array.asum(a), array.dot(a, array.array('i', [2000000000, 2000000000, 5])))
+
+# sums and dot products that overflow 64 bits
+a = array.array('I', [0xffffffff] * 3)
+print(array.asum(a), array.dot(a, a))
+a = array.array('i', [-0x80000000] * 3)
+b = array.array('i', [0x7fffffff, -0x80000000] * 3)
+print(array.dot(a, a), array.dot(b, b), array.dot(b, array.array('i', reversed(b))))
+
+# unsigned 32-bit scalars at and above 2**31
+a = array.array('I', [1, 0x80000000, 0xfffffffe])
+array.add(a, 0x80000000)
+print(list(a))
+array.mul(a, 0xffffffff)
+print(list(a))
+array.clip(a, 0x80000000, 0xffffffff)
+print(list(a), array.amax(a))
+
+# errors
+try:
+    array.add(array.array('h', [1, 2]), array.array('h', [1]))
+except ValueError:
+    print('ValueError')
+try:
+    array.add(array.array('h', [1, 2]), array.array('b', [1, 2]))
+except ValueError:
+    print('ValueError')
+try:
+    array.add(b'123', 1)
+except TypeError:
+    print('TypeError')
+try:
+    array.amin(bytearray())
+except ValueError:
+    print('ValueError')
+try:
+    array.asum(array.array('q', [1]))
+except TypeError:
+    print('TypeError')
+
+# the reductions don't shadow the builtins
+from array import *
+print(sum([1, 2]), min(3, 4), max(3, 4))
@@ -0,0 +1,77 @@
+# test const() with tuple and dict literals, which are built once and are read-only
+
+from micropython import const
+
+# check that const dicts are supported
+E = const({})
+try:
+    E[1] = 1
+    print("SKIP")
+    raise SystemExit
+except TypeError:
+    pass
+
+exec("A = const((1, 2, (3, 'four')))")
+print(A)
+
+exec("D = const({1: 'one', 'two': 2, (3, 4): b'34', 'f': 1.5, 'n': {'x': None}, 1: 'uno'})")
+print(sorted(D.items(), key=repr))
+print(D[1], D['two'], D[(3, 4)], D['n']['x'], len(D), 'f' in D, D.get('z'))
+
+# keys of mixed types
+exec("M = const({2.5: 1, b'x': 2, 1.5: 3, (1,): 4, 'a': 5, b'a': 6, 1: 7, 1.0: 8, True: 9})")
+print(sorted(M.items(), key=repr), M[(1,)], M[1], M[1.5])
+print((1,) in M, (2,) in M, M.get((2,)), M.get(b'a'), M.get('x', 0), 2.5 in M)
+
+# mutating a const dict raises TypeError
+def test_mutate(fun):
+    try:
+        fun()
+    except TypeError:
+        print("TypeError")
+test_mutate(lambda: D.__setitem__(1, 2))
+test_mutate(lambda: D.__delitem__(1))
+test_mutate(lambda: D.pop(1))
+test_mutate(lambda: D.popitem())
+test_mutate(lambda: D.setdefault('z', 1))
+test_mutate(lambda: D.update({2: 3}))
+test_mutate(lambda: D.clear())
+test_mutate(lambda: D['n'].clear())
+print(len(D))
+
+# a copy is mutable
+d2 = D.copy()
+d2['new'] = 1
+d3 = dict(D)
+d3['new'] = 1
+print(len(d2), len(d3), len(D))
+
+# tuples of constants are also built once
+def g():
+    return (1, 'a', None)
+print(g() is g(), g())
+
+# non-constant items are a syntax error
+def test_syntax(code):
+    try:
+        exec(code)
+    except SyntaxError:
+        print("SyntaxError")
+test_syntax("a = const({1: x})")
+test_syntax("a = const({1, 2})")
+test_syntax("a = const({x: x for x in ()})")
+test_syntax("a = const((1, [2]))")
+
+# only a module-level assignment is rewritten, other uses are normal calls
+import micropython
+def f():
+    return micropython.const((A, 1)), const({'a': A})
+print(f(), f()[1] is f()[1])
+def f():
+    x = const({'a': 1})
+    x['b'] = 2
+    return x
+print(sorted(f().items()))
+def const(x):
+    return ('user', x)
+print(const((A, 2)))
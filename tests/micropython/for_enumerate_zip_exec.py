@@ -0,0 +1,50 @@
+# test that loops over enumerate/zip in functions of exec'd code, which may be
+# compiled one statement at a time, are compiled without tuples unless a later
+# statement rebinds the builtins
+
+import gc
+try:
+    gc.mem_alloc
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+src = """
+def f(l):
+    s = 0
+    for i, x in enumerate(l):
+        s += i * x
+    for x, y in zip(l, l):
+        s += x - y
+    return s
+"""
+d = {}
+exec(src, d)
+l = list(range(1000))
+d["f"](l)
+gc.collect()
+gc.disable()
+m = gc.mem_alloc()
+s = d["f"](l)
+print(s, gc.mem_alloc() - m < 1000)
+gc.enable()
+
+src = """
+def f():
+    r = []
+    for i, x in enumerate("ab"):
+        r.append(i)
+    for x, y in zip("ab", "cd"):
+        r.append(x + y)
+    return r
+x = 1
+def rebind():
+    global enumerate, zip
+    enumerate = lambda s: [(7, c) for c in s]
+    zip = lambda a, b: [("z", "z")]
+"""
+d = {}
+exec(src, d)
+print(d["f"]())
+d["rebind"]()
+print(d["f"]())
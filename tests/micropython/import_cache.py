@@ -0,0 +1,91 @@
+# test caching of compiled bytecode for imported .py files
+
+import sys
+import micropython
+
+try:
+    import uos
+    micropython.bytecode_cache
+    uos.unlink
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+MOD = "import_cache_mod"
+
+def write(name, data):
+    f = open(name, "w")
+    f.write(data)
+    f.close()
+
+def remove(name):
+    try:
+        uos.unlink(name)
+    except OSError:
+        pass
+
+def exists(name):
+    try:
+        uos.stat(name)
+        return True
+    except OSError:
+        return False
+
+def load():
+    sys.modules.pop(MOD, None)
+    return __import__(MOD)
+
+sys.path.insert(0, "")
+remove(MOD + ".mpc")
+
+# first import compiles the source and writes the cache
+write(MOD + ".py", "x = 1\ndef f(a, *, b=2):\n    return (a, b, 'str', 1.5)\n")
+print(micropython.bytecode_cache())
+m = load()
+print(m.x, m.f(0), m.__file__ == MOD + ".py")
+print(exists(MOD + ".mpc"))
+
+# second import uses the cache
+m = load()
+print(m.x, m.f(0, b=3))
+
+# changing the source invalidates the cache; the replaced cache file may
+# still be in use by code loaded from it
+f = m.f
+write(MOD + ".py", "x = 22\n")
+m = load()
+print(m.x, f(1))
+m = load()
+print(m.x)
+
+# an edit that keeps the size, made within the same second, is seen
+write(MOD + ".py", "x = 23\n")
+m = load()
+print(m.x)
+
+# a corrupt or truncated cache file is ignored and replaced
+write(MOD + ".mpc", "garbage")
+m = load()
+print(m.x)
+m = load()
+print(m.x)
+
+# a syntax error in the source is still reported
+write(MOD + ".py", "x = (\n")
+try:
+    load()
+except SyntaxError:
+    print("SyntaxError")
+
+# with the cache disabled no cache file is written
+remove(MOD + ".mpc")
+write(MOD + ".py", "x = 333\n")
+micropython.bytecode_cache(False)
+print(micropython.bytecode_cache())
+m = load()
+print(m.x, exists(MOD + ".mpc"))
+micropython.bytecode_cache(True)
+
+remove(MOD + ".py")
+remove(MOD + ".mpc")
+sys.modules.pop(MOD, None)
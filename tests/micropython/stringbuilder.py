@@ -0,0 +1,41 @@
+# test micropython.StringBuilder
+
+import micropython
+
+try:
+    micropython.StringBuilder
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+sb = micropython.StringBuilder()
+print(len(sb), bool(sb))
+
+# build up using += and append
+for i in range(5):
+    sb += str(i)
+sb.append(",", "é", "x")
+print(sb, len(sb), bool(sb))
+
+# build returns the str and leaves the builder empty
+s = sb.build()
+print(s, type(s) is str, len(sb), repr(sb.build()))
+
+# builder can be reused, and given an initial size
+sb.append("again")
+print(sb.build())
+sb = micropython.StringBuilder(100)
+for i in range(100):
+    sb.append("ab", "c")
+s = sb.build()
+print(len(s), s[:6], s == "abc" * 100)
+
+# only str can be added
+try:
+    sb.append(b"1")
+except TypeError:
+    print("TypeError")
+try:
+    sb += 1
+except TypeError:
+    print("TypeError")
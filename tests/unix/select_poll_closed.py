@@ -0,0 +1,44 @@
+# test uselect.poll on a socket that is closed while registered; it's reported
+# as POLLNVAL
+
+try:
+    import usocket as socket, uselect as select
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+s1 = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+s2 = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+
+p = select.poll()
+p.register(s1, select.POLLIN)
+p.register(s2, select.POLLIN)
+print(p.poll(0))
+
+s1.close()
+print([(o is s1, e) for o, e in p.poll(100)])
+print([(o is s1, e) for o, e in p.poll(-1)])
+print([(o is s1, e) for o, e in p.ipoll(0)])
+
+# once it's unregistered the other socket is waited for alone
+p.unregister(s1)
+print(p.poll(10))
+
+s2.close()
+
+# a registered fd that is closed and whose number is reused by a new socket
+# is waited for as the new socket
+s1 = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+fd = s1.fileno()
+p = select.poll()
+p.register(fd, select.POLLIN)
+print(p.poll(0))
+s1.close()
+s2 = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+addr = socket.getaddrinfo("127.0.0.1", 8000)[0][-1]
+s2.bind(addr)
+s3 = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+s3.sendto(b"x", addr)
+print(s2.fileno() == fd, [(f == fd, e) for f, e in p.poll(500)])
+s2.close()
+s3.close()
@@ -0,0 +1,29 @@
+# test uselect.poll on a regular file together with a socket; regular files
+# are always ready
+
+try:
+    import usocket as socket, uselect as select
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+f = open("unix/select_poll_file.py")
+fd = f.fileno()
+s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+
+p = select.poll()
+p.register(fd, select.POLLIN)
+p.register(s, select.POLLIN)
+print([(o == fd, e) for o, e in p.poll(1000)])
+print([(o == fd, e) for o, e in p.ipoll(0)])
+
+# once the file is unregistered the socket is waited for alone
+p.unregister(fd)
+print(p.poll(10))
+p.register(fd, select.POLLIN | select.POLLOUT)
+print([(o == fd, e) for o, e in p.poll(0)])
+p.unregister(fd)
+print(p.poll(0))
+
+f.close()
+s.close()
@@ -57,7 +57,7 @@ class FreezeError(Exception):
         return 'error while freezing %s: %s' % (self.rawcode.source_file, self.msg)
 
 class Config:
-    MPY_VERSION = 2
+    MPY_VERSION = 3
     MICROPY_LONGINT_IMPL_NONE = 0
     MICROPY_LONGINT_IMPL_LONGLONG = 1
     MICROPY_LONGINT_IMPL_MPZ = 2
@@ -242,6 +242,109 @@ class RawCode:
             rc.freeze()
         # TODO
 
+    def _freeze_obj(self, obj_name, obj):
+        # print the C definition of obj (if it needs one) and return the lines
+        # that make up a reference to it within an array of mp_rom_obj_t
+        if obj is None:
+            return ['MP_ROM_PTR(&mp_const_none_obj),']
+        elif obj is False:
+            return ['MP_ROM_PTR(&mp_const_false_obj),']
+        elif obj is True:
+            return ['MP_ROM_PTR(&mp_const_true_obj),']
+        elif obj is Ellipsis:
+            return ['MP_ROM_PTR(&mp_const_ellipsis_obj),']
+        elif type(obj) is QStrObj:
+            return ['MP_ROM_QSTR(%s),' % global_qstrs[obj.qst].qstr_id]
+        elif is_str_type(obj) or is_bytes_type(obj):
+            if is_str_type(obj):
+                obj = bytes_cons(obj, 'utf8')
+                obj_type = 'mp_type_str'
+            else:
+                obj_type = 'mp_type_bytes'
+            print('STATIC const mp_obj_str_t %s = {{&%s}, %u, %u, (const byte*)"%s"};'
+                % (obj_name, obj_type, qstrutil.compute_hash(obj, config.MICROPY_QSTR_BYTES_IN_HASH),
+                    len(obj), ''.join(('\\x%02x' % b) for b in obj)))
+        elif is_int_type(obj):
+            if -(1 << (config.mp_small_int_bits - 1)) <= obj < (1 << (config.mp_small_int_bits - 1)):
+                # a small int within a constant tuple or dict
+                return ['MP_ROM_INT(%d),' % obj]
+            elif config.MICROPY_LONGINT_IMPL == config.MICROPY_LONGINT_IMPL_NONE:
+                # TODO check if we can actually fit this long-int into a small-int
+                raise FreezeError(self, 'target does not support long int')
+            elif config.MICROPY_LONGINT_IMPL == config.MICROPY_LONGINT_IMPL_LONGLONG:
+                # TODO
+                raise FreezeError(self, 'freezing int to long-long is not implemented')
+            elif config.MICROPY_LONGINT_IMPL == config.MICROPY_LONGINT_IMPL_MPZ:
+                neg = 0
+                if obj < 0:
+                    obj = -obj
+                    neg = 1
+                bits_per_dig = config.MPZ_DIG_SIZE
+                digs = []
+                z = obj
+                while z:
+                    digs.append(z & ((1 << bits_per_dig) - 1))
+                    z >>= bits_per_dig
+                ndigs = len(digs)
+                digs = ','.join(('%#x' % d) for d in digs)
+                print('STATIC const mp_obj_int_t %s = {{&mp_type_int}, '
+                    '{.neg=%u, .fixed_dig=1, .alloc=%u, .len=%u, .dig=(uint%u_t[]){%s}}};'
+                    % (obj_name, neg, ndigs, ndigs, bits_per_dig, digs))
+        elif type(obj) is float:
+            print('#if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A || MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_B')
+            print('STATIC const mp_obj_float_t %s = {{&mp_type_float}, %.16g};'
+                % (obj_name, obj))
+            print('#endif')
+            n = struct.unpack('<I', struct.pack('<f', obj))[0]
+            n = ((n & ~0x3) | 2) + 0x80800000
+            return [
+                '#if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A || MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_B',
+                'MP_ROM_PTR(&%s),' % obj_name,
+                '#elif MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_C',
+                '(mp_rom_obj_t)(0x%08x),' % (n,),
+                '#else',
+                '#error "MICROPY_OBJ_REPR_D not supported with floats in frozen mpy files"',
+                '#endif',
+            ]
+        elif type(obj) is complex:
+            print('STATIC const mp_obj_complex_t %s = {{&mp_type_complex}, %.16g, %.16g};'
+                % (obj_name, obj.real, obj.imag))
+        elif type(obj) is tuple:
+            if len(obj) == 0:
+                return ['MP_ROM_PTR(&mp_const_empty_tuple_obj),']
+            refs = [self._freeze_obj('%s_%u' % (obj_name, i), o) for i, o in enumerate(obj)]
+            print('STATIC const mp_rom_obj_tuple_t %s = {{&mp_type_tuple}, %u, {' % (obj_name, len(obj)))
+            for ref in refs:
+                print_obj_ref(ref)
+            print('}};')
+        elif type(obj) is ConstDict:
+            # a read-only dict with a fixed, ordered table
+            refs = [(self._freeze_obj('%s_k%u' % (obj_name, i), k), self._freeze_obj('%s_v%u' % (obj_name, i), v))
+                for i, (k, v) in enumerate(obj.items)]
+            if refs:
+                print('STATIC const mp_rom_map_elem_t %s_table[%u] = {' % (obj_name, len(refs)))
+                for k, v in refs:
+                    print('    {')
+                    print_obj_ref(k, '        ')
+                    print_obj_ref(v, '        ')
+                    print('    },')
+                print('};')
+            print('STATIC const mp_obj_dict_t %s = {{&mp_type_dict}, {' % obj_name)
+            print('    .all_keys_are_qstrs = %u,' % all(type(k) is QStrObj for k, v in obj.items))
+            print('    .is_fixed = 1,')
+            print('    .is_ordered = 1,')
+            print('    .used = %u,' % len(refs))
+            print('    .alloc = %u,' % len(refs))
+            if refs:
+                print('    .table = (mp_map_elem_t*)(mp_rom_map_elem_t*)%s_table,' % obj_name)
+            else:
+                print('    .table = NULL,')
+            print('}};')
+        else:
+            # TODO
+            raise FreezeError(self, 'freezing of object %r is not implemented' % (obj,))
+        return ['MP_ROM_PTR(&%s),' % obj_name]
+
     def freeze(self, parent_name):
         self.escaped_name = parent_name + self.simple_name.qstr_esc
 
@@ -285,70 +388,16 @@ class RawCode:
         print('};')
 
         # generate constant objects
-        for i, obj in enumerate(self.objs):
-            obj_name = 'const_obj_%s_%u' % (self.escaped_name, i)
-            if is_str_type(obj) or is_bytes_type(obj):
-                if is_str_type(obj):
-                    obj = bytes_cons(obj, 'utf8')
-                    obj_type = 'mp_type_str'
-                else:
-                    obj_type = 'mp_type_bytes'
-                print('STATIC const mp_obj_str_t %s = {{&%s}, %u, %u, (const byte*)"%s"};'
-                    % (obj_name, obj_type, qstrutil.compute_hash(obj, config.MICROPY_QSTR_BYTES_IN_HASH),
-                        len(obj), ''.join(('\\x%02x' % b) for b in obj)))
-            elif is_int_type(obj):
-                if config.MICROPY_LONGINT_IMPL == config.MICROPY_LONGINT_IMPL_NONE:
-                    # TODO check if we can actually fit this long-int into a small-int
-                    raise FreezeError(self, 'target does not support long int')
-                elif config.MICROPY_LONGINT_IMPL == config.MICROPY_LONGINT_IMPL_LONGLONG:
-                    # TODO
-                    raise FreezeError(self, 'freezing int to long-long is not implemented')
-                elif config.MICROPY_LONGINT_IMPL == config.MICROPY_LONGINT_IMPL_MPZ:
-                    neg = 0
-                    if obj < 0:
-                        obj = -obj
-                        neg = 1
-                    bits_per_dig = config.MPZ_DIG_SIZE
-                    digs = []
-                    z = obj
-                    while z:
-                        digs.append(z & ((1 << bits_per_dig) - 1))
-                        z >>= bits_per_dig
-                    ndigs = len(digs)
-                    digs = ','.join(('%#x' % d) for d in digs)
-                    print('STATIC const mp_obj_int_t %s = {{&mp_type_int}, '
-                        '{.neg=%u, .fixed_dig=1, .alloc=%u, .len=%u, .dig=(uint%u_t[]){%s}}};'
-                        % (obj_name, neg, ndigs, ndigs, bits_per_dig, digs))
-            elif type(obj) is float:
-                print('#if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A || MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_B')
-                print('STATIC const mp_obj_float_t %s = {{&mp_type_float}, %.16g};'
-                    % (obj_name, obj))
-                print('#endif')
-            elif type(obj) is complex:
-                print('STATIC const mp_obj_complex_t %s = {{&mp_type_complex}, %.16g, %.16g};'
-                    % (obj_name, obj.real, obj.imag))
-            else:
-                # TODO
-                raise FreezeError(self, 'freezing of object %r is not implemented' % (obj,))
+        obj_refs = [self._freeze_obj('const_obj_%s_%u' % (self.escaped_name, i), obj)
+            for i, obj in enumerate(self.objs)]
 
         # generate constant table
         print('STATIC const mp_rom_obj_t const_table_data_%s[%u] = {'
             % (self.escaped_name, len(self.qstrs) + len(self.objs) + len(self.raw_codes)))
         for qst in self.qstrs:
             print('    MP_ROM_QSTR(%s),' % global_qstrs[qst].qstr_id)
-        for i in range(len(self.objs)):
-            if type(self.objs[i]) is float:
-                print('#if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A || MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_B')
-                print('    MP_ROM_PTR(&const_obj_%s_%u),' % (self.escaped_name, i))
-                print('#elif MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_C')
-                n = struct.unpack('<I', struct.pack('<f', self.objs[i]))[0]
-                n = ((n & ~0x3) | 2) + 0x80800000
-                print('    (mp_rom_obj_t)(0x%08x),' % (n,))
-                print('#else')
-                print('#error "MICROPY_OBJ_REPR_D not supported with floats in frozen mpy files"')
-                print('#endif')
-            else:
-                print('    MP_ROM_PTR(&const_obj_%s_%u),' % (self.escaped_name, i))
+        for ref in obj_refs:
+            print_obj_ref(ref)
         for rc in self.raw_codes:
             print('    MP_ROM_PTR(&raw_code_%s),' % rc.escaped_name)
         print('};')
@@ -371,6 +420,13 @@ class RawCode:
         print('    },')
         print('};')
 
+def print_obj_ref(ref, indent='    '):
+    for line in ref:
+        if line.startswith('#'):
+            print(line)
+        else:
+            print(indent + line)
+
 def read_uint(f):
     i = 0
     while True:
@@ -389,10 +445,38 @@ def read_qstr(f):
     global_qstrs.append(qstr_type(data, qstr_esc, 'MP_QSTR_' + qstr_esc))
     return len(global_qstrs) - 1
 
+class QStrObj:
+    # an interned string within a constant tuple or dict
+    def __init__(self, qst):
+        self.qst = qst
+
+    def __repr__(self):
+        return repr(global_qstrs[self.qst].str)
+
+class ConstDict:
+    # a read-only dict, with its items kept in order
+    def __init__(self, items):
+        self.items = items
+
+    def __repr__(self):
+        return '{%s}' % ', '.join('%r: %r' % kv for kv in self.items)
+
 def read_obj(f):
     obj_type = f.read(1)
     if obj_type == b'e':
         return Ellipsis
+    elif obj_type == b'N':
+        return None
+    elif obj_type == b'F':
+        return False
+    elif obj_type == b'T':
+        return True
+    elif obj_type == b'q':
+        return QStrObj(read_qstr(f))
+    elif obj_type == b't':
+        return tuple(read_obj(f) for _ in range(read_uint(f)))
+    elif obj_type == b'd':
+        return ConstDict([(read_obj(f), read_obj(f)) for _ in range(read_uint(f))])
     else:
         buf = f.read(read_uint(f))
         if obj_type == b's':
@@ -464,6 +548,7 @@ def freeze_mpy(base_qstrs, raw_codes):
     print('#include "py/mpconfig.h"')
     print('#include "py/objint.h"')
     print('#include "py/objstr.h"')
+    print('#include "py/objtuple.h"')
     print('#include "py/emitglue.h"')
     print()
 
@@ -128,6 +128,7 @@ STATIC mp_uint_t fdfile_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, i
 STATIC mp_obj_t fdfile_close(mp_obj_t self_in) {
     mp_obj_fdfile_t *self = MP_OBJ_TO_PTR(self_in);
     close(self->fd);
+    MP_UNIX_FD_CLOSED();
 #ifdef MICROPY_CPYTHON_COMPAT
     self->fd = -1;
 #endif
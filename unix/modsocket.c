@@ -121,6 +121,7 @@ STATIC mp_obj_t socket_close(mp_obj_t self_in) {
     // file descriptor. If you're interested to catch I/O errors before
     // closing fd, fsync() it.
     close(self->fd);
+    MP_UNIX_FD_CLOSED();
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(socket_close_obj, socket_close);
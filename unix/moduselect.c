@@ -32,6 +32,10 @@
 #include <stdio.h>
 #include <errno.h>
 #include <poll.h>
+#if MICROPY_PY_USELECT_EPOLL
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
 
 #include "py/runtime.h"
 #include "py/obj.h"
@@ -49,6 +53,16 @@ extern const mp_obj_type_t mp_type_socket;
 
 /// \class Poll - poll class
 
+// With epoll, each registered fd is also added to an epoll instance, and
+// waiting returns just the ready entries, whose indices are kept in ready[].
+// Fds that epoll doesn't support (eg regular files, which are always ready)
+// are counted in n_no_epoll, and while there are any, poll() is used for
+// all entries instead.
+//
+// Closing an fd silently removes it from the epoll instance, so whenever an
+// fd has been closed since the last wait, the entries are re-added (see
+// poll_epoll_rearm).
+
 typedef struct _mp_obj_poll_t {
     mp_obj_base_t base;
     unsigned short alloc;
@@ -60,8 +74,76 @@ typedef struct _mp_obj_poll_t {
     int flags;
     // callee-owned tuple
     mp_obj_t ret_tuple;
+    #if MICROPY_PY_USELECT_EPOLL
+    int epfd;
+    unsigned int fd_close_count; // value of mp_unix_fd_close_count at the last wait
+    unsigned short n_no_epoll;
+    // per entry: whether it is in the epoll instance
+    bool *in_epoll;
+    // indices of the entries that were ready in the last poll
+    unsigned short *ready;
+    struct epoll_event *events;
+    #endif
 } mp_obj_poll_t;
 
+#if MICROPY_PY_USELECT_EPOLL
+
+unsigned int mp_unix_fd_close_count;
+
+// add the entry to the epoll instance, or update its events there
+STATIC void poll_epoll_update(mp_obj_poll_t *self, int i) {
+    struct pollfd *entry = &self->entries[i];
+    struct epoll_event ev;
+    ev.events = entry->events;
+    ev.data.u32 = i;
+    if (self->in_epoll[i]) {
+        if (epoll_ctl(self->epfd, EPOLL_CTL_MOD, entry->fd, &ev) == 0) {
+            return;
+        }
+        // the fd was closed, which removed it from the epoll instance
+        self->in_epoll[i] = false;
+        self->n_no_epoll++;
+    }
+    if (epoll_ctl(self->epfd, EPOLL_CTL_ADD, entry->fd, &ev) == 0) {
+        self->in_epoll[i] = true;
+        self->n_no_epoll--;
+    }
+}
+
+// Add the entries to the epoll instance again after an fd was closed.  An entry
+// that is still there fails with EEXIST.  One whose fd was closed fails with
+// EBADF, and is left to poll(), which reports it as POLLNVAL.  If the fd
+// number was reused, the new file is added, as poll() would wait for it too.
+STATIC void poll_epoll_rearm(mp_obj_poll_t *self) {
+    for (int i = 0; i < self->len; i++) {
+        if (self->in_epoll[i]) {
+            struct epoll_event ev;
+            ev.events = self->entries[i].events;
+            ev.data.u32 = i;
+            if (epoll_ctl(self->epfd, EPOLL_CTL_ADD, self->entries[i].fd, &ev) < 0 && errno != EEXIST) {
+                self->in_epoll[i] = false;
+                self->n_no_epoll++;
+            }
+        }
+    }
+}
+
+STATIC void poll_epoll_remove(mp_obj_poll_t *self, int i) {
+    if (self->entries[i].fd == -1) {
+        // a free slot
+        return;
+    }
+    if (self->in_epoll[i]) {
+        // may fail if the fd is already closed, which is fine
+        epoll_ctl(self->epfd, EPOLL_CTL_DEL, self->entries[i].fd, NULL);
+        self->in_epoll[i] = false;
+    } else {
+        self->n_no_epoll--;
+    }
+}
+
+#endif
+
 STATIC int get_fd(mp_obj_t fdlike) {
     int fd;
     // Shortcut for fdfile compatible types
@@ -98,6 +180,9 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
         int entry_fd = entry->fd;
         if (entry_fd == fd) {
             entry->events = flags;
+            #if MICROPY_PY_USELECT_EPOLL
+            poll_epoll_update(self, i);
+            #endif
             return mp_const_false;
         }
         if (entry_fd == -1) {
@@ -111,6 +196,11 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
             if (self->obj_map) {
                 self->obj_map = m_renew(mp_obj_t, self->obj_map, self->alloc, self->alloc + 4);
             }
+            #if MICROPY_PY_USELECT_EPOLL
+            self->in_epoll = m_renew(bool, self->in_epoll, self->alloc, self->alloc + 4);
+            self->ready = m_renew(unsigned short, self->ready, self->alloc, self->alloc + 4);
+            self->events = m_renew(struct epoll_event, self->events, self->alloc, self->alloc + 4);
+            #endif
             self->alloc += 4;
         }
         free_slot = &self->entries[self->len++];
@@ -126,6 +216,11 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
     free_slot->fd = fd;
     free_slot->events = flags;
     free_slot->revents = 0;
+    #if MICROPY_PY_USELECT_EPOLL
+    self->in_epoll[free_slot - self->entries] = false;
+    self->n_no_epoll++;
+    poll_epoll_update(self, free_slot - self->entries);
+    #endif
     return mp_const_true;
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_register_obj, 2, 3, poll_register);
@@ -137,6 +232,9 @@ STATIC mp_obj_t poll_unregister(mp_obj_t self_in, mp_obj_t obj_in) {
     int fd = get_fd(obj_in);
     for (int i = self->len - 1; i >= 0; i--) {
         if (entries->fd == fd) {
+            #if MICROPY_PY_USELECT_EPOLL
+            poll_epoll_remove(self, entries - self->entries);
+            #endif
             entries->fd = -1;
             if (self->obj_map) {
                 self->obj_map[entries - self->entries] = MP_OBJ_NULL;
@@ -159,6 +257,9 @@ STATIC mp_obj_t poll_modify(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t eventmas
     for (int i = self->len - 1; i >= 0; i--) {
         if (entries->fd == fd) {
             entries->events = mp_obj_get_int(eventmask_in);
+            #if MICROPY_PY_USELECT_EPOLL
+            poll_epoll_update(self, entries - self->entries);
+            #endif
             break;
         }
         entries++;
@@ -189,11 +290,65 @@ STATIC int poll_poll_internal(size_t n_args, const mp_obj_t *args) {
 
     self->flags = flags;
 
+    #if MICROPY_PY_USELECT_EPOLL
+    if (self->fd_close_count != mp_unix_fd_close_count) {
+        self->fd_close_count = mp_unix_fd_close_count;
+        poll_epoll_rearm(self);
+    }
+    if (self->n_no_epoll == 0) {
+        int n_ready = epoll_wait(self->epfd, self->events, self->alloc > 0 ? self->alloc : 1, timeout);
+        RAISE_ERRNO(n_ready, errno);
+        for (int i = 0; i < n_ready; i++) {
+            unsigned short idx = self->events[i].data.u32;
+            self->entries[idx].revents = self->events[i].events;
+            self->ready[i] = idx;
+        }
+        return n_ready;
+    }
+    #endif
+
     int n_ready = poll(self->entries, self->len, timeout);
     RAISE_ERRNO(n_ready, errno);
+    #if MICROPY_PY_USELECT_EPOLL
+    for (int i = 0, ret_i = 0; ret_i < n_ready; i++) {
+        if (self->entries[i].revents != 0) {
+            self->ready[ret_i++] = i;
+        }
+    }
+    #endif
     return n_ready;
 }
 
+// return the index of the next ready entry, and clear its events if polling
+// in oneshot mode
+STATIC int poll_next_ready(mp_obj_poll_t *self, int ret_i, int i) {
+    #if MICROPY_PY_USELECT_EPOLL
+    (void)i;
+    i = self->ready[ret_i];
+    #else
+    (void)ret_i;
+    while (self->entries[i].revents == 0) {
+        i++;
+    }
+    #endif
+    if (self->flags & FLAG_ONESHOT) {
+        self->entries[i].events = 0;
+        #if MICROPY_PY_USELECT_EPOLL
+        poll_epoll_update(self, i);
+        #endif
+    }
+    return i;
+}
+
+STATIC mp_obj_t poll_entry_obj(mp_obj_poll_t *self, int i) {
+    // If there's an object stored, return it, otherwise raw fd
+    if (self->obj_map && self->obj_map[i] != MP_OBJ_NULL) {
+        return self->obj_map[i];
+    } else {
+        return MP_OBJ_NEW_SMALL_INT(self->entries[i].fd);
+    }
+}
+
 /// \method poll([timeout])
 /// Timeout is in milliseconds.
 STATIC mp_obj_t poll_poll(size_t n_args, const mp_obj_t *args) {
@@ -206,23 +361,12 @@ STATIC mp_obj_t poll_poll(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
 
     mp_obj_list_t *ret_list = MP_OBJ_TO_PTR(mp_obj_new_list(n_ready, NULL));
-    int ret_i = 0;
-    struct pollfd *entries = self->entries;
-    for (int i = 0; i < self->len; i++, entries++) {
-        if (entries->revents != 0) {
-            mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, NULL));
-            // If there's an object stored, return it, otherwise raw fd
-            if (self->obj_map && self->obj_map[i] != MP_OBJ_NULL) {
-                t->items[0] = self->obj_map[i];
-            } else {
-                t->items[0] = MP_OBJ_NEW_SMALL_INT(entries->fd);
-            }
-            t->items[1] = MP_OBJ_NEW_SMALL_INT(entries->revents);
-            ret_list->items[ret_i++] = MP_OBJ_FROM_PTR(t);
-            if (self->flags & FLAG_ONESHOT) {
-                entries->events = 0;
-            }
-        }
+    for (int ret_i = 0, i = 0; ret_i < n_ready; ret_i++, i++) {
+        i = poll_next_ready(self, ret_i, i);
+        mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, NULL));
+        t->items[0] = poll_entry_obj(self, i);
+        t->items[1] = MP_OBJ_NEW_SMALL_INT(self->entries[i].revents);
+        ret_list->items[ret_i] = MP_OBJ_FROM_PTR(t);
     }
 
     return MP_OBJ_FROM_PTR(ret_list);
@@ -253,29 +397,31 @@ STATIC mp_obj_t poll_iternext(mp_obj_t self_in) {
 
     self->iter_cnt--;
 
-    struct pollfd *entries = self->entries + self->iter_idx;
-    for (int i = self->iter_idx; i < self->len; i++, entries++) {
-        self->iter_idx++;
-        if (entries->revents != 0) {
-            mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
-            // If there's an object stored, return it, otherwise raw fd
-            if (self->obj_map && self->obj_map[i] != MP_OBJ_NULL) {
-                t->items[0] = self->obj_map[i];
-            } else {
-                t->items[0] = MP_OBJ_NEW_SMALL_INT(entries->fd);
-            }
-            t->items[1] = MP_OBJ_NEW_SMALL_INT(entries->revents);
-            if (self->flags & FLAG_ONESHOT) {
-                entries->events = 0;
-            }
-            return MP_OBJ_FROM_PTR(t);
-        }
-    }
+    // with epoll iter_idx counts the ready entries returned so far, otherwise
+    // it is the index of the next entry to check
+    #if MICROPY_PY_USELECT_EPOLL
+    int i = poll_next_ready(self, self->iter_idx++, 0);
+    #else
+    int i = poll_next_ready(self, 0, self->iter_idx);
+    self->iter_idx = i + 1;
+    #endif
+    mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
+    t->items[0] = poll_entry_obj(self, i);
+    t->items[1] = MP_OBJ_NEW_SMALL_INT(self->entries[i].revents);
+    return MP_OBJ_FROM_PTR(t);
+}
 
-    assert(!"inconsistent number of poll active entries");
-    self->iter_cnt = 0;
-    return MP_OBJ_STOP_ITERATION;
+#if MICROPY_PY_USELECT_EPOLL
+STATIC mp_obj_t poll_del(mp_obj_t self_in) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->epfd >= 0) {
+        close(self->epfd);
+        self->epfd = -1;
+    }
+    return mp_const_none;
 }
+MP_DEFINE_CONST_FUN_OBJ_1(poll_del_obj, poll_del);
+#endif
 
 STATIC const mp_rom_map_elem_t poll_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_register), MP_ROM_PTR(&poll_register_obj) },
@@ -283,6 +429,9 @@ STATIC const mp_rom_map_elem_t poll_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_modify), MP_ROM_PTR(&poll_modify_obj) },
     { MP_ROM_QSTR(MP_QSTR_poll), MP_ROM_PTR(&poll_poll_obj) },
     { MP_ROM_QSTR(MP_QSTR_ipoll), MP_ROM_PTR(&poll_ipoll_obj) },
+    #if MICROPY_PY_USELECT_EPOLL
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&poll_del_obj) },
+    #endif
 };
 STATIC MP_DEFINE_CONST_DICT(poll_locals_dict, poll_locals_dict_table);
 
@@ -299,7 +448,19 @@ STATIC mp_obj_t select_poll(size_t n_args, const mp_obj_t *args) {
     if (n_args > 0) {
         alloc = mp_obj_get_int(args[0]);
     }
+    #if MICROPY_PY_USELECT_EPOLL
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    RAISE_ERRNO(epfd, errno);
+    mp_obj_poll_t *poll = m_new_obj_with_finaliser(mp_obj_poll_t);
+    poll->epfd = epfd;
+    poll->fd_close_count = mp_unix_fd_close_count;
+    poll->n_no_epoll = 0;
+    poll->in_epoll = m_new(bool, alloc);
+    poll->ready = m_new(unsigned short, alloc);
+    poll->events = m_new(struct epoll_event, alloc);
+    #else
     mp_obj_poll_t *poll = m_new_obj(mp_obj_poll_t);
+    #endif
     poll->base.type = &mp_type_poll;
     poll->entries = m_new(struct pollfd, alloc);
     poll->alloc = alloc;
@@ -29,6 +29,9 @@
 #define MICROPY_ENABLE_SCHEDULER            (1)
 #define MICROPY_ALLOC_PATH_MAX      (PATH_MAX)
 #define MICROPY_PERSISTENT_CODE_LOAD (1)
+#define MICROPY_PERSISTENT_CODE_LOAD_MAPPED (1)
+#define MICROPY_PERSISTENT_CODE_SAVE (1)
+#define MICROPY_PERSISTENT_CODE_CACHE (1)
 #if !defined(MICROPY_EMIT_X64) && defined(__x86_64__)
     #define MICROPY_EMIT_X64        (1)
 #endif
@@ -47,6 +50,10 @@
 #define MICROPY_COMP_MODULE_CONST   (1)
 #define MICROPY_COMP_TRIPLE_TUPLE_ASSIGN (1)
 #define MICROPY_COMP_RETURN_IF_EXPR (1)
+#define MICROPY_COMP_FOR_ENUMERATE_ZIP (1)
+#define MICROPY_COMP_CONST_LITERAL  (1)
+#define MICROPY_COMP_STREAMING      (1)
+#define MICROPY_OPT_STR_FORMAT_CACHE (1)
 #define MICROPY_ENABLE_GC           (1)
 #define MICROPY_ENABLE_FINALISER    (1)
 #define MICROPY_STACK_CHECK         (1)
@@ -64,7 +71,13 @@
 #define MICROPY_HELPER_LEXER_UNIX   (1)
 #define MICROPY_ENABLE_SOURCE_LINE  (1)
 #define MICROPY_FLOAT_IMPL          (MICROPY_FLOAT_IMPL_DOUBLE)
+#define MICROPY_FLOAT_REPR_SHORTEST (1)
+#define MICROPY_FLOAT_PARSE_EXACT   (1)
 #define MICROPY_LONGINT_IMPL        (MICROPY_LONGINT_IMPL_MPZ)
+#define MICROPY_OPT_MPZ_KARATSUBA   (1)
+#define MICROPY_OPT_MPZ_MONTGOMERY  (1)
+#define MICROPY_OPT_ITER_LEN_HINT   (1)
+#define MICROPY_OPT_LIST_TIMSORT    (1)
 #define MICROPY_STREAMS_NON_BLOCK   (1)
 #define MICROPY_STREAMS_POSIX_API   (1)
 #define MICROPY_OPT_COMPUTED_GOTO   (1)
@@ -79,6 +92,7 @@
 #define MICROPY_PY_BUILTINS_STR_PARTITION (1)
 #define MICROPY_PY_BUILTINS_STR_SPLITLINES (1)
 #define MICROPY_PY_BUILTINS_MEMORYVIEW (1)
+#define MICROPY_PY_BUILTINS_MEMORYVIEW_BYTES_METHODS (1)
 #define MICROPY_PY_BUILTINS_FROZENSET (1)
 #define MICROPY_PY_BUILTINS_COMPILE (1)
 #define MICROPY_PY_BUILTINS_NOTIMPLEMENTED (1)
@@ -88,8 +102,11 @@
 #define MICROPY_PY_BUILTINS_HELP_TEXT      esp32_help_text
 #define MICROPY_PY_BUILTINS_HELP_MODULES   (1)
 #define MICROPY_PY_MICROPYTHON_MEM_INFO (1)
+#define MICROPY_PY_MICROPYTHON_STRINGBUILDER (1)
 #define MICROPY_PY_ALL_SPECIAL_METHODS (1)
 #define MICROPY_PY_ARRAY_SLICE_ASSIGN (1)
+#define MICROPY_PY_ARRAY_BULK_OPS   (1)
+#define MICROPY_PY_STRUCT_STRUCT    (1)
 #define MICROPY_PY_BUILTINS_SLICE_ATTRS (1)
 #define MICROPY_PY_SYS_EXIT         (1)
 #if defined(__APPLE__) && defined(__MACH__)
@@ -119,10 +136,19 @@
 #define MICROPY_PY_UERRNO           (1)
 #define MICROPY_PY_UCTYPES          (1)
 #define MICROPY_PY_UZLIB            (1)
+#define MICROPY_PY_UZLIB_COMPRESS   (1)
+#define MICROPY_PY_UZLIB_FAST_DECODE (1)
 #define MICROPY_PY_UJSON            (1)
+#define MICROPY_PY_UJSON_SEPARATORS (1)
 #define MICROPY_PY_URE              (1)
+#define MICROPY_PY_URE_SUB          (1)
+#define MICROPY_PY_URE_FINDITER     (1)
+#define MICROPY_PY_URE_MATCH_SPAN   (1)
+#define MICROPY_PY_URE_CACHE        (1)
 #define MICROPY_PY_UHEAPQ           (1)
 #define MICROPY_PY_UTIMEQ           (1)
+#define MICROPY_PY_UEVENTLOOP       (1)
+#define MICROPY_PY_KVLOG            (1)
 #define MICROPY_PY_UHASHLIB         (1)
 #if MICROPY_PY_USSL && MICROPY_SSL_AXTLS
 #define MICROPY_PY_UHASHLIB_SHA1    (1)
@@ -134,6 +160,14 @@
 #ifndef MICROPY_PY_USELECT_POSIX
 #define MICROPY_PY_USELECT_POSIX    (1)
 #endif
+// Wait for poll objects with epoll, so a wakeup costs O(ready) not O(registered)
+#ifndef MICROPY_PY_USELECT_EPOLL
+#ifdef __linux__
+#define MICROPY_PY_USELECT_EPOLL    (1)
+#else
+#define MICROPY_PY_USELECT_EPOLL    (0)
+#endif
+#endif
 #define MICROPY_PY_WEBSOCKET        (1)
 #define MICROPY_PY_MACHINE          (1)
 #define MICROPY_PY_MACHINE_PULSE    (1)
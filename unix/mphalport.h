@@ -53,6 +53,15 @@ static inline void mp_hal_delay_ms(mp_uint_t ms) { usleep((ms) * 1000); }
 static inline void mp_hal_delay_us(mp_uint_t us) { usleep(us); }
 #define mp_hal_ticks_cpu() 0
 
+#if MICROPY_PY_USELECT_EPOLL
+// Closing an fd removes it from any epoll instance, and its number may then
+// be reused, so fds closed by MicroPython are counted for uselect.poll to see.
+extern unsigned int mp_unix_fd_close_count;
+#define MP_UNIX_FD_CLOSED() (mp_unix_fd_close_count++)
+#else
+#define MP_UNIX_FD_CLOSED()
+#endif
+
 #define RAISE_ERRNO(err_flag, error_val) \
     { if (err_flag == -1) \
         { mp_raise_OSError(error_val); } }